@@ -0,0 +1,25 @@
+/** @file bsp.h
+ * @brief Host stand-in for the board support package, the virtual COM port
+ * pins of the Thunderboard (bspconfig.h).
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#ifndef HOST_SIM_DEVICE_BSP_H_
+#define HOST_SIM_DEVICE_BSP_H_
+
+#include "em_gpio.h"
+
+#define BSP_BCC_USART USART0
+#define BSP_BCC_CLK cmuClock_USART0
+#define BSP_BCC_TX_LOCATION USART_ROUTELOC0_TXLOC_LOC1
+#define BSP_BCC_RX_LOCATION USART_ROUTELOC0_RXLOC_LOC1
+#define BSP_BCC_TXPORT gpioPortE
+#define BSP_BCC_TXPIN 7
+#define BSP_BCC_RXPORT gpioPortE
+#define BSP_BCC_RXPIN 6
+#define BSP_BCC_ENABLE_PORT gpioPortA
+#define BSP_BCC_ENABLE_PIN 15
+
+#endif /* HOST_SIM_DEVICE_BSP_H_ */
@@ -0,0 +1,215 @@
+/** @file core_armv8mml.h
+ * @brief Host stand-in for the Cortex-M core header.
+ *
+ * The host build defines ARM_MATH_ARMV8MML with __DSP_PRESENT, which makes
+ * arm_math.h include this header and take the same DSP code paths as the
+ * Cortex-M4 build. The SIMD and saturating intrinsics those paths use are
+ * defined here in plain C with the instructions' wrapping and saturation, so
+ * with -fwrapv the library computes bit for bit what it computes on the board.
+ *
+ * Interrupt masking, the NVIC and the cycle counter are kept by the
+ * simulator, see sim_device.c.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#ifndef HOST_SIM_DEVICE_CORE_ARMV8MML_H_
+#define HOST_SIM_DEVICE_CORE_ARMV8MML_H_
+
+#include <stdint.h>
+
+#define __STATIC_INLINE static inline
+#define __INLINE inline
+#define __ASM __asm__
+#define __NOP() ((void) 0)
+
+/** Interrupt masking and NVIC, kept by the simulator */
+void __disable_irq(void);
+void __enable_irq(void);
+void NVIC_EnableIRQ(int irq);
+void NVIC_DisableIRQ(int irq);
+void NVIC_ClearPendingIRQ(int irq);
+
+/** Cycle counter, reading the simulated clock at SIM_CORE_CLOCK */
+#define CYCCNT cyccnt()
+
+typedef struct {
+	volatile uint32_t CTRL;
+	uint32_t (*cyccnt)(void);
+} SimDwt_TypeDef;
+
+typedef struct {
+	volatile uint32_t DEMCR;
+} SimCoreDebug_TypeDef;
+
+extern SimDwt_TypeDef simDwt;
+extern SimCoreDebug_TypeDef simCoreDebug;
+
+#define DWT (&simDwt)
+#define CoreDebug (&simCoreDebug)
+#define DWT_CTRL_CYCCNTENA_Msk (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk (1UL << 24)
+
+/** Bit operations */
+static inline uint8_t __CLZ(uint32_t value) {
+	return value ? (uint8_t) __builtin_clz(value) : 32;
+}
+
+static inline uint32_t __ROR(uint32_t value, uint32_t shift) {
+	shift &= 31;
+	return shift ? (value >> shift) | (value << (32 - shift)) : value;
+}
+
+/** Saturation */
+static inline int32_t __SSAT(int32_t value, uint32_t bits) {
+	int32_t max = (1 << (bits - 1)) - 1, min = -(1 << (bits - 1));
+	return value > max ? max : (value < min ? min : value);
+}
+
+static inline uint32_t __USAT(int32_t value, uint32_t bits) {
+	int32_t max = (1 << bits) - 1;
+	return value > max ? (uint32_t) max : (value < 0 ? 0 : (uint32_t) value);
+}
+
+static inline int32_t hostClipQ63ToQ31(int64_t value) {
+	return ((int32_t) (value >> 32) != ((int32_t) value >> 31))
+	       ? (0x7FFFFFFF ^ (int32_t) (value >> 63)) : (int32_t) value;
+}
+
+/** Halves and bytes of a word, sign extended */
+#define HOST_LO16(x) (((int32_t) (x) << 16) >> 16)
+#define HOST_HI16(x) ((int32_t) (x) >> 16)
+#define HOST_BYTE(x, n) (((int32_t) (x) << (24 - 8 * (n))) >> 24)
+
+#define __PKHBT(ARG1, ARG2, ARG3) ((((int32_t) (ARG1) << 0) & (int32_t) 0x0000FFFF) \
+                                   | (((int32_t) (ARG2) << (ARG3)) & (int32_t) 0xFFFF0000))
+#define __PKHTB(ARG1, ARG2, ARG3) ((((int32_t) (ARG1) << 0) & (int32_t) 0xFFFF0000) \
+                                   | (((int32_t) (ARG2) >> (ARG3)) & (int32_t) 0x0000FFFF))
+
+/** Packed byte arithmetic */
+static inline uint32_t __QADD8(uint32_t x, uint32_t y) {
+	uint32_t result = 0;
+	for (int n = 0; n < 4; n++) {
+		result |= (uint32_t) (__SSAT(HOST_BYTE(x, n) + HOST_BYTE(y, n), 8) & 0xFF) << (8 * n);
+	}
+	return result;
+}
+
+static inline uint32_t __QSUB8(uint32_t x, uint32_t y) {
+	uint32_t result = 0;
+	for (int n = 0; n < 4; n++) {
+		result |= (uint32_t) (__SSAT(HOST_BYTE(x, n) - HOST_BYTE(y, n), 8) & 0xFF) << (8 * n);
+	}
+	return result;
+}
+
+/** Packed halfword arithmetic */
+static inline uint32_t hostPack16(int32_t low, int32_t high) {
+	return ((uint32_t) (high & 0xFFFF) << 16) | (uint32_t) (low & 0xFFFF);
+}
+
+static inline uint32_t __QADD16(uint32_t x, uint32_t y) {
+	return hostPack16(__SSAT(HOST_LO16(x) + HOST_LO16(y), 16),
+	                  __SSAT(HOST_HI16(x) + HOST_HI16(y), 16));
+}
+
+static inline uint32_t __SHADD16(uint32_t x, uint32_t y) {
+	return hostPack16((HOST_LO16(x) + HOST_LO16(y)) >> 1,
+	                  (HOST_HI16(x) + HOST_HI16(y)) >> 1);
+}
+
+static inline uint32_t __QSUB16(uint32_t x, uint32_t y) {
+	return hostPack16(__SSAT(HOST_LO16(x) - HOST_LO16(y), 16),
+	                  __SSAT(HOST_HI16(x) - HOST_HI16(y), 16));
+}
+
+static inline uint32_t __SHSUB16(uint32_t x, uint32_t y) {
+	return hostPack16((HOST_LO16(x) - HOST_LO16(y)) >> 1,
+	                  (HOST_HI16(x) - HOST_HI16(y)) >> 1);
+}
+
+static inline uint32_t __QASX(uint32_t x, uint32_t y) {
+	return hostPack16(__SSAT(HOST_LO16(x) - HOST_HI16(y), 16),
+	                  __SSAT(HOST_HI16(x) + HOST_LO16(y), 16));
+}
+
+static inline uint32_t __SHASX(uint32_t x, uint32_t y) {
+	return hostPack16((HOST_LO16(x) - HOST_HI16(y)) >> 1,
+	                  (HOST_HI16(x) + HOST_LO16(y)) >> 1);
+}
+
+static inline uint32_t __QSAX(uint32_t x, uint32_t y) {
+	return hostPack16(__SSAT(HOST_LO16(x) + HOST_HI16(y), 16),
+	                  __SSAT(HOST_HI16(x) - HOST_LO16(y), 16));
+}
+
+static inline uint32_t __SHSAX(uint32_t x, uint32_t y) {
+	return hostPack16((HOST_LO16(x) + HOST_HI16(y)) >> 1,
+	                  (HOST_HI16(x) - HOST_LO16(y)) >> 1);
+}
+
+static inline uint32_t __SSAT16(uint32_t x, uint32_t bits) {
+	return hostPack16(__SSAT(HOST_LO16(x), bits), __SSAT(HOST_HI16(x), bits));
+}
+
+static inline uint32_t __SXTB16(uint32_t x) {
+	return hostPack16(HOST_BYTE(x, 0), HOST_BYTE(x, 2));
+}
+
+/** Dual 16 bit multiplies */
+static inline uint32_t __SMUAD(uint32_t x, uint32_t y) {
+	return (uint32_t) (HOST_LO16(x) * HOST_LO16(y) + HOST_HI16(x) * HOST_HI16(y));
+}
+
+static inline uint32_t __SMUADX(uint32_t x, uint32_t y) {
+	return (uint32_t) (HOST_LO16(x) * HOST_HI16(y) + HOST_HI16(x) * HOST_LO16(y));
+}
+
+static inline uint32_t __SMUSD(uint32_t x, uint32_t y) {
+	return (uint32_t) (HOST_LO16(x) * HOST_LO16(y) - HOST_HI16(x) * HOST_HI16(y));
+}
+
+static inline uint32_t __SMUSDX(uint32_t x, uint32_t y) {
+	return (uint32_t) (HOST_LO16(x) * HOST_HI16(y) - HOST_HI16(x) * HOST_LO16(y));
+}
+
+static inline uint32_t __SMLAD(uint32_t x, uint32_t y, uint32_t sum) {
+	return (uint32_t) (HOST_LO16(x) * HOST_LO16(y) + HOST_HI16(x) * HOST_HI16(y)
+	                   + (int32_t) sum);
+}
+
+static inline uint32_t __SMLADX(uint32_t x, uint32_t y, uint32_t sum) {
+	return (uint32_t) (HOST_LO16(x) * HOST_HI16(y) + HOST_HI16(x) * HOST_LO16(y)
+	                   + (int32_t) sum);
+}
+
+static inline uint32_t __SMLSDX(uint32_t x, uint32_t y, uint32_t sum) {
+	return (uint32_t) (HOST_LO16(x) * HOST_HI16(y) - HOST_HI16(x) * HOST_LO16(y)
+	                   + (int32_t) sum);
+}
+
+static inline uint64_t __SMLALD(uint32_t x, uint32_t y, uint64_t sum) {
+	return (uint64_t) ((int64_t) HOST_LO16(x) * HOST_LO16(y)
+	                   + (int64_t) HOST_HI16(x) * HOST_HI16(y) + (int64_t) sum);
+}
+
+static inline uint64_t __SMLALDX(uint32_t x, uint32_t y, uint64_t sum) {
+	return (uint64_t) ((int64_t) HOST_LO16(x) * HOST_HI16(y)
+	                   + (int64_t) HOST_HI16(x) * HOST_LO16(y) + (int64_t) sum);
+}
+
+/** Saturating and high word arithmetic */
+static inline int32_t __QADD(int32_t x, int32_t y) {
+	return hostClipQ63ToQ31((int64_t) x + y);
+}
+
+static inline int32_t __QSUB(int32_t x, int32_t y) {
+	return hostClipQ63ToQ31((int64_t) x - y);
+}
+
+static inline int32_t __SMMLA(int32_t x, int32_t y, int32_t sum) {
+	return sum + (int32_t) (((int64_t) x * y) >> 32);
+}
+
+#endif /* HOST_SIM_DEVICE_CORE_ARMV8MML_H_ */
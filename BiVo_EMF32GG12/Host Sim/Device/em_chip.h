@@ -0,0 +1,17 @@
+/** @file em_chip.h
+ * @brief Host stand-in for emlib's chip initialization.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#ifndef HOST_SIM_DEVICE_EM_CHIP_H_
+#define HOST_SIM_DEVICE_EM_CHIP_H_
+
+#include "em_device.h"
+
+/** Errata fixes have nothing to do on the host */
+static inline void CHIP_Init(void) {
+}
+
+#endif /* HOST_SIM_DEVICE_EM_CHIP_H_ */
@@ -0,0 +1,29 @@
+/** @file em_cmu.h
+ * @brief Host stand-in for emlib's clock management. Clocks always run on the
+ * host, so enabling one does nothing, and the peripheral clocks run undivided
+ * at the simulated core clock.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#ifndef HOST_SIM_DEVICE_EM_CMU_H_
+#define HOST_SIM_DEVICE_EM_CMU_H_
+
+#include "em_device.h"
+
+typedef enum {
+	cmuClock_GPIO, cmuClock_USART0, cmuClock_PDM, cmuClock_LDMA, cmuClock_WTIMER0
+} CMU_Clock_TypeDef;
+
+static inline void CMU_ClockEnable(CMU_Clock_TypeDef clock, bool enable) {
+	(void) clock;
+	(void) enable;
+}
+
+static inline uint32_t CMU_ClockFreqGet(CMU_Clock_TypeDef clock) {
+	(void) clock;
+	return 19000000;		// SIM_CORE_CLOCK
+}
+
+#endif /* HOST_SIM_DEVICE_EM_CMU_H_ */
@@ -0,0 +1,115 @@
+/** @file em_device.h
+ * @brief Host stand-in for the EFM32GG12 device header.
+ *
+ * The bit fields come from the device's own register headers, so drivers
+ * write the same values they write on the board. The register blocks the
+ * drivers touch (CMU, PDM, USART0 and WTIMER0) are replaced with simulated
+ * ones, kept by sim_device.c.
+ *
+ * Registers with side effects are reached through functions. Their names are
+ * defined to call them, so PDM->RXDATA in a driver pops the simulated FIFO and
+ * USART0->TXDATA = byte hands the byte to the simulated link, with the driver
+ * code unchanged. Every such access is also a point where the simulator
+ * catches up its clock, see sim_device.c.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#ifndef HOST_SIM_DEVICE_EM_DEVICE_H_
+#define HOST_SIM_DEVICE_EM_DEVICE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define EFM32GG12B810F1024GM64 1
+
+/** Register qualifiers used by the device headers */
+#define __I volatile const
+#define __O volatile
+#define __IO volatile
+#define __IM volatile const
+#define __OM volatile
+#define __IOM volatile
+
+/** Interrupt numbers of the peripherals simulated */
+typedef enum IRQn {
+	USART0_RX_IRQn = 6, USART0_TX_IRQn = 7, PDM_IRQn = 59
+} IRQn_Type;
+
+#include "core_armv8mml.h"
+
+/** Register bit fields, from the device headers */
+#include "efm32gg12b_cmu.h"
+#include "efm32gg12b_pdm.h"
+#include "efm32gg12b_timer_cc.h"
+#include "efm32gg12b_timer.h"
+#include "efm32gg12b_usart.h"
+
+/** Registers with side effects, accessed through the simulator */
+#define STATUS status()				// PDM FIFO and USART buffer state
+#define RXDATA rxdata()				// pops the PDM FIFO or the USART receiver
+#define SYNCBUSY syncbusy()
+#define CMD cmd()[0]					// PDM START and STOP, timer START
+#define CNT cnt()							// timer counter, from the simulated clock
+#define TXDATA txdata()[0]
+#define TXDOUBLE txdouble()[0]
+
+/** @struct Simulated CMU, clock enables only */
+typedef struct {
+	volatile uint32_t HFBUSCLKEN0;
+	volatile uint32_t HFPERCLKEN0;
+	volatile uint32_t HFPERCLKEN1;
+	volatile uint32_t PDMCTRL;
+} SimCmu_TypeDef;
+
+/** @struct Simulated PDM, one channel */
+typedef struct {
+	uint32_t (*status)(void);
+	uint32_t (*rxdata)(void);
+	uint32_t (*syncbusy)(void);
+	volatile uint32_t *(*cmd)(void);
+	volatile uint32_t EN;
+	volatile uint32_t CTRL;
+	volatile uint32_t CFG0;
+	volatile uint32_t CFG1;
+	volatile uint32_t IF;
+	volatile uint32_t IFS;
+	volatile uint32_t IFC;
+	volatile uint32_t IEN;
+	volatile uint32_t ROUTEPEN;
+	volatile uint32_t ROUTELOC0;
+	volatile uint32_t ROUTELOC1;
+} SimPdm_TypeDef;
+
+/** @struct Simulated USART, asynchronous 8N1 only */
+typedef struct {
+	uint32_t (*status)(void);
+	uint32_t (*rxdata)(void);
+	volatile uint32_t *(*txdata)(void);
+	volatile uint32_t *(*txdouble)(void);
+	volatile uint32_t ROUTEPEN;
+	volatile uint32_t ROUTELOC0;
+} SimUsart_TypeDef;
+
+/** @struct Simulated TIMER, a free running up-counter */
+typedef struct {
+	uint32_t (*cnt)(void);
+	volatile uint32_t *(*cmd)(void);
+	volatile uint32_t CTRL;
+} SimTimer_TypeDef;
+
+extern SimCmu_TypeDef simCmu;
+extern SimPdm_TypeDef simPdm;
+extern SimUsart_TypeDef simUsart0;
+extern SimTimer_TypeDef simWtimer0;
+
+#define CMU (&simCmu)
+#define PDM (&simPdm)
+#define USART0 (&simUsart0)
+#define WTIMER0 (&simWtimer0)
+
+/** Interrupt handlers the firmware provides */
+void PDM_IRQHandler(void);
+
+#endif /* HOST_SIM_DEVICE_EM_DEVICE_H_ */
@@ -0,0 +1,16 @@
+/** @file em_emu.h
+ * @brief Host stand-in for emlib's energy management.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#ifndef HOST_SIM_DEVICE_EM_EMU_H_
+#define HOST_SIM_DEVICE_EM_EMU_H_
+
+#include "em_device.h"
+
+/** Sleeps until the next interrupt, advancing the simulated time to it */
+void EMU_EnterEM1(void);
+
+#endif /* HOST_SIM_DEVICE_EM_EMU_H_ */
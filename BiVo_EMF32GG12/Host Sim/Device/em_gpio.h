@@ -0,0 +1,42 @@
+/** @file em_gpio.h
+ * @brief Host stand-in for emlib's GPIO. Pins are not simulated, the
+ * microphone and the link are reached through their peripherals only.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#ifndef HOST_SIM_DEVICE_EM_GPIO_H_
+#define HOST_SIM_DEVICE_EM_GPIO_H_
+
+#include "em_device.h"
+
+typedef enum {
+	gpioPortA, gpioPortB, gpioPortC, gpioPortD, gpioPortE, gpioPortF
+} GPIO_Port_TypeDef;
+
+typedef enum {
+	gpioModeDisabled, gpioModeInput, gpioModePushPull
+} GPIO_Mode_TypeDef;
+
+static inline void GPIO_PinModeSet(GPIO_Port_TypeDef port, unsigned int pin,
+                                   GPIO_Mode_TypeDef mode, unsigned int out) {
+	(void) port;
+	(void) pin;
+	(void) mode;
+	(void) out;
+}
+
+static inline void GPIO_PinOutSet(GPIO_Port_TypeDef port, unsigned int pin) {
+	(void) port;
+	(void) pin;
+}
+
+static inline void GPIO_SlewrateSet(GPIO_Port_TypeDef port, uint32_t slewrate,
+                                    uint32_t slewrateAlt) {
+	(void) port;
+	(void) slewrate;
+	(void) slewrateAlt;
+}
+
+#endif /* HOST_SIM_DEVICE_EM_GPIO_H_ */
@@ -0,0 +1,14 @@
+/** @file em_ldma.h
+ * @brief Host stand-in for emlib's LDMA. The drivers include it but do not
+ * use DMA.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#ifndef HOST_SIM_DEVICE_EM_LDMA_H_
+#define HOST_SIM_DEVICE_EM_LDMA_H_
+
+#include "em_device.h"
+
+#endif /* HOST_SIM_DEVICE_EM_LDMA_H_ */
@@ -0,0 +1,14 @@
+/** @file em_pdm.h
+ * @brief Host stand-in for emlib's PDM. The microphone driver programs the
+ * registers directly, see em_device.h.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#ifndef HOST_SIM_DEVICE_EM_PDM_H_
+#define HOST_SIM_DEVICE_EM_PDM_H_
+
+#include "em_device.h"
+
+#endif /* HOST_SIM_DEVICE_EM_PDM_H_ */
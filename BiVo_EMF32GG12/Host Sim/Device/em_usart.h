@@ -0,0 +1,24 @@
+/** @file em_usart.h
+ * @brief Host stand-in for emlib's USART. Only the baud rate is simulated,
+ * frames are always 8N1.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#ifndef HOST_SIM_DEVICE_EM_USART_H_
+#define HOST_SIM_DEVICE_EM_USART_H_
+
+#include "em_device.h"
+
+typedef struct {
+	bool enable;
+	uint32_t baudrate;
+} USART_InitAsync_TypeDef;
+
+#define USART_INITASYNC_DEFAULT {true, 115200}
+
+void USART_InitAsync(SimUsart_TypeDef *usart,
+                     const USART_InitAsync_TypeDef *init);
+
+#endif /* HOST_SIM_DEVICE_EM_USART_H_ */
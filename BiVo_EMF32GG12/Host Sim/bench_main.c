@@ -0,0 +1,723 @@
+/** @file bench_main.c
+ * @brief Host benchmarks of the DSP kernels of the analysis pipeline.
+ *
+ * Times the CMSIS kernels the firmware calls and the Audio Analysis functions,
+ * built from the same sources as the firmware, over a range of FFT sizes and
+ * block lengths. The numbers are host ns, so they compare kernels and catch
+ * regressions before going to the board, the board's own cycle counts come
+ * from the profiler (profiler.h).
+ *
+ * Each benchmark is run in batches of calls long enough to time well (-t),
+ * after a warm-up batch, and the per-call time of each batch is kept. The
+ * process is pinned to the CPU it starts on. Results go to stdout as CSV, one
+ * line per benchmark and size:
+ *
+ * 	benchmark,size,samples,calls,runs,min_ns,median_ns,mean_ns,stddev_ns,ns_per_sample
+ *
+ * size is the FFT size, block length or segment FFT size of the benchmark, the
+ * number of targets for goertzel_targets or the frames matched over for
+ * match_templates, and samples the audio samples
+ * one call covers. goertzel_targets runs blocks of BENCH_GOERTZEL_BLOCK
+ * samples, so its lines compare directly with rfft_mag_q15 and fft_kernel at
+ * that size to find the target count where the FFT becomes cheaper. Compare two outputs with
+ * Tools/bench_compare.py.
+ *
+ * Usage: bivo_bench [-r runs] [-t ms] [-l] [filter...]
+ * 	-r	Timed batches per benchmark, 15 by default.
+ * 	-t	Shortest batch, in ms, 5 by default.
+ * 	-l	List the benchmarks and sizes instead of running them.
+ * 	filter	Only run benchmarks whose name contains one of the filters.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include "arm_math.h"
+#include "acoustic_indices.h"
+#include "audio_analysis.h"
+#include "decimator.h"
+#include "fft_kernels.h"
+#include "goertzel.h"
+#include "level_meter.h"
+#include "match_templates.h"
+#include "nn_classifier.h"
+#include "nn_model.h"
+#include "pitch_tracker.h"
+#include "sample_pack.h"
+#include "spectral_shape.h"
+
+#define BENCH_SAMPLE_RATE 19900				// rate of the standard configuration
+#define BENCH_SEGMENT 19900						// samples of a segment, 1 s
+#define BENCH_MAX_FFT 2048
+#define BENCH_MAX_RUNS 1000
+#define BENCH_GOERTZEL_BLOCK 256			// block of the target count sweep
+
+/** @brief Prepare one size of a benchmark.
+ *
+ * @return Audio samples one call covers, 0 to skip the size.
+ */
+typedef uint32_t (*BenchSetup)(int size);
+
+/** @struct One benchmark, run at each of its sizes.
+ */
+struct Benchmark {
+		const char *name;
+		const int *sizes;				// ends with 0
+		BenchSetup setup;
+		void (*run)(void);
+		void (*teardown)(void);	// NULL if there is nothing to free
+};
+
+/** Test signal, a tone and a chirp over low noise */
+static int16_t _audio[BENCH_SEGMENT];
+
+/** Working buffers of the kernels */
+static q15_t _frame[BENCH_MAX_FFT];
+static q15_t _spectrum[2 * BENCH_MAX_FFT];
+static q15_t _magnitude[BENCH_MAX_FFT + 2];
+static q31_t _frame31[BENCH_MAX_FFT];
+static q31_t _output31[BENCH_MAX_FFT];
+static float32_t _frameF32[BENCH_MAX_FFT];
+static float32_t _spectrumF32[BENCH_MAX_FFT];
+static float32_t _magnitudeF32[BENCH_MAX_FFT];
+
+/** Kernel instances */
+static int _size;
+static arm_rfft_instance_q15 _rfft;
+static arm_rfft_fast_instance_f32 _rfftF32;
+static FftKernel _kernel;
+static arm_biquad_casd_df1_inst_q31 _biquad;
+static q31_t _biquadCoeffs[10];
+static q31_t _biquadState[8];
+static struct Decimator _decimator;
+static struct AnlysConfig _anlysConfig;
+static struct GoertzelConfig _goertzelConfig;
+static const uint16_t _goertzelTargets[] = {2500, 3150, 4000};
+static const uint16_t _goertzelSweep[GOERTZEL_MAX_TARGETS] = {
+		1000, 1500, 2000, 2500, 3000, 3500, 4000, 4500,
+		5000, 5500, 6000, 6500, 7000, 7500, 8000, 8500
+	};
+static struct MatchResult _matchResults[MATCH_TEMPLATE_COUNT];
+static uint32_t _matchSamples;
+static struct AnlysSpectrum _frameSpectrum;
+static struct SpectralShape _shape;
+static int _shapeLower, _shapeUpper;
+static q15_t _features[MEL_MAX_BANDS];
+static q15_t _nnInput[BENCH_MAX_FFT];
+static q15_t _nnScores[BENCH_MAX_FFT];
+static struct PitchEstimate _pitch;
+static uint32_t _packed[SAMPLE_PACK_SIZE(BENCH_SEGMENT)];
+static volatile bool _result;					// keeps results from being optimized out
+
+/** Sizes */
+static const int _fftSizes[] = {64, 128, 256, 512, 1024, 2048, 0};
+static const int _blockSizes[] = {32, 64, 128, 256, 512, 1024, 0};
+static const int _segmentFftSizes[] = {128, 256, 512, 1024, 0};
+static const int _goertzelCounts[] = {1, 2, 4, 6, 7, 8, 12, 16, 0};
+static const int _matchFrames[] = {16, 32, 64, 0};
+static const int _inferenceSizes[] = {256, 0};
+static const int _levelBlocks[] = {16, 32, 64, 128, 256, 0};
+static const int _pitchWindows[] = {64, 128, 192, 256, 0};
+
+/** @brief Fill the test signal, a quiet tone and chirp over noise. The segment
+ * benchmarks set the threshold out of reach, so the level trigger analyzes
+ * every frame. The onset trigger stops at the first onset, as it does on the
+ * board.
+ */
+static void makeAudio(void) {
+	uint32_t seed = 12345;
+	double phase = 0.0;
+
+	for (int index=0; index<BENCH_SEGMENT; index++) {
+		double t = (double) index / BENCH_SAMPLE_RATE;
+
+		seed = seed * 1664525 + 1013904223;
+		phase += 2.0 * M_PI * (2000.0 + 3000.0 * t) / BENCH_SAMPLE_RATE;
+		_audio[index] = (int16_t) (200.0 * sin(2.0 * M_PI * 3150.0 * t)
+		                           + 100.0 * sin(phase)) + (int16_t) (seed >> 24) - 128;
+	}
+}
+
+/** CMSIS real FFT, the frame is copied in as the firmware does */
+static uint32_t setupRfftQ15(int size) {
+	_size = size;
+	return arm_rfft_init_q15(&_rfft, size, 0, 1) == ARM_MATH_SUCCESS ? size : 0;
+}
+
+static void runRfftQ15(void) {
+	memcpy(_frame, _audio, _size * sizeof(q15_t));
+	arm_rfft_q15(&_rfft, _frame, _spectrum);
+}
+
+/** CMSIS complex magnitude of a real FFT's non-redundant half */
+static uint32_t setupCmplxMag(int size) {
+	_size = size;
+	memcpy(_spectrum, _audio, 2 * size * sizeof(q15_t) < sizeof(_audio)
+	       ? 2 * size * sizeof(q15_t) : sizeof(_audio));
+	return size;
+}
+
+static void runCmplxMag(void) {
+	arm_cmplx_mag_q15(_spectrum, _magnitude, _size/2 + 1);
+}
+
+/** Firmware's CMSIS path, real FFT and magnitudes */
+static void runRfftMagQ15(void) {
+	memcpy(_frame, _audio, _size * sizeof(q15_t));
+	arm_rfft_q15(&_rfft, _frame, _spectrum);
+	arm_cmplx_mag_q15(_spectrum, _magnitude, _size/2 + 1);
+}
+
+/** Generated fixed-size kernels, FFT and magnitudes in one */
+static uint32_t setupKernel(int size) {
+	_size = size;
+	_kernel = fftKernel_select(size);
+	return _kernel != NULL ? size : 0;
+}
+
+static void runKernel(void) {
+	memcpy(_frame, _audio, _size * sizeof(q15_t));
+	_kernel(_frame, _magnitude);
+}
+
+/** Floating point real FFT and magnitudes, from q15 samples */
+static uint32_t setupRfftF32(int size) {
+	_size = size;
+	return arm_rfft_fast_init_f32(&_rfftF32, size) == ARM_MATH_SUCCESS ? size : 0;
+}
+
+static void runRfftF32(void) {
+	arm_q15_to_float(_audio, _frameF32, _size);
+	arm_rfft_fast_f32(&_rfftF32, _frameF32, _spectrumF32, 0);
+	arm_cmplx_mag_f32(_spectrumF32, _magnitudeF32, _size/2);
+}
+
+/** Two stage q31 biquad cascade with postShift 1, as in the level meter. Both
+ * stages are a 100 Hz Butterworth high pass in Q30 */
+static uint32_t setupBiquad(int size) {
+	static const q31_t coeffs[10] = {
+			1050035008, -2100070016, 1050035008, 2099546536, -1026851671,
+			1050035008, -2100070016, 1050035008, 2099546536, -1026851671
+		};
+
+	_size = size;
+	memcpy(_biquadCoeffs, coeffs, sizeof(coeffs));
+	arm_biquad_cascade_df1_init_q31(&_biquad, 2, _biquadCoeffs, _biquadState, 1);
+	for (int index=0; index<size; index++) {
+		_frame31[index] = (q31_t) _audio[index] << 16;
+	}
+	return size;
+}
+
+static void runBiquad(void) {
+	arm_biquad_cascade_df1_q31(&_biquad, _frame31, _output31, _size);
+}
+
+static void runBiquadFast(void) {
+	arm_biquad_cascade_df1_fast_q31(&_biquad, _frame31, _output31, _size);
+}
+
+/** Decimators, size is the output block */
+static uint32_t setupDecimator(int size, int factor) {
+	_size = size;
+	if (size * factor > BENCH_SEGMENT
+	    || decimator_init(&_decimator, factor, size) != DECIM_OK) {
+		return 0;
+	}
+	return size * factor;
+}
+
+static uint32_t setupDecimator2(int size) {
+	return setupDecimator(size, 2);
+}
+
+static uint32_t setupDecimator3(int size) {
+	return setupDecimator(size, 3);
+}
+
+static uint32_t setupDecimator4(int size) {
+	return setupDecimator(size, 4);
+}
+
+static void runDecimator(void) {
+	decimator_process(&_decimator, _audio, _frame);
+}
+
+static void teardownDecimator(void) {
+	decimator_deinit(&_decimator);
+}
+
+/** Segment analysis, one segment at the standard configuration with the FFT
+ * size varied */
+static uint32_t setupAnalysis(int size) {
+	_anlysConfig = (struct AnlysConfig) {
+			.fftSize = size,
+			.freqLower = 0,
+			.freqUpper = 9950,
+			.powerThreshold = 30000,
+			.sampleScaler = 1,
+			.decimation = 1,
+			.trigger = ANLYS_TRIGGER_LEVEL,
+			.onsetMargin = 1024
+		};
+	return audioAnalysis_init(_anlysConfig, BENCH_SAMPLE_RATE) == ANLYS_OK
+	    ? BENCH_SEGMENT : 0;
+}
+
+static void runAnalyzeAudio(void) {
+	_result = analyzeAudio(_audio, BENCH_SEGMENT, BENCH_SAMPLE_RATE, _anlysConfig);
+}
+
+static void runAnalyzeEvent(void) {
+	struct AnlysEvent event;
+
+	_result = analyzeAudioEvent(_audio, BENCH_SEGMENT, BENCH_SAMPLE_RATE,
+	                            _anlysConfig, &event);
+}
+
+static uint32_t setupOnsets(int size) {
+	setupAnalysis(size);
+	_anlysConfig.trigger = ANLYS_TRIGGER_ONSET;
+	return BENCH_SEGMENT;
+}
+
+static void teardownAnalysis(void) {
+	audioAnalysis_deinit();
+}
+
+/** Packed 12 bit storage, a block of size packed or unpacked */
+static uint32_t setupPack(int size) {
+	_size = size;
+	for (int index=0; index<size; index+=SAMPLE_PACK_GROUP) {
+		samplePack_group(&_audio[index], &_packed[index / SAMPLE_PACK_GROUP * SAMPLE_PACK_WORDS]);
+	}
+	return size;
+}
+
+static void runPack(void) {
+	bool clipped = false;
+
+	for (int index=0; index<_size; index+=SAMPLE_PACK_GROUP) {
+		clipped |= samplePack_group(&_audio[index],
+		                            &_packed[index / SAMPLE_PACK_GROUP * SAMPLE_PACK_WORDS]);
+	}
+	_result = clipped;
+}
+
+static void runUnpack(void) {
+	samplePack_read(_packed, 0, _size, (int16_t *) _frame);
+	_result = _frame[0] != 0;
+}
+
+/** Goertzel detector, one segment in blocks of size */
+static uint32_t setupGoertzel(int size) {
+	_goertzelConfig = (struct GoertzelConfig) {
+			.blockSize = size,
+			.powerThreshold = 30000,
+			.sampleScaler = 1,
+			.targets = _goertzelTargets,
+			.targetCount = sizeof(_goertzelTargets) / sizeof(_goertzelTargets[0])
+		};
+	return goertzel_init(_goertzelConfig, BENCH_SAMPLE_RATE) == GOERTZEL_OK
+	       ? BENCH_SEGMENT : 0;
+}
+
+static void runGoertzel(void) {
+	_result = analyzeAudioGoertzel(_audio, BENCH_SEGMENT, BENCH_SAMPLE_RATE,
+	                               _goertzelConfig);
+}
+
+/** Goertzel filter bank, one block of BENCH_GOERTZEL_BLOCK with size targets */
+static uint32_t setupGoertzelTargets(int size) {
+	_goertzelConfig = (struct GoertzelConfig) {
+			.blockSize = BENCH_GOERTZEL_BLOCK,
+			.powerThreshold = 30000,
+			.sampleScaler = 1,
+			.targets = _goertzelSweep,
+			.targetCount = size
+		};
+	return goertzel_init(_goertzelConfig, BENCH_SAMPLE_RATE) == GOERTZEL_OK
+	       ? BENCH_GOERTZEL_BLOCK : 0;
+}
+
+static void runGoertzelBlock(void) {
+	_result = goertzel_update(_audio, BENCH_GOERTZEL_BLOCK);
+}
+
+/** Template matcher, with the checked in templates over size frames at the
+ * settings they were made with */
+static uint32_t setupMatch(int size) {
+	struct MatchConfig config = {
+			.bands = MATCH_TEMPLATE_BANDS,
+			.freqLower = MATCH_TEMPLATE_FREQ_LOWER,
+			.freqUpper = MATCH_TEMPLATE_FREQ_UPPER,
+			.minScore = INT16_MAX,
+			.templates = matchTemplateSet,
+			.templateCount = MATCH_TEMPLATE_COUNT
+		};
+
+	if (setupAnalysis(MATCH_TEMPLATE_FFT_SIZE) == 0
+	    || templateMatcher_init(config, _anlysConfig, BENCH_SAMPLE_RATE, size)
+	       != MATCH_OK) {
+		return 0;
+	}
+	_matchSamples = size * MATCH_TEMPLATE_FFT_SIZE * MATCH_TEMPLATE_DECIMATION;
+	return _matchSamples;
+}
+
+static void runMatch(void) {
+	_result = matchTemplates(_audio, _matchSamples, _anlysConfig, _matchResults);
+}
+
+static void teardownMatch(void) {
+	templateMatcher_deinit();
+	audioAnalysis_deinit();
+}
+
+/** Spectrum of the first frame of the test signal, for the benchmarks of what
+ * is computed from a frame's spectrum */
+static uint32_t setupFrameSpectrum(int size) {
+	if (setupAnalysis(size) == 0 || audioAnalysis_startSegment(_anlysConfig) == 0
+	    || !analyzeFrame(_audio, &_frameSpectrum)) {
+		return 0;
+	}
+	return size;
+}
+
+/** Spectral shape of one frame's spectrum over 1 to 8 kHz, as the gates use
+ * it */
+static uint32_t setupShape(int size) {
+	_size = size;
+	_shapeLower = 1000 * size / BENCH_SAMPLE_RATE;
+	_shapeUpper = 8000 * size / BENCH_SAMPLE_RATE;
+	return setupFrameSpectrum(size);
+}
+
+static void runShape(void) {
+	spectralShape_frame(&_frameSpectrum, _shapeLower, _shapeUpper,
+	                    BENCH_SAMPLE_RATE, _size, &_shape);
+	_result = _shape.entropy != 0;
+}
+
+/** Acoustic indices, one frame's spectrum added to the interval, with the
+ * events mode's settings */
+static uint32_t setupIndices(int size) {
+	struct IndicesConfig config = {
+			.aciStepSeconds = 5,
+			.biLower = 2000,
+			.biUpper = 8000,
+			.anthroLower = 1000,
+			.anthroUpper = 2000,
+			.bioLower = 2000,
+			.bioUpper = 8000,
+			.adiBandWidth = 1000,
+			.adiThreshold = -50
+		};
+
+	if (setupFrameSpectrum(size) == 0
+	    || acousticIndices_init(config, BENCH_SAMPLE_RATE, size, size/2 + 1)
+	       != INDICES_OK) {
+		return 0;
+	}
+	return size;
+}
+
+static void runIndices(void) {
+	acousticIndices_frame(&_frameSpectrum);
+}
+
+static void teardownIndices(void) {
+	acousticIndices_deinit();
+	audioAnalysis_deinit();
+}
+
+/** Mel features of one frame's spectrum, log mel energies or MFCCs, with 32
+ * bands from 1 to 9 kHz. The spectrum is found once, only the features are
+ * timed */
+static uint32_t setupMel(int size, int cepstra) {
+	struct MelConfig config = {
+			.bands = 32,
+			.cepstra = cepstra,
+			.freqLower = 1000,
+			.freqUpper = 9000
+		};
+
+	if (setupFrameSpectrum(size) == 0
+	    || melFeatures_init(config, _anlysConfig, BENCH_SAMPLE_RATE) != MEL_OK) {
+		return 0;
+	}
+	return size;
+}
+
+static uint32_t setupMelEnergies(int size) {
+	return setupMel(size, 0);
+}
+
+static uint32_t setupMfcc(int size) {
+	return setupMel(size, 13);
+}
+
+static void runMel(void) {
+	melFeatures_frame(&_frameSpectrum, _features);
+	_result = _features[0] != 0;
+}
+
+static void teardownMel(void) {
+	melFeatures_deinit();
+	audioAnalysis_deinit();
+}
+
+/** Classifier, the checked in model over 26 band, 13 MFCC features. One
+ * inference covers a frame of the segment as classifySegment runs it */
+static uint32_t setupClassifier(int size) {
+	struct MelConfig config = {
+			.bands = 26,
+			.cepstra = 13,
+			.freqLower = 1000,
+			.freqUpper = 9000
+		};
+
+	if (setupAnalysis(size) == 0
+	    || melFeatures_init(config, _anlysConfig, BENCH_SAMPLE_RATE) != MEL_OK
+	    || nnClassifier_init(nnModel) != NN_OK
+	    || nnClassifier_inputLength() > BENCH_MAX_FFT) {
+		return 0;
+	}
+	for (int index=0; index<nnClassifier_inputLength(); index++) {
+		_nnInput[index] = _audio[index];
+	}
+	return size;
+}
+
+static uint32_t setupClassifySegment(int size) {
+	return setupClassifier(size) != 0 ? BENCH_SEGMENT : 0;
+}
+
+static void runInference(void) {
+	_result = nnClassifier_run(_nnInput)[0] != 0;
+}
+
+static void runClassifySegment(void) {
+	_result = nnClassifier_classifySegment(_audio, BENCH_SEGMENT, _anlysConfig,
+	                                       _nnScores) == 0;
+}
+
+static void teardownClassifier(void) {
+	nnClassifier_deinit();
+	melFeatures_deinit();
+	audioAnalysis_deinit();
+}
+
+/** Level meter, one block */
+static uint32_t setupLevel(int size) {
+	struct LevelConfig config = {.calibration = 0};
+
+	_size = size;
+	return levelMeter_init(config, BENCH_SAMPLE_RATE) == LEVEL_OK ? size : 0;
+}
+
+static void runLevel(void) {
+	levelMeter_block(_audio, _size);
+}
+
+/** Pitch tracker, one frame of size samples */
+static uint32_t setupPitch(int size) {
+	struct PitchConfig config = {
+			.windowSize = size,
+			.minFreq = 1000,
+			.maxFreq = 8000,
+			.threshold = 4915
+		};
+
+	return pitchTracker_init(config, BENCH_SAMPLE_RATE) == PITCH_OK ? size : 0;
+}
+
+static void runPitch(void) {
+	pitchTracker_frame(_audio, &_pitch);
+}
+
+/** Benchmarks, in the order they run */
+static const struct Benchmark _benchmarks[] = {
+		{"rfft_q15", _fftSizes, setupRfftQ15, runRfftQ15, NULL},
+		{"cmplx_mag_q15", _fftSizes, setupCmplxMag, runCmplxMag, NULL},
+		{"rfft_mag_q15", _fftSizes, setupRfftQ15, runRfftMagQ15, NULL},
+		{"fft_kernel", _fftSizes, setupKernel, runKernel, NULL},
+		{"rfft_mag_f32", _fftSizes, setupRfftF32, runRfftF32, NULL},
+		{"biquad_df1_q31", _blockSizes, setupBiquad, runBiquad, NULL},
+		{"biquad_df1_fast_q31", _blockSizes, setupBiquad, runBiquadFast, NULL},
+		{"decimator_2", _blockSizes, setupDecimator2, runDecimator, teardownDecimator},
+		{"decimator_3", _blockSizes, setupDecimator3, runDecimator, teardownDecimator},
+		{"decimator_4", _blockSizes, setupDecimator4, runDecimator, teardownDecimator},
+		{"analyze_audio", _segmentFftSizes, setupAnalysis, runAnalyzeAudio,
+		 teardownAnalysis},
+		{"analyze_onsets", _segmentFftSizes, setupOnsets, runAnalyzeAudio,
+		 teardownAnalysis},
+		{"analyze_event", _segmentFftSizes, setupAnalysis, runAnalyzeEvent,
+		 teardownAnalysis},
+		{"sample_pack", _blockSizes, setupPack, runPack, NULL},
+		{"sample_unpack", _blockSizes, setupPack, runUnpack, NULL},
+		{"goertzel", _blockSizes, setupGoertzel, runGoertzel, NULL},
+		{"goertzel_targets", _goertzelCounts, setupGoertzelTargets, runGoertzelBlock,
+		 NULL},
+		{"match_templates", _matchFrames, setupMatch, runMatch, teardownMatch},
+		{"nn_inference", _inferenceSizes, setupClassifier, runInference,
+		 teardownClassifier},
+		{"nn_classify_segment", _segmentFftSizes, setupClassifySegment,
+		 runClassifySegment, teardownClassifier},
+		{"level_meter", _levelBlocks, setupLevel, runLevel, NULL},
+		{"pitch_frame", _pitchWindows, setupPitch, runPitch, NULL},
+		{"spectral_shape_frame", _segmentFftSizes, setupShape, runShape,
+		 teardownAnalysis},
+		{"acoustic_indices_frame", _segmentFftSizes, setupIndices, runIndices,
+		 teardownIndices},
+		{"mel_frame", _segmentFftSizes, setupMelEnergies, runMel, teardownMel},
+		{"mfcc_frame", _segmentFftSizes, setupMfcc, runMel, teardownMel}
+	};
+
+/** @brief Host monotonic time, in ns.
+ */
+static uint64_t nowNs(void) {
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t) now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+/** @brief Time a batch of calls.
+ *
+ * @return ns the batch took.
+ */
+static uint64_t timeBatch(void (*run)(void), uint32_t calls) {
+	uint64_t start = nowNs();
+
+	for (uint32_t call=0; call<calls; call++) {
+		run();
+	}
+
+	return nowNs() - start;
+}
+
+static int compareDoubles(const void *a, const void *b) {
+	double difference = *(const double*) a - *(const double*) b;
+
+	return (difference > 0) - (difference < 0);
+}
+
+/** @brief Run one size of a benchmark and print its line.
+ */
+static void measure(const struct Benchmark *benchmark, int size, int runs,
+                    uint64_t batchNs) {
+	static double times[BENCH_MAX_RUNS];
+	uint32_t samples = benchmark->setup(size);
+	uint32_t calls = 1;
+	double sum = 0.0, squares = 0.0, mean, median;
+
+	if (samples == 0) {
+		return;
+	}
+
+	// grow the batch until it is long enough to time, which also warms up
+	while (timeBatch(benchmark->run, calls) < batchNs && calls < (1u << 30)) {
+		calls *= 2;
+	}
+
+	for (int run=0; run<runs; run++) {
+		times[run] = (double) timeBatch(benchmark->run, calls) / calls;
+		sum += times[run];
+	}
+	qsort(times, runs, sizeof(double), compareDoubles);
+
+	mean = sum / runs;
+	for (int run=0; run<runs; run++) {
+		squares += (times[run] - mean) * (times[run] - mean);
+	}
+	median = runs % 2 ? times[runs/2] : (times[runs/2 - 1] + times[runs/2]) / 2;
+
+	printf("%s,%d,%u,%u,%d,%.1f,%.1f,%.1f,%.1f,%.3f\n", benchmark->name, size,
+	       samples, calls, runs, times[0], median, mean,
+	       runs > 1 ? sqrt(squares / (runs - 1)) : 0.0, median / samples);
+	fflush(stdout);
+
+	if (benchmark->teardown != NULL) {
+		benchmark->teardown();
+	}
+}
+
+/** @brief If a benchmark passes the filters given on the command line.
+ */
+static bool selected(const char *name, char **filters, int count) {
+	for (int index=0; index<count; index++) {
+		if (strstr(name, filters[index]) != NULL) {
+			return true;
+		}
+	}
+
+	return count == 0;
+}
+
+int main(int argc, char **argv) {
+	int runs = 15;
+	double batchMs = 5.0;
+	bool list = false;
+	int option;
+	cpu_set_t cpus;
+
+	while ((option = getopt(argc, argv, "r:t:l")) != -1) {
+		switch (option) {
+			case 'r':
+				runs = atoi(optarg);
+				break;
+			case 't':
+				batchMs = atof(optarg);
+				break;
+			case 'l':
+				list = true;
+				break;
+			default:
+				fprintf(stderr, "usage: %s [-r runs] [-t ms] [-l] [filter...]\n",
+				        argv[0]);
+				return 1;
+		}
+	}
+	if (runs < 1 || runs > BENCH_MAX_RUNS || batchMs <= 0.0) {
+		fprintf(stderr, "%s: runs must be 1 to %d and ms over 0\n", argv[0],
+		        BENCH_MAX_RUNS);
+		return 1;
+	}
+
+	// stay on one CPU, so the caches and the clock stay the same
+	CPU_ZERO(&cpus);
+	CPU_SET(sched_getcpu(), &cpus);
+	sched_setaffinity(0, sizeof(cpus), &cpus);
+
+	makeAudio();
+	if (!list) {
+		printf("benchmark,size,samples,calls,runs,min_ns,median_ns,mean_ns,"
+		       "stddev_ns,ns_per_sample\n");
+	}
+
+	for (int index=0; index<sizeof(_benchmarks)/sizeof(_benchmarks[0]); index++) {
+		const struct Benchmark *benchmark = &_benchmarks[index];
+
+		if (!selected(benchmark->name, &argv[optind], argc - optind)) {
+			continue;
+		}
+		for (const int *size = benchmark->sizes; *size != 0; size++) {
+			if (list) {
+				printf("%s %d\n", benchmark->name, *size);
+				continue;
+			}
+			measure(benchmark, *size, runs, (uint64_t) (batchMs * 1e6));
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,1205 @@
+/** @file check_main.c
+ * @brief Host checks of the analysis against float64 references, the tables
+ * the analysis changes were judged by.
+ *
+ * Runs the Audio Analysis modules, built from the same sources as the
+ * firmware, on synthetic signals whose answer is known. Every signal comes
+ * from a fixed seed, so a run gives the same table each time on any host.
+ * The FFT backend checked is the one built in, make check FFT=cmsis or
+ * FFT=f32 checks the others. Output is CSV on stdout, one table per check:
+ *
+ * 	spectrum	Each frame's magnitude spectrum against a float64 DFT of the same
+ * 				frame, two tones and noise at levels from 4 to 16384 counts.
+ * 				The peak error is of the louder tone. SNR is over the whole
+ * 				spectrum, for the analysis path, for the CMSIS q15 path with
+ * 				the same block exponent, and for the fixed gain of
+ * 				sampleScaler the analysis used before block exponents.
+ * 	detect	A 3-5 kHz chirp in uniform noise, amplitude swept from 1 to 16
+ * 				counts, 20 trials each: segments detected by
+ * 				analyzeAudioEvent, the onset error, and false alarms of
+ * 				analyzeAudio on the noise alone.
+ * 	onset		Ten 4 s scenes of five 150 ms 2.5-5.5 kHz sweeps over noise at
+ * 				sigma 30: onsets found within 30 ms of a sweep, extra ones,
+ * 				and the segments each trigger flags. A scene of hum alone
+ * 				comes last.
+ * 	pitch		Tones and harmonic tones from 1 to 7 kHz at three noise levels:
+ * 				the worst f0 error, gross errors (off by more than 30%) and
+ * 				unvoiced frames, and the mean confidence. White noise comes last.
+ * 	indices	60 s soundscapes of chirps, a 1.5 kHz hum at -30 dBFS and
+ * 				white noise, with the events mode's settings, added by
+ * 				analyzeAudioEvent: ACI, BI, NDSI and ADI against the same
+ * 				definitions on a float64 DFT of each frame. Fails if ACI is
+ * 				off by more than 1.6%, BI by more than 1%, or NDSI or ADI by
+ * 				0.0005 or more. ADI counts cells against a hard threshold, so
+ * 				a signal with leakage right at adiThreshold can differ more.
+ * 	level		A-weighted Leq of -20 dBFS tones at the third octave centers
+ * 				from 31.5 Hz to 8 kHz, read from the second 1 s interval,
+ * 				against the standard A curve. Fails if any tone reads more
+ * 				than 0.25 dB off, the accuracy level_meter.h gives.
+ * 	mel			Log mel energies and MFCCs, 32 bands from 1 to 9 kHz at fftSize
+ * 				256, against the same filterbank and DCT in float64 on a
+ * 				float64 DFT, for a tone in noise at levels from 64 to 16384
+ * 				counts. Fails if the log mel energies are off by more than
+ * 				0.14 dB on average or the MFCC SNR is under 40 dB (generated
+ * 				kernels), or 0.03 dB and 53 dB (f32). The CMSIS backend is
+ * 				not suitable for features and fails, see mel_features.h.
+ * 	gates		Ten 1 s segments each of chirps, warbles, white noise rain,
+ * 				low-passed wind gusts and pulsed insect noise, 1-8 kHz band:
+ * 				the flatness and entropy of each frame (of the calls, only
+ * 				frames within a call), and segments analyzeAudio flags with
+ * 				the gates off and at maxEntropy 0.80 and maxFlatness 0.10.
+ * 				Fails unless every segment passes the level threshold, the
+ * 				gates keep every call segment and reject every noise one, call
+ * 				flatness stays under 0.08, and the flatness of rain and insects
+ * 				stays over 0.30 and of wind over 0.15.
+ * 	nn			The classifier's scores for each row of nn_inputs.csv against
+ * 				nn_scores.csv, the scores nn_convert.py --reference gives for
+ * 				the model in Modules/Classifier. Fails unless every score is
+ * 				bit-exact. Both files are read from the working directory.
+ *
+ * A check that fails prints why on stderr and bivo_check exits with 1.
+ *
+ * Usage: bivo_check [-n fftSize] check...
+ * 	-n	FFT size of the spectrum check, 256 by default.
+ * 	check	spectrum, detect, onset, pitch, indices, level, mel, gates or
+ * 				nn.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include "arm_math.h"
+#include "audio_analysis.h"
+#include "pitch_tracker.h"
+#include "spectral_shape.h"
+#include "mel_features.h"
+#include "acoustic_indices.h"
+#include "level_meter.h"
+#include "nn_classifier.h"
+#include "nn_model.h"
+
+#define CHECK_SAMPLE_RATE 19900			// rate of the standard configuration
+#define CHECK_MAX_FFT 1024
+#define CHECK_SCENE (4 * CHECK_SAMPLE_RATE)
+#define CHECK_SCALER 50							// sampleScaler of the standard configuration
+#define CHECK_SOUNDSCAPE 60					// seconds of each indices soundscape
+#define CHECK_NN_INPUTS "nn_inputs.csv"
+#define CHECK_NN_SCORES "nn_scores.csv"
+#define CHECK_NN_MAX_VALUES 256			// longest row of either file
+
+/** Signals, and the scratch of the reference paths */
+static int16_t _audio[CHECK_SCENE];
+static q15_t _frame[CHECK_MAX_FFT];
+static q15_t _spectrum[2 * CHECK_MAX_FFT];
+static q15_t _magnitude[CHECK_MAX_FFT/2 + 1];
+static double _reference[CHECK_MAX_FFT/2 + 1];
+static double _cosine[CHECK_MAX_FFT];
+static double _sine[CHECK_MAX_FFT];
+static int _twiddleSize = 0;
+
+/** Noise generator, the same sequence on every host */
+static uint32_t _seed;
+
+static double uniform(void) {
+	_seed = _seed * 1664525 + 1013904223;
+	return (_seed >> 8) / 16777216.0 - 0.5;
+}
+
+static double gauss(void) {
+	double u = uniform() + 0.5 + 1e-9;
+	double v = uniform() + 0.5;
+
+	return sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v);
+}
+
+static int16_t saturate(double value) {
+	value = round(value);
+	return (int16_t) (value > 32767.0 ? 32767.0 : value < -32768.0 ? -32768.0 : value);
+}
+
+/** @brief Magnitudes of the float64 DFT of a frame, on the scale of
+ * arm_rfft_q15 and arm_cmplx_mag_q15, |X| / (2 * size).
+ */
+static void referenceSpectrum(const int16_t *frame, int size) {
+	if (size != _twiddleSize) {
+		for (int index=0; index<size; index++) {
+			_cosine[index] = cos(2.0 * M_PI * index / size);
+			_sine[index] = sin(2.0 * M_PI * index / size);
+		}
+		_twiddleSize = size;
+	}
+
+	for (int bin=0; bin<=size/2; bin++) {
+		double re = 0.0, im = 0.0;
+
+		for (int index=0; index<size; index++) {
+			re += frame[index] * _cosine[(bin * index) % size];
+			im -= frame[index] * _sine[(bin * index) % size];
+		}
+		_reference[bin] = sqrt(re * re + im * im) / (2.0 * size);
+	}
+}
+
+/** @brief The CMSIS q15 path on a frame, normalized with the largest block
+ * exponent that fits as the analysis does.
+ *
+ * @return The block exponent.
+ */
+static int cmsisSpectrum(const int16_t *frame, arm_rfft_instance_q15 *rfft,
+                         int size) {
+	int peak = 0, shift = 0;
+
+	for (int index=0; index<size; index++) {
+		peak = abs(frame[index]) > peak ? abs(frame[index]) : peak;
+	}
+	while (shift < 15 && peak > 0 && (peak << (shift + 1)) <= 32767) {
+		shift++;
+	}
+	for (int index=0; index<size; index++) {
+		_frame[index] = frame[index] << shift;
+	}
+	arm_rfft_q15(rfft, _frame, _spectrum);
+	arm_cmplx_mag_q15(_spectrum, _magnitude, size/2 + 1);
+
+	return shift;
+}
+
+/** @brief The fixed gain the analysis used before block exponents: samples
+ * multiplied by sampleScaler, wrapping past the q15 range.
+ */
+static void fixedGainSpectrum(const int16_t *frame, arm_rfft_instance_q15 *rfft,
+                              int size) {
+	for (int index=0; index<size; index++) {
+		_frame[index] = (q15_t) (frame[index] * CHECK_SCALER);
+	}
+	arm_rfft_q15(rfft, _frame, _spectrum);
+	arm_cmplx_mag_q15(_spectrum, _magnitude, size/2 + 1);
+}
+
+/** @brief Accumulate the error of a spectrum against the reference.
+ */
+static void addError(const q15_t *magnitude, double scale, int bins,
+                     double *signal, double *error) {
+	for (int bin=0; bin<bins; bin++) {
+		double difference = magnitude[bin] / scale - _reference[bin];
+
+		*signal += _reference[bin] * _reference[bin];
+		*error += difference * difference;
+	}
+}
+
+/** @brief Spectrum accuracy at each level, see the file comment.
+ */
+static void checkSpectrum(int size) {
+	struct AnlysConfig config = {
+			.fftSize = size, .sampleScaler = CHECK_SCALER, .powerThreshold = 20,
+			.freqLower = 0, .freqUpper = 9950, .decimation = 1
+		};
+	struct AnlysSpectrum spectrum;
+	arm_rfft_instance_q15 rfft;
+	int16_t frame[CHECK_MAX_FFT];
+	double toneBin = size * 37.3 / 256;
+
+	if (audioAnalysis_init(config, CHECK_SAMPLE_RATE) != ANLYS_OK
+	    || audioAnalysis_startSegment(config) != size
+	    || arm_rfft_init_q15(&rfft, size, 0, 1) != ARM_MATH_SUCCESS) {
+		fprintf(stderr, "spectrum: no analysis at fftSize %d\n", size);
+		return;
+	}
+
+	printf("backend,fft_size,amplitude,peak_error_pct,snr_db,cmsis_snr_db,"
+	       "fixed_gain_snr_db\n");
+	_seed = 1;
+	for (int amplitude=4; amplitude<=16384; amplitude*=2) {
+		double signal = 0.0, error = 0.0, cmsisError = 0.0, fixedError = 0.0;
+		double unused = 0.0, worstPeak = 0.0;
+
+		for (int trial=0; trial<10; trial++) {
+			for (int index=0; index<size; index++) {
+				frame[index] = saturate(amplitude
+				    * (0.7 * sin(2.0 * M_PI * (toneBin + trial) * index / size)
+				       + 0.2 * sin(2.0 * M_PI * size * 90.1 / 256 * index / size)
+				       + 0.2 * uniform()));
+			}
+			referenceSpectrum(frame, size);
+
+			analyzeFrame(frame, &spectrum);
+			addError(spectrum.magnitude, ldexp(1.0, spectrum.shift), spectrum.bins,
+			         &signal, &error);
+
+			// the louder tone's peak, within a few bins of it
+			double peak = 0.0, referencePeak = 0.0;
+			for (int bin=(int) toneBin + trial - 3; bin<=(int) toneBin + trial + 4; bin++) {
+				peak = fmax(peak, spectrum.magnitude[bin] / ldexp(1.0, spectrum.shift));
+				referencePeak = fmax(referencePeak, _reference[bin]);
+			}
+			worstPeak = fmax(worstPeak, fabs(peak - referencePeak) / referencePeak);
+
+			int shift = cmsisSpectrum(frame, &rfft, size);
+			addError(_magnitude, ldexp(1.0, shift), size/2 + 1, &unused, &cmsisError);
+			fixedGainSpectrum(frame, &rfft, size);
+			addError(_magnitude, CHECK_SCALER, size/2 + 1, &unused, &fixedError);
+		}
+
+		printf("%d,%d,%d,%.2f,%.1f,%.1f,%.1f\n", ANLYS_FFT_BACKEND, size, amplitude,
+		       100.0 * worstPeak, 10.0 * log10(signal / error),
+		       10.0 * log10(signal / cmsisError), 10.0 * log10(signal / fixedError));
+	}
+	audioAnalysis_deinit();
+}
+
+/** @brief One second of a chirp from 3 to 5 kHz, 0.3 s to 0.5 s in, over
+ * uniform noise of the given width.
+ */
+static void makeChirp(double amplitude, double noise) {
+	for (int index=0; index<CHECK_SAMPLE_RATE; index++) {
+		double t = (double) index / CHECK_SAMPLE_RATE;
+		double value = 0.0;
+
+		if (t > 0.3 && t < 0.5) {
+			value = amplitude * sin(2.0 * M_PI * (3000.0 * t + 5000.0 * (t - 0.3) * (t - 0.3)))
+			        * sin(M_PI * (t - 0.3) / 0.2);
+		}
+		_audio[index] = saturate(value + noise * uniform());
+	}
+}
+
+/** @brief Detection of a faint chirp, see the file comment.
+ */
+static void checkDetect(void) {
+	struct AnlysConfig config = {
+			.fftSize = 256, .sampleScaler = CHECK_SCALER, .powerThreshold = 60,
+			.freqLower = 2000, .freqUpper = 6000, .decimation = 1
+		};
+	struct AnlysEvent event;
+	const int trials = 20;
+
+	printf("backend,amplitude,trials,detected,mean_onset_error_samples,"
+	       "false_alarms\n");
+	_seed = 3;
+	for (double amplitude=1.0; amplitude<=16.01; amplitude*=M_SQRT2) {
+		int detected = 0, falseAlarms = 0;
+		long onsetError = 0;
+
+		for (int trial=0; trial<trials; trial++) {
+			makeChirp(amplitude, 24.0);
+			if (analyzeAudioEvent(_audio, CHECK_SAMPLE_RATE, CHECK_SAMPLE_RATE, config,
+			                      &event)) {
+				detected++;
+				onsetError += labs((long) event.onsetSample - (long) (0.3 * CHECK_SAMPLE_RATE));
+			}
+			makeChirp(0.0, 24.0);
+			falseAlarms += analyzeAudio(_audio, CHECK_SAMPLE_RATE, CHECK_SAMPLE_RATE, config);
+		}
+
+		printf("%d,%.1f,%d,%d,%ld,%d\n", ANLYS_FFT_BACKEND, amplitude, trials,
+		       detected, detected > 0 ? onsetError / detected : 0, falseAlarms);
+	}
+	audioAnalysis_deinit();
+}
+
+/** Starts of the sweeps of an onset scene, in s */
+static const double _calls[] = {0.5, 1.3, 2.1, 2.9, 3.5};
+#define CHECK_CALLS (sizeof(_calls) / sizeof(_calls[0]))
+
+/** @brief A scene of sweeps over noise, and hum at 4.2 kHz.
+ */
+static void makeScene(double amplitude, double hum, uint32_t seed) {
+	_seed = seed;
+	for (int index=0; index<CHECK_SCENE; index++) {
+		double t = (double) index / CHECK_SAMPLE_RATE;
+		double value = 30.0 * gauss() + hum * sin(2.0 * M_PI * 4200.0 * t);
+
+		for (int call=0; call<CHECK_CALLS; call++) {
+			double u = t - _calls[call];
+
+			if (u >= 0.0 && u < 0.15) {
+				value += amplitude * sin(2.0 * M_PI * (2500.0 * u + 1500.0 * u * u / 0.15))
+				         * fmin(1.0, fmin(u / 0.005, (0.15 - u) / 0.005));
+			}
+		}
+		_audio[index] = saturate(value);
+	}
+}
+
+/** @brief Onsets and trigger verdicts, see the file comment.
+ */
+static void checkOnset(void) {
+	static const double amplitudes[] = {4000, 1000, 250, 100, 0};
+	static const double hums[] = {0, 3000, 0, 0, 3000};
+	struct AnlysConfig config = {
+			.fftSize = 256, .sampleScaler = CHECK_SCALER, .powerThreshold = 2000,
+			.freqLower = 1000, .freqUpper = 8000, .decimation = 1,
+			.onsetMargin = 1024
+		};
+	uint32_t onsets[64];
+
+	printf("amplitude,hum,onsets_found,calls,extra_onsets,mean_error_ms,"
+	       "level_segments,onset_segments,combined_segments,scenes\n");
+	for (int row=0; row<sizeof(amplitudes)/sizeof(amplitudes[0]); row++) {
+		int found = 0, extra = 0, verdicts[3] = {0, 0, 0};
+		double error = 0.0;
+
+		for (int scene=0; scene<10; scene++) {
+			makeScene(amplitudes[row], hums[row], 100 * row + scene + 1);
+
+			uint32_t count = analyzeAudioOnsets(_audio, CHECK_SCENE, CHECK_SAMPLE_RATE,
+			                                    config, onsets, 64);
+			for (uint32_t onset=0; onset<count; onset++) {
+				double t = (double) onsets[onset] / CHECK_SAMPLE_RATE;
+				bool matched = false;
+
+				for (int call=0; call<CHECK_CALLS; call++) {
+					if (amplitudes[row] > 0.0 && fabs(t - _calls[call]) < 0.03) {
+						matched = true;
+						error += fabs(t - _calls[call]);
+					}
+				}
+				found += matched;
+				extra += !matched;
+			}
+
+			for (int trigger=0; trigger<3; trigger++) {
+				config.trigger = trigger;
+				verdicts[trigger] += analyzeAudio(_audio, CHECK_SCENE, CHECK_SAMPLE_RATE,
+				                                  config);
+			}
+			config.trigger = ANLYS_TRIGGER_LEVEL;
+		}
+
+		printf("%.0f,%.0f,%d,%d,%d,%.1f,%d,%d,%d,10\n", amplitudes[row], hums[row],
+		       found, amplitudes[row] > 0.0 ? 10 * (int) CHECK_CALLS : 0, extra,
+		       found > 0 ? 1000.0 * error / found : 0.0,
+		       verdicts[ANLYS_TRIGGER_LEVEL], verdicts[ANLYS_TRIGGER_ONSET],
+		       verdicts[ANLYS_TRIGGER_COMBINED]);
+	}
+	audioAnalysis_deinit();
+}
+
+/** @brief f0 accuracy of the pitch tracker, see the file comment.
+ */
+static void checkPitch(void) {
+	struct PitchConfig config = {
+			.windowSize = 256, .minFreq = 1000, .maxFreq = 8000,
+			.threshold = 4915		// 0.15
+		};
+	struct PitchEstimate estimate;
+	uint32_t length;
+	int voiced = 0;
+	double confidence = 0.0;
+
+	if (pitchTracker_init(config, CHECK_SAMPLE_RATE) != PITCH_OK) {
+		fprintf(stderr, "pitch: bad configuration\n");
+		return;
+	}
+	length = pitchTracker_frameLength();
+
+	printf("signal,snr_db,frames,worst_error_pct,gross_errors,unvoiced,"
+	       "mean_confidence\n");
+	for (int harmonics=0; harmonics<2; harmonics++) {
+		for (double noise=0.0; noise<=1000.0; noise+=500.0) {
+			int frames = 0, gross = 0, unvoiced = 0;
+			double worst = 0.0, power = 0.0;
+
+			confidence = 0.0;
+			_seed = 7;
+			for (double f0=1000.0; f0<=7000.0; f0+=37.0, frames++) {
+				double phase = 6.0 * (uniform() + 0.5);
+
+				power = 0.0;
+				for (int index=0; index<length; index++) {
+					double w = 2.0 * M_PI * f0 * index / CHECK_SAMPLE_RATE + phase;
+					double value = 3000.0 * sin(w);
+
+					if (harmonics && 2.0 * f0 < CHECK_SAMPLE_RATE / 2) {
+						value += 1500.0 * sin(2.0 * w);
+					}
+					if (harmonics && 3.0 * f0 < CHECK_SAMPLE_RATE / 2) {
+						value += 800.0 * sin(3.0 * w);
+					}
+					power += value * value;
+					_audio[index] = saturate(value + noise * gauss());
+				}
+				power /= length;
+
+				pitchTracker_frame(_audio, &estimate);
+				double error = fabs(estimate.f0 - f0) / f0;
+				unvoiced += !estimate.voiced;
+				confidence += estimate.confidence / 32768.0;
+				if (error > 0.3) {
+					gross++;
+				}
+				else if (error > worst) {
+					worst = error;
+				}
+			}
+
+			printf("%s,%.1f,%d,%.2f,%d,%d,%.3f\n", harmonics ? "harmonic" : "tone",
+			       noise > 0.0 ? 10.0 * log10(power / (noise * noise)) : INFINITY,
+			       frames, 100.0 * worst, gross, unvoiced, confidence / frames);
+		}
+	}
+
+	// white noise should not be voiced
+	_seed = 11;
+	confidence = 0.0;
+	for (int frame=0; frame<200; frame++) {
+		for (int index=0; index<length; index++) {
+			_audio[index] = saturate(3000.0 * gauss());
+		}
+		pitchTracker_frame(_audio, &estimate);
+		voiced += estimate.voiced;
+		confidence += estimate.confidence / 32768.0;
+	}
+	printf("noise,,200,,,%d,%.3f\n", 200 - voiced, confidence / 200);
+}
+
+/** @brief Log2 mel energies of the float64 reference spectrum, with the
+ * filterbank melFeatures_init builds computed in float64.
+ */
+static void referenceMel(struct MelConfig config, int size, double *logMel) {
+	double edges[MEL_MAX_BANDS + 2];
+	double melLower = 2595.0 * log10(1.0 + config.freqLower / 700.0);
+	double melUpper = 2595.0 * log10(1.0 + config.freqUpper / 700.0);
+
+	for (int i=0; i<config.bands+2; i++) {
+		double mel = melLower + (melUpper - melLower) * i / (config.bands + 1);
+		edges[i] = 700.0 * (pow(10.0, mel / 2595.0) - 1.0) * size / CHECK_SAMPLE_RATE;
+	}
+
+	for (int band=0; band<config.bands; band++) {
+		double left = edges[band], center = edges[band + 1], right = edges[band + 2];
+		double energy = 0.0;
+		int covered = 0;
+
+		for (int bin=(int) ceil(left); bin<=(int) floor(right) && bin<=size/2; bin++) {
+			double weight = bin <= center ? (bin - left) / (center - left)
+			                              : (right - bin) / (right - center);
+			if (weight > 0.0) {
+				energy += weight * _reference[bin] * _reference[bin];
+				covered++;
+			}
+		}
+		if (covered == 0) {
+			int bin = (int) (center + 0.5) < size/2 ? (int) (center + 0.5) : size/2;
+			energy = _reference[bin] * _reference[bin];
+		}
+		logMel[band] = log2(energy);
+	}
+}
+
+/** @brief Mel and MFCC accuracy, see the file comment.
+ *
+ * @return true if the mean log mel error and the MFCC SNR meet the built in
+ * backend's bounds.
+ */
+static bool checkMel(void) {
+#if ANLYS_FFT_BACKEND == ANLYS_FFT_F32
+	const double maxErrorDb = 0.03, minSnrDb = 53.0;
+#else
+	const double maxErrorDb = 0.14, minSnrDb = 40.0;
+#endif
+	struct AnlysConfig config = {
+			.fftSize = 256, .sampleScaler = CHECK_SCALER, .powerThreshold = 20,
+			.freqLower = 1000, .freqUpper = 9000, .decimation = 1
+		};
+	struct MelConfig melConfig = {
+			.bands = 32, .cepstra = 0, .freqLower = 1000, .freqUpper = 9000
+		};
+	struct AnlysSpectrum spectrum;
+	q15_t features[MEL_MAX_BANDS];
+	double logMel[MEL_MAX_BANDS];
+	int16_t frame[256];
+	double totalError = 0.0, signal = 0.0, error = 0.0;
+	int values = 0;
+	bool passed;
+
+	printf("backend,amplitude,frames,mean_log_mel_error_db,"
+	       "worst_log_mel_error_db,mfcc_snr_db\n");
+	for (int amplitude=64; amplitude<=16384; amplitude*=4) {
+		double levelError = 0.0, worstError = 0.0;
+		double levelSignal = 0.0, levelNoise = 0.0;
+
+		for (int cepstra=0; cepstra<=13; cepstra+=13) {
+			melConfig.cepstra = cepstra;
+			if (audioAnalysis_init(config, CHECK_SAMPLE_RATE) != ANLYS_OK
+			    || melFeatures_init(melConfig, config, CHECK_SAMPLE_RATE) != MEL_OK) {
+				fprintf(stderr, "mel: bad configuration\n");
+				melFeatures_deinit();
+				audioAnalysis_deinit();
+				return false;
+			}
+
+			// the same frames for the log energies and the cepstra
+			_seed = amplitude;
+			for (int trial=0; trial<20; trial++) {
+				double tone = 1500.0 + 300.0 * trial;
+
+				for (int index=0; index<256; index++) {
+					frame[index] = saturate(amplitude
+					    * (0.5 * sin(2.0 * M_PI * tone * index / CHECK_SAMPLE_RATE)
+					       + 0.25 * gauss()));
+				}
+				referenceSpectrum(frame, 256);
+				referenceMel(melConfig, 256, logMel);
+
+				analyzeFrame(frame, &spectrum);
+				melFeatures_frame(&spectrum, features);
+
+				for (int j=0; j<melFeatures_length(); j++) {
+					double expected = logMel[j];
+
+					if (cepstra > 0) {
+						expected = 0.0;
+						for (int band=0; band<melConfig.bands; band++) {
+							expected += logMel[band] * sqrt((j == 0 ? 1.0 : 2.0) / melConfig.bands)
+							            * cos(M_PI * j * (band + 0.5) / melConfig.bands);
+						}
+						levelSignal += expected * expected;
+						levelNoise += pow(features[j] / 256.0 - expected, 2.0);
+					}
+					else {
+						// log2 of power, 10 log10(2) dB an octave
+						double difference = fabs(features[j] / 256.0 - expected) * 3.0103;
+
+						levelError += difference;
+						worstError = fmax(worstError, difference);
+					}
+				}
+			}
+			melFeatures_deinit();
+			audioAnalysis_deinit();
+		}
+
+		printf("%d,%d,20,%.3f,%.3f,%.1f\n", ANLYS_FFT_BACKEND, amplitude,
+		       levelError / (20 * melConfig.bands), worstError,
+		       10.0 * log10(levelSignal / levelNoise));
+		totalError += levelError;
+		values += 20 * melConfig.bands;
+		signal += levelSignal;
+		error += levelNoise;
+	}
+
+	passed = totalError / values <= maxErrorDb
+	         && 10.0 * log10(signal / error) >= minSnrDb;
+	fprintf(stderr, "mel: %s, log mel off by %.3f dB on average (bound %.2f), "
+	        "MFCC SNR %.1f dB (bound %.0f)\n", passed ? "passed" : "FAILED",
+	        totalError / values, maxErrorDb, 10.0 * log10(signal / error), minSnrDb);
+	return passed;
+}
+
+/** Soundscapes of the indices check */
+enum Soundscape {
+	SCAPE_CHIRPS, SCAPE_HUM, SCAPE_NOISE, SCAPES
+};
+static const char *_scapeNames[SCAPES] = {"chirps", "hum", "noise"};
+
+/** Float64 reference of the acoustic indices, accumulated like the module */
+struct IndicesReference {
+		double previous[CHECK_MAX_FFT/2 + 1];
+		double changeSum[CHECK_MAX_FFT/2 + 1];
+		double levelSum[CHECK_MAX_FFT/2 + 1];
+		double powerSum[CHECK_MAX_FFT/2 + 1];
+		double adiCounts[INDICES_MAX_ADI_BANDS];
+		double aci;
+		int stepFrames;
+		int frames;
+		bool havePrevious;
+};
+
+/** @brief One second of a soundscape: 2.5-5.5 kHz chirps every 0.4 s over
+ * quiet noise, a 1.5 kHz hum over the same noise, or white noise.
+ */
+static void makeSoundscape(enum Soundscape scape, int second) {
+	for (int index=0; index<CHECK_SAMPLE_RATE; index++) {
+		double t = second + (double) index / CHECK_SAMPLE_RATE;
+		double u = fmod(t, 0.4);
+		double value = 30.0 * gauss();
+
+		if (scape == SCAPE_CHIRPS && u < 0.15) {
+			value += 3000.0 * sin(2.0 * M_PI * (2500.0 * u + 1500.0 * u * u / 0.15))
+			         * fmin(1.0, fmin(u / 0.005, (0.15 - u) / 0.005));
+		}
+		else if (scape == SCAPE_HUM) {
+			value += 1000.0 * sin(2.0 * M_PI * 1500.0 * t);
+		}
+		else if (scape == SCAPE_NOISE) {
+			value = 1000.0 * gauss();
+		}
+		_audio[index] = saturate(value);
+	}
+}
+
+/** @brief Close the reference's ACI step, as closeStep does.
+ */
+static void referenceStep(struct IndicesReference *reference, int bins) {
+	for (int bin=0; bin<bins; bin++) {
+		if (reference->levelSum[bin] > 0.0) {
+			reference->aci += reference->changeSum[bin] / reference->levelSum[bin];
+		}
+		reference->changeSum[bin] = 0.0;
+		reference->levelSum[bin] = 0.0;
+	}
+	reference->havePrevious = false;
+}
+
+/** @brief Add the float64 spectrum of a frame to the reference.
+ */
+static void referenceIndicesFrame(struct IndicesReference *reference,
+                                  struct IndicesConfig config, int size) {
+	double threshold = pow(10.0, config.adiThreshold / 20.0);
+
+	for (int bin=0; bin<=size/2; bin++) {
+		double level = _reference[bin] / INDICES_FULL_SCALE;
+		int band = (int) ((double) bin * CHECK_SAMPLE_RATE / size / config.adiBandWidth);
+
+		reference->powerSum[bin] += level * level;
+		reference->levelSum[bin] += level;
+		if (reference->havePrevious) {
+			reference->changeSum[bin] += fabs(level - reference->previous[bin]);
+		}
+		reference->previous[bin] = level;
+		if (level >= threshold && band < INDICES_MAX_ADI_BANDS) {
+			reference->adiCounts[band]++;
+		}
+	}
+	reference->havePrevious = true;
+
+	reference->frames++;
+	if (reference->frames % reference->stepFrames == 0) {
+		referenceStep(reference, size/2 + 1);
+	}
+}
+
+/** @brief Sum of the reference's mean power over [lower, upper) Hz.
+ */
+static double referencePower(const struct IndicesReference *reference,
+                             int lower, int upper, int size) {
+	double power = 0.0;
+
+	for (int bin=(lower * size + CHECK_SAMPLE_RATE - 1) / CHECK_SAMPLE_RATE;
+	     bin<(upper * size + CHECK_SAMPLE_RATE - 1) / CHECK_SAMPLE_RATE; bin++) {
+		power += reference->powerSum[bin] / reference->frames;
+	}
+	return power;
+}
+
+/** @brief The indices of the reference, by the definitions of
+ * acoustic_indices.h.
+ */
+static void referenceIndices(struct IndicesReference *reference,
+                             struct IndicesConfig config, int size,
+                             struct AcousticIndices *indices) {
+	int lower = (config.biLower * size + CHECK_SAMPLE_RATE - 1) / CHECK_SAMPLE_RATE;
+	int upper = (config.biUpper * size + CHECK_SAMPLE_RATE - 1) / CHECK_SAMPLE_RATE;
+	int nyquist = size/2 * CHECK_SAMPLE_RATE / size;
+	int bands = (nyquist + config.adiBandWidth - 1) / config.adiBandWidth;
+	double floor = INFINITY, bi = 0.0, shares = 0.0, adi = 0.0;
+	double anthro, bio;
+
+	if (reference->frames % reference->stepFrames != 0) {
+		referenceStep(reference, size/2 + 1);
+	}
+
+	for (int bin=lower; bin<upper; bin++) {
+		floor = fmin(floor, 10.0 * log10(reference->powerSum[bin] / reference->frames
+		                                 + 1e-12));
+	}
+	for (int bin=lower; bin<upper; bin++) {
+		bi += (10.0 * log10(reference->powerSum[bin] / reference->frames + 1e-12)
+		       - floor) * CHECK_SAMPLE_RATE / size / 1000.0;
+	}
+
+	anthro = referencePower(reference, config.anthroLower, config.anthroUpper, size);
+	bio = referencePower(reference, config.bioLower, config.bioUpper, size);
+
+	// bins in each ADI band, as acousticIndices_init counts them
+	for (int band=0; band<bands; band++) {
+		int bins = 0;
+
+		for (int bin=0; bin<=size/2; bin++) {
+			bins += bin * CHECK_SAMPLE_RATE / size / config.adiBandWidth == band;
+		}
+		reference->adiCounts[band] /= bins;
+		shares += reference->adiCounts[band];
+	}
+	for (int band=0; band<bands && shares > 0.0; band++) {
+		if (reference->adiCounts[band] > 0.0) {
+			double share = reference->adiCounts[band] / shares;
+			adi -= share * log(share);
+		}
+	}
+
+	indices->aci = reference->aci;
+	indices->bi = bi;
+	indices->ndsi = anthro + bio > 0.0 ? (bio - anthro) / (bio + anthro) : 0.0;
+	indices->adi = adi;
+	indices->frames = reference->frames;
+}
+
+/** @brief Acoustic indices against the float64 reference, see the file
+ * comment.
+ *
+ * @return true if every soundscape's indices are within the bounds.
+ */
+static bool checkIndices(void) {
+	/* the events mode's settings */
+	struct AnlysConfig config = {
+			.fftSize = 256, .sampleScaler = 50, .powerThreshold = 20,
+			.freqLower = 0, .freqUpper = 9950, .decimation = 1, .indices = true
+		};
+	struct IndicesConfig indicesConfig = {
+			.aciStepSeconds = 5, .biLower = 2000, .biUpper = 8000,
+			.anthroLower = 1000, .anthroUpper = 2000, .bioLower = 2000,
+			.bioUpper = 8000, .adiBandWidth = 1000, .adiThreshold = -50
+		};
+	static struct IndicesReference reference;
+	struct AcousticIndices indices, expected;
+	struct AnlysEvent event;
+	uint32_t frameStride;
+	int failures = 0;
+
+	if (audioAnalysis_init(config, CHECK_SAMPLE_RATE) != ANLYS_OK
+	    || (frameStride = audioAnalysis_startSegment(config)) == 0
+	    || acousticIndices_init(indicesConfig, CHECK_SAMPLE_RATE, frameStride,
+	                            config.fftSize/2 + 1) != INDICES_OK) {
+		fprintf(stderr, "indices: bad configuration\n");
+		audioAnalysis_deinit();
+		return false;
+	}
+
+	printf("soundscape,frames,aci,aci_reference,bi,bi_reference,ndsi,"
+	       "ndsi_reference,adi,adi_reference\n");
+	for (int scape=0; scape<SCAPES; scape++) {
+		double aciError, biError;
+
+		memset(&reference, 0, sizeof(reference));
+		reference.stepFrames = indicesConfig.aciStepSeconds * CHECK_SAMPLE_RATE
+		                       / frameStride;
+		_seed = 500 + scape;
+		for (int second=0; second<CHECK_SOUNDSCAPE; second++) {
+			makeSoundscape(scape, second);
+			analyzeAudioEvent(_audio, CHECK_SAMPLE_RATE, CHECK_SAMPLE_RATE, config,
+			                  &event);
+			for (uint32_t offset=0; offset+frameStride<=CHECK_SAMPLE_RATE;
+			     offset+=frameStride) {
+				referenceSpectrum(&_audio[offset], config.fftSize);
+				referenceIndicesFrame(&reference, indicesConfig, config.fftSize);
+			}
+		}
+		acousticIndices_take(&indices);
+		referenceIndices(&reference, indicesConfig, config.fftSize, &expected);
+
+		printf("%s,%lu,%.2f,%.2f,%.2f,%.2f,%.4f,%.4f,%.4f,%.4f\n", _scapeNames[scape],
+		       (unsigned long) indices.frames, indices.aci, expected.aci, indices.bi,
+		       expected.bi, indices.ndsi, expected.ndsi, indices.adi, expected.adi);
+
+		aciError = fabs(indices.aci - expected.aci) / expected.aci;
+		biError = expected.bi > 0.0 ? fabs(indices.bi - expected.bi) / expected.bi
+		                            : fabs(indices.bi);
+		if (indices.frames != expected.frames || aciError > 0.016 || biError > 0.01
+		    || fabs(indices.ndsi - expected.ndsi) >= 0.0005
+		    || fabs(indices.adi - expected.adi) >= 0.0005) {
+			fprintf(stderr, "indices: FAILED on %s, ACI off by %.2f%%, BI by %.2f%%, "
+			        "NDSI by %.4f, ADI by %.4f\n", _scapeNames[scape], 100.0 * aciError,
+			        100.0 * biError, fabs(indices.ndsi - expected.ndsi),
+			        fabs(indices.adi - expected.adi));
+			failures++;
+		}
+	}
+	acousticIndices_deinit();
+	audioAnalysis_deinit();
+
+	if (failures == 0) {
+		fprintf(stderr, "indices: passed, within the bounds on every soundscape\n");
+	}
+	return failures == 0;
+}
+
+/** Signals of the gates check */
+enum ShapeSignal {
+	SHAPE_CHIRP, SHAPE_WARBLE, SHAPE_RAIN, SHAPE_WIND, SHAPE_INSECT, SHAPE_SIGNALS
+};
+static const char *_shapeNames[SHAPE_SIGNALS] = {
+		"chirp", "warble", "rain", "wind", "insect"
+};
+
+/** Starts of the calls of a gates segment, in s, each 0.2 s long */
+static const double _shapeCalls[] = {0.1, 0.4, 0.7};
+#define CHECK_SHAPE_CALLS (sizeof(_shapeCalls) / sizeof(_shapeCalls[0]))
+#define CHECK_SHAPE_CALL 0.2
+
+/** @brief One second of a gates signal: three chirps or warbles over quiet
+ * noise, white noise rain, low-passed wind with gusts, or white noise pulsed
+ * like an insect's buzz.
+ */
+static void makeShape(enum ShapeSignal signal, uint32_t seed) {
+	double wind = 0.0;
+	double pole = exp(-2.0 * M_PI * 500.0 / CHECK_SAMPLE_RATE);
+
+	_seed = seed;
+	for (int index=0; index<CHECK_SAMPLE_RATE; index++) {
+		double t = (double) index / CHECK_SAMPLE_RATE;
+		double value = 0.0;
+
+		if (signal == SHAPE_CHIRP || signal == SHAPE_WARBLE) {
+			value = 30.0 * gauss();
+			for (int call=0; call<CHECK_SHAPE_CALLS; call++) {
+				double u = t - _shapeCalls[call];
+				double ramp = fmin(1.0, fmin(u / 0.005, (CHECK_SHAPE_CALL - u) / 0.005));
+
+				if (u < 0.0 || u >= CHECK_SHAPE_CALL) {
+					continue;
+				}
+				if (signal == SHAPE_CHIRP) {
+					value += 3000.0 * ramp
+					         * sin(2.0 * M_PI * (2000.0 * u + 7500.0 * u * u));
+				}
+				else {
+					value += 3000.0 * ramp
+					         * sin(2.0 * M_PI * (3500.0 * u
+					                             - 600.0 / (2.0 * M_PI * 25.0)
+					                               * cos(2.0 * M_PI * 25.0 * u)));
+				}
+			}
+		}
+		else if (signal == SHAPE_RAIN) {
+			value = 1000.0 * gauss();
+		}
+		else if (signal == SHAPE_WIND) {
+			wind = pole * wind + (1.0 - pole) * 20000.0 * gauss();
+			value = wind * (0.4 + 0.6 * pow(sin(M_PI * 1.5 * t), 2.0));
+		}
+		else {
+			value = 1000.0 * gauss() * (sin(2.0 * M_PI * 40.0 * t) > 0.0 ? 1.0 : 0.15);
+		}
+		_audio[index] = saturate(value);
+	}
+}
+
+/** @brief Whether a gates frame lies within one of the calls.
+ */
+static bool inCall(uint32_t start, uint32_t length) {
+	for (int call=0; call<CHECK_SHAPE_CALLS; call++) {
+		double callStart = _shapeCalls[call] * CHECK_SAMPLE_RATE;
+		double callEnd = (_shapeCalls[call] + CHECK_SHAPE_CALL) * CHECK_SAMPLE_RATE;
+
+		if (start >= callStart && start + length <= callEnd) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/** @brief Spectral shape and the gates' verdicts on calls and noise, see the
+ * file comment.
+ *
+ * @return true if every signal is flagged without the gates, the calls are
+ * flagged with them, the noises are not, and the flatness of each lies in the
+ * range the gates were set from.
+ */
+static bool checkGates(void) {
+	/* flatness range each signal's frames must lie in, calls during the calls,
+	 * with margin either side of the 0.10 gate */
+	static const double lowest[SHAPE_SIGNALS] = {0.0, 0.0, 0.30, 0.15, 0.30};
+	static const double highest[SHAPE_SIGNALS] = {0.08, 0.08, 1.0, 1.0, 1.0};
+	struct AnlysConfig config = {
+			.fftSize = 256, .sampleScaler = CHECK_SCALER, .powerThreshold = 2000,
+			.freqLower = 1000, .freqUpper = 8000, .decimation = 1
+		};
+	struct AnlysGates gates = {
+			.maxEntropy = 26214, .maxFlatness = 3277		// 0.80 and 0.10
+		};
+	int lowerBin = config.freqLower * config.fftSize / CHECK_SAMPLE_RATE;
+	int upperBin = config.freqUpper * config.fftSize / CHECK_SAMPLE_RATE;
+	struct AnlysSpectrum spectrum;
+	struct SpectralShape shape;
+	uint32_t frameStride;
+	int failures = 0;
+
+	if (audioAnalysis_init(config, CHECK_SAMPLE_RATE) != ANLYS_OK) {
+		fprintf(stderr, "gates: bad configuration\n");
+		return false;
+	}
+
+	printf("signal,segments,frames,min_flatness,max_flatness,min_entropy,"
+	       "max_entropy,flagged,flagged_gated\n");
+	for (int signal=0; signal<SHAPE_SIGNALS; signal++) {
+		bool call = signal == SHAPE_CHIRP || signal == SHAPE_WARBLE;
+		double minFlatness = 1.0, maxFlatness = 0.0;
+		double minEntropy = 1.0, maxEntropy = 0.0;
+		int frames = 0, flagged = 0, gated = 0;
+
+		for (int segment=0; segment<10; segment++) {
+			makeShape(signal, 1000 * signal + segment + 1);
+
+			frameStride = audioAnalysis_startSegment(config);
+			for (uint32_t offset=0; offset+frameStride<=CHECK_SAMPLE_RATE;
+			     offset+=frameStride) {
+				if (call && !inCall(offset, frameStride)) {
+					continue;
+				}
+				analyzeFrame(&_audio[offset], &spectrum);
+				spectralShape_frame(&spectrum, lowerBin, upperBin, CHECK_SAMPLE_RATE,
+				                    frameStride, &shape);
+				minFlatness = fmin(minFlatness, shape.flatness / 32768.0);
+				maxFlatness = fmax(maxFlatness, shape.flatness / 32768.0);
+				minEntropy = fmin(minEntropy, shape.entropy / 32768.0);
+				maxEntropy = fmax(maxEntropy, shape.entropy / 32768.0);
+				frames++;
+			}
+
+			config.gates = (struct AnlysGates) {0};
+			flagged += analyzeAudio(_audio, CHECK_SAMPLE_RATE, CHECK_SAMPLE_RATE,
+			                        config);
+			config.gates = gates;
+			gated += analyzeAudio(_audio, CHECK_SAMPLE_RATE, CHECK_SAMPLE_RATE,
+			                      config);
+		}
+
+		printf("%s,10,%d,%.3f,%.3f,%.3f,%.3f,%d,%d\n", _shapeNames[signal], frames,
+		       minFlatness, maxFlatness, minEntropy, maxEntropy, flagged, gated);
+		if (flagged != 10 || gated != (call ? 10 : 0)
+		    || minFlatness < lowest[signal] || maxFlatness > highest[signal]) {
+			fprintf(stderr, "gates: FAILED on %s, flatness %.3f-%.3f, flagged %d, "
+			        "%d with the gates, of 10\n", _shapeNames[signal], minFlatness,
+			        maxFlatness, flagged, gated);
+			failures++;
+		}
+	}
+	audioAnalysis_deinit();
+
+	if (failures == 0) {
+		fprintf(stderr, "gates: passed, calls flagged and noise rejected\n");
+	}
+	return failures == 0;
+}
+
+/** @brief The standard A-weighting at a frequency, in dB.
+ */
+static double aWeighting(double freq) {
+	double f2 = freq * freq;
+	double response = 12194.0 * 12194.0 * f2 * f2
+	                  / ((f2 + 20.6 * 20.6) * sqrt((f2 + 107.7 * 107.7) * (f2 + 737.9 * 737.9))
+	                     * (f2 + 12194.0 * 12194.0));
+
+	return 20.0 * log10(response) + 2.0;
+}
+
+/** @brief A-weighted Leq of tones against the standard curve, see the file
+ * comment.
+ *
+ * @return true if every tone reads within 0.25 dB of the curve.
+ */
+static bool checkLevel(void) {
+	static const double freqs[] = {
+			31.5, 40, 50, 63, 80, 100, 125, 160, 200, 250, 315, 400, 500, 630, 800,
+			1000, 1250, 1600, 2000, 2500, 3150, 4000, 5000, 6300, 8000
+		};
+	struct LevelConfig config = {.calibration = 0};
+	struct LevelReading reading;
+	double worst = 0.0;
+	bool passed;
+
+	printf("freq_hz,expected_db,leq_db,error_db\n");
+	for (int tone=0; tone<sizeof(freqs)/sizeof(freqs[0]); tone++) {
+		double expected = 20.0 * log10(3277.0 / 32767.0) + aWeighting(freqs[tone]);
+		bool taken = false;
+
+		if (levelMeter_init(config, CHECK_SAMPLE_RATE) != LEVEL_OK) {
+			fprintf(stderr, "level: bad configuration\n");
+			return false;
+		}
+
+		// the first interval holds the filters settling, the second is read
+		for (int second=0; second<2; second++) {
+			for (int index=0; index<CHECK_SAMPLE_RATE; index++) {
+				double t = second + (double) index / CHECK_SAMPLE_RATE;
+				_audio[index] = saturate(3277.0 * sin(2.0 * M_PI * freqs[tone] * t));
+			}
+			for (int index=0; index<CHECK_SAMPLE_RATE; index+=LEVEL_MAX_BLOCK) {
+				int count = CHECK_SAMPLE_RATE - index < LEVEL_MAX_BLOCK
+				            ? CHECK_SAMPLE_RATE - index : LEVEL_MAX_BLOCK;
+				levelMeter_block(&_audio[index], count);
+			}
+			taken = levelMeter_take(LEVEL_SHORT, &reading);
+		}
+		if (!taken) {
+			fprintf(stderr, "level: no reading at %.1f Hz\n", freqs[tone]);
+			return false;
+		}
+
+		printf("%.1f,%.2f,%.2f,%.2f\n", freqs[tone], expected, reading.leq / 100.0,
+		       reading.leq / 100.0 - expected);
+		worst = fmax(worst, fabs(reading.leq / 100.0 - expected));
+	}
+
+	passed = worst <= 0.25;
+	fprintf(stderr, "level: %s, within %.2f dB of the A curve (bound 0.25)\n",
+	        passed ? "passed" : "FAILED", worst);
+	return passed;
+}
+
+/** @brief Read one CSV row of integers.
+ *
+ * @return Number of values read, 0 at the end of the file, -1 for a row
+ * longer than maxValues.
+ */
+static int readRow(FILE *file, q15_t *values, int maxValues) {
+	char line[CHECK_NN_MAX_VALUES * 8];
+	char *cursor, *end;
+	int count = 0;
+
+	if (fgets(line, sizeof(line), file) == NULL) {
+		return 0;
+	}
+	for (cursor = line; ; cursor = end + 1) {
+		long value = strtol(cursor, &end, 10);
+		if (end == cursor) {
+			break;
+		}
+		if (count == maxValues) {
+			return -1;
+		}
+		values[count++] = (q15_t) value;
+		if (*end != ',') {
+			break;
+		}
+	}
+
+	return count;
+}
+
+/** @brief Run the loaded model on each row of inputs and compare its scores
+ * with the row of scores.
+ *
+ * @return true if every score is bit-exact.
+ */
+static bool compareScores(FILE *inputs, FILE *scores) {
+	q15_t input[CHECK_NN_MAX_VALUES];
+	q15_t expected[CHECK_NN_MAX_VALUES];
+	const q15_t *result;
+	int rows = 0, mismatches = 0, length;
+
+	printf("row,class,expected,score\n");
+	while ((length = readRow(inputs, input, CHECK_NN_MAX_VALUES)) != 0) {
+		if (length != nnClassifier_inputLength()
+		    || readRow(scores, expected, CHECK_NN_MAX_VALUES)
+		       != nnClassifier_classes()) {
+			fprintf(stderr, "nn: row %d does not match the model\n", rows);
+			return false;
+		}
+
+		result = nnClassifier_run(input);
+		for (int c = 0; c < nnClassifier_classes(); c++) {
+			printf("%d,%d,%d,%d\n", rows, c, expected[c], result[c]);
+			mismatches += result[c] != expected[c];
+		}
+		rows++;
+	}
+
+	if (rows == 0 || mismatches > 0) {
+		fprintf(stderr, "nn: FAILED, %d of %d scores differ\n", mismatches,
+		        rows * nnClassifier_classes());
+		return false;
+	}
+	fprintf(stderr, "nn: passed, %d rows bit-exact\n", rows);
+	return true;
+}
+
+/** @brief Classifier scores against the converter's reference, see the file
+ * comment.
+ *
+ * @return true if every score is bit-exact.
+ */
+static bool checkNN(void) {
+	FILE *inputs = fopen(CHECK_NN_INPUTS, "r");
+	FILE *scores = fopen(CHECK_NN_SCORES, "r");
+	enum NN_Ecode error;
+	bool passed = false;
+
+	if (inputs == NULL || scores == NULL) {
+		fprintf(stderr, "nn: cannot open %s and %s\n", CHECK_NN_INPUTS,
+		        CHECK_NN_SCORES);
+	}
+	else if ((error = nnClassifier_init(nnModel)) != NN_OK) {
+		fprintf(stderr, "nn: model not loaded, error %d\n", error);
+	}
+	else {
+		passed = compareScores(inputs, scores);
+	}
+
+	nnClassifier_deinit();
+	if (inputs != NULL) {
+		fclose(inputs);
+	}
+	if (scores != NULL) {
+		fclose(scores);
+	}
+	return passed;
+}
+
+int main(int argc, char **argv) {
+	int size = 256;
+	int option;
+	bool passed = true;
+
+	while ((option = getopt(argc, argv, "n:")) != -1) {
+		switch (option) {
+			case 'n':
+				size = atoi(optarg);
+				break;
+			default:
+				fprintf(stderr, "usage: %s [-n fftSize] check...\n", argv[0]);
+				return 1;
+		}
+	}
+	if (size < 64 || size > CHECK_MAX_FFT || (size & (size - 1)) != 0
+	    || optind == argc) {
+		fprintf(stderr, "usage: %s [-n fftSize] "
+		        "spectrum|detect|onset|pitch|indices|level|mel|gates|nn...\n"
+		        "fftSize is a power of 2 from 64 to %d\n", argv[0], CHECK_MAX_FFT);
+		return 1;
+	}
+
+	for (int index=optind; index<argc; index++) {
+		if (strcmp(argv[index], "spectrum") == 0) {
+			checkSpectrum(size);
+		}
+		else if (strcmp(argv[index], "detect") == 0) {
+			checkDetect();
+		}
+		else if (strcmp(argv[index], "onset") == 0) {
+			checkOnset();
+		}
+		else if (strcmp(argv[index], "pitch") == 0) {
+			checkPitch();
+		}
+		else if (strcmp(argv[index], "indices") == 0) {
+			passed &= checkIndices();
+		}
+		else if (strcmp(argv[index], "level") == 0) {
+			passed &= checkLevel();
+		}
+		else if (strcmp(argv[index], "mel") == 0) {
+			passed &= checkMel();
+		}
+		else if (strcmp(argv[index], "gates") == 0) {
+			passed &= checkGates();
+		}
+		else if (strcmp(argv[index], "nn") == 0) {
+			passed &= checkNN();
+		}
+		else {
+			fprintf(stderr, "%s: no check %s\n", argv[0], argv[index]);
+			return 1;
+		}
+	}
+
+	return passed ? 0 : 1;
+}
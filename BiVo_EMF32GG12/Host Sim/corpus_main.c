@@ -0,0 +1,532 @@
+/** @file corpus_main.c
+ * @brief Detection quality against compute cost over a labeled corpus.
+ *
+ * Runs the standard mode's detector, analyzeAudio built from the firmware's
+ * sources, over labeled recordings, for every combination of the AnlysConfig
+ * values swept. The recordings are cut into consecutive segments of
+ * AUDIO_SEG_LEN seconds as run_standard_mode records them, and the tail short
+ * of a segment is dropped. Settings not swept are those of the standard mode.
+ *
+ * Labels: each recording name.wav has an Audacity label file name.txt beside
+ * it, one call per line as start and end in seconds, tab separated. A
+ * recording without one has no calls. A segment holds a call if a label covers
+ * CORPUS_MIN_OVERLAP seconds of it, and a segment passing analysis counts as a
+ * true or false positive by that.
+ *
+ * Recordings are 16 bit PCM at the standard mode's sample rate. Resample
+ * others first, with the device's anti-alias filtering in mind.
+ *
+ * Each configuration runs in its own process, as the modules keep their state
+ * in statics, and up to -j run at once, one per core by default. Cost is the
+ * host time analyzeAudio takes per second of audio, from the profiler. With -s,
+ * board cycles per host ns as measured with the profiler on both, it is also
+ * given in board cycles. Transmit bytes are those run_standard_mode sends for
+ * each segment passing, without the time it stops listening to send them.
+ *
+ * Output is CSV on stdout, one line per configuration, the Pareto front on F1,
+ * cost and transmit bytes first (pareto 1), each part ordered by cost:
+ *
+ * 	<swept>...,segments,calls,tp,fp,fn,precision,recall,f1,bytes_per_hour,
+ * 	ns_per_s,[cycles_per_s,]pareto
+ *
+ * Usage: bivo_corpus [-j jobs] [-s scale] [name=value,value...]... corpus...
+ * 	-j	Configurations run at once, the number of cores by default.
+ * 	-s	Board cycles per host ns, to give the cost in cycles.
+ * 	name	AnlysConfig field to sweep: fftSize, sampleScaler, powerThreshold,
+ * 			freqLower, freqUpper, decimation, fineSize, trigger, onsetMargin,
+ * 			maxEntropy, maxFlatness, centroidLower or centroidUpper.
+ * 	corpus	WAV files, or directories of them.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "standard_mode.h"
+#include "profiler.h"
+#include "sim_wav.h"
+
+#define CORPUS_MAX_FILES 4096
+#define CORPUS_MAX_LABELS 65536				// labels over all the files
+#define CORPUS_MAX_SWEEPS 8						// parameters swept
+#define CORPUS_MAX_VALUES 32					// values of one parameter
+#define CORPUS_MAX_CONFIGS 100000
+#define CORPUS_MIN_OVERLAP 0.1				// s of a call that make a segment hold it
+
+/** @struct AnlysConfig field that can be swept.
+ */
+struct CorpusParameter {
+		const char *name;
+		size_t offset;
+		bool isQ15;				// q15_t field, else int
+};
+
+/** @struct Recording and its calls, in seconds.
+ */
+struct CorpusFile {
+		char *path;
+		int firstLabel;
+		int labels;
+};
+
+/** @struct Parameter swept, and its values.
+ */
+struct CorpusSweep {
+		const struct CorpusParameter *parameter;
+		int values[CORPUS_MAX_VALUES];
+		int count;
+};
+
+/** @struct Outcome of one configuration, written by its process.
+ */
+struct CorpusResult {
+		bool done;
+		uint32_t segments;
+		uint32_t calls;					// segments holding a call
+		uint32_t truePositives;
+		uint32_t falsePositives;
+		uint64_t ns;						// host time in analyzeAudio
+		double f1;
+		double bytesPerHour;
+		double nsPerSecond;
+		bool pareto;
+};
+
+static const struct CorpusParameter _parameters[] = {
+		{"fftSize", offsetof(struct AnlysConfig, fftSize), false},
+		{"sampleScaler", offsetof(struct AnlysConfig, sampleScaler), false},
+		{"powerThreshold", offsetof(struct AnlysConfig, powerThreshold), false},
+		{"freqLower", offsetof(struct AnlysConfig, freqLower), false},
+		{"freqUpper", offsetof(struct AnlysConfig, freqUpper), false},
+		{"decimation", offsetof(struct AnlysConfig, decimation), false},
+		{"fineSize", offsetof(struct AnlysConfig, fineSize), false},
+		{"trigger", offsetof(struct AnlysConfig, trigger), false},
+		{"onsetMargin", offsetof(struct AnlysConfig, onsetMargin), false},
+		{"maxEntropy", offsetof(struct AnlysConfig, gates.maxEntropy), true},
+		{"maxFlatness", offsetof(struct AnlysConfig, gates.maxFlatness), true},
+		{"centroidLower", offsetof(struct AnlysConfig, gates.centroidLower), false},
+		{"centroidUpper", offsetof(struct AnlysConfig, gates.centroidUpper), false}
+	};
+
+static struct CorpusFile _files[CORPUS_MAX_FILES];
+static int _fileCount = 0;
+static double _labelStarts[CORPUS_MAX_LABELS];
+static double _labelEnds[CORPUS_MAX_LABELS];
+static int _labelCount = 0;
+static struct CorpusSweep _sweeps[CORPUS_MAX_SWEEPS];
+static int _sweepCount = 0;
+static uint32_t _sampleRate;
+static uint32_t _segmentSize;
+
+/** @brief Read the labels of a recording, from the .txt beside it.
+ */
+static void readLabels(struct CorpusFile *file) {
+	char path[4096], line[512];
+	size_t length = strlen(file->path);
+	FILE *labels;
+
+	file->firstLabel = _labelCount;
+	file->labels = 0;
+	snprintf(path, sizeof(path), "%.*s.txt", (int) (length - 4), file->path);
+	labels = fopen(path, "r");
+	if (labels == NULL) {
+		return;
+	}
+
+	while (fgets(line, sizeof(line), labels) != NULL) {
+		double start, end;
+
+		// Audacity writes a second line of frequencies for spectral labels
+		if (line[0] == '\\' || sscanf(line, "%lf %lf", &start, &end) != 2) {
+			continue;
+		}
+		if (_labelCount == CORPUS_MAX_LABELS) {
+			fprintf(stderr, "%s: more than %d labels in the corpus\n", path,
+			        CORPUS_MAX_LABELS);
+			exit(1);
+		}
+		_labelStarts[_labelCount] = start;
+		_labelEnds[_labelCount] = end;
+		_labelCount++;
+		file->labels++;
+	}
+	fclose(labels);
+}
+
+/** @brief Add a recording, checking its sample rate.
+ */
+static void addFile(const char *path) {
+	size_t length = strlen(path);
+	char *paths[1];
+
+	if (length < 4 || strcasecmp(&path[length - 4], ".wav") != 0) {
+		return;
+	}
+	if (_fileCount == CORPUS_MAX_FILES) {
+		fprintf(stderr, "more than %d recordings\n", CORPUS_MAX_FILES);
+		exit(1);
+	}
+
+	_files[_fileCount].path = strdup(path);
+	paths[0] = _files[_fileCount].path;
+	if (simWav_open(paths, 1) != _sampleRate) {
+		fprintf(stderr, "%s: not at the standard mode's %u Hz\n", path, _sampleRate);
+		exit(1);
+	}
+	readLabels(&_files[_fileCount]);
+	_fileCount++;
+}
+
+/** @brief Add a recording, or the recordings in a directory.
+ */
+static void addCorpus(const char *path) {
+	struct stat status;
+	struct dirent **entries;
+	char child[4096];
+	int count;
+
+	if (stat(path, &status) != 0) {
+		perror(path);
+		exit(1);
+	}
+	if (!S_ISDIR(status.st_mode)) {
+		addFile(path);
+		return;
+	}
+
+	count = scandir(path, &entries, NULL, alphasort);
+	for (int index=0; index<count; index++) {
+		if (entries[index]->d_name[0] != '.') {
+			snprintf(child, sizeof(child), "%s/%s", path, entries[index]->d_name);
+			addFile(child);
+		}
+		free(entries[index]);
+	}
+	free(entries);
+}
+
+/** @brief Add a sweep, from name=value,value...
+ *
+ * @return false if the argument is not a sweep.
+ */
+static bool addSweep(const char *argument) {
+	const char *equals = strchr(argument, '=');
+	struct CorpusSweep *sweep = &_sweeps[_sweepCount];
+	char *next;
+
+	if (equals == NULL) {
+		return false;
+	}
+	if (_sweepCount == CORPUS_MAX_SWEEPS) {
+		fprintf(stderr, "more than %d parameters swept\n", CORPUS_MAX_SWEEPS);
+		exit(1);
+	}
+
+	sweep->parameter = NULL;
+	for (int index=0; index<sizeof(_parameters)/sizeof(_parameters[0]); index++) {
+		if (strlen(_parameters[index].name) == equals - argument
+		    && strncmp(_parameters[index].name, argument, equals - argument) == 0) {
+			sweep->parameter = &_parameters[index];
+		}
+	}
+	if (sweep->parameter == NULL) {
+		fprintf(stderr, "%.*s: not a parameter that can be swept\n",
+		        (int) (equals - argument), argument);
+		exit(1);
+	}
+
+	sweep->count = 0;
+	for (const char *value = equals + 1; *value != '\0'; value = next + (*next == ',')) {
+		if (sweep->count == CORPUS_MAX_VALUES) {
+			fprintf(stderr, "%s: more than %d values\n", sweep->parameter->name,
+			        CORPUS_MAX_VALUES);
+			exit(1);
+		}
+		sweep->values[sweep->count++] = (int) strtol(value, &next, 0);
+		if (next == value || (*next != ',' && *next != '\0')) {
+			fprintf(stderr, "%s: bad value list\n", argument);
+			exit(1);
+		}
+	}
+	_sweepCount++;
+
+	return true;
+}
+
+/** @brief Value of a sweep in a configuration, configurations counting through
+ * the combinations with the last sweep fastest.
+ */
+static int sweepValue(uint32_t config, int sweepIdx) {
+	for (int index=_sweepCount-1; index>sweepIdx; index--) {
+		config /= _sweeps[index].count;
+	}
+
+	return _sweeps[sweepIdx].values[config % _sweeps[sweepIdx].count];
+}
+
+/** @brief Analysis configuration of a configuration number.
+ */
+static struct AnlysConfig makeConfig(uint32_t config) {
+	struct AnlysConfig anlysConfig = anlys_config;
+
+	for (int index=0; index<_sweepCount; index++) {
+		void *field = (uint8_t*) &anlysConfig + _sweeps[index].parameter->offset;
+
+		if (_sweeps[index].parameter->isQ15) {
+			*(q15_t*) field = (q15_t) sweepValue(config, index);
+		}
+		else {
+			*(int*) field = sweepValue(config, index);
+		}
+	}
+
+	return anlysConfig;
+}
+
+/** @brief If a segment of a recording holds a call.
+ */
+static bool holdsCall(const struct CorpusFile *file, uint32_t start) {
+	double segmentStart = (double) start / _sampleRate;
+	double segmentEnd = (double) (start + _segmentSize) / _sampleRate;
+
+	for (int index=file->firstLabel; index<file->firstLabel+file->labels; index++) {
+		double overlap = (_labelEnds[index] < segmentEnd ? _labelEnds[index] : segmentEnd)
+		                 - (_labelStarts[index] > segmentStart
+		                    ? _labelStarts[index] : segmentStart);
+
+		if (overlap >= CORPUS_MIN_OVERLAP) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/** @brief Run the detector over the corpus with one configuration, in the
+ * process of that configuration.
+ */
+static void evaluate(uint32_t config, struct CorpusResult *result) {
+	struct AnlysConfig anlysConfig = makeConfig(config);
+	int16_t *segment = (int16_t*) malloc(_segmentSize * sizeof(int16_t));
+	struct ProfilerRegion stats;
+
+	if (audioAnalysis_init(anlysConfig, _sampleRate) != ANLYS_OK) {
+		fprintf(stderr, "configuration %u is rejected by the analysis\n", config);
+		free(segment);
+		return;
+	}
+	profiler_reset();
+
+	for (int fileIdx=0; fileIdx<_fileCount; fileIdx++) {
+		simWav_open(&_files[fileIdx].path, 1);
+
+		for (uint32_t start=0; ; start+=_segmentSize) {
+			bool complete = true;
+			bool passed, call;
+
+			for (uint32_t index=0; index<_segmentSize && complete; index++) {
+				complete = simWav_sample(start + index, &segment[index]);
+			}
+			if (!complete) {
+				break;
+			}
+
+			passed = analyzeAudio(segment, _segmentSize, _sampleRate, anlysConfig);
+			call = holdsCall(&_files[fileIdx], start);
+			result->segments++;
+			result->calls += call;
+			result->truePositives += passed && call;
+			result->falsePositives += passed && !call;
+		}
+	}
+
+	profiler_region(PROFILE_ANALYZE, &stats);
+	result->ns = stats.sum;
+	result->done = true;
+	free(segment);
+}
+
+/** @brief Fill in the figures of merit of a result.
+ */
+static void score(struct CorpusResult *result) {
+	uint32_t passed = result->truePositives + result->falsePositives;
+	double precision = passed > 0 ? (double) result->truePositives / passed : 0.0;
+	double recall = result->calls > 0 ? (double) result->truePositives / result->calls : 0.0;
+	double seconds = (double) result->segments * _segmentSize / _sampleRate;
+
+	result->f1 = precision + recall > 0 ? 2 * precision * recall / (precision + recall) : 0.0;
+	// each segment passing is sent as samples and the end of segment message
+	result->bytesPerHour = seconds > 0
+	    ? passed * (_segmentSize * sizeof(int16_t) + 5) * 3600.0 / seconds : 0.0;
+	result->nsPerSecond = seconds > 0 ? result->ns / seconds : 0.0;
+}
+
+/** @brief If a result is no worse than another on F1, cost and bytes, and
+ * better on one.
+ */
+static bool dominates(const struct CorpusResult *a, const struct CorpusResult *b) {
+	return a->f1 >= b->f1 && a->nsPerSecond <= b->nsPerSecond
+	       && a->bytesPerHour <= b->bytesPerHour
+	       && (a->f1 > b->f1 || a->nsPerSecond < b->nsPerSecond
+	           || a->bytesPerHour < b->bytesPerHour);
+}
+
+static struct CorpusResult *_sortResults;
+
+static int compareConfigs(const void *a, const void *b) {
+	const struct CorpusResult *ra = &_sortResults[*(const uint32_t*) a];
+	const struct CorpusResult *rb = &_sortResults[*(const uint32_t*) b];
+
+	if (ra->pareto != rb->pareto) {
+		return rb->pareto - ra->pareto;
+	}
+	return (ra->nsPerSecond > rb->nsPerSecond) - (ra->nsPerSecond < rb->nsPerSecond);
+}
+
+/** @brief Print the results, the Pareto front first.
+ */
+static void report(struct CorpusResult *results, uint32_t configs, double scale) {
+	uint32_t *order = (uint32_t*) malloc(configs * sizeof(uint32_t));
+	uint32_t count = 0;
+
+	for (uint32_t config=0; config<configs; config++) {
+		if (!results[config].done) {
+			fprintf(stderr, "configuration %u did not finish\n", config);
+			continue;
+		}
+		score(&results[config]);
+		order[count++] = config;
+	}
+	for (uint32_t index=0; index<count; index++) {
+		results[order[index]].pareto = true;
+		for (uint32_t other=0; other<count; other++) {
+			if (dominates(&results[order[other]], &results[order[index]])) {
+				results[order[index]].pareto = false;
+				break;
+			}
+		}
+	}
+	_sortResults = results;
+	qsort(order, count, sizeof(uint32_t), compareConfigs);
+
+	for (int index=0; index<_sweepCount; index++) {
+		printf("%s,", _sweeps[index].parameter->name);
+	}
+	printf("segments,calls,tp,fp,fn,precision,recall,f1,bytes_per_hour,ns_per_s,%s"
+	       "pareto\n", scale > 0 ? "cycles_per_s," : "");
+
+	for (uint32_t index=0; index<count; index++) {
+		const struct CorpusResult *result = &results[order[index]];
+		uint32_t passed = result->truePositives + result->falsePositives;
+
+		for (int sweep=0; sweep<_sweepCount; sweep++) {
+			printf("%d,", sweepValue(order[index], sweep));
+		}
+		printf("%u,%u,%u,%u,%u,%.4f,%.4f,%.4f,%.0f,%.0f,", result->segments,
+		       result->calls, result->truePositives, result->falsePositives,
+		       result->calls - result->truePositives,
+		       passed > 0 ? (double) result->truePositives / passed : 0.0,
+		       result->calls > 0 ? (double) result->truePositives / result->calls : 0.0,
+		       result->f1, result->bytesPerHour, result->nsPerSecond);
+		if (scale > 0) {
+			printf("%.0f,", result->nsPerSecond * scale);
+		}
+		printf("%d\n", result->pareto);
+	}
+
+	free(order);
+}
+
+int main(int argc, char **argv) {
+	long jobs = sysconf(_SC_NPROCESSORS_ONLN);
+	double scale = 0.0;
+	uint32_t configs = 1;
+	struct CorpusResult *results;
+	int running = 0, option;
+
+	while ((option = getopt(argc, argv, "j:s:")) != -1) {
+		switch (option) {
+			case 'j':
+				jobs = atol(optarg);
+				break;
+			case 's':
+				scale = atof(optarg);
+				break;
+			default:
+				fprintf(stderr, "usage: %s [-j jobs] [-s scale] "
+				        "[name=value,value...]... corpus...\n", argv[0]);
+				return 1;
+		}
+	}
+
+	_sampleRate = BASE_CLK_RATE/((mic_config.clk_prescalar+1)*mic_config.down_sample_rate);
+	_segmentSize = AUDIO_SEG_LEN*_sampleRate;
+	for (int index=optind; index<argc; index++) {
+		if (!addSweep(argv[index])) {
+			addCorpus(argv[index]);
+		}
+	}
+	if (_fileCount == 0) {
+		fprintf(stderr, "%s: no recordings\n", argv[0]);
+		return 1;
+	}
+	for (int index=0; index<_sweepCount; index++) {
+		if ((uint64_t) configs * _sweeps[index].count > CORPUS_MAX_CONFIGS) {
+			fprintf(stderr, "more than %d configurations\n", CORPUS_MAX_CONFIGS);
+			return 1;
+		}
+		configs *= _sweeps[index].count;
+	}
+	if (jobs < 1) {
+		jobs = 1;
+	}
+
+	// results are written by each configuration's process straight into memory
+	// shared with this one
+	results = mmap(NULL, configs * sizeof(struct CorpusResult),
+	               PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (results == MAP_FAILED) {
+		perror("results");
+		return 1;
+	}
+	memset(results, 0, configs * sizeof(struct CorpusResult));
+	fprintf(stderr, "%s: %u configurations over %d recordings, %d labels, %ld at "
+	        "a time\n", argv[0], configs, _fileCount, _labelCount, jobs);
+
+	profiler_init();
+	fflush(stdout);
+	for (uint32_t config=0; config<configs; config++) {
+		pid_t child;
+
+		if (running == jobs) {
+			wait(NULL);
+			running--;
+		}
+		child = fork();
+		if (child == 0) {
+			evaluate(config, &results[config]);
+			_exit(0);
+		}
+		if (child < 0) {
+			perror("fork");
+			return 1;
+		}
+		running++;
+	}
+	while (running > 0) {
+		wait(NULL);
+		running--;
+	}
+
+	report(results, configs, scale);
+	return 0;
+}
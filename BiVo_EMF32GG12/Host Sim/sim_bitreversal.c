@@ -0,0 +1,42 @@
+/** @file sim_bitreversal.c
+ * @brief C versions of the CMSIS bit reversal, which the board build takes
+ * from arm_bitreversal2.S.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#include <stdint.h>
+
+/** @brief Swap the complex 16 bit pairs the table lists.
+ */
+void arm_bitreversal_16(uint16_t *pSrc, const uint16_t bitRevLen,
+                        const uint16_t *pBitRevTab) {
+	for (uint16_t i = 0; i < bitRevLen; i += 2) {
+		uint16_t a = pBitRevTab[i] >> 2, b = pBitRevTab[i + 1] >> 2, swap;
+
+		swap = pSrc[a];
+		pSrc[a] = pSrc[b];
+		pSrc[b] = swap;
+		swap = pSrc[a + 1];
+		pSrc[a + 1] = pSrc[b + 1];
+		pSrc[b + 1] = swap;
+	}
+}
+
+/** @brief Swap the complex 32 bit pairs the table lists.
+ */
+void arm_bitreversal_32(uint32_t *pSrc, const uint16_t bitRevLen,
+                        const uint16_t *pBitRevTab) {
+	for (uint16_t i = 0; i < bitRevLen; i += 2) {
+		uint16_t a = pBitRevTab[i] >> 2, b = pBitRevTab[i + 1] >> 2;
+		uint32_t swap;
+
+		swap = pSrc[a];
+		pSrc[a] = pSrc[b];
+		pSrc[b] = swap;
+		swap = pSrc[a + 1];
+		pSrc[a + 1] = pSrc[b + 1];
+		pSrc[b + 1] = swap;
+	}
+}
@@ -0,0 +1,587 @@
+/** @file sim_device.c
+ * @brief Simulated EFM32GG12 peripherals and clock for the host build.
+ *
+ * Time: the firmware runs natively, so simulated time is moved on at its
+ * peripheral accesses. Each access first catches the clock up by the host
+ * time the firmware ran since the access before, times cpuScale, then acts at
+ * that time. Interrupts that came due meanwhile are taken on the way, in order
+ * and at the times they came due, as if they had preempted the firmware, and
+ * the time their handlers take pushes the firmware's own work later. A value
+ * written to a register with side effects lands after the access that handed
+ * out the register, so it takes effect at the next access, timed at the write.
+ *
+ * PDM: started and stopped with CMD, clocked at SIM_PDM_CLOCK over the
+ * prescaler and down sample rate the driver programs. Each sample is what the
+ * audio source holds at that moment. Samples arriving to a full FIFO are lost
+ * and counted.
+ *
+ * USART: bytes written go out on a line of the configured baud rate, 8N1.
+ * STATUS is read truthfully, but a read straight after another one is taken
+ * as the firmware spinning on it: a full transmit buffer is then waited out in
+ * simulated time, and an empty receiver waits for the input. The wait blocks
+ * on the input when there is no interrupt to come meanwhile.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <poll.h>
+#include <unistd.h>
+#include "sim_device.h"
+#include "em_usart.h"
+#include "em_emu.h"
+
+/** Register writes waiting for the next access */
+enum Sim_Write {
+	WRITE_NONE, WRITE_PDM_CMD, WRITE_USART_TXDATA, WRITE_USART_TXDOUBLE
+};
+
+/** Register access functions */
+static uint32_t pdmStatus(void);
+static uint32_t pdmRxdata(void);
+static uint32_t pdmSyncbusy(void);
+static volatile uint32_t *pdmCmd(void);
+static uint32_t dwtCyccnt(void);
+static uint32_t timerCnt(void);
+static volatile uint32_t *timerCmd(void);
+static uint32_t usartStatus(void);
+static uint32_t usartRxdata(void);
+static volatile uint32_t *usartTxdata(void);
+static volatile uint32_t *usartTxdouble(void);
+
+/** Register blocks */
+SimCmu_TypeDef simCmu;
+SimPdm_TypeDef simPdm = {
+		.status = pdmStatus,
+		.rxdata = pdmRxdata,
+		.syncbusy = pdmSyncbusy,
+		.cmd = pdmCmd
+	};
+SimUsart_TypeDef simUsart0 = {
+		.status = usartStatus,
+		.rxdata = usartRxdata,
+		.txdata = usartTxdata,
+		.txdouble = usartTxdouble
+	};
+
+SimDwt_TypeDef simDwt = {
+		.cyccnt = dwtCyccnt
+	};
+SimCoreDebug_TypeDef simCoreDebug;
+SimTimer_TypeDef simWtimer0 = {
+		.cnt = timerCnt,
+		.cmd = timerCmd
+	};
+
+static struct SimConfig _config;
+static struct SimStats _stats;
+
+/** Clock */
+static uint64_t _now = 0;						// simulated ns
+static uint64_t _lastExit = 0;			// host ns the firmware last got control back
+static int _depth = 0;							// handlers running
+
+/** Write in flight */
+static enum Sim_Write _write = WRITE_NONE;
+static volatile uint32_t _writeSlot;
+
+/** Interrupts */
+static bool _irqMasked = false;
+static bool _pdmIrqEnabled = false;
+
+/** PDM */
+static bool _pdmRunning = false;
+static uint64_t _pdmStart = 0;			// time of the last START
+static uint64_t _pdmIndex = 0;			// samples since the last START
+static uint64_t _pdmStopped = 0;		// time of the last STOP
+static int16_t _fifo[SIM_PDM_FIFO_DEPTH];
+static int _fifoHead = 0;
+static int _fifoCount = 0;
+static uint64_t _levelTime = 0;			// time the FIFO reached the interrupt level
+
+/** USART */
+static uint64_t _byteTime = 10 * SIM_NS_PER_SECOND / 115200;
+static uint64_t _txFree = 0;				// time the line has sent every byte queued
+static FILE *_tx = NULL;
+static int _rxByte = -1;						// byte waiting in the receiver
+static bool _rxClosed = false;
+static int _statusPolls = 0;				// STATUS reads in a row
+static bool _lastTxbl = false;			// the last STATUS read showed TXBL
+static bool _awaitingTx = false;		// a segment ended, no byte sent since
+
+/** @brief Host CPU time of the firmware's thread, in ns. Time the host gives
+ * to other threads, such as the endurance run's application, is not the
+ * firmware's.
+ */
+static uint64_t hostNs(void) {
+	struct timespec now;
+
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+	return (uint64_t) now.tv_sec * SIM_NS_PER_SECOND + now.tv_nsec;
+}
+
+/** @brief End the simulation.
+ */
+static void finish(const char *reason) {
+	if (_tx != NULL) {
+		fflush(_tx);
+	}
+	_config.finish(reason);
+	exit(0);
+}
+
+/** @brief Sample rate the driver programmed, from the prescaler and the down
+ * sample rate.
+ */
+static uint32_t pdmRate(void) {
+	uint32_t prescaler = (PDM->CFG1 & _PDM_CFG1_PRESC_MASK) >> _PDM_CFG1_PRESC_SHIFT;
+	uint32_t downSample = (PDM->CTRL & _PDM_CTRL_DSR_MASK) >> _PDM_CTRL_DSR_SHIFT;
+
+	return downSample == 0 ? 0 : SIM_PDM_CLOCK / ((prescaler + 1) * downSample);
+}
+
+/** @brief Time sample index since the last START arrives at.
+ */
+static uint64_t sampleTime(uint64_t index) {
+	return _pdmStart + index * SIM_NS_PER_SECOND / _stats.sampleRate;
+}
+
+/** @brief Sample of the audio source playing at a time.
+ */
+static uint64_t worldIndex(uint64_t time) {
+	return time / SIM_NS_PER_SECOND * _config.audioRate
+	       + time % SIM_NS_PER_SECOND * _config.audioRate / SIM_NS_PER_SECOND;
+}
+
+/** @brief Put the next sample in the FIFO, or lose it if the FIFO is full.
+ */
+static void pdmSample(void) {
+	uint64_t time = sampleTime(++_pdmIndex);
+	int16_t sample;
+
+	if (!_config.audio(worldIndex(time), &sample)) {
+		finish("end of audio");
+	}
+
+	if (_fifoCount == SIM_PDM_FIFO_DEPTH) {
+		_stats.overflows++;
+		return;
+	}
+	_fifo[(_fifoHead + _fifoCount) % SIM_PDM_FIFO_DEPTH] = sample;
+	_fifoCount++;
+	_stats.samples++;
+
+	if (_fifoCount == SIM_PDM_FIFO_LEVEL && !(PDM->IF & PDM_IF_DVL)) {
+		PDM->IF |= PDM_IF_DVL;
+		_levelTime = time;
+	}
+}
+
+/** @brief Act on a START or STOP command.
+ */
+static void pdmCommand(uint32_t command) {
+	if ((command & PDM_CMD_START) && !_pdmRunning) {
+		_stats.sampleRate = pdmRate();
+		if (_stats.sampleRate == 0) {
+			finish("PDM started without a down sample rate");
+		}
+		_stats.stopped += _now - _pdmStopped;
+		_pdmRunning = true;
+		_pdmStart = _now;
+		_pdmIndex = 0;
+	}
+	if ((command & PDM_CMD_STOP) && _pdmRunning) {
+		_pdmRunning = false;
+		_pdmStopped = _now;
+		_stats.segments++;
+		_awaitingTx = true;
+	}
+}
+
+/** @brief Put a byte on the line after the ones already queued.
+ */
+static void transmit(uint8_t byte) {
+	uint64_t start = _txFree > _now ? _txFree : _now;
+
+	_txFree = start + _byteTime;
+	_stats.bytesSent++;
+	_stats.linkBusy += _byteTime;
+
+	if (_awaitingTx) {
+		uint64_t latency = start - _pdmStopped;
+
+		_stats.latencies++;
+		_stats.latencySum += latency;
+		if (latency > _stats.latencyMax) {
+			_stats.latencyMax = latency;
+		}
+		_awaitingTx = false;
+	}
+
+	if (_tx != NULL) {
+		fputc(byte, _tx);
+	}
+}
+
+/** @brief Apply the register writes made since the last access.
+ */
+static void commitWrites(void) {
+	if (PDM->IFC != 0) {
+		PDM->IF &= ~PDM->IFC;
+		PDM->IFC = 0;
+	}
+
+	switch (_write) {
+		case WRITE_PDM_CMD:
+			pdmCommand(_writeSlot);
+			break;
+		case WRITE_USART_TXDATA:
+			transmit((uint8_t) _writeSlot);
+			break;
+		case WRITE_USART_TXDOUBLE:
+			transmit((uint8_t) _writeSlot);
+			transmit((uint8_t) (_writeSlot >> 8));
+			break;
+		default:
+			break;
+	}
+	_write = WRITE_NONE;
+}
+
+/** @brief If the PDM interrupt is due and may be taken now.
+ */
+static bool interruptDue(void) {
+	return _depth == 0 && !_irqMasked && _pdmIrqEnabled
+	       && (PDM->IF & PDM->IEN & PDM_IF_DVL);
+}
+
+static void catchUp(void);
+
+/** @brief Run the PDM handler now.
+ *
+ * @return Simulated time the handler took.
+ */
+static uint64_t takeInterrupt(void) {
+	uint64_t start = _now;
+
+	_stats.interrupts++;
+	if (_now - _levelTime > _stats.maxIrqLatency) {
+		_stats.maxIrqLatency = _now - _levelTime;
+	}
+
+	_depth++;
+	_lastExit = hostNs();
+	PDM_IRQHandler();
+	catchUp();
+	_depth--;
+
+	return _now - start;
+}
+
+/** @brief Move the clock on by a stretch of firmware execution, taking the
+ * interrupts that come due on the way. Within a handler, samples keep
+ * arriving but no interrupt is taken.
+ */
+static void run(uint64_t duration) {
+	uint64_t until = _now + duration;
+
+	while (true) {
+		if (interruptDue()) {
+			until += takeInterrupt();
+			continue;
+		}
+		if (!_pdmRunning || sampleTime(_pdmIndex + 1) > until) {
+			break;
+		}
+		if (sampleTime(_pdmIndex + 1) > _now) {
+			_now = sampleTime(_pdmIndex + 1);
+		}
+		pdmSample();
+	}
+
+	if (until > _now) {
+		_now = until;
+	}
+}
+
+/** @brief Bring the simulation up to the firmware's current point: apply its
+ * writes, then account for the time it ran.
+ */
+static void catchUp(void) {
+	commitWrites();
+	run(_config.cpuScale > 0
+	    ? (uint64_t) ((hostNs() - _lastExit) * _config.cpuScale) : 0);
+}
+
+/** @brief Start of a register access other than USART STATUS.
+ */
+static void enter(void) {
+	_statusPolls = 0;
+	catchUp();
+}
+
+/** @brief End of a register access, the firmware runs on.
+ */
+static void leave(void) {
+	static bool ticking = false;
+
+	if (_config.tick != NULL && !ticking && _depth == 0 && !_irqMasked) {
+		ticking = true;
+		_config.tick();
+		ticking = false;
+	}
+	if (_config.cpuScale > 0) {
+		_lastExit = hostNs();
+	}
+}
+
+/** @brief If a byte has come in, reading the input.
+ *
+ * @param wait Block until a byte comes or the input closes.
+ */
+static bool receiverReady(bool wait) {
+	struct pollfd input = {.fd = _config.rxFd, .events = POLLIN};
+	uint8_t byte;
+
+	if (_rxByte >= 0) {
+		return true;
+	}
+	if (_rxClosed || _config.rxFd < 0) {
+		return false;
+	}
+
+	if (wait && _tx != NULL) {
+		fflush(_tx);
+	}
+	if (poll(&input, 1, wait ? -1 : 0) > 0) {
+		if (read(_config.rxFd, &byte, 1) == 1) {
+			_rxByte = byte;
+			_stats.bytesReceived++;
+			return true;
+		}
+		_rxClosed = true;
+	}
+
+	return false;
+}
+
+/** PDM registers */
+static uint32_t pdmStatus(void) {
+	uint32_t status;
+
+	enter();
+	status = _fifoCount == 0 ? PDM_STATUS_EMPTY : 0;
+	leave();
+
+	return status;
+}
+
+static uint32_t pdmRxdata(void) {
+	uint32_t data = 0;
+
+	enter();
+	if (_fifoCount > 0) {
+		data = (uint16_t) _fifo[_fifoHead];
+		_fifoHead = (_fifoHead + 1) % SIM_PDM_FIFO_DEPTH;
+		_fifoCount--;
+	}
+	leave();
+
+	return data;
+}
+
+static uint32_t pdmSyncbusy(void) {
+	enter();
+	leave();
+
+	return 0;
+}
+
+static volatile uint32_t *pdmCmd(void) {
+	enter();
+	_write = WRITE_PDM_CMD;
+	leave();
+
+	return &_writeSlot;
+}
+
+/** USART registers */
+static uint32_t usartStatus(void) {
+	bool spinning = _statusPolls > 0;
+	uint32_t status = 0;
+
+	catchUp();
+
+	if (spinning && _txFree > _now + _byteTime) {
+		run(_txFree - _byteTime - _now);
+	}
+	// spinning past TXBL, so on the receiver. The firmware's own time can set
+	// TXBL between reads, that read is not spinning on the receiver yet.
+	else if (spinning && _lastTxbl && !receiverReady(false)) {
+		if (_pdmRunning) {
+			run(_byteTime);
+		}
+		else if (!receiverReady(true)) {
+			finish("link input closed while the firmware waits on it");
+		}
+	}
+
+	if (_txFree <= _now + _byteTime) {
+		status |= USART_STATUS_TXBL;
+	}
+	if (receiverReady(false)) {
+		status |= USART_STATUS_RXDATAV;
+	}
+	_lastTxbl = (status & USART_STATUS_TXBL) != 0;
+	_statusPolls++;
+	leave();
+
+	return status;
+}
+
+static uint32_t usartRxdata(void) {
+	uint32_t data = 0;
+
+	enter();
+	if (receiverReady(false)) {
+		data = (uint8_t) _rxByte;
+		_rxByte = -1;
+	}
+	leave();
+
+	return data;
+}
+
+static volatile uint32_t *usartTxdata(void) {
+	enter();
+	_write = WRITE_USART_TXDATA;
+	leave();
+
+	return &_writeSlot;
+}
+
+static volatile uint32_t *usartTxdouble(void) {
+	enter();
+	_write = WRITE_USART_TXDOUBLE;
+	leave();
+
+	return &_writeSlot;
+}
+
+/** Cycle counter */
+static uint32_t dwtCyccnt(void) {
+	uint64_t cycles;
+
+	enter();
+	cycles = _now / SIM_NS_PER_SECOND * SIM_CORE_CLOCK
+	         + _now % SIM_NS_PER_SECOND * SIM_CORE_CLOCK / SIM_NS_PER_SECOND;
+	leave();
+
+	return (uint32_t) cycles;
+}
+
+/** WTIMER0, counting up from the start of the simulation at SIM_CORE_CLOCK
+ * over its prescaler. START is taken as given. */
+static uint32_t timerCnt(void) {
+	uint64_t cycles;
+
+	enter();
+	cycles = _now / SIM_NS_PER_SECOND * SIM_CORE_CLOCK
+	         + _now % SIM_NS_PER_SECOND * SIM_CORE_CLOCK / SIM_NS_PER_SECOND;
+	leave();
+
+	return (uint32_t) (cycles >> ((simWtimer0.CTRL & _TIMER_CTRL_PRESC_MASK)
+	                              >> _TIMER_CTRL_PRESC_SHIFT));
+}
+
+static volatile uint32_t *timerCmd(void) {
+	static volatile uint32_t command;
+
+	return &command;
+}
+
+/** @brief Set the simulated line's baud rate.
+ */
+void USART_InitAsync(SimUsart_TypeDef *usart,
+                     const USART_InitAsync_TypeDef *init) {
+	(void) usart;
+
+	enter();
+	_byteTime = 10 * SIM_NS_PER_SECOND / init->baudrate;
+	leave();
+}
+
+/** @brief Sleep until an interrupt is taken, or until one is pending while
+ * interrupts are masked.
+ */
+void EMU_EnterEM1(void) {
+	uint64_t interrupts;
+
+	enter();
+	interrupts = _stats.interrupts;
+	while (_stats.interrupts == interrupts
+	       && !(_irqMasked && (PDM->IF & PDM->IEN & PDM_IF_DVL))) {
+		if (!_pdmRunning || !_pdmIrqEnabled || !(PDM->IEN & PDM_IEN_DVL)) {
+			finish("asleep with no interrupt to wake it");
+		}
+		run(sampleTime(_pdmIndex + 1) - _now);
+	}
+	leave();
+}
+
+/** Interrupt masking and NVIC */
+void __disable_irq(void) {
+	enter();
+	_irqMasked = true;
+	leave();
+}
+
+void __enable_irq(void) {
+	_irqMasked = false;
+	enter();
+	leave();
+}
+
+void NVIC_EnableIRQ(int irq) {
+	if (irq == PDM_IRQn) {
+		_pdmIrqEnabled = true;
+	}
+	enter();
+	leave();
+}
+
+void NVIC_DisableIRQ(int irq) {
+	enter();
+	if (irq == PDM_IRQn) {
+		_pdmIrqEnabled = false;
+	}
+	leave();
+}
+
+void NVIC_ClearPendingIRQ(int irq) {
+	(void) irq;
+}
+
+/** @brief Set up the simulation, before the firmware starts.
+ *
+ * @param config Audio source, link and CPU time scale.
+ */
+void simDevice_init(struct SimConfig config) {
+	_config = config;
+	_tx = config.txFd >= 0 ? fdopen(config.txFd, "wb") : NULL;
+	_lastExit = hostNs();
+}
+
+/** @brief Statistics of the simulation so far.
+ */
+void simDevice_stats(struct SimStats *stats) {
+	*stats = _stats;
+	stats->time = _now;
+	if (!_pdmRunning) {
+		stats->stopped += _now - _pdmStopped;
+	}
+}
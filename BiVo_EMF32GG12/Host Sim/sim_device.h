@@ -0,0 +1,80 @@
+/** @file sim_device.h
+ * @brief Simulated EFM32GG12 peripherals and clock for the host build.
+ *
+ * The simulated time only moves when the firmware touches a simulated
+ * register or sleeps, see sim_device.c. The microphone hears a world clocked
+ * by the audio source, so audio keeps going by while the PDM is stopped, as it
+ * would on the board.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#ifndef HOST_SIM_SIM_DEVICE_H_
+#define HOST_SIM_SIM_DEVICE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "em_device.h"
+
+#define SIM_CORE_CLOCK 19000000			// core clock, HFRCO at its reset band
+#define SIM_PDM_CLOCK 19104000			// PDM clock, as BASE_CLK_RATE in mic_drv.h
+#define SIM_PDM_FIFO_DEPTH 4				// samples the PDM FIFO holds
+#define SIM_PDM_FIFO_LEVEL 4				// samples for the data valid interrupt
+#define SIM_NS_PER_SECOND 1000000000ULL
+
+/** @brief Supplies the sound the microphone hears.
+ *
+ * @param index Sample of the world, at the source's rate. Never decreases from
+ * one call to the next.
+ * @param sample Written with the sample.
+ * @return false when the audio has run out.
+ */
+typedef bool (*SimAudioSource)(uint64_t index, int16_t *sample);
+
+/** @brief Called when the simulation cannot go on, does not return.
+ */
+typedef void (*SimFinish)(const char *reason);
+
+/** @brief Called as the firmware resumes after a register access, outside
+ * interrupt handlers and with interrupts unmasked, so it may read the
+ * firmware's state and call into it.
+ */
+typedef void (*SimTick)(void);
+
+/* Simulation Configuration */
+struct SimConfig {
+		double cpuScale;				// simulated ns per host ns the firmware runs, 0 for none
+		int rxFd;								// bytes from the host application, -1 for none
+		int txFd;								// bytes to the host application, -1 to discard
+		SimAudioSource audio;
+		uint32_t audioRate;			// sample rate of the audio source
+		SimFinish finish;
+		SimTick tick;						// NULL for none
+};
+
+/** @struct Simulation Statistics
+ * Times are in simulated ns.
+ */
+struct SimStats {
+		uint64_t time;
+		uint32_t sampleRate;		// PDM rate set by the firmware, 0 before the first start
+		uint64_t samples;				// samples put in the PDM FIFO
+		uint64_t overflows;			// samples lost to a full FIFO
+		uint64_t stopped;				// time the PDM was stopped, audio not heard
+		uint64_t interrupts;
+		uint64_t maxIrqLatency;	// longest time from a FIFO level to its handler
+		uint64_t bytesSent;
+		uint64_t bytesReceived;
+		uint64_t linkBusy;			// time the transmitter was shifting bytes out
+		uint32_t segments;			// recordings ended by stopping the PDM
+		uint32_t latencies;			// segments followed by a transmission
+		uint64_t latencySum;		// from each segment's end to the next byte sent
+		uint64_t latencyMax;
+};
+
+/** Function Prototypes */
+void simDevice_init(struct SimConfig config);
+void simDevice_stats(struct SimStats *stats);
+
+#endif /* HOST_SIM_SIM_DEVICE_H_ */
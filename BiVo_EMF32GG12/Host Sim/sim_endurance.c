@@ -0,0 +1,555 @@
+/** @file sim_endurance.c
+ * @brief Endurance run of the host simulation.
+ *
+ * Audio: generated, two second scenes picked at random from quiet and loud
+ * noise, silence, and calls of random pitch, chirp and length, some loud
+ * enough to clip. The generator is a function of the sample index, so a run is
+ * the same audio every time.
+ *
+ * Commands: a thread stands in for the desktop application over pipes. In the
+ * standard and stream modes it handshakes, sometimes asks for the profile, and
+ * asks for a segment, over and over. In the events mode it handshakes once,
+ * then asks for a summary, the kept segment or the profile after every minute
+ * of level records.
+ *
+ * Measured in each of SIM_ENDURANCE_WINDOWS windows of the run:
+ * 	live heap, peak bytes allocated by the firmware (malloc and friends are
+ * 		wrapped at link time)
+ * 	heap extent, bytes the allocator holds, and its fragmentation, the share of
+ * 		them free but not at the top of the heap
+ * 	stack depth, the deepest the stack has been painted over so far
+ * 	analysis time, median host us per segment, from the profiler
+ * 	latency, median simulated time from the end of a segment to the next byte
+ * 		sent. The firmware's processing only counts with a cpu scale, so the
+ * 		run uses SIM_ENDURANCE_CPU_SCALE unless one is given.
+ *
+ * After the warm-up windows, the second half of the windows is set against the
+ * first. The run fails if the heap or stack grew past its slack, or if the
+ * median window's analysis time or latency grew by SIM_TIME_GROWTH. Times are
+ * host times: a median is not moved by the few segments a busy host slowed, or
+ * by how many segments of a window happened to hold calls. Host numbers stand
+ * in for the board's, what matters is that they stay flat.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "sim_endurance.h"
+#include "profiler.h"
+
+/** @struct What one window measured.
+ */
+struct SimWindow {
+		uint64_t heapPeak;
+		uint64_t heapExtent;
+		double fragmentation;
+		uint64_t stackDepth;
+		uint32_t segments;
+		double analysisUs;			// median of the segments analyzed
+		uint32_t latencies;
+		double latencyUs;				// median of the segments followed by a transmission
+};
+
+/** Run */
+static uint64_t _length = 0;				// samples of audio
+static uint64_t _windowNs = 0;			// simulated length of a window
+static int _window = 0;							// window being measured
+static struct SimWindow _windows[SIM_ENDURANCE_WINDOWS];
+static struct ProfilerRegion _lastAnalysis;
+static struct SimStats _lastStats;
+
+/** @struct Times of the current window, for their median.
+ */
+struct SimTimes {
+		uint32_t ns[SIM_WINDOW_SEGMENTS];
+		int count;
+};
+static struct SimTimes _analysisTimes;	// of each segment analyzed
+static struct SimTimes _latencyTimes;		// of each segment followed by a transmission
+
+/** Heap, the firmware runs on one thread */
+static uint64_t _heapLive = 0;
+static uint64_t _heapPeak = 0;
+
+/** Stack */
+static uintptr_t _stackLow = 0;			// lowest byte painted
+static uintptr_t _stackBase = 0;		// top of the painted area, where the firmware starts
+
+/** Link, as seen by the application */
+static int _toBoard = -1;
+static int _fromBoard = -1;
+
+/** Heap wrappers, see the link of bivo_sim */
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *pointer, size_t size);
+void __real_free(void *pointer);
+
+static void heapAdd(void *pointer) {
+	if (pointer != NULL) {
+		_heapLive += malloc_usable_size(pointer);
+		if (_heapLive > _heapPeak) {
+			_heapPeak = _heapLive;
+		}
+	}
+}
+
+void *__wrap_malloc(size_t size) {
+	void *pointer = __real_malloc(size);
+
+	heapAdd(pointer);
+	return pointer;
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+	void *pointer = __real_calloc(count, size);
+
+	heapAdd(pointer);
+	return pointer;
+}
+
+void *__wrap_realloc(void *pointer, size_t size) {
+	uint64_t old = pointer != NULL ? malloc_usable_size(pointer) : 0;
+	void *moved = __real_realloc(pointer, size);
+
+	if (moved != NULL || size == 0) {
+		_heapLive -= old;
+		heapAdd(moved);
+	}
+	return moved;
+}
+
+void __wrap_free(void *pointer) {
+	if (pointer != NULL) {
+		_heapLive -= malloc_usable_size(pointer);
+	}
+	__real_free(pointer);
+}
+
+/** @brief Paint the stack below the caller, to find later how deep the
+ * firmware has used it. Call right before starting the firmware.
+ */
+__attribute__((noinline)) void simEndurance_paintStack(void) {
+	uint8_t area[SIM_STACK_PAINT];
+
+	memset(area, 0xA5, sizeof(area));
+	// keep the painting, though the area is not read here
+	__asm__ volatile ("" : : "r" (area) : "memory");
+	// the area is left, but the stack below the firmware keeps the paint
+	_stackLow = (uintptr_t) area;
+	_stackBase = (uintptr_t) &area[SIM_STACK_PAINT];
+}
+
+/** @brief Deepest the stack has been used, in bytes from where the firmware
+ * started.
+ */
+static uint64_t stackDepth(void) {
+	const volatile uint8_t *byte = (const volatile uint8_t*) _stackLow;
+
+	if (_stackLow == 0) {
+		return 0;
+	}
+	while ((uintptr_t) byte < _stackBase && *byte == 0xA5) {
+		byte++;
+	}
+
+	return _stackBase - (uintptr_t) byte;
+}
+
+/** @brief Add the mean of the times that ended since the last read, one
+ * time as a rule.
+ */
+static void addTime(struct SimTimes *times, uint64_t sum, uint32_t count) {
+	if (count > 0 && times->count < SIM_WINDOW_SEGMENTS) {
+		times->ns[times->count++] = sum / count;
+	}
+}
+
+static int compareTimes(const void *a, const void *b) {
+	uint32_t first = *(const uint32_t*) a, second = *(const uint32_t*) b;
+
+	return (first > second) - (first < second);
+}
+
+/** @brief Median of the window's times in us, and start the next window's.
+ */
+static double takeMedianUs(struct SimTimes *times) {
+	int count = times->count;
+	double median;
+
+	if (count == 0) {
+		return 0.0;
+	}
+	qsort(times->ns, count, sizeof(uint32_t), compareTimes);
+	median = count % 2 == 1 ? times->ns[count / 2]
+	    : (times->ns[count / 2 - 1] + (double) times->ns[count / 2]) / 2.0;
+	times->count = 0;
+
+	return median / 1e3;
+}
+
+/** @brief Close the current window and start the next. Reads the profiler,
+ * which masks interrupts through the simulation, so it is called from the
+ * tick rather than the audio source.
+ */
+static void closeWindow(void) {
+	struct SimWindow *window = &_windows[_window];
+	struct ProfilerRegion analysis;
+	struct SimStats stats;
+	struct mallinfo2 heap = mallinfo2();
+
+	profiler_region(PROFILE_ANALYZE, &analysis);
+	simDevice_stats(&stats);
+
+	window->heapPeak = _heapPeak;
+	window->heapExtent = heap.arena;
+	window->fragmentation = heap.arena > 0
+	    ? (double) (heap.fordblks - heap.keepcost) / heap.arena : 0.0;
+	window->stackDepth = stackDepth();
+	window->segments = analysis.count - _lastAnalysis.count;
+	window->analysisUs = takeMedianUs(&_analysisTimes);
+	window->latencies = stats.latencies - _lastStats.latencies;
+	window->latencyUs = takeMedianUs(&_latencyTimes);
+
+	_lastAnalysis = analysis;
+	_lastStats = stats;
+	_heapPeak = _heapLive;
+	_window++;
+}
+
+/** @brief Random bits of a number, for the generator.
+ */
+static uint32_t hash(uint64_t value) {
+	value ^= value >> 33;
+	value *= 0xff51afd7ed558ccdULL;
+	value ^= value >> 33;
+	value *= 0xc4ceb9fe1a85ec53ULL;
+	value ^= value >> 33;
+	return (uint32_t) value;
+}
+
+/** @brief Take the times of the segments since the last read, and close the
+ * windows the run has passed, see SimTick.
+ */
+static void endurance_tick(void) {
+	static struct ProfilerRegion lastAnalysis;
+	static struct SimStats lastStats;
+	struct ProfilerRegion analysis;
+	struct SimStats stats;
+
+	simDevice_stats(&stats);
+
+	// times of each segment, read often enough to see the segments one by one
+	if (stats.time >= lastStats.time + SIM_SEGMENT_POLL_NS) {
+		profiler_region(PROFILE_ANALYZE, &analysis);
+		addTime(&_analysisTimes, analysis.sum - lastAnalysis.sum,
+		        analysis.count - lastAnalysis.count);
+		addTime(&_latencyTimes, stats.latencySum - lastStats.latencySum,
+		        stats.latencies - lastStats.latencies);
+		lastAnalysis = analysis;
+		lastStats = stats;
+	}
+
+	while (_window < SIM_ENDURANCE_WINDOWS && stats.time >= (_window + 1) * _windowNs) {
+		closeWindow();
+	}
+}
+
+/** @brief Generated audio, see SimAudioSource.
+ */
+static bool endurance_sample(uint64_t index, int16_t *sample) {
+	uint64_t sceneLength = 2 * SIM_ENDURANCE_RATE;
+	uint32_t scene = hash(index / sceneLength);
+	double t = (double) (index % sceneLength) / SIM_ENDURANCE_RATE;
+	int32_t noise = (int32_t) (hash(index + 0x5eed) & 0xFFFF) - 0x8000;
+	double value;
+
+	if (index >= _length) {
+		return false;
+	}
+
+	switch (scene % 8) {
+		case 0: case 1: case 2:		// quiet
+			value = noise / 256.0;
+			break;
+		case 3:										// rain or wind
+			value = noise / 8.0;
+			break;
+		case 4: case 5: case 6: {	// call
+			double start = (scene >> 8) % 100 / 100.0;
+			double length = 0.1 + (scene >> 16) % 140 / 100.0;
+			double freq = 1500.0 + (scene >> 4) % 6000;
+			double chirp = (double) ((int) ((scene >> 20) % 4000) - 2000);
+			double amplitude = scene % 8 == 6 ? 40000.0 : 3000.0;
+
+			value = noise / 128.0;
+			if (t >= start && t < start + length) {
+				value += amplitude * sin(2.0 * M_PI * (freq + chirp * (t - start) / 2.0)
+				                         * (t - start));
+			}
+			break;
+		}
+		default:									// silence
+			value = 0.0;
+			break;
+	}
+
+	*sample = value > 32767.0 ? 32767 : value < -32768.0 ? -32768 : (int16_t) value;
+	return true;
+}
+
+/** @brief Send a command to the board.
+ */
+static void sendCommand(const char *command) {
+	if (write(_toBoard, command, 5) != 5) {
+		pthread_exit(NULL);
+	}
+}
+
+/** @brief Next byte from the board, the thread ends with the link.
+ */
+static uint8_t nextByte(void) {
+	static uint8_t buffer[4096];
+	static ssize_t length = 0, position = 0;
+
+	if (position == length) {
+		length = read(_fromBoard, buffer, sizeof(buffer));
+		position = 0;
+		if (length <= 0) {
+			pthread_exit(NULL);
+		}
+	}
+
+	return buffer[position++];
+}
+
+/** @brief Read from the board until a message has come.
+ */
+static void awaitMessage(const char *message) {
+	char window[5] = {0};
+
+	while (memcmp(window, message, 5) != 0) {
+		memmove(window, &window[1], 4);
+		window[4] = nextByte();
+	}
+}
+
+#if BIVO_OP_MODE == 1
+/** @brief Read from the board until a number of level records have come.
+ */
+static void awaitLevels(int count) {
+	uint8_t window[3] = {0};
+
+	while (count > 0) {
+		window[0] = window[1];
+		window[1] = window[2];
+		window[2] = nextByte();
+		if (window[0] == RECORD_SYNC && window[1] == RECORD_LEVEL
+		    && window[2] == sizeof(struct LevelRecord)) {
+			count--;
+		}
+	}
+}
+#endif
+
+/** @brief The desktop application, see the file comment.
+ */
+static void *application(void *unused) {
+	uint32_t seed = 1;
+
+	sendCommand("hands");
+	awaitMessage("cnfrm");
+	sendCommand("ackng");
+
+#if BIVO_OP_MODE == 1
+	while (true) {
+		awaitLevels(60);
+		seed = hash(seed);
+		switch (seed % 3) {
+			case 0:
+				sendCommand("sumry");
+				break;
+			case 1:
+				sendCommand("fetch");
+				awaitMessage("-end-");
+				break;
+			default:
+				sendCommand("profl");
+				break;
+		}
+	}
+#else
+	while (true) {
+		seed = hash(seed);
+		if (seed % 10 == 0) {
+			sendCommand("profl");
+		}
+		sendCommand("recrd");
+		awaitMessage("-end-");
+
+		sendCommand("hands");
+		awaitMessage("cnfrm");
+		sendCommand("ackng");
+	}
+#endif
+
+	return NULL;
+}
+
+/** @brief Set up an endurance run: the audio source, and the link to a thread
+ * standing in for the application.
+ *
+ * @param hours Simulated length of the run.
+ * @param config Audio and link settings are filled in, and the cpu scale if
+ * it is 0.
+ */
+void simEndurance_start(double hours, struct SimConfig *config) {
+	int toBoard[2], fromBoard[2];
+	pthread_t thread;
+
+	// the audio runs a little past the last window, so the tick closes it
+	_windowNs = (uint64_t) (hours * 3600.0 * SIM_NS_PER_SECOND / SIM_ENDURANCE_WINDOWS);
+	_length = (uint64_t) ((hours * 3600.0 + SIM_ENDURANCE_TAIL) * SIM_ENDURANCE_RATE);
+	if (_windowNs < SIM_NS_PER_SECOND) {
+		fprintf(stderr, "endurance run too short\n");
+		exit(1);
+	}
+
+	if (pipe(toBoard) != 0 || pipe(fromBoard) != 0) {
+		perror("pipe");
+		exit(1);
+	}
+	config->rxFd = toBoard[0];
+	config->txFd = fromBoard[1];
+	config->audio = endurance_sample;
+	config->audioRate = SIM_ENDURANCE_RATE;
+	config->tick = endurance_tick;
+	if (config->cpuScale <= 0.0) {
+		config->cpuScale = SIM_ENDURANCE_CPU_SCALE;
+	}
+	_toBoard = toBoard[1];
+	_fromBoard = fromBoard[0];
+
+	if (pthread_create(&thread, NULL, application, NULL) != 0) {
+		perror("application thread");
+		exit(1);
+	}
+}
+
+/** @brief Growth of a measure from the first to the second half of the checked
+ * windows, as the largest value of each half.
+ */
+static void halves(size_t offset, bool isDouble, double *first, double *second) {
+	int checked = _window - SIM_ENDURANCE_WARMUP;
+
+	*first = 0.0;
+	*second = 0.0;
+	for (int index=SIM_ENDURANCE_WARMUP; index<_window; index++) {
+		const uint8_t *field = (const uint8_t*) &_windows[index] + offset;
+		double value = isDouble ? *(const double*) field : *(const uint64_t*) field;
+		double *half = index - SIM_ENDURANCE_WARMUP < checked / 2 ? first : second;
+
+		if (value > *half) {
+			*half = value;
+		}
+	}
+}
+
+static int compareDoubles(const void *a, const void *b) {
+	double difference = *(const double*) a - *(const double*) b;
+
+	return (difference > 0.0) - (difference < 0.0);
+}
+
+/** @brief Median of a per window mean over each half of the checked windows,
+ * leaving out windows where the count it is a mean of is 0.
+ */
+static void medianHalves(size_t offset, size_t countOffset, double *first,
+                         double *second) {
+	int checked = _window - SIM_ENDURANCE_WARMUP;
+	double values[2][SIM_ENDURANCE_WINDOWS];
+	int counts[2] = {0, 0};
+	double *medians[2] = {first, second};
+
+	for (int index=SIM_ENDURANCE_WARMUP; index<_window; index++) {
+		const uint8_t *window = (const uint8_t*) &_windows[index];
+		int half = index - SIM_ENDURANCE_WARMUP < checked / 2 ? 0 : 1;
+
+		if (*(const uint32_t*) (window + countOffset) > 0) {
+			values[half][counts[half]++] = *(const double*) (window + offset);
+		}
+	}
+	for (int half=0; half<2; half++) {
+		qsort(values[half], counts[half], sizeof(double), compareDoubles);
+		*medians[half] = counts[half] == 0 ? 0.0
+		    : counts[half] % 2 == 1 ? values[half][counts[half] / 2]
+		    : (values[half][counts[half] / 2 - 1] + values[half][counts[half] / 2]) / 2.0;
+	}
+}
+
+/** @brief Print the windows and check them.
+ *
+ * @return false if a measure kept growing.
+ */
+bool simEndurance_report(void) {
+	double first, second;
+	bool passed = true;
+
+	fprintf(stderr, "endurance: window  hours  heap_peak  heap_extent  fragmented  "
+	        "stack  segments  analysis_us  latency_us\n");
+	for (int index=0; index<_window; index++) {
+		const struct SimWindow *window = &_windows[index];
+
+		fprintf(stderr, "endurance: %6d %6.1f %10llu %12llu %10.1f%% %6llu %9u "
+		        "%12.1f %11.1f\n", index,
+		        (double) (index + 1) * _windowNs / SIM_NS_PER_SECOND / 3600.0,
+		        (unsigned long long) window->heapPeak,
+		        (unsigned long long) window->heapExtent, 100.0 * window->fragmentation,
+		        (unsigned long long) window->stackDepth, window->segments,
+		        window->analysisUs, window->latencyUs);
+	}
+	if (_window - SIM_ENDURANCE_WARMUP < 2) {
+		fprintf(stderr, "endurance: FAILED, the run ended before it could be checked\n");
+		return false;
+	}
+
+	halves(offsetof(struct SimWindow, heapPeak), false, &first, &second);
+	if (second > first + SIM_HEAP_SLACK) {
+		fprintf(stderr, "endurance: live heap grew from %.0f to %.0f bytes\n", first, second);
+		passed = false;
+	}
+	halves(offsetof(struct SimWindow, heapExtent), false, &first, &second);
+	if (second > first * 1.01 + SIM_EXTENT_SLACK) {
+		fprintf(stderr, "endurance: heap extent grew from %.0f to %.0f bytes\n", first, second);
+		passed = false;
+	}
+	halves(offsetof(struct SimWindow, stackDepth), false, &first, &second);
+	if (second > first + SIM_STACK_SLACK) {
+		fprintf(stderr, "endurance: stack grew from %.0f to %.0f bytes\n", first, second);
+		passed = false;
+	}
+	medianHalves(offsetof(struct SimWindow, analysisUs),
+	             offsetof(struct SimWindow, segments), &first, &second);
+	if (second > first * SIM_TIME_GROWTH) {
+		fprintf(stderr, "endurance: analysis time grew from %.1f to %.1f us\n", first, second);
+		passed = false;
+	}
+	medianHalves(offsetof(struct SimWindow, latencyUs),
+	             offsetof(struct SimWindow, latencies), &first, &second);
+	if (second > first * SIM_TIME_GROWTH + SIM_LATENCY_SLACK) {
+		fprintf(stderr, "endurance: latency grew from %.1f to %.1f us\n", first, second);
+		passed = false;
+	}
+
+	fprintf(stderr, "endurance: %s\n", passed ? "passed" : "FAILED");
+	return passed;
+}
@@ -0,0 +1,38 @@
+/** @file sim_endurance.h
+ * @brief Endurance run of the host simulation, hours of mixed audio and
+ * commands checked for resources that keep growing.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#ifndef HOST_SIM_SIM_ENDURANCE_H_
+#define HOST_SIM_SIM_ENDURANCE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sim_device.h"
+
+#define SIM_ENDURANCE_RATE 19900			// rate of the generated audio
+#define SIM_ENDURANCE_WINDOWS 24			// windows the run is measured in
+#define SIM_ENDURANCE_WARMUP 2				// first windows, left out of the checks
+#define SIM_ENDURANCE_TAIL 60				// s of audio past the last window
+#define SIM_STACK_PAINT (1024 * 1024)	// bytes of stack painted to find its depth
+#define SIM_WINDOW_SEGMENTS 4096			// segment times a window keeps for its median
+#define SIM_SEGMENT_POLL_NS 250000000	// simulated ns between reads of the segment times
+#define SIM_ENDURANCE_CPU_SCALE 1.0		// cpu scale of a run without -c, so the
+																		// latency counts processing time
+
+/** Growth allowed from the first to the second half of the checked windows */
+#define SIM_HEAP_SLACK 0							// bytes of live heap
+#define SIM_EXTENT_SLACK 4096					// bytes of heap extent, plus 1%
+#define SIM_STACK_SLACK 256						// bytes of stack
+#define SIM_TIME_GROWTH 1.5						// ratio of median analysis time and latency
+#define SIM_LATENCY_SLACK 50					// us of latency, plus the ratio
+
+/** Function Prototypes */
+void simEndurance_paintStack(void);
+void simEndurance_start(double hours, struct SimConfig *config);
+bool simEndurance_report(void);
+
+#endif /* HOST_SIM_SIM_ENDURANCE_H_ */
@@ -0,0 +1,193 @@
+/** @file sim_main.c
+ * @brief Host simulation of the BiVo firmware.
+ *
+ * Runs main.c, the Modules and the Operation Modes unchanged on the host,
+ * against simulated PDM and USART peripherals (sim_device.c). The microphone
+ * hears WAV files and the serial link is a pipe, a file or a pseudo-terminal
+ * the desktop application can open. Time is simulated, so the pipeline runs
+ * as fast as the host allows, and a report of throughput and latency is
+ * printed to stderr at the end.
+ *
+ * Usage: bivo_sim [-c scale] [-i input] [-o output] [-p] audio.wav...
+ * 		bivo_sim [-c scale] -e hours
+ * 	-c	Simulated ns per host ns the firmware runs. 0, the default, counts
+ * 			only audio and link time. Set it to the board's slowdown relative to
+ * 			the host to count processing time as well. An endurance run
+ * 			uses SIM_ENDURANCE_CPU_SCALE unless given one.
+ * 	-i	File or pipe of bytes the application sends, - for stdin.
+ * 	-o	File or pipe for the bytes the board sends, - for stdout.
+ * 	-p	Open a pseudo-terminal for the link, instead of -i and -o.
+ * 	-e	Endurance run of so many simulated hours, on generated audio and a
+ * 			simulated application (sim_endurance.c). Exits with status 1 if a
+ * 			resource kept growing.
+ *
+ * The simulation ends when the audio runs out, or when the firmware waits on
+ * a link input that has closed.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#define _XOPEN_SOURCE 600
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include <time.h>
+#include "sim_device.h"
+#include "sim_wav.h"
+#include "sim_endurance.h"
+
+/** Firmware entry, main.c's main renamed by the build */
+int bivo_main(void);
+
+/** Host time the simulation started, for the real time factor */
+static struct timespec _started;
+
+/** Whether this is an endurance run */
+static bool _endurance = false;
+
+/** @brief Open a file for the link, - for a standard stream.
+ */
+static int openLink(const char *path, int flags, int standard) {
+	int fd;
+
+	if (strcmp(path, "-") == 0) {
+		return standard;
+	}
+	fd = open(path, flags, 0644);
+	if (fd < 0) {
+		perror(path);
+		exit(1);
+	}
+
+	return fd;
+}
+
+/** @brief Open a pseudo-terminal in raw mode for the link and print its name.
+ * The simulator holds the terminal's own end open too, so the link does not
+ * read as closed before the application opens it.
+ */
+static int openTerminal(void) {
+	struct termios mode;
+	int master = posix_openpt(O_RDWR | O_NOCTTY);
+	const char *name;
+
+	if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0
+	    || (name = ptsname(master)) == NULL || open(name, O_RDWR | O_NOCTTY) < 0) {
+		perror("pseudo-terminal");
+		exit(1);
+	}
+	tcgetattr(master, &mode);
+	cfmakeraw(&mode);
+	tcsetattr(master, TCSANOW, &mode);
+
+	fprintf(stderr, "bivo_sim: link on %s\n", name);
+	return master;
+}
+
+/** @brief Print the report and end, see SimFinish.
+ */
+static void report(const char *reason) {
+	struct SimStats stats;
+	struct timespec now;
+	double wall, simulated;
+
+	simDevice_stats(&stats);
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	wall = (now.tv_sec - _started.tv_sec) + (now.tv_nsec - _started.tv_nsec) / 1e9;
+	simulated = stats.time / 1e9;
+
+	fprintf(stderr, "bivo_sim: %s\n", reason);
+	fprintf(stderr, "time: %.3f s simulated in %.3f s, %.1fx real time\n",
+	        simulated, wall, wall > 0 ? simulated / wall : 0.0);
+	fprintf(stderr, "audio: %llu samples at %u Hz, %llu lost to FIFO overflow, "
+	        "not listening %.1f%% of the time\n",
+	        (unsigned long long) stats.samples, stats.sampleRate,
+	        (unsigned long long) stats.overflows,
+	        stats.time > 0 ? 100.0 * stats.stopped / stats.time : 0.0);
+	fprintf(stderr, "interrupts: %llu, longest latency %.1f us\n",
+	        (unsigned long long) stats.interrupts, stats.maxIrqLatency / 1e3);
+	fprintf(stderr, "link: %llu bytes sent, busy %.1f%% of the time, "
+	        "%llu bytes received\n",
+	        (unsigned long long) stats.bytesSent,
+	        stats.time > 0 ? 100.0 * stats.linkBusy / stats.time : 0.0,
+	        (unsigned long long) stats.bytesReceived);
+	fprintf(stderr, "segments: %u, %u followed by a transmission, latency "
+	        "mean %.1f ms, max %.1f ms\n",
+	        stats.segments, stats.latencies,
+	        stats.latencies > 0 ? stats.latencySum / 1e6 / stats.latencies : 0.0,
+	        stats.latencyMax / 1e6);
+
+	if (_endurance && !simEndurance_report()) {
+		exit(1);
+	}
+}
+
+/** @brief Print the usage and end.
+ */
+static void usage(const char *name) {
+	fprintf(stderr, "usage: %s [-c scale] [-i input] [-o output] [-p] audio.wav...\n"
+	        "       %s [-c scale] -e hours\n", name, name);
+	exit(1);
+}
+
+int main(int argc, char **argv) {
+	struct SimConfig config = {
+			.cpuScale = 0.0,
+			.rxFd = -1,
+			.txFd = -1,
+			.audio = simWav_sample,
+			.finish = report
+		};
+	double hours = 0.0;
+	int option;
+
+	while ((option = getopt(argc, argv, "c:e:i:o:p")) != -1) {
+		switch (option) {
+			case 'c':
+				config.cpuScale = atof(optarg);
+				break;
+			case 'e':
+				hours = atof(optarg);
+				_endurance = true;
+				break;
+			case 'i':
+				config.rxFd = openLink(optarg, O_RDONLY, STDIN_FILENO);
+				break;
+			case 'o':
+				config.txFd = openLink(optarg, O_WRONLY | O_CREAT | O_TRUNC, STDOUT_FILENO);
+				break;
+			case 'p':
+				config.rxFd = openTerminal();
+				config.txFd = dup(config.rxFd);
+				break;
+			default:
+				usage(argv[0]);
+		}
+	}
+	// an endurance run brings its own audio and link
+	if (_endurance ? optind < argc || config.rxFd >= 0 || config.txFd >= 0
+	               : optind >= argc) {
+		usage(argv[0]);
+	}
+
+	if (_endurance) {
+		simEndurance_start(hours, &config);
+	} else {
+		config.audioRate = simWav_open(&argv[optind], argc - optind);
+	}
+	simDevice_init(config);
+	clock_gettime(CLOCK_MONOTONIC, &_started);
+
+	if (_endurance) {
+		simEndurance_paintStack();
+	}
+	bivo_main();
+
+	report("firmware returned");
+	return 0;
+}
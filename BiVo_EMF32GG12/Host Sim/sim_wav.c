@@ -0,0 +1,170 @@
+/** @file sim_wav.c
+ * @brief WAV files played back to back as the sound the simulated microphone
+ * hears. Files are 16 bit PCM at one sample rate, the first channel is used.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim_wav.h"
+
+/** Files */
+static char **_paths = NULL;
+static int _count = 0;
+static int _next = 0;						// file opened next
+static uint32_t _rate = 0;
+
+/** Current file */
+static FILE *_file = NULL;
+static uint16_t _channels = 0;
+static uint32_t _remaining = 0;		// frames left in the data chunk
+
+/** Playback position */
+static uint64_t _position = 0;		// world sample the next frame read is
+static int16_t _held = 0;					// last frame read
+
+/** @brief Little endian fields of a header.
+ */
+static uint32_t read32(const uint8_t *bytes) {
+	return bytes[0] | bytes[1] << 8 | bytes[2] << 16 | (uint32_t) bytes[3] << 24;
+}
+
+static uint16_t read16(const uint8_t *bytes) {
+	return bytes[0] | bytes[1] << 8;
+}
+
+/** @brief Open the next file and find its data chunk. Exits on a file that
+ * cannot be played, a simulation on the wrong audio is no use.
+ *
+ * @return false if there are no more files.
+ */
+static bool openNext(void) {
+	uint8_t header[12], chunk[8], format[16];
+	const char *path;
+	uint32_t rate = 0, size;
+	uint16_t bits = 0;
+
+	if (_file != NULL) {
+		fclose(_file);
+		_file = NULL;
+	}
+	if (_next >= _count) {
+		return false;
+	}
+	path = _paths[_next++];
+
+	_file = fopen(path, "rb");
+	if (_file == NULL) {
+		perror(path);
+		exit(1);
+	}
+	if (fread(header, 1, 12, _file) != 12 || memcmp(header, "RIFF", 4) != 0
+	    || memcmp(&header[8], "WAVE", 4) != 0) {
+		fprintf(stderr, "%s: not a WAV file\n", path);
+		exit(1);
+	}
+
+	_channels = 0;
+	while (fread(chunk, 1, 8, _file) == 8) {
+		size = read32(&chunk[4]);
+
+		if (memcmp(chunk, "fmt ", 4) == 0 && size >= 16) {
+			if (fread(format, 1, 16, _file) != 16) {
+				break;
+			}
+			_channels = read16(&format[2]);
+			rate = read32(&format[4]);
+			bits = read16(&format[14]);
+			fseek(_file, size - 16 + (size & 1), SEEK_CUR);
+		}
+		else if (memcmp(chunk, "data", 4) == 0) {
+			if (bits != 16 || _channels == 0) {
+				fprintf(stderr, "%s: only 16 bit PCM is supported\n", path);
+				exit(1);
+			}
+			if (_rate == 0) {
+				_rate = rate;
+			}
+			else if (rate != _rate) {
+				fprintf(stderr, "%s: %u Hz, the first file is %u Hz\n", path, rate, _rate);
+				exit(1);
+			}
+			_remaining = size / (2 * _channels);
+			return true;
+		}
+		else {
+			fseek(_file, size + (size & 1), SEEK_CUR);
+		}
+	}
+
+	fprintf(stderr, "%s: no audio data\n", path);
+	exit(1);
+}
+
+/** @brief Read the next frame, going on to the next file at the end of one.
+ */
+static bool readFrame(void) {
+	int16_t frame[8];
+
+	while (_remaining == 0) {
+		if (!openNext()) {
+			return false;
+		}
+	}
+
+	if (_channels <= 8) {
+		if (fread(frame, 2 * _channels, 1, _file) != 1) {
+			_remaining = 0;
+			return readFrame();
+		}
+	}
+	else {
+		if (fread(frame, 2, 1, _file) != 1) {
+			_remaining = 0;
+			return readFrame();
+		}
+		fseek(_file, 2 * (_channels - 1), SEEK_CUR);
+	}
+	_remaining--;
+
+	_held = (int16_t) read16((const uint8_t*) &frame[0]);
+	_position++;
+	return true;
+}
+
+/** @brief Open the files and their first one.
+ *
+ * @param paths Files, in playing order.
+ * @param count Number of files.
+ * @return Sample rate of the files.
+ */
+uint32_t simWav_open(char **paths, int count) {
+	_paths = paths;
+	_count = count;
+	_next = 0;
+	_rate = 0;
+	_position = 0;
+
+	if (!openNext()) {
+		fprintf(stderr, "no audio files\n");
+		exit(1);
+	}
+
+	return _rate;
+}
+
+/** @brief Sample playing at a point of the world, see SimAudioSource.
+ */
+bool simWav_sample(uint64_t index, int16_t *sample) {
+	while (_position <= index) {
+		if (!readFrame()) {
+			return false;
+		}
+	}
+
+	*sample = _held;
+	return true;
+}
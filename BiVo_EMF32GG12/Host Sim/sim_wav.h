@@ -0,0 +1,19 @@
+/** @file sim_wav.h
+ * @brief WAV files played back to back as the sound the simulated microphone
+ * hears.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#ifndef HOST_SIM_SIM_WAV_H_
+#define HOST_SIM_SIM_WAV_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/** Function Prototypes */
+uint32_t simWav_open(char **paths, int count);
+bool simWav_sample(uint64_t index, int16_t *sample);
+
+#endif /* HOST_SIM_SIM_WAV_H_ */
@@ -0,0 +1,264 @@
+/** @file acoustic_indices.c
+ * @brief Ecoacoustic indices accumulated from the analysis frames.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#include "acoustic_indices.h"
+#include "mem_plan.h"
+
+#define INDICES_NO_BAND 0xFF		// bin past the last ADI band
+
+/** Per bin accumulators, taken from the DSP scratch by acousticIndices_init */
+static float32_t *_previous = NULL;		// amplitude in the last frame
+static float32_t *_changeSum = NULL;		// ACI, summed change over the step
+static float32_t *_levelSum = NULL;		// ACI, summed amplitude over the step
+static float32_t *_powerSum = NULL;		// summed power over the interval
+static uint8_t *_binBand = NULL;				// ADI band of each bin
+static int _bins = 0;
+static bool _haveScratch = false;
+static size_t _scratchMark = 0;			// DSP scratch use before the accumulators
+
+/** Layout, set by acousticIndices_init */
+static struct IndicesConfig _config;
+static uint16_t _sampleRate = 0;
+static uint32_t _frameStride = 0;
+static uint32_t _stepFrames = 0;
+static int _adiBands = 0;
+static uint16_t _adiBins[INDICES_MAX_ADI_BANDS];	// bins in each ADI band
+static float32_t _adiThreshold = 0.0f;					// amplitude, full scale 1.0
+
+/** Interval state */
+static uint32_t _adiCounts[INDICES_MAX_ADI_BANDS];	// cells over the threshold
+static float32_t _aci = 0.0f;				// ACI of the steps closed so far
+static uint32_t _frames = 0;				// frames in the interval
+static uint32_t _stepFramesSeen = 0;	// frames in the current ACI step
+static bool _havePrevious = false;
+
+/** @brief First bin at or above a frequency.
+ */
+static int freqToBin(int freq) {
+	return ((uint32_t) freq * _frameStride + _sampleRate - 1) / _sampleRate;
+}
+
+/** @brief Add the current ACI step to the index and start the next one.
+ */
+static void closeStep(void) {
+	for (int bin = 0; bin < _bins; bin++) {
+		if (_levelSum[bin] > 0.0f) {
+			_aci += _changeSum[bin] / _levelSum[bin];
+		}
+		_changeSum[bin] = 0.0f;
+		_levelSum[bin] = 0.0f;
+	}
+	_stepFramesSeen = 0;
+	_havePrevious = false;
+}
+
+/** @brief Clear the interval's accumulators.
+ */
+static void resetInterval(void) {
+	for (int bin = 0; bin < _bins; bin++) {
+		_changeSum[bin] = 0.0f;
+		_levelSum[bin] = 0.0f;
+		_powerSum[bin] = 0.0f;
+	}
+	for (int band = 0; band < INDICES_MAX_ADI_BANDS; band++) {
+		_adiCounts[band] = 0;
+	}
+	_aci = 0.0f;
+	_frames = 0;
+	_stepFramesSeen = 0;
+	_havePrevious = false;
+}
+
+/** @brief Initialize the acoustic indices for a frame layout.
+ * Bin k of a frame is at k * sampleRate / frameStride Hz. Each index's bands
+ * must lie within the spectrum.
+ *
+ * @param config ACI step, index bands and ADI settings.
+ * @param sampleRate Calibrated sample rate of the audio.
+ * @param frameStride Full-rate samples per frame, from
+ * audioAnalysis_startSegment.
+ * @param bins Bins in each frame's spectrum.
+ * @return INDICES_OK, INDICES_BAD_CONFIG, or INDICES_NO_MEMORY.
+ */
+enum Indices_Ecode acousticIndices_init(struct IndicesConfig config,
+                                        uint16_t sampleRate,
+                                        uint32_t frameStride, int bins) {
+	int nyquist;
+
+	acousticIndices_deinit();
+
+	// a stride of 0 is analysis that could not be set up
+	if (frameStride == 0 || sampleRate == 0) {
+		return INDICES_BAD_CONFIG;
+	}
+	nyquist = (uint32_t) (bins - 1) * sampleRate / frameStride;
+
+	if (config.aciStepSeconds < 1
+	    || config.biLower >= config.biUpper || config.biUpper > nyquist
+	    || config.anthroLower >= config.anthroUpper
+	    || config.anthroUpper > nyquist
+	    || config.bioLower >= config.bioUpper || config.bioUpper > nyquist
+	    || config.adiBandWidth < 1) {
+		return INDICES_BAD_CONFIG;
+	}
+
+	_scratchMark = memPlan_scratchMark();
+	_haveScratch = true;
+	_previous = memPlan_scratch(bins * sizeof(float32_t));
+	_changeSum = memPlan_scratch(bins * sizeof(float32_t));
+	_levelSum = memPlan_scratch(bins * sizeof(float32_t));
+	_powerSum = memPlan_scratch(bins * sizeof(float32_t));
+	_binBand = memPlan_scratch(bins * sizeof(uint8_t));
+	if (_previous == NULL || _changeSum == NULL || _levelSum == NULL
+	    || _powerSum == NULL || _binBand == NULL) {
+		acousticIndices_deinit();
+		return INDICES_NO_MEMORY;
+	}
+
+	_config = config;
+	_sampleRate = sampleRate;
+	_frameStride = frameStride;
+	_bins = bins;
+	_stepFrames = (uint32_t) config.aciStepSeconds * sampleRate / frameStride;
+
+	// ADI bands from 0 Hz up to Nyquist, a partial last band included
+	_adiBands = (nyquist + config.adiBandWidth - 1) / config.adiBandWidth;
+	if (_adiBands > INDICES_MAX_ADI_BANDS) {
+		_adiBands = INDICES_MAX_ADI_BANDS;
+	}
+	for (int band = 0; band < INDICES_MAX_ADI_BANDS; band++) {
+		_adiBins[band] = 0;
+	}
+	for (int bin = 0; bin < bins; bin++) {
+		int band = (uint32_t) bin * sampleRate / frameStride / config.adiBandWidth;
+
+		_binBand[bin] = band < _adiBands ? band : INDICES_NO_BAND;
+		if (band < _adiBands) {
+			_adiBins[band]++;
+		}
+	}
+	_adiThreshold = powf(10.0f, config.adiThreshold / 20.0f);
+
+	resetInterval();
+
+	return INDICES_OK;
+}
+
+/** @brief Give the accumulators back to the DSP scratch.
+ */
+void acousticIndices_deinit(void) {
+	if (_haveScratch) {
+		memPlan_scratchRewind(_scratchMark);
+		_haveScratch = false;
+	}
+	_previous = NULL;
+	_changeSum = NULL;
+	_levelSum = NULL;
+	_powerSum = NULL;
+	_binBand = NULL;
+	_bins = 0;
+}
+
+/** @brief Add one frame to the interval.
+ * Each bin costs a few float operations, about a tenth of the frame's FFT.
+ *
+ * @param spectrum Spectrum from analyzeFrame.
+ */
+void acousticIndices_frame(const struct AnlysSpectrum *spectrum) {
+	// amplitude relative to a full scale sine, with the block exponent undone
+	float32_t scale = ldexpf(1.0f / INDICES_FULL_SCALE, -spectrum->shift);
+	int bins = spectrum->bins < _bins ? spectrum->bins : _bins;
+
+	for (int bin = 0; bin < bins; bin++) {
+		float32_t level = spectrum->magnitude[bin] * scale;
+
+		_powerSum[bin] += level * level;
+		_levelSum[bin] += level;
+		if (_havePrevious) {
+			_changeSum[bin] += fabsf(level - _previous[bin]);
+		}
+		_previous[bin] = level;
+
+		if (level >= _adiThreshold && _binBand[bin] != INDICES_NO_BAND) {
+			_adiCounts[_binBand[bin]]++;
+		}
+	}
+	_havePrevious = true;
+
+	_frames++;
+	if (++_stepFramesSeen >= _stepFrames) {
+		closeStep();
+	}
+}
+
+/** @brief Compute the indices of the interval so far and start a new one.
+ * A partial ACI step at the end is closed and counted.
+ *
+ * @param indices Written with the indices.
+ */
+void acousticIndices_take(struct AcousticIndices *indices) {
+	int lower, upper;
+	float32_t floor, shares = 0.0f, anthro = 0.0f, bio = 0.0f;
+	float32_t binWidth = (float32_t) _sampleRate / _frameStride / 1000.0f;
+
+	indices->aci = 0.0f;
+	indices->bi = 0.0f;
+	indices->ndsi = 0.0f;
+	indices->adi = 0.0f;
+	indices->frames = _frames;
+	if (_bins == 0 || _frames == 0) {
+		return;
+	}
+
+	if (_stepFramesSeen > 0) {
+		closeStep();
+	}
+	indices->aci = _aci;
+
+	// BI, area of the mean spectrum in dB above its minimum in the band
+	lower = freqToBin(_config.biLower);
+	upper = freqToBin(_config.biUpper);
+	floor = INFINITY;
+	for (int bin = lower; bin < upper; bin++) {
+		float32_t level = 10.0f * log10f(_powerSum[bin] / _frames + 1e-12f);
+		if (level < floor) {
+			floor = level;
+		}
+	}
+	for (int bin = lower; bin < upper; bin++) {
+		float32_t level = 10.0f * log10f(_powerSum[bin] / _frames + 1e-12f);
+		indices->bi += (level - floor) * binWidth;
+	}
+
+	// NDSI
+	for (int bin = freqToBin(_config.anthroLower);
+	     bin < freqToBin(_config.anthroUpper); bin++) {
+		anthro += _powerSum[bin];
+	}
+	for (int bin = freqToBin(_config.bioLower);
+	     bin < freqToBin(_config.bioUpper); bin++) {
+		bio += _powerSum[bin];
+	}
+	if (anthro + bio > 0.0f) {
+		indices->ndsi = (bio - anthro) / (bio + anthro);
+	}
+
+	// ADI, entropy of each band's share of cells over the threshold
+	for (int band = 0; band < _adiBands; band++) {
+		if (_adiBins[band] > 0) {
+			shares += (float32_t) _adiCounts[band] / _adiBins[band];
+		}
+	}
+	for (int band = 0; band < _adiBands && shares > 0.0f; band++) {
+		if (_adiBins[band] > 0 && _adiCounts[band] > 0) {
+			float32_t share = (float32_t) _adiCounts[band] / _adiBins[band] / shares;
+			indices->adi -= share * logf(share);
+		}
+	}
+
+	resetInterval();
+}
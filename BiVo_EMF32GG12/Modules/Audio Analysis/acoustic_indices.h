@@ -0,0 +1,80 @@
+/** @file acoustic_indices.h
+ * @brief Ecoacoustic indices accumulated from the analysis frames over an
+ * interval, so a soundscape can be summarized without its audio leaving the
+ * board. An interval runs from one acousticIndices_take to the next. The
+ * definitions follow the usual desktop implementations (soundecology), on the
+ * board's own FFT frames:
+ *
+ * ACI (Acoustic Complexity Index): for each bin, the summed absolute change of
+ * its amplitude from frame to frame over the summed amplitude, added up over
+ * the bins. Computed per step of aciStepSeconds and summed over the interval.
+ * BI (Bioacoustic Index): area of the interval's mean spectrum in dB above its
+ * lowest value between biLower and biUpper, in dB kHz.
+ * NDSI (Normalized Difference Soundscape Index): (B - A) / (B + A), where B is
+ * the power between bioLower and bioUpper and A between anthroLower and
+ * anthroUpper. -1 to 1, positive when biophony dominates.
+ * ADI (Acoustic Diversity Index): Shannon entropy, in nats, of the share of
+ * cells over adiThreshold dBFS in each adiBandWidth band.
+ *
+ * Amplitudes are taken relative to a full scale sine, 0 dBFS, with the frame's
+ * block exponent taken out. Frames are added by analyzeAudioEvent when the
+ * analysis configuration has indices set, as it is the analysis that sees
+ * every frame of a segment.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#ifndef MODULES_AUDIO_ANALYSIS_ACOUSTIC_INDICES_H_
+#define MODULES_AUDIO_ANALYSIS_ACOUSTIC_INDICES_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <math.h>
+#include "arm_math.h"
+#include "audio_analysis.h"
+
+#define INDICES_MAX_ADI_BANDS 16		// most bands the ADI is taken over
+#define INDICES_FULL_SCALE 8192			// magnitude of a full scale sine
+
+/* Acoustic Indices Configuration
+ * Frequencies are in Hz and cover [lower, upper). */
+struct IndicesConfig {
+		int aciStepSeconds;			// ACI step, changes are summed over each step
+		int biLower;
+		int biUpper;
+		int anthroLower;
+		int anthroUpper;
+		int bioLower;
+		int bioUpper;
+		int adiBandWidth;				// Hz per ADI band, bands start at 0 Hz
+		int adiThreshold;				// dBFS a cell must reach to count for ADI
+};
+
+/** @struct Acoustic Indices
+ * Indices of one interval.
+ */
+struct AcousticIndices {
+		float32_t aci;
+		float32_t bi;						// dB kHz
+		float32_t ndsi;					// -1 to 1
+		float32_t adi;					// nats
+		uint32_t frames;				// frames the indices were computed over
+};
+
+/** @enum Error codes the acoustic indices may respond with.
+ */
+enum Indices_Ecode {
+	INDICES_OK = 0, INDICES_BAD_CONFIG = 1, INDICES_NO_MEMORY = 2
+};
+
+/** Function Prototypes */
+enum Indices_Ecode acousticIndices_init(struct IndicesConfig config,
+                                        uint16_t sampleRate,
+                                        uint32_t frameStride, int bins);
+void acousticIndices_deinit(void);
+void acousticIndices_frame(const struct AnlysSpectrum *spectrum);
+void acousticIndices_take(struct AcousticIndices *indices);
+
+#endif /* MODULES_AUDIO_ANALYSIS_ACOUSTIC_INDICES_H_ */
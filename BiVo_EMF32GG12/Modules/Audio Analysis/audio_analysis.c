@@ -6,59 +6,848 @@
  */
 
 #include "audio_analysis.h"
+#include "spectral_flux.h"
+#include "spectral_shape.h"
+#include "acoustic_indices.h"
+#include "profiler.h"
+#include "mem_plan.h"
+#include "sample_pack.h"
+
+/** Working buffers, taken from the DSP scratch by audioAnalysis_init */
+static q15_t *_copyArray = NULL;				// copy of samples, FFT computes in place
+static q15_t *_fftOutput = NULL;				// output of FFT, twice as large as copy
+static q15_t *_magnitudeOutput = NULL;	// magnitude of FFT (used against thresh)
+static arm_rfft_instance_q15 _rfftInstance;
+static FftKernel _fftKernel = NULL;		// fixed-size kernel, NULL to use CMSIS
+#if ANLYS_FFT_BACKEND == ANLYS_FFT_F32
+static float32_t *_floatFrame = NULL;			// frame as float, FFT works in place
+static float32_t *_floatSpectrum = NULL;	// packed output of the real FFT
+static arm_rfft_fast_instance_f32 _rfftFastInstance;
+#endif
+static struct Decimator _decimator;
+static int _fftSize = 0;
+static int _decimation = 0;		// configured factor, to detect a change
+static int _frameStride = 0;	// full-rate samples consumed by each frame
+static int _frameShift = 0;		// block exponent, left shift applied to the frame
+static uint16_t _sampleRate = 0;	// full rate the band was checked at, 0 if unknown
+static size_t _scratchMark = 0;	// DSP scratch use before the buffers were taken
+static size_t _scratchEnd = 0;	// DSP scratch use after they were taken
+
+/** Fine pass of the cascade, taken when fineSize is larger than fftSize */
+static q15_t *_fineCopy = NULL;				// full-rate samples around a flagged frame
+static q15_t *_fineOutput = NULL;			// output of FFT, CMSIS path only
+static q15_t *_fineMagnitude = NULL;	// magnitude of the fine FFT
+static arm_rfft_instance_q15 _fineRfftInstance;
+static FftKernel _fineKernel = NULL;
+static int _fineSize = 0;						// 0 when the cascade is off
+static int _fineShift = 0;						// block exponent of the fine frame
+static int32_t _fineStart = -1;				// first sample of the analyzed fine frame
+
+/** Segment in packed storage, set while analyzeAudioPacked runs */
+static const uint32_t *_packedSegment = NULL;
+static q15_t *_packedStage = NULL;		// full-rate frame unpacked for the decimator
+
+/** Onset detector settings, to set it up again on a change */
+static int _fluxLowerBin = -1;
+static int _fluxUpperBin = -1;
+static int _onsetGap = 0;				// ANLYS_ONSET_GAP_MS in frames
+
+/** Cascade statistics */
+static uint32_t _statFrames = 0;
+static uint32_t _statEscalations = 0;
+static uint32_t _statFineFrames = 0;
+static uint64_t _statTicks = 0;
+static uint64_t _statSamples = 0;
+
+/** Operation variables */
+static bool _initializedFlag = false;
+
+/** @brief Normalize a frame to use the full q15 range.
+ * Block floating-point: the frame's peak is found and every sample is shifted
+ * left by the same amount, the block exponent, until the peak just fits. The
+ * FFT then works with as many significant bits as the frame allows, and loud
+ * frames can no longer wrap around like a fixed gain would make them.
+ *
+ * @return The block exponent.
+ */
+static int normalizeFrame(q15_t *frame, int size) {
+	q15_t maxValue, minValue;
+	uint32_t index;
+	q31_t peak;
+	int shift;
+
+	arm_max_q15(frame, size, &maxValue, &index);
+	arm_min_q15(frame, size, &minValue, &index);
+	peak = maxValue > -minValue ? maxValue : -minValue;
+
+	// a 15 bit peak has 17 leading zeros, silence is left alone
+	shift = peak > 0 ? __CLZ(peak) - 17 : 0;
+	if (shift < 0) {
+		shift = 0;
+	}
+
+	arm_shift_q15(frame, shift, frame, size);
+
+	return shift;
+}
+
+#if ANLYS_FFT_BACKEND == ANLYS_FFT_F32
+/** @brief Find the magnitude spectrum of the frame in the copy array in f32.
+ * The FFT and magnitudes are computed in floating point, so the frame needs
+ * no normalizing. The magnitudes are then handed over in q15 on the same scale
+ * as the q15 path, with the block exponent chosen from the loudest magnitude
+ * rather than the loudest sample. Quiet frames keep more significant bits than
+ * the q15 path can give them.
+ */
+static void frameSpectrumF32(void) {
+	float32_t peak, scale;
+	uint32_t index;
+	int exponent;
+
+	arm_q15_to_float(_copyArray, _floatFrame, _fftSize);
+	arm_rfft_fast_f32(&_rfftFastInstance, _floatFrame, _floatSpectrum, 0);
+
+	// DC and Nyquist are packed together as the real and imaginary parts of the
+	// first value, so take the magnitudes of the rest and then place those two
+	arm_cmplx_mag_f32(_floatSpectrum, _floatFrame, _fftSize/2);
+	_floatFrame[0] = fabsf(_floatSpectrum[0]);
+	_floatFrame[_fftSize/2] = fabsf(_floatSpectrum[1]);
+
+	// scale of arm_cmplx_mag_q15 after arm_rfft_q15, |X| / (2 * fftSize)
+	arm_scale_f32(_floatFrame, 0.5f / _fftSize, _floatFrame, _fftSize/2 + 1);
+
+	// the largest shift that keeps the loudest magnitude under 1.0
+	arm_max_f32(_floatFrame, _fftSize/2 + 1, &peak, &index);
+	_frameShift = 0;
+	if (peak > 0.0f) {
+		frexpf(peak, &exponent);
+		_frameShift = -exponent;
+		if (_frameShift < 0) {
+			_frameShift = 0;
+		}
+		else if (_frameShift > ANLYS_F32_MAX_SHIFT) {
+			_frameShift = ANLYS_F32_MAX_SHIFT;
+		}
+	}
+
+	scale = ldexpf(1.0f, _frameShift);
+	arm_scale_f32(_floatFrame, scale, _floatFrame, _fftSize/2 + 1);
+	arm_float_to_q15(_floatFrame, _magnitudeOutput, _fftSize/2 + 1);
+}
+#endif
+
+/** @brief Copy samples of the segment into a working buffer, unpacking them
+ * if the segment is in packed storage.
+ */
+static void loadSamples(q15_t *dest, int16_t *audioSamples, uint32_t first,
+                        uint32_t count) {
+	if (_packedSegment != NULL) {
+		samplePack_read(_packedSegment, first, count, dest);
+	}
+	else {
+		memcpy(dest, &audioSamples[first], count * sizeof(q15_t));
+	}
+}
+
+/** @brief Find the magnitude spectrum of one frame of samples.
+ * Only the non-redundant half of the spectrum (fftSize/2 + 1 bins) is written
+ * to the magnitude buffer. The magnitudes are scaled by the frame's block
+ * exponent, use passesThreshold and toReference to interpret them.
+ *
+ * @param audioSamples Samples of the segment, NULL if it is packed.
+ * @param offset First sample of the frame, _frameStride full-rate samples long.
+ */
+static void frameSpectrum(int16_t *audioSamples, uint32_t offset) {
+	uint32_t profileStart = profiler_begin();
+
+	if (_frameStride != _fftSize) {
+		// decimate into the copy array
+		if (_packedSegment != NULL) {
+			loadSamples(_packedStage, audioSamples, offset, _frameStride);
+			decimator_process(&_decimator, _packedStage, _copyArray);
+		}
+		else {
+			decimator_process(&_decimator, &audioSamples[offset], _copyArray);
+		}
+	}
+	else {
+		// copy into copy array to avoid corrupting the segment's data
+		loadSamples(_copyArray, audioSamples, offset, _fftSize);
+	}
+
+#if ANLYS_FFT_BACKEND == ANLYS_FFT_F32
+	frameSpectrumF32();
+	profiler_end(PROFILE_FFT, profileStart);
+	return;
+#endif
+
+	_frameShift = normalizeFrame(_copyArray, _fftSize);
+
+	if (_fftKernel != NULL) {
+		// FFT and magnitude in one, works in place in the copy array
+		_fftKernel(_copyArray, _magnitudeOutput);
+		profiler_end(PROFILE_FFT, profileStart);
+		return;
+	}
+
+	// perform Fast Fourier Transform
+	arm_rfft_q15(&_rfftInstance, _copyArray, _fftOutput);
+
+	// find magnitude of frequencies to find power density spectrum
+	arm_cmplx_mag_q15(_fftOutput, _magnitudeOutput, _fftSize/2 + 1);
+	profiler_end(PROFILE_FFT, profileStart);
+}
+
+/** @brief Compare a magnitude of the current frame against the threshold.
+ * The threshold is set for samples multiplied by sampleScaler, so the
+ * magnitude is brought to that scale first. The comparison is done on the
+ * cross-multiplied values so no precision is lost, in 64 bits as a threshold
+ * of 32768 or more shifted by 16 is past the q31 range.
+ */
+static bool passesThreshold(q15_t magnitude, struct AnlysConfig config) {
+	return (q63_t) magnitude * config.sampleScaler
+	    >= (q63_t) config.powerThreshold << _frameShift;
+}
+
+/** @brief Express a magnitude of the current frame at the reference scale,
+ * samples multiplied by sampleScaler, saturating at the q15 range.
+ */
+static q15_t toReference(q15_t magnitude, struct AnlysConfig config) {
+	return (q15_t) __SSAT(((q31_t) magnitude * config.sampleScaler)
+	                      >> _frameShift, 16);
+}
+
+/** @brief Frequency of an FFT bin at the analysis rate, in Hz.
+ */
+static uint16_t binToFreq(int bin, uint16_t sampleRate) {
+	return (uint32_t) bin * sampleRate / _frameStride;
+}
+
+/** @brief FFT bin holding a frequency at the analysis rate.
+ */
+static int freqToBin(int freq, uint16_t sampleRate) {
+	return (uint32_t) freq * _frameStride / sampleRate;
+}
+
+/** @brief Bins of the analysis band, clamped to the spectrum so a band
+ * reaching past the analysis rate's Nyquist frequency cannot index outside
+ * it.
+ */
+static void bandBins(struct AnlysConfig config, uint16_t sampleRate,
+                     int *lowerIdx, int *upperIdx) {
+	*lowerIdx = freqToBin(config.freqLower, sampleRate);
+	*upperIdx = freqToBin(config.freqUpper, sampleRate);
+	if (*upperIdx > _fftSize/2) {
+		*upperIdx = _fftSize/2;
+	}
+	if (*lowerIdx > *upperIdx) {
+		*lowerIdx = *upperIdx;
+	}
+}
+
+/** @brief Check the analysis band of a configuration: ordered, and inside
+ * [0, sampleRate/(2*decimation)].
+ *
+ * @param sampleRate Full rate of the segments, 0 to only check the order.
+ */
+static bool bandValid(struct AnlysConfig config, uint16_t sampleRate) {
+	int decimation = config.decimation > 1 ? config.decimation : 1;
+
+	return config.freqLower >= 0 && config.freqLower < config.freqUpper
+	    && (sampleRate == 0 || config.freqUpper <= sampleRate / (2 * decimation));
+}
+
+/** @brief Set up the onset detector for the analysis band and start a new
+ * segment. Its running averages are kept while the settings stay the same.
+ */
+static void startOnsets(int lowerIdx, int upperIdx, uint16_t sampleRate) {
+	int gap = (uint32_t) ANLYS_ONSET_GAP_MS * sampleRate / (1000 * _frameStride);
+
+	if (lowerIdx != _fluxLowerBin || upperIdx != _fluxUpperBin
+	    || gap != _onsetGap) {
+		spectralFlux_init(lowerIdx, upperIdx, gap);
+		_fluxLowerBin = lowerIdx;
+		_fluxUpperBin = upperIdx;
+		_onsetGap = gap;
+	}
+	spectralFlux_reset();
+}
+
+/** @brief Run the onset detector on the current frame.
+ */
+static bool frameOnset(struct AnlysConfig config) {
+	struct AnlysSpectrum spectrum = {_magnitudeOutput, _fftSize/2 + 1, _frameShift};
+
+	return spectralFlux_frame(&spectrum, config.onsetMargin);
+}
+
+/** @brief Check the current frame's spectral shape against the gates.
+ * Only run on frames that already passed the threshold, the features add
+ * about 15% to the cost of a 256 point frame.
+ *
+ * @return true if every gate that is on passes.
+ */
+static bool passesGates(int lowerIdx, int upperIdx, uint16_t sampleRate,
+                        struct AnlysConfig config) {
+	struct AnlysSpectrum spectrum = {_magnitudeOutput, _fftSize/2 + 1, _frameShift};
+	struct SpectralShape shape;
+
+	if (config.gates.maxEntropy == 0 && config.gates.maxFlatness == 0
+	    && config.gates.centroidLower == 0 && config.gates.centroidUpper == 0) {
+		return true;
+	}
+
+	spectralShape_frame(&spectrum, lowerIdx, upperIdx, sampleRate, _frameStride,
+	                    &shape);
+
+	return (config.gates.maxEntropy == 0
+	        || shape.entropy <= config.gates.maxEntropy)
+	    && (config.gates.maxFlatness == 0
+	        || shape.flatness <= config.gates.maxFlatness)
+	    && (config.gates.centroidLower == 0
+	        || shape.centroid >= config.gates.centroidLower)
+	    && (config.gates.centroidUpper == 0
+	        || shape.centroid <= config.gates.centroidUpper);
+}
+
+/** @brief Fine FFT size a configuration runs the cascade with.
+ * The fine frame has to span more than a coarse frame's full-rate samples to
+ * resolve its bins more finely, otherwise the cascade is off.
+ *
+ * @return config.fineSize, or 0 for no fine pass.
+ */
+static int fineSizeFor(struct AnlysConfig config) {
+	int frameStride = config.fftSize
+	                  * (config.decimation > 1 ? config.decimation : 1);
+
+	return config.fineSize > frameStride ? config.fineSize : 0;
+}
+
+/** @brief Re-analyze a flagged frame with the fine FFT.
+ * Fine frames are fineSize full-rate samples on a grid of fineSize, and a
+ * coarse frame uses the one holding its center (the last one of the segment
+ * is moved back to end with it). Flagged coarse frames that share a fine
+ * frame then share its FFT. Only the fine bins within one coarse bin of the
+ * flagged ones are checked.
+ *
+ * @param lowerIdx Lowest coarse bin that passed the threshold.
+ * @param upperIdx Highest coarse bin that passed the threshold.
+ * @return true if the fine pass confirms the frame.
+ */
+static bool escalateFrame(int16_t *audioSamples, uint32_t bufferSize,
+                          uint32_t copyOffset, int lowerIdx, int upperIdx,
+                          uint16_t sampleRate, struct AnlysConfig config) {
+	uint32_t start = (copyOffset + _frameStride/2) / _fineSize * _fineSize;
+	int fineLower, fineUpper;
+
+	// a segment shorter than the fine frame keeps the coarse verdict
+	if (bufferSize < (uint32_t) _fineSize) {
+		return true;
+	}
+	if (start + _fineSize > bufferSize) {
+		start = bufferSize - _fineSize;
+	}
+
+	_statEscalations++;
+	if ((int32_t) start != _fineStart) {
+		_fineStart = start;
+		_statFineFrames++;
+
+		loadSamples(_fineCopy, audioSamples, start, _fineSize);
+		_fineShift = normalizeFrame(_fineCopy, _fineSize);
+		if (_fineKernel != NULL) {
+			_fineKernel(_fineCopy, _fineMagnitude);
+		}
+		else {
+			arm_rfft_q15(&_fineRfftInstance, _fineCopy, _fineOutput);
+			arm_cmplx_mag_q15(_fineOutput, _fineMagnitude, _fineSize/2 + 1);
+		}
+	}
+
+	// zoomed region, at the fine resolution and inside the analysis band
+	fineLower = (uint32_t) (lowerIdx > 0 ? lowerIdx - 1 : 0) * _fineSize
+	            / _frameStride;
+	fineUpper = (uint32_t) (upperIdx + 1) * _fineSize / _frameStride;
+	if (fineLower < (int) ((uint32_t) config.freqLower * _fineSize / sampleRate)) {
+		fineLower = (uint32_t) config.freqLower * _fineSize / sampleRate;
+	}
+	if (fineUpper > (int) ((uint32_t) config.freqUpper * _fineSize / sampleRate)) {
+		fineUpper = (uint32_t) config.freqUpper * _fineSize / sampleRate;
+	}
+	if (fineUpper > _fineSize/2) {
+		fineUpper = _fineSize/2;
+	}
+
+	// same comparison as passesThreshold, with the fine frame's exponent
+	for (int testIdx = fineLower; testIdx <= fineUpper; testIdx++) {
+		if ((q63_t) _fineMagnitude[testIdx] * config.sampleScaler
+		    >= (q63_t) config.powerThreshold << _fineShift) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/** @brief Prepare the working buffers for analyzing a new segment.
+ * (Re)initializes if the configuration changed and clears the decimator's
+ * history, as segments are not necessarily back to back. Re-initializing is
+ * refused once another module has taken DSP scratch after the analysis
+ * buffers, as their buffers would be handed out again.
+ *
+ * @return Full-rate samples consumed by each frame, the step for analyzeFrame.
+ * 0 if the configuration is rejected by audioAnalysis_init or cannot be
+ * changed to, nothing can be analyzed then.
+ */
+uint32_t audioAnalysis_startSegment(struct AnlysConfig config) {
+	if (!_initializedFlag || _fftSize != config.fftSize
+	    || _decimation != config.decimation
+	    || _fineSize != fineSizeFor(config)) {
+		// buffers taken by a later module would be handed out twice
+		if (_initializedFlag && memPlan_scratchMark() != _scratchEnd) {
+			return 0;
+		}
+		if (audioAnalysis_init(config, _sampleRate) != ANLYS_OK) {
+			return 0;
+		}
+	}
+	if (_frameStride != _fftSize) {
+		decimator_reset(&_decimator);
+	}
+
+	return _frameStride;
+}
+
+/** @brief Find the magnitude spectrum of one frame, for analysis stages
+ * outside this module.
+ * Frames must be passed in order, each one frame stride (the return value of
+ * audioAnalysis_startSegment) after the one before, so the decimator's
+ * history stays continuous.
+ *
+ * @param frame First sample of the frame.
+ * @param spectrum Filled with the frame's spectrum. The magnitudes are only
+ * valid until the next frame is analyzed.
+ * @return false, and an empty spectrum, if analysis is not initialized.
+ */
+bool analyzeFrame(int16_t *frame, struct AnlysSpectrum *spectrum) {
+	if (!_initializedFlag) {
+		spectrum->magnitude = NULL;
+		spectrum->bins = 0;
+		spectrum->shift = 0;
+		return false;
+	}
+
+	frameSpectrum(frame, 0);
+
+	spectrum->magnitude = _magnitudeOutput;
+	spectrum->bins = _fftSize/2 + 1;
+	spectrum->shift = _frameShift;
+
+	return true;
+}
+
+/** @brief Initialize audio analysis.
+ * Takes the working buffers from the DSP scratch and sets up the FFT for the
+ * configured size. Calling again with a different configuration takes the
+ * buffers again, no other module may have taken scratch since. A
+ * configuration whose buffers do not fit the DSP scratch is left
+ * uninitialized, as is one with a decimation factor the decimator has no
+ * filter for.
+ *
+ * @param config Analysis configuration the buffers are sized for.
+ * @param sampleRate Full rate of the segments to be analyzed, the band must
+ * lie within half of it after decimation. 0 if not known yet, only the order
+ * of the band is checked then.
+ * @return ANLYS_OK, ANLYS_BAD_CONFIG for a band that is empty or outside the
+ * analysis rate or an unsupported decimation factor, or ANLYS_NO_MEMORY.
+ */
+enum Anlys_Ecode audioAnalysis_init(struct AnlysConfig config,
+                                    uint16_t sampleRate) {
+	enum Decim_Ecode decimError;
+
+	// release buffers of a previous configuration
+	audioAnalysis_deinit();
+
+	if (!bandValid(config, sampleRate)) {
+		return ANLYS_BAD_CONFIG;
+	}
+	_sampleRate = sampleRate;
+
+	_fftSize = config.fftSize;
+	_scratchMark = memPlan_scratchMark();
+	_copyArray = memPlan_scratch( _fftSize * sizeof(q15_t) );
+	_magnitudeOutput = memPlan_scratch( _fftSize * sizeof(q15_t) );
+
+	// use a generated kernel if there is one for this size, the CMSIS path
+	// needs its own output buffer
+#if ANLYS_FFT_BACKEND == ANLYS_FFT_KERNELS
+	_fftKernel = fftKernel_select(_fftSize);
+#else
+	_fftKernel = NULL;
+#endif
+#if ANLYS_FFT_BACKEND == ANLYS_FFT_F32
+	_floatFrame = memPlan_scratch( _fftSize * sizeof(float32_t) );
+	_floatSpectrum = memPlan_scratch( _fftSize * sizeof(float32_t) );
+	arm_rfft_fast_init_f32(&_rfftFastInstance, _fftSize);
+#else
+	if (_fftKernel == NULL) {
+		_fftOutput = memPlan_scratch( _fftSize * 2 * sizeof(q15_t) );
+		arm_rfft_init_q15(&_rfftInstance, _fftSize, 0, 1);
+	}
+#endif
+
+	// decimation front end, frames then span more of the segment
+	_decimation = config.decimation;
+	_frameStride = _fftSize;
+	if (_decimation > 1) {
+		decimError = decimator_init(&_decimator, _decimation, _fftSize);
+		if (decimError != DECIM_OK) {
+			_initializedFlag = true;
+			audioAnalysis_deinit();
+			return decimError == DECIM_UNSUPPORTED ? ANLYS_BAD_CONFIG
+			                                       : ANLYS_NO_MEMORY;
+		}
+		_frameStride = _decimation * _fftSize;
+	}
+
+	// fine pass of the cascade, q15 whichever backend the coarse pass uses
+	_fineSize = fineSizeFor(config);
+	if (_fineSize > 0) {
+		_fineCopy = memPlan_scratch( _fineSize * sizeof(q15_t) );
+		_fineMagnitude = memPlan_scratch( (_fineSize/2 + 1) * sizeof(q15_t) );
+#if ANLYS_FFT_BACKEND == ANLYS_FFT_KERNELS
+		_fineKernel = fftKernel_select(_fineSize);
+#else
+		_fineKernel = NULL;
+#endif
+		if (_fineKernel == NULL) {
+			_fineOutput = memPlan_scratch( _fineSize * 2 * sizeof(q15_t) );
+			arm_rfft_init_q15(&_fineRfftInstance, _fineSize, 0, 1);
+		}
+	}
+
+	if (_copyArray == NULL || _magnitudeOutput == NULL
+#if ANLYS_FFT_BACKEND == ANLYS_FFT_F32
+	    || _floatFrame == NULL || _floatSpectrum == NULL
+#else
+	    || (_fftKernel == NULL && _fftOutput == NULL)
+#endif
+	    || (_fineSize > 0 && (_fineCopy == NULL || _fineMagnitude == NULL
+	                          || (_fineKernel == NULL && _fineOutput == NULL)))) {
+		// give back the buffers that were taken
+		_initializedFlag = true;
+		audioAnalysis_deinit();
+		return ANLYS_NO_MEMORY;
+	}
+
+	// set initialized flag
+	_scratchEnd = memPlan_scratchMark();
+	_initializedFlag = true;
+
+	return ANLYS_OK;
+}
+
+/** @brief De-initialize audio analysis, giving the working buffers back to the
+ * DSP scratch.
+ */
+void audioAnalysis_deinit( void ) {
+	if (_initializedFlag) {
+		memPlan_scratchRewind(_scratchMark);
+	}
+	_copyArray = NULL;
+	_fftOutput = NULL;
+	_magnitudeOutput = NULL;
+	_fineCopy = NULL;
+	_fineOutput = NULL;
+	_fineMagnitude = NULL;
+	_fineSize = 0;
+#if ANLYS_FFT_BACKEND == ANLYS_FFT_F32
+	_floatFrame = NULL;
+	_floatSpectrum = NULL;
+#endif
+	if (_frameStride != _fftSize) {
+		decimator_deinit(&_decimator);
+	}
+	_frameStride = _fftSize;
+
+	_initializedFlag = false;
+}
 
 /** @brief Perform audio analysis on the audio data given.
+ * config.trigger selects what flags a frame. With the cascade on, a frame
+ * over the threshold only counts if the fine pass confirms it.
  */
 bool analyzeAudio(int16_t *audioSamples, uint32_t bufferSize,
                   uint16_t sampleRate, struct AnlysConfig config) {
-	// copy samples because FFT computes in place
-	q15_t *copyArray = malloc( config.fftSize * sizeof(q15_t) );
-	// output of FFT, twice as large as copy array
-	q15_t *fftOutput = malloc( config.fftSize * 2 * sizeof(q15_t) );
-	// holds magnitude of FFT (used against thresh)
-	q15_t *magnitudeOutput = malloc( config.fftSize * sizeof(q15_t) );
-	// frequency bin size of the psd
-	uint16_t psd_bin_size = sampleRate / config.fftSize;
 	// result of the analysis
 	bool analysis_result = false;
-	// rfft config
-	arm_rfft_instance_q15 rfft_instance;
-	arm_rfft_init_q15(&rfft_instance, config.fftSize, 0, 1);
+	uint32_t profileStart = profiler_begin();
+	int lowerIdx, upperIdx, firstFlagged, lastFlagged;
+	int onsetWindow = 0;		// frames left to check the level in after an onset
+
+	// make sure the working buffers match the configuration
+	if (audioAnalysis_startSegment(config) == 0) {
+		return false;
+	}
+	_fineStart = -1;
+
+	bandBins(config, sampleRate, &lowerIdx, &upperIdx);
+	if (config.trigger != ANLYS_TRIGGER_LEVEL) {
+		startOnsets(lowerIdx, upperIdx, sampleRate);
+	}
 
 	// loop through the entire length of the buffer to analyze
 	for (int copyOffset = 0;
-			copyOffset < (bufferSize/config.fftSize)*config.fftSize;
-			copyOffset += config.fftSize ) {
+			copyOffset < (bufferSize/_frameStride)*_frameStride;
+			copyOffset += _frameStride ) {
 
-		// copy into copy array to avoid corrupting the segment's data
-		for (int copyToIdx = 0; copyToIdx < config.fftSize; copyToIdx++) {
-			copyArray[copyToIdx] = audioSamples[copyOffset + copyToIdx] * config.sampleScaler;
-		}
+		frameSpectrum(audioSamples, copyOffset);
+		_statFrames++;
 
-		// perform Fast Fourier Transform
-		arm_rfft_q15(&rfft_instance, copyArray, fftOutput);
-
-		// find magnitude of frequencies to find power density spectrum
-		arm_cmplx_mag_q15(fftOutput, magnitudeOutput, config.fftSize*2);
+		// onsets flag the segment by themselves, or open a window of
+		// ANLYS_ONSET_GAP_MS in which the level is checked
+		if (config.trigger == ANLYS_TRIGGER_ONSET) {
+			if (frameOnset(config)) {
+				analysis_result = true;
+				break;
+			}
+			continue;
+		}
+		if (config.trigger == ANLYS_TRIGGER_COMBINED) {
+			if (frameOnset(config)) {
+				onsetWindow = _onsetGap > 1 ? _onsetGap : 1;
+			}
+			if (onsetWindow == 0) {
+				continue;
+			}
+			onsetWindow--;
+		}
 
 		// compare to threshold and return if within frequency range and above
 		// threshold. (marking the segment as potential to have bird vocalization)
-		for (int testIdx=config.freqLower/psd_bin_size;
-				testIdx<=config.freqUpper/psd_bin_size && testIdx<config.fftSize;
-				testIdx++) {
-			if (magnitudeOutput[testIdx] >= config.powerThreshold) {
-				// potentially contains bird vocalizations
-				analysis_result = true;
-				break;
+		firstFlagged = -1;
+		lastFlagged = -1;
+		for (int testIdx = lowerIdx; testIdx <= upperIdx; testIdx++) {
+			if (passesThreshold(_magnitudeOutput[testIdx], config)) {
+				if (firstFlagged < 0) {
+					firstFlagged = testIdx;
+				}
+				lastFlagged = testIdx;
+
+				// without the cascade, one bin is enough
+				if (_fineSize == 0) {
+					break;
+				}
 			}
 		}
 
+		if (firstFlagged >= 0
+		    && passesGates(lowerIdx, upperIdx, sampleRate, config)) {
+			// potentially contains bird vocalizations
+			analysis_result = _fineSize == 0
+			    || escalateFrame(audioSamples, bufferSize, copyOffset, firstFlagged,
+			                     lastFlagged, sampleRate, config);
+		}
+
 		// if analysis marks segment, break to return
 		if (analysis_result) {
 			break;
 		}
 	}
 
-	// free allocated memory and return result
+	_statSamples += bufferSize;
+	_statTicks += profiler_begin() - profileStart;
+	profiler_end(PROFILE_ANALYZE, profileStart);
+
 	return analysis_result;
 }
+
+/** @brief Perform audio analysis on a segment in packed storage, see
+ * sample_pack.h. Each frame is unpacked as it is analyzed, so the verdict is
+ * the one analyzeAudio gives for the unpacked segment. With decimation, a
+ * full-rate frame is taken from the DSP scratch for the length of the call.
+ */
+bool analyzeAudioPacked(const uint32_t *packed, uint32_t bufferSize,
+                        uint16_t samplingRate, struct AnlysConfig config) {
+	size_t mark;
+	bool passes;
+
+	if (audioAnalysis_startSegment(config) == 0) {
+		return false;
+	}
+	mark = memPlan_scratchMark();
+	if (_frameStride != _fftSize) {
+		_packedStage = memPlan_scratch(_frameStride * sizeof(q15_t));
+		if (_packedStage == NULL) {
+			return false;
+		}
+	}
+
+	_packedSegment = packed;
+	passes = analyzeAudio(NULL, bufferSize, samplingRate, config);
+	_packedSegment = NULL;
+	_packedStage = NULL;
+	memPlan_scratchRewind(mark);
+
+	return passes;
+}
+
+/** @brief Find the onsets in the audio data given.
+ * The whole segment is analyzed with the spectral flux onset detector,
+ * whatever the configured trigger.
+ *
+ * @param onsets Written with the first sample of each onset frame.
+ * @param maxOnsets Most onsets to write, later ones are dropped.
+ * @return Number of onsets written.
+ */
+uint32_t analyzeAudioOnsets(int16_t *audioSamples, uint32_t bufferSize,
+                            uint16_t sampleRate, struct AnlysConfig config,
+                            uint32_t *onsets, uint32_t maxOnsets) {
+	uint32_t count = 0;
+	int lowerIdx, upperIdx;
+
+	// make sure the working buffers match the configuration
+	if (audioAnalysis_startSegment(config) == 0) {
+		return 0;
+	}
+
+	bandBins(config, sampleRate, &lowerIdx, &upperIdx);
+	startOnsets(lowerIdx, upperIdx, sampleRate);
+
+	for (uint32_t copyOffset = 0;
+			copyOffset < (bufferSize/_frameStride)*_frameStride && count < maxOnsets;
+			copyOffset += _frameStride ) {
+		frameSpectrum(audioSamples, copyOffset);
+
+		if (frameOnset(config)) {
+			onsets[count++] = copyOffset;
+		}
+	}
+
+	return count;
+}
+
+/** @brief Perform audio analysis on the audio data given and describe what was
+ * found.
+ * Unlike analyzeAudio, the whole segment is analyzed so the duration, band and
+ * peak of the detection cover every flagged frame, and with config.indices
+ * every frame is added to the acoustic indices. The noise floor is the mean
+ * in-band magnitude of the quietest frame in the segment.
+ *
+ * @param event Filled with the description of the detection. Only the noise
+ * floor is meaningful if nothing was detected.
+ * @return true if the segment passed analysis.
+ */
+bool analyzeAudioEvent(int16_t *audioSamples, uint32_t bufferSize,
+                       uint16_t sampleRate, struct AnlysConfig config,
+                       struct AnlysEvent *event) {
+	// start of the last frame passing the threshold
+	uint32_t lastFlagged = 0;
+	q15_t framePeak, frameMean;
+	uint32_t framePeakIdx;
+	uint32_t profileStart = profiler_begin();
+	int lowerIdx, upperIdx;
+
+	event->detected = false;
+	event->onsetSample = 0;
+	event->durationSamples = 0;
+	event->bandLower = 0;
+	event->bandUpper = 0;
+	event->peakFreq = 0;
+	event->peakMagnitude = 0;
+	event->noiseFloor = INT16_MAX;
+
+	// make sure the working buffers match the configuration
+	if (audioAnalysis_startSegment(config) == 0) {
+		return false;
+	}
+
+	// bins of the spectrum inside the analysis band, at the (possibly reduced)
+	// analysis rate
+	bandBins(config, sampleRate, &lowerIdx, &upperIdx);
+
+	// loop through the entire length of the buffer to analyze
+	for (uint32_t copyOffset = 0;
+			copyOffset < (bufferSize/_frameStride)*_frameStride;
+			copyOffset += _frameStride ) {
+
+		frameSpectrum(audioSamples, copyOffset);
+
+		if (config.indices) {
+			struct AnlysSpectrum spectrum = {_magnitudeOutput, _fftSize/2 + 1,
+			                                 _frameShift};
+			acousticIndices_frame(&spectrum);
+		}
+
+		// loudest bin and average level of the band for this frame
+		arm_max_q15(&_magnitudeOutput[lowerIdx], upperIdx - lowerIdx + 1,
+		            &framePeak, &framePeakIdx);
+		arm_mean_q15(&_magnitudeOutput[lowerIdx], upperIdx - lowerIdx + 1,
+		             &frameMean);
+
+		if (toReference(frameMean, config) < event->noiseFloor) {
+			event->noiseFloor = toReference(frameMean, config);
+		}
+
+		if (!passesThreshold(framePeak, config)
+		    || !passesGates(lowerIdx, upperIdx, sampleRate, config)) {
+			continue;
+		}
+
+		// frame passed, extend the detection to cover it
+		if (!event->detected) {
+			event->detected = true;
+			event->onsetSample = copyOffset;
+			event->bandLower = UINT16_MAX;
+		}
+		lastFlagged = copyOffset;
+
+		for (int testIdx = lowerIdx; testIdx <= upperIdx; testIdx++) {
+			if (passesThreshold(_magnitudeOutput[testIdx], config)) {
+				if (binToFreq(testIdx, sampleRate) < event->bandLower) {
+					event->bandLower = binToFreq(testIdx, sampleRate);
+				}
+				if (binToFreq(testIdx, sampleRate) > event->bandUpper) {
+					event->bandUpper = binToFreq(testIdx, sampleRate);
+				}
+			}
+		}
+
+		if (toReference(framePeak, config) > event->peakMagnitude) {
+			event->peakMagnitude = toReference(framePeak, config);
+			event->peakFreq = binToFreq(lowerIdx + framePeakIdx, sampleRate);
+		}
+	}
+
+	if (event->detected) {
+		event->durationSamples = lastFlagged + _frameStride - event->onsetSample;
+	}
+	profiler_end(PROFILE_ANALYZE, profileStart);
+
+	return event->detected;
+}
+
+/** @brief Report how often the cascade escalated and the cost of analyzeAudio
+ * since the last reset.
+ *
+ * @param sampleRate Sample rate of the analyzed audio.
+ * @param stats Filled with the statistics.
+ */
+void audioAnalysis_cascadeStats(uint16_t sampleRate,
+                                struct AnlysCascadeStats *stats) {
+	stats->frames = _statFrames;
+	stats->escalations = _statEscalations;
+	stats->fineFrames = _statFineFrames;
+	stats->ticksPerSecond = _statSamples > 0
+	    ? (uint32_t) (_statTicks * sampleRate / _statSamples) : 0;
+}
+
+/** @brief Clear the cascade statistics.
+ */
+void audioAnalysis_resetStats(void) {
+	_statFrames = 0;
+	_statEscalations = 0;
+	_statFineFrames = 0;
+	_statTicks = 0;
+	_statSamples = 0;
+}
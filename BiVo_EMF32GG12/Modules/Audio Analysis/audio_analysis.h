@@ -16,21 +16,136 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
+#include "em_device.h"
 #include "arm_math.h"
+#include "decimator.h"
+#include "fft_kernels.h"
 
-/* Analysis Configuration */
+/* FFT backend, chosen at build time by defining ANLYS_FFT_BACKEND */
+#define ANLYS_FFT_CMSIS 0			// arm_rfft_q15 + arm_cmplx_mag_q15, any size
+#define ANLYS_FFT_KERNELS 1		// generated kernels, CMSIS for other sizes
+#define ANLYS_FFT_F32 2				// arm_rfft_fast_f32, for hard-float builds
+#ifndef ANLYS_FFT_BACKEND
+#define ANLYS_FFT_BACKEND ANLYS_FFT_KERNELS
+#endif
+#define ANLYS_F32_MAX_SHIFT 16		// largest block exponent of the f32 path
+
+/** @struct Analysis Gates
+ * Spectral shape a frame over the threshold must also have to be flagged, see
+ * spectral_shape.h. Tonal calls have low entropy and flatness, broadband rain
+ * and wind have both near 1.0. A gate set to 0 is off.
+ */
+struct AnlysGates {
+		q15_t maxEntropy;						// highest normalized spectral entropy
+		q15_t maxFlatness;					// highest spectral flatness
+		int centroidLower;					// lowest spectral centroid, in Hz
+		int centroidUpper;					// highest spectral centroid, in Hz
+};
+
+/* Analysis Configuration
+ * Frames are normalized with a block exponent before the FFT rather than
+ * multiplied by a fixed gain. sampleScaler is the reference gain that
+ * powerThreshold and reported magnitudes are expressed at, as if the samples
+ * had been multiplied by it without overflowing. */
 struct AnlysConfig {
 		int fftSize;
 		int sampleScaler;
 		int powerThreshold;
 		int freqLower;
 		int freqUpper;
+		int decimation;		// 2, 3 or 4 to analyze at a reduced rate, 0 or 1 for full
+		int fineSize;			// FFT size flagged frames are re-analyzed with, must be
+											// over fftSize*decimation, else no fine pass
+		int trigger;			// what flags a frame, one of ANLYS_TRIGGER_*
+		int onsetMargin;	// flux over the adaptive threshold for an onset, Q8 log2
+		struct AnlysGates gates;	// spectral shape a flagged frame must have
+		bool indices;			// add analyzeAudioEvent's frames to the acoustic indices
+};
+
+/* Frame triggers for analyzeAudio */
+#define ANLYS_TRIGGER_LEVEL 0			// a bin over powerThreshold
+#define ANLYS_TRIGGER_ONSET 1			// a spectral flux onset, at any level
+#define ANLYS_TRIGGER_COMBINED 2	// a bin over powerThreshold soon after an onset
+#define ANLYS_ONSET_GAP_MS 150			// shortest time from one onset to the next,
+																		// and how long an onset keeps the level armed
+
+/* With decimation, freqUpper should stay below 40% of sampleRate/decimation,
+ * the passband edge of the anti-alias filter. */
+
+/* Coarse-to-fine cascade: with fineSize larger than the frame stride (fftSize
+ * times the decimation factor, the full-rate samples of a coarse frame), so
+ * each fine bin is narrower than a coarse one, analyzeAudio runs a cheap
+ * small FFT over every frame, and only a frame with bins over the
+ * threshold is re-analyzed with a fineSize FFT of the full-rate samples around
+ * it. The fine pass only checks the bins within one coarse bin of those that
+ * passed, so a frame is flagged only if the finer resolution confirms it.
+ * Neighbouring flagged frames share a fine frame, see escalateFrame.
+ * A tone's magnitude does not depend on the FFT size, so the same threshold
+ * applies to both passes. */
+
+/** @struct Analysis Cascade Statistics
+ * How much the cascade escalated and what analyzeAudio cost, since the last
+ * audioAnalysis_resetStats.
+ */
+struct AnlysCascadeStats {
+		uint32_t frames;						// frames analyzed by the coarse pass
+		uint32_t escalations;				// frames re-analyzed by the fine pass
+		uint32_t fineFrames;				// fine FFTs run, escalations can share one
+		uint32_t ticksPerSecond;		// average profiler ticks per second of audio, core
+										// cycles on the board, see profiler.h
+};
+
+/** @struct Analysis Event
+ * Describes the detection found in a segment by analyzeAudioEvent. Times are
+ * in samples relative to the start of the segment, frequencies are in Hz.
+ */
+struct AnlysEvent {
+		bool detected;							// true if any frame passed the threshold
+		uint32_t onsetSample;				// first sample of the first flagged frame
+		uint32_t durationSamples;		// first to last flagged frame, inclusive
+		uint16_t bandLower;					// lowest frequency over threshold
+		uint16_t bandUpper;					// highest frequency over threshold
+		uint16_t peakFreq;					// frequency of the loudest magnitude
+		q15_t peakMagnitude;				// loudest in-band magnitude of the segment
+		q15_t noiseFloor;						// quietest frame's mean in-band magnitude
+};
+
+/** @struct Analysis Spectrum
+ * Magnitude spectrum of one frame, as found by analyzeFrame. Bin k is at
+ * k * sampleRate / frameStride Hz. Magnitudes are on the scale of
+ * arm_cmplx_mag_q15 after arm_rfft_q15, multiplied by 2^shift.
+ */
+struct AnlysSpectrum {
+		q15_t *magnitude;						// fftSize/2 + 1 bins
+		int bins;										// number of bins, fftSize/2 + 1
+		int shift;									// block exponent of the frame
+};
+
+/** @enum Error codes audio analysis may respond with.
+ */
+enum Anlys_Ecode {
+	ANLYS_OK = 0, ANLYS_NO_MEMORY = 1, ANLYS_BAD_CONFIG = 2
 };
 
 /* Function Prototypes */
 bool analyzeAudio(int16_t *audioSamples, uint32_t bufferSize,
                   uint16_t samplingRate, struct AnlysConfig config);
+bool analyzeAudioPacked(const uint32_t *packed, uint32_t bufferSize,
+                        uint16_t samplingRate, struct AnlysConfig config);
+bool analyzeAudioEvent(int16_t *audioSamples, uint32_t bufferSize,
+                       uint16_t samplingRate, struct AnlysConfig config,
+                       struct AnlysEvent *event);
 void audioAnalysis_deinit( void );
-void audioAnalysis_init(void);
+enum Anlys_Ecode audioAnalysis_init(struct AnlysConfig config,
+                                    uint16_t sampleRate);
+uint32_t audioAnalysis_startSegment(struct AnlysConfig config);
+bool analyzeFrame(int16_t *frame, struct AnlysSpectrum *spectrum);
+uint32_t analyzeAudioOnsets(int16_t *audioSamples, uint32_t bufferSize,
+                            uint16_t sampleRate, struct AnlysConfig config,
+                            uint32_t *onsets, uint32_t maxOnsets);
+void audioAnalysis_cascadeStats(uint16_t sampleRate,
+                                struct AnlysCascadeStats *stats);
+void audioAnalysis_resetStats(void);
 
 #endif /* MODULES_AUDIO_ANALYSIS_AUDIO_ANALYSIS_H_ */
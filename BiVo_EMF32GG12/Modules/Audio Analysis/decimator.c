@@ -0,0 +1,113 @@
+/** @file decimator.c
+ * @brief Polyphase FIR decimation front end for audio analysis.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#include "decimator.h"
+#include "mem_plan.h"
+
+/** Anti-alias filters, one per supported decimation factor.
+ * Kaiser windowed sinc (beta for 50 dB) with the cutoff at the reduced-rate
+ * Nyquist frequency, quantized to q15 with the zero end taps dropped. The
+ * filters are symmetric, so they need no reversal for CMSIS.
+ */
+static const q15_t decimate2Coeffs[27] = {
+		82, 0, -219, 0, 464, 0, -877, 0, 1603, 0, -3166, 0, 10314, 16367, 10314,
+		0, -3166, 0, 1603, 0, -877, 0, 464, 0, -219, 0, 82
+};
+
+static const q15_t decimate3Coeffs[41] = {
+		39, 57, 0, -110, -145, 0, 239, 299, 0, -457, -560, 0, 836, 1027, 0,
+		-1609, -2097, 0, 4430, 8981, 10909, 8981, 4430, 0, -2097, -1609, 0, 1027,
+		836, 0, -560, -457, 0, 299, 239, 0, -145, -110, 0, 57, 39
+};
+
+static const q15_t decimate4Coeffs[55] = {
+		21, 41, 38, 0, -62, -110, -95, 0, 138, 232, 194, 0, -266, -438, -360, 0,
+		487, 801, 663, 0, -927, -1583, -1382, 0, 2399, 5155, 7347, 8181, 7347,
+		5155, 2399, 0, -1382, -1583, -927, 0, 663, 801, 487, 0, -360, -438, -266,
+		0, 194, 232, 138, 0, -95, -110, -62, 0, 38, 41, 21
+};
+
+/** @brief Initialize a decimator.
+ * Takes the filter state for decimating fixed size blocks from the DSP
+ * scratch.
+ *
+ * @param decimator Decimator to initialize.
+ * @param factor Decimation factor, 2, 3 or 4.
+ * @param outputSize Number of samples produced by each call to
+ * decimator_process. Each call consumes factor times as many.
+ * @return DECIM_UNSUPPORTED if there is no filter for the factor,
+ * DECIM_NO_MEMORY if the state does not fit the DSP scratch.
+ */
+enum Decim_Ecode decimator_init(struct Decimator *decimator, int factor,
+                                int outputSize) {
+	const q15_t *coeffs;
+	uint16_t numTaps;
+	size_t stateBytes;
+
+	switch (factor) {
+		case 2:
+			coeffs = decimate2Coeffs;
+			numTaps = sizeof(decimate2Coeffs) / sizeof(q15_t);
+			break;
+		case 3:
+			coeffs = decimate3Coeffs;
+			numTaps = sizeof(decimate3Coeffs) / sizeof(q15_t);
+			break;
+		case 4:
+			coeffs = decimate4Coeffs;
+			numTaps = sizeof(decimate4Coeffs) / sizeof(q15_t);
+			break;
+		default:
+			return DECIM_UNSUPPORTED;
+	}
+
+	decimator->factor = factor;
+	decimator->outputSize = outputSize;
+	stateBytes = (numTaps + factor*outputSize - 1) * sizeof(q15_t);
+	decimator->scratchMark = memPlan_scratchMark();
+	decimator->state = memPlan_scratch( stateBytes );
+	if (decimator->state == NULL) {
+		return DECIM_NO_MEMORY;
+	}
+	memset(decimator->state, 0, stateBytes);
+
+	arm_fir_decimate_init_q15(&decimator->instance, numTaps, factor,
+	                          (q15_t*) coeffs, decimator->state,
+	                          factor*outputSize);
+
+	return DECIM_OK;
+}
+
+/** @brief De-initialize a decimator, giving its state back to the DSP
+ * scratch.
+ */
+void decimator_deinit(struct Decimator *decimator) {
+	if (decimator->state != NULL) {
+		memPlan_scratchRewind(decimator->scratchMark);
+	}
+	decimator->state = NULL;
+}
+
+/** @brief Clear the filter history.
+ * Call before decimating audio that doesn't follow the last block processed,
+ * such as a new segment.
+ */
+void decimator_reset(struct Decimator *decimator) {
+	memset(decimator->state, 0,
+	       (decimator->instance.numTaps - 1) * sizeof(q15_t));
+}
+
+/** @brief Filter and downsample one block.
+ *
+ * @param input factor*outputSize samples at the full rate.
+ * @param output outputSize samples at the reduced rate.
+ */
+void decimator_process(struct Decimator *decimator, int16_t *input,
+                       q15_t *output) {
+	arm_fir_decimate_fast_q15(&decimator->instance, input, output,
+	                          decimator->factor*decimator->outputSize);
+}
@@ -0,0 +1,53 @@
+/** @file decimator.h
+ * @brief Decimation front end for audio analysis. Low-pass filters and
+ * downsamples the segment's samples with a polyphase FIR decimator so the
+ * analysis runs on a reduced-rate stream, while the segment itself stays at the
+ * full rate for transmission.
+ *
+ * The anti-alias filters are precomputed for factors of 2, 3 and 4. Each
+ * passes up to 80% of the reduced-rate Nyquist frequency and attenuates
+ * everything that would alias into that passband by at least 43 dB.
+ *
+ * The decimator uses the fast q15 CMSIS routine, which accumulates in 32 bits.
+ * This is plenty for raw microphone samples, scaling should be applied after
+ * decimation.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#ifndef MODULES_AUDIO_ANALYSIS_DECIMATOR_H_
+#define MODULES_AUDIO_ANALYSIS_DECIMATOR_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arm_math.h"
+
+/** @enum Error codes the decimator may respond with.
+ */
+enum Decim_Ecode {
+	DECIM_OK = 0, DECIM_UNSUPPORTED = 1, DECIM_NO_MEMORY = 2
+};
+
+/** @struct Decimator
+ * Filter instance and state for one decimation factor and block size.
+ */
+struct Decimator {
+		arm_fir_decimate_instance_q15 instance;
+		q15_t *state;				// from the DSP scratch, NULL when not initialized
+		size_t scratchMark;	// DSP scratch use before the state was taken
+		int factor;
+		int outputSize;
+};
+
+/** Function Prototypes */
+enum Decim_Ecode decimator_init(struct Decimator *decimator, int factor,
+                                int outputSize);
+void decimator_deinit(struct Decimator *decimator);
+void decimator_reset(struct Decimator *decimator);
+void decimator_process(struct Decimator *decimator, int16_t *input,
+                       q15_t *output);
+
+#endif /* MODULES_AUDIO_ANALYSIS_DECIMATOR_H_ */
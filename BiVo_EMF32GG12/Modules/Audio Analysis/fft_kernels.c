@@ -0,0 +1,764 @@
+/** @file fft_kernels.c
+ * @brief Fixed-size real FFT + magnitude kernels for audio analysis.
+ *
+ * GENERATED by Tools/gen_fft_kernels.py, do not edit by hand.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#include "fft_kernels.h"
+
+/** sqrt(i * 2^24) for i = 64 to 256, used by binMagnitude */
+static const uint32_t sqrtTable[193] = {
+		32768, 33023, 33276, 33527, 33776, 34024, 34270, 34514,
+		34756, 34996, 35235, 35472, 35708, 35942, 36175, 36406,
+		36636, 36864, 37091, 37316, 37540, 37763, 37985, 38205,
+		38424, 38642, 38858, 39073, 39287, 39500, 39712, 39923,
+		40132, 40341, 40548, 40755, 40960, 41164, 41368, 41570,
+		41771, 41972, 42171, 42369, 42567, 42763, 42959, 43154,
+		43348, 43541, 43733, 43925, 44115, 44305, 44494, 44682,
+		44869, 45056, 45242, 45427, 45611, 45795, 45977, 46160,
+		46341, 46522, 46702, 46881, 47059, 47237, 47415, 47591,
+		47767, 47942, 48117, 48291, 48465, 48637, 48809, 48981,
+		49152, 49322, 49492, 49661, 49830, 49998, 50166, 50332,
+		50499, 50665, 50830, 50995, 51159, 51323, 51486, 51649,
+		51811, 51972, 52134, 52294, 52454, 52614, 52773, 52932,
+		53090, 53248, 53405, 53562, 53719, 53874, 54030, 54185,
+		54340, 54494, 54647, 54801, 54954, 55106, 55258, 55410,
+		55561, 55712, 55862, 56012, 56162, 56311, 56459, 56608,
+		56756, 56903, 57051, 57198, 57344, 57490, 57636, 57781,
+		57926, 58071, 58215, 58359, 58503, 58646, 58789, 58931,
+		59073, 59215, 59357, 59498, 59639, 59779, 59919, 60059,
+		60199, 60338, 60477, 60615, 60753, 60891, 61029, 61166,
+		61303, 61440, 61576, 61712, 61848, 61984, 62119, 62254,
+		62388, 62523, 62657, 62790, 62924, 63057, 63190, 63323,
+		63455, 63587, 63719, 63850, 63982, 64113, 64243, 64374,
+		64504, 64634, 64763, 64893, 65022, 65151, 65279, 65408,
+		65536
+};
+
+/** @brief Swap complex values into bit-reversed order.
+ */
+static inline void bitReverse(uint32_t *z, const uint16_t *swaps, int count) {
+	for (int i = 0; i < 2*count; i += 2) {
+		uint32_t tmp = z[swaps[i]];
+		z[swaps[i]] = z[swaps[i + 1]];
+		z[swaps[i + 1]] = tmp;
+	}
+}
+
+/** @brief Butterfly with W = 1, scaled by 1/4 (first stage only).
+ */
+static inline void butterflyQuarter(uint32_t *a, uint32_t *b) {
+	uint32_t aHalf = __SHADD16(*a, 0);
+	uint32_t bHalf = __SHADD16(*b, 0);
+
+	*a = __SHADD16(aHalf, bHalf);
+	*b = __SHSUB16(aHalf, bHalf);
+}
+
+/** @brief Butterfly with W = 1, scaled by 1/2.
+ */
+static inline void butterflyHalf(uint32_t *a, uint32_t *b) {
+	uint32_t sum = __SHADD16(*a, *b);
+
+	*b = __SHSUB16(*a, *b);
+	*a = sum;
+}
+
+/** @brief Butterfly with W = -j, scaled by 1/2.
+ */
+static inline void butterflyMinusJ(uint32_t *a, uint32_t *b) {
+	uint32_t sum = __SHSAX(*a, *b);
+
+	*b = __SHASX(*a, *b);
+	*a = sum;
+}
+
+/** @brief Butterfly with W = cos - j sin, given as (cos, sin), scaled by 1/2.
+ */
+static inline void butterfly(uint32_t *a, uint32_t *b, uint32_t w) {
+	q31_t tr = ((q31_t) __SMUAD(*b, w)) >> 15;
+	q31_t ti = ((q31_t) __SMUSDX(w, *b)) >> 15;
+	uint32_t t = __PKHBT(tr, ti, 16);
+
+	*b = __SHSUB16(*a, t);
+	*a = __SHADD16(*a, t);
+}
+
+/** @brief Magnitude of one bin of the real FFT, as arm_cmplx_mag_q15 scales it.
+ * The square root is normalized with __CLZ so the power falls in [2^30, 2^32)
+ * and then looked up from sqrtTable with linear interpolation, which is
+ * accurate to a fraction of an output step.
+ */
+static inline q15_t binMagnitude(q31_t re, q31_t im) {
+	uint32_t power = (uint32_t) (re * re) + (uint32_t) (im * im);
+	uint32_t shift, index, root;
+
+	if (power == 0) {
+		return 0;
+	}
+
+	shift = __CLZ(power) & ~1u;
+	power <<= shift;
+	index = (power >> 24) - 64;
+	root = sqrtTable[index] + (((sqrtTable[index + 1] - sqrtTable[index])
+	                            * ((power >> 8) & 0xFFFF)) >> 16);
+
+	// sqrt(power) = root >> shift/2, the magnitude is half of that
+	return (q15_t) (root >> (shift/2 + 1));
+}
+
+/** @brief Split the complex FFT of the packed frame into the real FFT and
+ * take the magnitude of bins 0 to m.
+ *
+ * @param z Complex FFT of m points, scaled by 1/(2m).
+ * @param twiddle W = cos - j sin of 2 pi k / 2m for k = 1 to m-1.
+ */
+static void splitMagnitude(uint32_t *z, const uint32_t *twiddle, int m,
+                           q15_t *magnitude) {
+	q31_t zr0 = (int16_t) z[0];
+	q31_t zi0 = (int16_t) (z[0] >> 16);
+
+	magnitude[0] = binMagnitude(zr0 + zi0, 0);
+	magnitude[m] = binMagnitude(zr0 - zi0, 0);
+
+	for (int k = 1; k < m; k++) {
+		q31_t zr = (int16_t) z[k], zi = (int16_t) (z[k] >> 16);
+		q31_t cr = (int16_t) z[m - k], ci = (int16_t) (z[m - k] >> 16);
+		q31_t c = (int16_t) twiddle[k - 1], s = (int16_t) (twiddle[k - 1] >> 16);
+		// A = Z[k] + conj(Z[m-k]), B = Z[k] - conj(Z[m-k])
+		q31_t ar = zr + cr, ai = zi - ci;
+		q31_t br = zr - cr, bi = zi + ci;
+		// X[k] = (A + W * -jB) / 2
+		q31_t re = (ar + ((c * bi - s * br) >> 15)) >> 1;
+		q31_t im = (ai - ((c * br + s * bi) >> 15)) >> 1;
+
+		magnitude[k] = binMagnitude(re, im);
+	}
+}
+
+/* 128 point real FFT: 64 point complex FFT, 6 stages */
+static const uint32_t fftTwiddle128[32] = {
+		0x00007FFF, 0x0C8C7F62, 0x18F97D8A, 0x25287A7D, 0x30FC7642, 0x3C5770E3,
+		0x471D6A6E, 0x513462F2, 0x5A825A82, 0x62F25134, 0x6A6E471D, 0x70E33C57,
+		0x764230FC, 0x7A7D2528, 0x7D8A18F9, 0x7F620C8C, 0x7FFF0000, 0x7F62F374,
+		0x7D8AE707, 0x7A7DDAD8, 0x7642CF04, 0x70E3C3A9, 0x6A6EB8E3, 0x62F2AECC,
+		0x5A82A57E, 0x51349D0E, 0x471D9592, 0x3C578F1D, 0x30FC89BE, 0x25288583,
+		0x18F98276, 0x0C8C809E
+};
+
+static const uint32_t splitTwiddle128[63] = {
+		0x06487FD9, 0x0C8C7F62, 0x12C87E9D, 0x18F97D8A, 0x1F1A7C2A, 0x25287A7D,
+		0x2B1F7885, 0x30FC7642, 0x36BA73B6, 0x3C5770E3, 0x41CE6DCA, 0x471D6A6E,
+		0x4C4066D0, 0x513462F2, 0x55F65ED7, 0x5A825A82, 0x5ED755F6, 0x62F25134,
+		0x66D04C40, 0x6A6E471D, 0x6DCA41CE, 0x70E33C57, 0x73B636BA, 0x764230FC,
+		0x78852B1F, 0x7A7D2528, 0x7C2A1F1A, 0x7D8A18F9, 0x7E9D12C8, 0x7F620C8C,
+		0x7FD90648, 0x7FFF0000, 0x7FD9F9B8, 0x7F62F374, 0x7E9DED38, 0x7D8AE707,
+		0x7C2AE0E6, 0x7A7DDAD8, 0x7885D4E1, 0x7642CF04, 0x73B6C946, 0x70E3C3A9,
+		0x6DCABE32, 0x6A6EB8E3, 0x66D0B3C0, 0x62F2AECC, 0x5ED7AA0A, 0x5A82A57E,
+		0x55F6A129, 0x51349D0E, 0x4C409930, 0x471D9592, 0x41CE9236, 0x3C578F1D,
+		0x36BA8C4A, 0x30FC89BE, 0x2B1F877B, 0x25288583, 0x1F1A83D6, 0x18F98276,
+		0x12C88163, 0x0C8C809E, 0x06488027
+};
+
+static const uint16_t bitRevSwaps128[56] = {
+		1, 32, 2, 16, 3, 48, 4, 8, 5, 40, 6, 24,
+		7, 56, 9, 36, 10, 20, 11, 52, 13, 44, 14, 28,
+		15, 60, 17, 34, 19, 50, 21, 42, 22, 26, 23, 58,
+		25, 38, 27, 54, 29, 46, 31, 62, 35, 49, 37, 41,
+		39, 57, 43, 53, 47, 61, 55, 59
+};
+
+/** @brief Magnitude spectrum of a 128 sample frame.
+ * The frame is used as workspace and is overwritten.
+ */
+void fftKernel_rfftMag128(q15_t *frame, q15_t *magnitude) {
+	uint32_t *z = (uint32_t*) frame;
+	int i, k;
+
+	bitReverse(z, bitRevSwaps128, 28);
+
+	// stage 1: 2 point butterflies, W = 1
+	for (i = 0; i < 64; i += 2) {
+		butterflyQuarter(&z[i], &z[i + 1]);
+	}
+
+	// stage 2: 4 point butterflies, W = 1 and -j
+	for (i = 0; i < 64; i += 4) {
+		butterflyHalf(&z[i], &z[i + 2]);
+		butterflyMinusJ(&z[i + 1], &z[i + 3]);
+	}
+
+	// stage 3: 8 point butterflies, twiddle step 8
+	for (i = 0; i < 64; i += 8) {
+		for (k = 0; k < 4; k++) {
+			butterfly(&z[i + k], &z[i + k + 4], fftTwiddle128[k * 8]);
+		}
+	}
+
+	// stage 4: 16 point butterflies, twiddle step 4
+	for (i = 0; i < 64; i += 16) {
+		for (k = 0; k < 8; k++) {
+			butterfly(&z[i + k], &z[i + k + 8], fftTwiddle128[k * 4]);
+		}
+	}
+
+	// stage 5: 32 point butterflies, twiddle step 2
+	for (i = 0; i < 64; i += 32) {
+		for (k = 0; k < 16; k++) {
+			butterfly(&z[i + k], &z[i + k + 16], fftTwiddle128[k * 2]);
+		}
+	}
+
+	// stage 6: 64 point butterflies, twiddle step 1
+	for (i = 0; i < 64; i += 64) {
+		for (k = 0; k < 32; k++) {
+			butterfly(&z[i + k], &z[i + k + 32], fftTwiddle128[k]);
+		}
+	}
+
+	splitMagnitude(z, splitTwiddle128, 64, magnitude);
+}
+
+/* 256 point real FFT: 128 point complex FFT, 7 stages */
+static const uint32_t fftTwiddle256[64] = {
+		0x00007FFF, 0x06487FD9, 0x0C8C7F62, 0x12C87E9D, 0x18F97D8A, 0x1F1A7C2A,
+		0x25287A7D, 0x2B1F7885, 0x30FC7642, 0x36BA73B6, 0x3C5770E3, 0x41CE6DCA,
+		0x471D6A6E, 0x4C4066D0, 0x513462F2, 0x55F65ED7, 0x5A825A82, 0x5ED755F6,
+		0x62F25134, 0x66D04C40, 0x6A6E471D, 0x6DCA41CE, 0x70E33C57, 0x73B636BA,
+		0x764230FC, 0x78852B1F, 0x7A7D2528, 0x7C2A1F1A, 0x7D8A18F9, 0x7E9D12C8,
+		0x7F620C8C, 0x7FD90648, 0x7FFF0000, 0x7FD9F9B8, 0x7F62F374, 0x7E9DED38,
+		0x7D8AE707, 0x7C2AE0E6, 0x7A7DDAD8, 0x7885D4E1, 0x7642CF04, 0x73B6C946,
+		0x70E3C3A9, 0x6DCABE32, 0x6A6EB8E3, 0x66D0B3C0, 0x62F2AECC, 0x5ED7AA0A,
+		0x5A82A57E, 0x55F6A129, 0x51349D0E, 0x4C409930, 0x471D9592, 0x41CE9236,
+		0x3C578F1D, 0x36BA8C4A, 0x30FC89BE, 0x2B1F877B, 0x25288583, 0x1F1A83D6,
+		0x18F98276, 0x12C88163, 0x0C8C809E, 0x06488027
+};
+
+static const uint32_t splitTwiddle256[127] = {
+		0x03247FF6, 0x06487FD9, 0x096B7FA7, 0x0C8C7F62, 0x0FAB7F0A, 0x12C87E9D,
+		0x15E27E1E, 0x18F97D8A, 0x1C0C7CE4, 0x1F1A7C2A, 0x22247B5D, 0x25287A7D,
+		0x2827798A, 0x2B1F7885, 0x2E11776C, 0x30FC7642, 0x33DF7505, 0x36BA73B6,
+		0x398D7255, 0x3C5770E3, 0x3F176F5F, 0x41CE6DCA, 0x447B6C24, 0x471D6A6E,
+		0x49B468A7, 0x4C4066D0, 0x4EC064E9, 0x513462F2, 0x539B60EC, 0x55F65ED7,
+		0x58435CB4, 0x5A825A82, 0x5CB45843, 0x5ED755F6, 0x60EC539B, 0x62F25134,
+		0x64E94EC0, 0x66D04C40, 0x68A749B4, 0x6A6E471D, 0x6C24447B, 0x6DCA41CE,
+		0x6F5F3F17, 0x70E33C57, 0x7255398D, 0x73B636BA, 0x750533DF, 0x764230FC,
+		0x776C2E11, 0x78852B1F, 0x798A2827, 0x7A7D2528, 0x7B5D2224, 0x7C2A1F1A,
+		0x7CE41C0C, 0x7D8A18F9, 0x7E1E15E2, 0x7E9D12C8, 0x7F0A0FAB, 0x7F620C8C,
+		0x7FA7096B, 0x7FD90648, 0x7FF60324, 0x7FFF0000, 0x7FF6FCDC, 0x7FD9F9B8,
+		0x7FA7F695, 0x7F62F374, 0x7F0AF055, 0x7E9DED38, 0x7E1EEA1E, 0x7D8AE707,
+		0x7CE4E3F4, 0x7C2AE0E6, 0x7B5DDDDC, 0x7A7DDAD8, 0x798AD7D9, 0x7885D4E1,
+		0x776CD1EF, 0x7642CF04, 0x7505CC21, 0x73B6C946, 0x7255C673, 0x70E3C3A9,
+		0x6F5FC0E9, 0x6DCABE32, 0x6C24BB85, 0x6A6EB8E3, 0x68A7B64C, 0x66D0B3C0,
+		0x64E9B140, 0x62F2AECC, 0x60ECAC65, 0x5ED7AA0A, 0x5CB4A7BD, 0x5A82A57E,
+		0x5843A34C, 0x55F6A129, 0x539B9F14, 0x51349D0E, 0x4EC09B17, 0x4C409930,
+		0x49B49759, 0x471D9592, 0x447B93DC, 0x41CE9236, 0x3F1790A1, 0x3C578F1D,
+		0x398D8DAB, 0x36BA8C4A, 0x33DF8AFB, 0x30FC89BE, 0x2E118894, 0x2B1F877B,
+		0x28278676, 0x25288583, 0x222484A3, 0x1F1A83D6, 0x1C0C831C, 0x18F98276,
+		0x15E281E2, 0x12C88163, 0x0FAB80F6, 0x0C8C809E, 0x096B8059, 0x06488027,
+		0x0324800A
+};
+
+static const uint16_t bitRevSwaps256[112] = {
+		1, 64, 2, 32, 3, 96, 4, 16, 5, 80, 6, 48,
+		7, 112, 9, 72, 10, 40, 11, 104, 12, 24, 13, 88,
+		14, 56, 15, 120, 17, 68, 18, 36, 19, 100, 21, 84,
+		22, 52, 23, 116, 25, 76, 26, 44, 27, 108, 29, 92,
+		30, 60, 31, 124, 33, 66, 35, 98, 37, 82, 38, 50,
+		39, 114, 41, 74, 43, 106, 45, 90, 46, 58, 47, 122,
+		49, 70, 51, 102, 53, 86, 55, 118, 57, 78, 59, 110,
+		61, 94, 63, 126, 67, 97, 69, 81, 71, 113, 75, 105,
+		77, 89, 79, 121, 83, 101, 87, 117, 91, 109, 95, 125,
+		103, 115, 111, 123
+};
+
+/** @brief Magnitude spectrum of a 256 sample frame.
+ * The frame is used as workspace and is overwritten.
+ */
+void fftKernel_rfftMag256(q15_t *frame, q15_t *magnitude) {
+	uint32_t *z = (uint32_t*) frame;
+	int i, k;
+
+	bitReverse(z, bitRevSwaps256, 56);
+
+	// stage 1: 2 point butterflies, W = 1
+	for (i = 0; i < 128; i += 2) {
+		butterflyQuarter(&z[i], &z[i + 1]);
+	}
+
+	// stage 2: 4 point butterflies, W = 1 and -j
+	for (i = 0; i < 128; i += 4) {
+		butterflyHalf(&z[i], &z[i + 2]);
+		butterflyMinusJ(&z[i + 1], &z[i + 3]);
+	}
+
+	// stage 3: 8 point butterflies, twiddle step 16
+	for (i = 0; i < 128; i += 8) {
+		for (k = 0; k < 4; k++) {
+			butterfly(&z[i + k], &z[i + k + 4], fftTwiddle256[k * 16]);
+		}
+	}
+
+	// stage 4: 16 point butterflies, twiddle step 8
+	for (i = 0; i < 128; i += 16) {
+		for (k = 0; k < 8; k++) {
+			butterfly(&z[i + k], &z[i + k + 8], fftTwiddle256[k * 8]);
+		}
+	}
+
+	// stage 5: 32 point butterflies, twiddle step 4
+	for (i = 0; i < 128; i += 32) {
+		for (k = 0; k < 16; k++) {
+			butterfly(&z[i + k], &z[i + k + 16], fftTwiddle256[k * 4]);
+		}
+	}
+
+	// stage 6: 64 point butterflies, twiddle step 2
+	for (i = 0; i < 128; i += 64) {
+		for (k = 0; k < 32; k++) {
+			butterfly(&z[i + k], &z[i + k + 32], fftTwiddle256[k * 2]);
+		}
+	}
+
+	// stage 7: 128 point butterflies, twiddle step 1
+	for (i = 0; i < 128; i += 128) {
+		for (k = 0; k < 64; k++) {
+			butterfly(&z[i + k], &z[i + k + 64], fftTwiddle256[k]);
+		}
+	}
+
+	splitMagnitude(z, splitTwiddle256, 128, magnitude);
+}
+
+/* 512 point real FFT: 256 point complex FFT, 8 stages */
+static const uint32_t fftTwiddle512[128] = {
+		0x00007FFF, 0x03247FF6, 0x06487FD9, 0x096B7FA7, 0x0C8C7F62, 0x0FAB7F0A,
+		0x12C87E9D, 0x15E27E1E, 0x18F97D8A, 0x1C0C7CE4, 0x1F1A7C2A, 0x22247B5D,
+		0x25287A7D, 0x2827798A, 0x2B1F7885, 0x2E11776C, 0x30FC7642, 0x33DF7505,
+		0x36BA73B6, 0x398D7255, 0x3C5770E3, 0x3F176F5F, 0x41CE6DCA, 0x447B6C24,
+		0x471D6A6E, 0x49B468A7, 0x4C4066D0, 0x4EC064E9, 0x513462F2, 0x539B60EC,
+		0x55F65ED7, 0x58435CB4, 0x5A825A82, 0x5CB45843, 0x5ED755F6, 0x60EC539B,
+		0x62F25134, 0x64E94EC0, 0x66D04C40, 0x68A749B4, 0x6A6E471D, 0x6C24447B,
+		0x6DCA41CE, 0x6F5F3F17, 0x70E33C57, 0x7255398D, 0x73B636BA, 0x750533DF,
+		0x764230FC, 0x776C2E11, 0x78852B1F, 0x798A2827, 0x7A7D2528, 0x7B5D2224,
+		0x7C2A1F1A, 0x7CE41C0C, 0x7D8A18F9, 0x7E1E15E2, 0x7E9D12C8, 0x7F0A0FAB,
+		0x7F620C8C, 0x7FA7096B, 0x7FD90648, 0x7FF60324, 0x7FFF0000, 0x7FF6FCDC,
+		0x7FD9F9B8, 0x7FA7F695, 0x7F62F374, 0x7F0AF055, 0x7E9DED38, 0x7E1EEA1E,
+		0x7D8AE707, 0x7CE4E3F4, 0x7C2AE0E6, 0x7B5DDDDC, 0x7A7DDAD8, 0x798AD7D9,
+		0x7885D4E1, 0x776CD1EF, 0x7642CF04, 0x7505CC21, 0x73B6C946, 0x7255C673,
+		0x70E3C3A9, 0x6F5FC0E9, 0x6DCABE32, 0x6C24BB85, 0x6A6EB8E3, 0x68A7B64C,
+		0x66D0B3C0, 0x64E9B140, 0x62F2AECC, 0x60ECAC65, 0x5ED7AA0A, 0x5CB4A7BD,
+		0x5A82A57E, 0x5843A34C, 0x55F6A129, 0x539B9F14, 0x51349D0E, 0x4EC09B17,
+		0x4C409930, 0x49B49759, 0x471D9592, 0x447B93DC, 0x41CE9236, 0x3F1790A1,
+		0x3C578F1D, 0x398D8DAB, 0x36BA8C4A, 0x33DF8AFB, 0x30FC89BE, 0x2E118894,
+		0x2B1F877B, 0x28278676, 0x25288583, 0x222484A3, 0x1F1A83D6, 0x1C0C831C,
+		0x18F98276, 0x15E281E2, 0x12C88163, 0x0FAB80F6, 0x0C8C809E, 0x096B8059,
+		0x06488027, 0x0324800A
+};
+
+static const uint32_t splitTwiddle512[255] = {
+		0x01927FFE, 0x03247FF6, 0x04B67FEA, 0x06487FD9, 0x07D97FC2, 0x096B7FA7,
+		0x0AFB7F87, 0x0C8C7F62, 0x0E1C7F38, 0x0FAB7F0A, 0x113A7ED6, 0x12C87E9D,
+		0x14557E60, 0x15E27E1E, 0x176E7DD6, 0x18F97D8A, 0x1A837D3A, 0x1C0C7CE4,
+		0x1D937C89, 0x1F1A7C2A, 0x209F7BC6, 0x22247B5D, 0x23A77AEF, 0x25287A7D,
+		0x26A87A06, 0x2827798A, 0x29A4790A, 0x2B1F7885, 0x2C9977FB, 0x2E11776C,
+		0x2F8776D9, 0x30FC7642, 0x326E75A6, 0x33DF7505, 0x354E7460, 0x36BA73B6,
+		0x38257308, 0x398D7255, 0x3AF3719E, 0x3C5770E3, 0x3DB87023, 0x3F176F5F,
+		0x40746E97, 0x41CE6DCA, 0x43266CF9, 0x447B6C24, 0x45CD6B4B, 0x471D6A6E,
+		0x486A698C, 0x49B468A7, 0x4AFB67BD, 0x4C4066D0, 0x4D8165DE, 0x4EC064E9,
+		0x4FFB63EF, 0x513462F2, 0x526961F1, 0x539B60EC, 0x54CA5FE4, 0x55F65ED7,
+		0x571E5DC8, 0x58435CB4, 0x59645B9D, 0x5A825A82, 0x5B9D5964, 0x5CB45843,
+		0x5DC8571E, 0x5ED755F6, 0x5FE454CA, 0x60EC539B, 0x61F15269, 0x62F25134,
+		0x63EF4FFB, 0x64E94EC0, 0x65DE4D81, 0x66D04C40, 0x67BD4AFB, 0x68A749B4,
+		0x698C486A, 0x6A6E471D, 0x6B4B45CD, 0x6C24447B, 0x6CF94326, 0x6DCA41CE,
+		0x6E974074, 0x6F5F3F17, 0x70233DB8, 0x70E33C57, 0x719E3AF3, 0x7255398D,
+		0x73083825, 0x73B636BA, 0x7460354E, 0x750533DF, 0x75A6326E, 0x764230FC,
+		0x76D92F87, 0x776C2E11, 0x77FB2C99, 0x78852B1F, 0x790A29A4, 0x798A2827,
+		0x7A0626A8, 0x7A7D2528, 0x7AEF23A7, 0x7B5D2224, 0x7BC6209F, 0x7C2A1F1A,
+		0x7C891D93, 0x7CE41C0C, 0x7D3A1A83, 0x7D8A18F9, 0x7DD6176E, 0x7E1E15E2,
+		0x7E601455, 0x7E9D12C8, 0x7ED6113A, 0x7F0A0FAB, 0x7F380E1C, 0x7F620C8C,
+		0x7F870AFB, 0x7FA7096B, 0x7FC207D9, 0x7FD90648, 0x7FEA04B6, 0x7FF60324,
+		0x7FFE0192, 0x7FFF0000, 0x7FFEFE6E, 0x7FF6FCDC, 0x7FEAFB4A, 0x7FD9F9B8,
+		0x7FC2F827, 0x7FA7F695, 0x7F87F505, 0x7F62F374, 0x7F38F1E4, 0x7F0AF055,
+		0x7ED6EEC6, 0x7E9DED38, 0x7E60EBAB, 0x7E1EEA1E, 0x7DD6E892, 0x7D8AE707,
+		0x7D3AE57D, 0x7CE4E3F4, 0x7C89E26D, 0x7C2AE0E6, 0x7BC6DF61, 0x7B5DDDDC,
+		0x7AEFDC59, 0x7A7DDAD8, 0x7A06D958, 0x798AD7D9, 0x790AD65C, 0x7885D4E1,
+		0x77FBD367, 0x776CD1EF, 0x76D9D079, 0x7642CF04, 0x75A6CD92, 0x7505CC21,
+		0x7460CAB2, 0x73B6C946, 0x7308C7DB, 0x7255C673, 0x719EC50D, 0x70E3C3A9,
+		0x7023C248, 0x6F5FC0E9, 0x6E97BF8C, 0x6DCABE32, 0x6CF9BCDA, 0x6C24BB85,
+		0x6B4BBA33, 0x6A6EB8E3, 0x698CB796, 0x68A7B64C, 0x67BDB505, 0x66D0B3C0,
+		0x65DEB27F, 0x64E9B140, 0x63EFB005, 0x62F2AECC, 0x61F1AD97, 0x60ECAC65,
+		0x5FE4AB36, 0x5ED7AA0A, 0x5DC8A8E2, 0x5CB4A7BD, 0x5B9DA69C, 0x5A82A57E,
+		0x5964A463, 0x5843A34C, 0x571EA238, 0x55F6A129, 0x54CAA01C, 0x539B9F14,
+		0x52699E0F, 0x51349D0E, 0x4FFB9C11, 0x4EC09B17, 0x4D819A22, 0x4C409930,
+		0x4AFB9843, 0x49B49759, 0x486A9674, 0x471D9592, 0x45CD94B5, 0x447B93DC,
+		0x43269307, 0x41CE9236, 0x40749169, 0x3F1790A1, 0x3DB88FDD, 0x3C578F1D,
+		0x3AF38E62, 0x398D8DAB, 0x38258CF8, 0x36BA8C4A, 0x354E8BA0, 0x33DF8AFB,
+		0x326E8A5A, 0x30FC89BE, 0x2F878927, 0x2E118894, 0x2C998805, 0x2B1F877B,
+		0x29A486F6, 0x28278676, 0x26A885FA, 0x25288583, 0x23A78511, 0x222484A3,
+		0x209F843A, 0x1F1A83D6, 0x1D938377, 0x1C0C831C, 0x1A8382C6, 0x18F98276,
+		0x176E822A, 0x15E281E2, 0x145581A0, 0x12C88163, 0x113A812A, 0x0FAB80F6,
+		0x0E1C80C8, 0x0C8C809E, 0x0AFB8079, 0x096B8059, 0x07D9803E, 0x06488027,
+		0x04B68016, 0x0324800A, 0x01928002
+};
+
+static const uint16_t bitRevSwaps512[240] = {
+		1, 128, 2, 64, 3, 192, 4, 32, 5, 160, 6, 96,
+		7, 224, 8, 16, 9, 144, 10, 80, 11, 208, 12, 48,
+		13, 176, 14, 112, 15, 240, 17, 136, 18, 72, 19, 200,
+		20, 40, 21, 168, 22, 104, 23, 232, 25, 152, 26, 88,
+		27, 216, 28, 56, 29, 184, 30, 120, 31, 248, 33, 132,
+		34, 68, 35, 196, 37, 164, 38, 100, 39, 228, 41, 148,
+		42, 84, 43, 212, 44, 52, 45, 180, 46, 116, 47, 244,
+		49, 140, 50, 76, 51, 204, 53, 172, 54, 108, 55, 236,
+		57, 156, 58, 92, 59, 220, 61, 188, 62, 124, 63, 252,
+		65, 130, 67, 194, 69, 162, 70, 98, 71, 226, 73, 146,
+		74, 82, 75, 210, 77, 178, 78, 114, 79, 242, 81, 138,
+		83, 202, 85, 170, 86, 106, 87, 234, 89, 154, 91, 218,
+		93, 186, 94, 122, 95, 250, 97, 134, 99, 198, 101, 166,
+		103, 230, 105, 150, 107, 214, 109, 182, 110, 118, 111, 246,
+		113, 142, 115, 206, 117, 174, 119, 238, 121, 158, 123, 222,
+		125, 190, 127, 254, 131, 193, 133, 161, 135, 225, 137, 145,
+		139, 209, 141, 177, 143, 241, 147, 201, 149, 169, 151, 233,
+		155, 217, 157, 185, 159, 249, 163, 197, 167, 229, 171, 213,
+		173, 181, 175, 245, 179, 205, 183, 237, 187, 221, 191, 253,
+		199, 227, 203, 211, 207, 243, 215, 235, 223, 251, 239, 247
+};
+
+/** @brief Magnitude spectrum of a 512 sample frame.
+ * The frame is used as workspace and is overwritten.
+ */
+void fftKernel_rfftMag512(q15_t *frame, q15_t *magnitude) {
+	uint32_t *z = (uint32_t*) frame;
+	int i, k;
+
+	bitReverse(z, bitRevSwaps512, 120);
+
+	// stage 1: 2 point butterflies, W = 1
+	for (i = 0; i < 256; i += 2) {
+		butterflyQuarter(&z[i], &z[i + 1]);
+	}
+
+	// stage 2: 4 point butterflies, W = 1 and -j
+	for (i = 0; i < 256; i += 4) {
+		butterflyHalf(&z[i], &z[i + 2]);
+		butterflyMinusJ(&z[i + 1], &z[i + 3]);
+	}
+
+	// stage 3: 8 point butterflies, twiddle step 32
+	for (i = 0; i < 256; i += 8) {
+		for (k = 0; k < 4; k++) {
+			butterfly(&z[i + k], &z[i + k + 4], fftTwiddle512[k * 32]);
+		}
+	}
+
+	// stage 4: 16 point butterflies, twiddle step 16
+	for (i = 0; i < 256; i += 16) {
+		for (k = 0; k < 8; k++) {
+			butterfly(&z[i + k], &z[i + k + 8], fftTwiddle512[k * 16]);
+		}
+	}
+
+	// stage 5: 32 point butterflies, twiddle step 8
+	for (i = 0; i < 256; i += 32) {
+		for (k = 0; k < 16; k++) {
+			butterfly(&z[i + k], &z[i + k + 16], fftTwiddle512[k * 8]);
+		}
+	}
+
+	// stage 6: 64 point butterflies, twiddle step 4
+	for (i = 0; i < 256; i += 64) {
+		for (k = 0; k < 32; k++) {
+			butterfly(&z[i + k], &z[i + k + 32], fftTwiddle512[k * 4]);
+		}
+	}
+
+	// stage 7: 128 point butterflies, twiddle step 2
+	for (i = 0; i < 256; i += 128) {
+		for (k = 0; k < 64; k++) {
+			butterfly(&z[i + k], &z[i + k + 64], fftTwiddle512[k * 2]);
+		}
+	}
+
+	// stage 8: 256 point butterflies, twiddle step 1
+	for (i = 0; i < 256; i += 256) {
+		for (k = 0; k < 128; k++) {
+			butterfly(&z[i + k], &z[i + k + 128], fftTwiddle512[k]);
+		}
+	}
+
+	splitMagnitude(z, splitTwiddle512, 256, magnitude);
+}
+
+/* 1024 point real FFT: 512 point complex FFT, 9 stages */
+static const uint32_t fftTwiddle1024[256] = {
+		0x00007FFF, 0x01927FFE, 0x03247FF6, 0x04B67FEA, 0x06487FD9, 0x07D97FC2,
+		0x096B7FA7, 0x0AFB7F87, 0x0C8C7F62, 0x0E1C7F38, 0x0FAB7F0A, 0x113A7ED6,
+		0x12C87E9D, 0x14557E60, 0x15E27E1E, 0x176E7DD6, 0x18F97D8A, 0x1A837D3A,
+		0x1C0C7CE4, 0x1D937C89, 0x1F1A7C2A, 0x209F7BC6, 0x22247B5D, 0x23A77AEF,
+		0x25287A7D, 0x26A87A06, 0x2827798A, 0x29A4790A, 0x2B1F7885, 0x2C9977FB,
+		0x2E11776C, 0x2F8776D9, 0x30FC7642, 0x326E75A6, 0x33DF7505, 0x354E7460,
+		0x36BA73B6, 0x38257308, 0x398D7255, 0x3AF3719E, 0x3C5770E3, 0x3DB87023,
+		0x3F176F5F, 0x40746E97, 0x41CE6DCA, 0x43266CF9, 0x447B6C24, 0x45CD6B4B,
+		0x471D6A6E, 0x486A698C, 0x49B468A7, 0x4AFB67BD, 0x4C4066D0, 0x4D8165DE,
+		0x4EC064E9, 0x4FFB63EF, 0x513462F2, 0x526961F1, 0x539B60EC, 0x54CA5FE4,
+		0x55F65ED7, 0x571E5DC8, 0x58435CB4, 0x59645B9D, 0x5A825A82, 0x5B9D5964,
+		0x5CB45843, 0x5DC8571E, 0x5ED755F6, 0x5FE454CA, 0x60EC539B, 0x61F15269,
+		0x62F25134, 0x63EF4FFB, 0x64E94EC0, 0x65DE4D81, 0x66D04C40, 0x67BD4AFB,
+		0x68A749B4, 0x698C486A, 0x6A6E471D, 0x6B4B45CD, 0x6C24447B, 0x6CF94326,
+		0x6DCA41CE, 0x6E974074, 0x6F5F3F17, 0x70233DB8, 0x70E33C57, 0x719E3AF3,
+		0x7255398D, 0x73083825, 0x73B636BA, 0x7460354E, 0x750533DF, 0x75A6326E,
+		0x764230FC, 0x76D92F87, 0x776C2E11, 0x77FB2C99, 0x78852B1F, 0x790A29A4,
+		0x798A2827, 0x7A0626A8, 0x7A7D2528, 0x7AEF23A7, 0x7B5D2224, 0x7BC6209F,
+		0x7C2A1F1A, 0x7C891D93, 0x7CE41C0C, 0x7D3A1A83, 0x7D8A18F9, 0x7DD6176E,
+		0x7E1E15E2, 0x7E601455, 0x7E9D12C8, 0x7ED6113A, 0x7F0A0FAB, 0x7F380E1C,
+		0x7F620C8C, 0x7F870AFB, 0x7FA7096B, 0x7FC207D9, 0x7FD90648, 0x7FEA04B6,
+		0x7FF60324, 0x7FFE0192, 0x7FFF0000, 0x7FFEFE6E, 0x7FF6FCDC, 0x7FEAFB4A,
+		0x7FD9F9B8, 0x7FC2F827, 0x7FA7F695, 0x7F87F505, 0x7F62F374, 0x7F38F1E4,
+		0x7F0AF055, 0x7ED6EEC6, 0x7E9DED38, 0x7E60EBAB, 0x7E1EEA1E, 0x7DD6E892,
+		0x7D8AE707, 0x7D3AE57D, 0x7CE4E3F4, 0x7C89E26D, 0x7C2AE0E6, 0x7BC6DF61,
+		0x7B5DDDDC, 0x7AEFDC59, 0x7A7DDAD8, 0x7A06D958, 0x798AD7D9, 0x790AD65C,
+		0x7885D4E1, 0x77FBD367, 0x776CD1EF, 0x76D9D079, 0x7642CF04, 0x75A6CD92,
+		0x7505CC21, 0x7460CAB2, 0x73B6C946, 0x7308C7DB, 0x7255C673, 0x719EC50D,
+		0x70E3C3A9, 0x7023C248, 0x6F5FC0E9, 0x6E97BF8C, 0x6DCABE32, 0x6CF9BCDA,
+		0x6C24BB85, 0x6B4BBA33, 0x6A6EB8E3, 0x698CB796, 0x68A7B64C, 0x67BDB505,
+		0x66D0B3C0, 0x65DEB27F, 0x64E9B140, 0x63EFB005, 0x62F2AECC, 0x61F1AD97,
+		0x60ECAC65, 0x5FE4AB36, 0x5ED7AA0A, 0x5DC8A8E2, 0x5CB4A7BD, 0x5B9DA69C,
+		0x5A82A57E, 0x5964A463, 0x5843A34C, 0x571EA238, 0x55F6A129, 0x54CAA01C,
+		0x539B9F14, 0x52699E0F, 0x51349D0E, 0x4FFB9C11, 0x4EC09B17, 0x4D819A22,
+		0x4C409930, 0x4AFB9843, 0x49B49759, 0x486A9674, 0x471D9592, 0x45CD94B5,
+		0x447B93DC, 0x43269307, 0x41CE9236, 0x40749169, 0x3F1790A1, 0x3DB88FDD,
+		0x3C578F1D, 0x3AF38E62, 0x398D8DAB, 0x38258CF8, 0x36BA8C4A, 0x354E8BA0,
+		0x33DF8AFB, 0x326E8A5A, 0x30FC89BE, 0x2F878927, 0x2E118894, 0x2C998805,
+		0x2B1F877B, 0x29A486F6, 0x28278676, 0x26A885FA, 0x25288583, 0x23A78511,
+		0x222484A3, 0x209F843A, 0x1F1A83D6, 0x1D938377, 0x1C0C831C, 0x1A8382C6,
+		0x18F98276, 0x176E822A, 0x15E281E2, 0x145581A0, 0x12C88163, 0x113A812A,
+		0x0FAB80F6, 0x0E1C80C8, 0x0C8C809E, 0x0AFB8079, 0x096B8059, 0x07D9803E,
+		0x06488027, 0x04B68016, 0x0324800A, 0x01928002
+};
+
+static const uint32_t splitTwiddle1024[511] = {
+		0x00C97FFF, 0x01927FFE, 0x025B7FFA, 0x03247FF6, 0x03ED7FF1, 0x04B67FEA,
+		0x057F7FE2, 0x06487FD9, 0x07117FCE, 0x07D97FC2, 0x08A27FB5, 0x096B7FA7,
+		0x0A337F98, 0x0AFB7F87, 0x0BC47F75, 0x0C8C7F62, 0x0D547F4E, 0x0E1C7F38,
+		0x0EE47F22, 0x0FAB7F0A, 0x10737EF0, 0x113A7ED6, 0x12017EBA, 0x12C87E9D,
+		0x138F7E7F, 0x14557E60, 0x151C7E3F, 0x15E27E1E, 0x16A87DFB, 0x176E7DD6,
+		0x18337DB1, 0x18F97D8A, 0x19BE7D63, 0x1A837D3A, 0x1B477D0F, 0x1C0C7CE4,
+		0x1CD07CB7, 0x1D937C89, 0x1E577C5A, 0x1F1A7C2A, 0x1FDD7BF9, 0x209F7BC6,
+		0x21627B92, 0x22247B5D, 0x22E57B27, 0x23A77AEF, 0x24677AB7, 0x25287A7D,
+		0x25E87A42, 0x26A87A06, 0x276879C9, 0x2827798A, 0x28E5794A, 0x29A4790A,
+		0x2A6278C8, 0x2B1F7885, 0x2BDC7840, 0x2C9977FB, 0x2D5577B4, 0x2E11776C,
+		0x2ECC7723, 0x2F8776D9, 0x3042768E, 0x30FC7642, 0x31B575F4, 0x326E75A6,
+		0x33277556, 0x33DF7505, 0x349774B3, 0x354E7460, 0x3604740B, 0x36BA73B6,
+		0x3770735F, 0x38257308, 0x38D972AF, 0x398D7255, 0x3A4071FA, 0x3AF3719E,
+		0x3BA57141, 0x3C5770E3, 0x3D087083, 0x3DB87023, 0x3E686FC2, 0x3F176F5F,
+		0x3FC66EFB, 0x40746E97, 0x41216E31, 0x41CE6DCA, 0x427A6D62, 0x43266CF9,
+		0x43D16C8F, 0x447B6C24, 0x45246BB8, 0x45CD6B4B, 0x46756ADD, 0x471D6A6E,
+		0x47C469FD, 0x486A698C, 0x490F691A, 0x49B468A7, 0x4A586832, 0x4AFB67BD,
+		0x4B9E6747, 0x4C4066D0, 0x4CE16657, 0x4D8165DE, 0x4E216564, 0x4EC064E9,
+		0x4F5E646C, 0x4FFB63EF, 0x50986371, 0x513462F2, 0x51CF6272, 0x526961F1,
+		0x5303616F, 0x539B60EC, 0x54336068, 0x54CA5FE4, 0x55605F5E, 0x55F65ED7,
+		0x568A5E50, 0x571E5DC8, 0x57B15D3E, 0x58435CB4, 0x58D45C29, 0x59645B9D,
+		0x59F45B10, 0x5A825A82, 0x5B1059F4, 0x5B9D5964, 0x5C2958D4, 0x5CB45843,
+		0x5D3E57B1, 0x5DC8571E, 0x5E50568A, 0x5ED755F6, 0x5F5E5560, 0x5FE454CA,
+		0x60685433, 0x60EC539B, 0x616F5303, 0x61F15269, 0x627251CF, 0x62F25134,
+		0x63715098, 0x63EF4FFB, 0x646C4F5E, 0x64E94EC0, 0x65644E21, 0x65DE4D81,
+		0x66574CE1, 0x66D04C40, 0x67474B9E, 0x67BD4AFB, 0x68324A58, 0x68A749B4,
+		0x691A490F, 0x698C486A, 0x69FD47C4, 0x6A6E471D, 0x6ADD4675, 0x6B4B45CD,
+		0x6BB84524, 0x6C24447B, 0x6C8F43D1, 0x6CF94326, 0x6D62427A, 0x6DCA41CE,
+		0x6E314121, 0x6E974074, 0x6EFB3FC6, 0x6F5F3F17, 0x6FC23E68, 0x70233DB8,
+		0x70833D08, 0x70E33C57, 0x71413BA5, 0x719E3AF3, 0x71FA3A40, 0x7255398D,
+		0x72AF38D9, 0x73083825, 0x735F3770, 0x73B636BA, 0x740B3604, 0x7460354E,
+		0x74B33497, 0x750533DF, 0x75563327, 0x75A6326E, 0x75F431B5, 0x764230FC,
+		0x768E3042, 0x76D92F87, 0x77232ECC, 0x776C2E11, 0x77B42D55, 0x77FB2C99,
+		0x78402BDC, 0x78852B1F, 0x78C82A62, 0x790A29A4, 0x794A28E5, 0x798A2827,
+		0x79C92768, 0x7A0626A8, 0x7A4225E8, 0x7A7D2528, 0x7AB72467, 0x7AEF23A7,
+		0x7B2722E5, 0x7B5D2224, 0x7B922162, 0x7BC6209F, 0x7BF91FDD, 0x7C2A1F1A,
+		0x7C5A1E57, 0x7C891D93, 0x7CB71CD0, 0x7CE41C0C, 0x7D0F1B47, 0x7D3A1A83,
+		0x7D6319BE, 0x7D8A18F9, 0x7DB11833, 0x7DD6176E, 0x7DFB16A8, 0x7E1E15E2,
+		0x7E3F151C, 0x7E601455, 0x7E7F138F, 0x7E9D12C8, 0x7EBA1201, 0x7ED6113A,
+		0x7EF01073, 0x7F0A0FAB, 0x7F220EE4, 0x7F380E1C, 0x7F4E0D54, 0x7F620C8C,
+		0x7F750BC4, 0x7F870AFB, 0x7F980A33, 0x7FA7096B, 0x7FB508A2, 0x7FC207D9,
+		0x7FCE0711, 0x7FD90648, 0x7FE2057F, 0x7FEA04B6, 0x7FF103ED, 0x7FF60324,
+		0x7FFA025B, 0x7FFE0192, 0x7FFF00C9, 0x7FFF0000, 0x7FFFFF37, 0x7FFEFE6E,
+		0x7FFAFDA5, 0x7FF6FCDC, 0x7FF1FC13, 0x7FEAFB4A, 0x7FE2FA81, 0x7FD9F9B8,
+		0x7FCEF8EF, 0x7FC2F827, 0x7FB5F75E, 0x7FA7F695, 0x7F98F5CD, 0x7F87F505,
+		0x7F75F43C, 0x7F62F374, 0x7F4EF2AC, 0x7F38F1E4, 0x7F22F11C, 0x7F0AF055,
+		0x7EF0EF8D, 0x7ED6EEC6, 0x7EBAEDFF, 0x7E9DED38, 0x7E7FEC71, 0x7E60EBAB,
+		0x7E3FEAE4, 0x7E1EEA1E, 0x7DFBE958, 0x7DD6E892, 0x7DB1E7CD, 0x7D8AE707,
+		0x7D63E642, 0x7D3AE57D, 0x7D0FE4B9, 0x7CE4E3F4, 0x7CB7E330, 0x7C89E26D,
+		0x7C5AE1A9, 0x7C2AE0E6, 0x7BF9E023, 0x7BC6DF61, 0x7B92DE9E, 0x7B5DDDDC,
+		0x7B27DD1B, 0x7AEFDC59, 0x7AB7DB99, 0x7A7DDAD8, 0x7A42DA18, 0x7A06D958,
+		0x79C9D898, 0x798AD7D9, 0x794AD71B, 0x790AD65C, 0x78C8D59E, 0x7885D4E1,
+		0x7840D424, 0x77FBD367, 0x77B4D2AB, 0x776CD1EF, 0x7723D134, 0x76D9D079,
+		0x768ECFBE, 0x7642CF04, 0x75F4CE4B, 0x75A6CD92, 0x7556CCD9, 0x7505CC21,
+		0x74B3CB69, 0x7460CAB2, 0x740BC9FC, 0x73B6C946, 0x735FC890, 0x7308C7DB,
+		0x72AFC727, 0x7255C673, 0x71FAC5C0, 0x719EC50D, 0x7141C45B, 0x70E3C3A9,
+		0x7083C2F8, 0x7023C248, 0x6FC2C198, 0x6F5FC0E9, 0x6EFBC03A, 0x6E97BF8C,
+		0x6E31BEDF, 0x6DCABE32, 0x6D62BD86, 0x6CF9BCDA, 0x6C8FBC2F, 0x6C24BB85,
+		0x6BB8BADC, 0x6B4BBA33, 0x6ADDB98B, 0x6A6EB8E3, 0x69FDB83C, 0x698CB796,
+		0x691AB6F1, 0x68A7B64C, 0x6832B5A8, 0x67BDB505, 0x6747B462, 0x66D0B3C0,
+		0x6657B31F, 0x65DEB27F, 0x6564B1DF, 0x64E9B140, 0x646CB0A2, 0x63EFB005,
+		0x6371AF68, 0x62F2AECC, 0x6272AE31, 0x61F1AD97, 0x616FACFD, 0x60ECAC65,
+		0x6068ABCD, 0x5FE4AB36, 0x5F5EAAA0, 0x5ED7AA0A, 0x5E50A976, 0x5DC8A8E2,
+		0x5D3EA84F, 0x5CB4A7BD, 0x5C29A72C, 0x5B9DA69C, 0x5B10A60C, 0x5A82A57E,
+		0x59F4A4F0, 0x5964A463, 0x58D4A3D7, 0x5843A34C, 0x57B1A2C2, 0x571EA238,
+		0x568AA1B0, 0x55F6A129, 0x5560A0A2, 0x54CAA01C, 0x54339F98, 0x539B9F14,
+		0x53039E91, 0x52699E0F, 0x51CF9D8E, 0x51349D0E, 0x50989C8F, 0x4FFB9C11,
+		0x4F5E9B94, 0x4EC09B17, 0x4E219A9C, 0x4D819A22, 0x4CE199A9, 0x4C409930,
+		0x4B9E98B9, 0x4AFB9843, 0x4A5897CE, 0x49B49759, 0x490F96E6, 0x486A9674,
+		0x47C49603, 0x471D9592, 0x46759523, 0x45CD94B5, 0x45249448, 0x447B93DC,
+		0x43D19371, 0x43269307, 0x427A929E, 0x41CE9236, 0x412191CF, 0x40749169,
+		0x3FC69105, 0x3F1790A1, 0x3E68903E, 0x3DB88FDD, 0x3D088F7D, 0x3C578F1D,
+		0x3BA58EBF, 0x3AF38E62, 0x3A408E06, 0x398D8DAB, 0x38D98D51, 0x38258CF8,
+		0x37708CA1, 0x36BA8C4A, 0x36048BF5, 0x354E8BA0, 0x34978B4D, 0x33DF8AFB,
+		0x33278AAA, 0x326E8A5A, 0x31B58A0C, 0x30FC89BE, 0x30428972, 0x2F878927,
+		0x2ECC88DD, 0x2E118894, 0x2D55884C, 0x2C998805, 0x2BDC87C0, 0x2B1F877B,
+		0x2A628738, 0x29A486F6, 0x28E586B6, 0x28278676, 0x27688637, 0x26A885FA,
+		0x25E885BE, 0x25288583, 0x24678549, 0x23A78511, 0x22E584D9, 0x222484A3,
+		0x2162846E, 0x209F843A, 0x1FDD8407, 0x1F1A83D6, 0x1E5783A6, 0x1D938377,
+		0x1CD08349, 0x1C0C831C, 0x1B4782F1, 0x1A8382C6, 0x19BE829D, 0x18F98276,
+		0x1833824F, 0x176E822A, 0x16A88205, 0x15E281E2, 0x151C81C1, 0x145581A0,
+		0x138F8181, 0x12C88163, 0x12018146, 0x113A812A, 0x10738110, 0x0FAB80F6,
+		0x0EE480DE, 0x0E1C80C8, 0x0D5480B2, 0x0C8C809E, 0x0BC4808B, 0x0AFB8079,
+		0x0A338068, 0x096B8059, 0x08A2804B, 0x07D9803E, 0x07118032, 0x06488027,
+		0x057F801E, 0x04B68016, 0x03ED800F, 0x0324800A, 0x025B8006, 0x01928002,
+		0x00C98001
+};
+
+static const uint16_t bitRevSwaps1024[480] = {
+		1, 256, 2, 128, 3, 384, 4, 64, 5, 320, 6, 192,
+		7, 448, 8, 32, 9, 288, 10, 160, 11, 416, 12, 96,
+		13, 352, 14, 224, 15, 480, 17, 272, 18, 144, 19, 400,
+		20, 80, 21, 336, 22, 208, 23, 464, 24, 48, 25, 304,
+		26, 176, 27, 432, 28, 112, 29, 368, 30, 240, 31, 496,
+		33, 264, 34, 136, 35, 392, 36, 72, 37, 328, 38, 200,
+		39, 456, 41, 296, 42, 168, 43, 424, 44, 104, 45, 360,
+		46, 232, 47, 488, 49, 280, 50, 152, 51, 408, 52, 88,
+		53, 344, 54, 216, 55, 472, 57, 312, 58, 184, 59, 440,
+		60, 120, 61, 376, 62, 248, 63, 504, 65, 260, 66, 132,
+		67, 388, 69, 324, 70, 196, 71, 452, 73, 292, 74, 164,
+		75, 420, 76, 100, 77, 356, 78, 228, 79, 484, 81, 276,
+		82, 148, 83, 404, 85, 340, 86, 212, 87, 468, 89, 308,
+		90, 180, 91, 436, 92, 116, 93, 372, 94, 244, 95, 500,
+		97, 268, 98, 140, 99, 396, 101, 332, 102, 204, 103, 460,
+		105, 300, 106, 172, 107, 428, 109, 364, 110, 236, 111, 492,
+		113, 284, 114, 156, 115, 412, 117, 348, 118, 220, 119, 476,
+		121, 316, 122, 188, 123, 444, 125, 380, 126, 252, 127, 508,
+		129, 258, 131, 386, 133, 322, 134, 194, 135, 450, 137, 290,
+		138, 162, 139, 418, 141, 354, 142, 226, 143, 482, 145, 274,
+		147, 402, 149, 338, 150, 210, 151, 466, 153, 306, 154, 178,
+		155, 434, 157, 370, 158, 242, 159, 498, 161, 266, 163, 394,
+		165, 330, 166, 202, 167, 458, 169, 298, 171, 426, 173, 362,
+		174, 234, 175, 490, 177, 282, 179, 410, 181, 346, 182, 218,
+		183, 474, 185, 314, 187, 442, 189, 378, 190, 250, 191, 506,
+		193, 262, 195, 390, 197, 326, 199, 454, 201, 294, 203, 422,
+		205, 358, 206, 230, 207, 486, 209, 278, 211, 406, 213, 342,
+		215, 470, 217, 310, 219, 438, 221, 374, 222, 246, 223, 502,
+		225, 270, 227, 398, 229, 334, 231, 462, 233, 302, 235, 430,
+		237, 366, 239, 494, 241, 286, 243, 414, 245, 350, 247, 478,
+		249, 318, 251, 446, 253, 382, 255, 510, 259, 385, 261, 321,
+		263, 449, 265, 289, 267, 417, 269, 353, 271, 481, 275, 401,
+		277, 337, 279, 465, 281, 305, 283, 433, 285, 369, 287, 497,
+		291, 393, 293, 329, 295, 457, 299, 425, 301, 361, 303, 489,
+		307, 409, 309, 345, 311, 473, 315, 441, 317, 377, 319, 505,
+		323, 389, 327, 453, 331, 421, 333, 357, 335, 485, 339, 405,
+		343, 469, 347, 437, 349, 373, 351, 501, 355, 397, 359, 461,
+		363, 429, 367, 493, 371, 413, 375, 477, 379, 445, 383, 509,
+		391, 451, 395, 419, 399, 483, 407, 467, 411, 435, 415, 499,
+		423, 459, 431, 491, 439, 475, 447, 507, 463, 487, 479, 503
+};
+
+/** @brief Magnitude spectrum of a 1024 sample frame.
+ * The frame is used as workspace and is overwritten.
+ */
+void fftKernel_rfftMag1024(q15_t *frame, q15_t *magnitude) {
+	uint32_t *z = (uint32_t*) frame;
+	int i, k;
+
+	bitReverse(z, bitRevSwaps1024, 240);
+
+	// stage 1: 2 point butterflies, W = 1
+	for (i = 0; i < 512; i += 2) {
+		butterflyQuarter(&z[i], &z[i + 1]);
+	}
+
+	// stage 2: 4 point butterflies, W = 1 and -j
+	for (i = 0; i < 512; i += 4) {
+		butterflyHalf(&z[i], &z[i + 2]);
+		butterflyMinusJ(&z[i + 1], &z[i + 3]);
+	}
+
+	// stage 3: 8 point butterflies, twiddle step 64
+	for (i = 0; i < 512; i += 8) {
+		for (k = 0; k < 4; k++) {
+			butterfly(&z[i + k], &z[i + k + 4], fftTwiddle1024[k * 64]);
+		}
+	}
+
+	// stage 4: 16 point butterflies, twiddle step 32
+	for (i = 0; i < 512; i += 16) {
+		for (k = 0; k < 8; k++) {
+			butterfly(&z[i + k], &z[i + k + 8], fftTwiddle1024[k * 32]);
+		}
+	}
+
+	// stage 5: 32 point butterflies, twiddle step 16
+	for (i = 0; i < 512; i += 32) {
+		for (k = 0; k < 16; k++) {
+			butterfly(&z[i + k], &z[i + k + 16], fftTwiddle1024[k * 16]);
+		}
+	}
+
+	// stage 6: 64 point butterflies, twiddle step 8
+	for (i = 0; i < 512; i += 64) {
+		for (k = 0; k < 32; k++) {
+			butterfly(&z[i + k], &z[i + k + 32], fftTwiddle1024[k * 8]);
+		}
+	}
+
+	// stage 7: 128 point butterflies, twiddle step 4
+	for (i = 0; i < 512; i += 128) {
+		for (k = 0; k < 64; k++) {
+			butterfly(&z[i + k], &z[i + k + 64], fftTwiddle1024[k * 4]);
+		}
+	}
+
+	// stage 8: 256 point butterflies, twiddle step 2
+	for (i = 0; i < 512; i += 256) {
+		for (k = 0; k < 128; k++) {
+			butterfly(&z[i + k], &z[i + k + 128], fftTwiddle1024[k * 2]);
+		}
+	}
+
+	// stage 9: 512 point butterflies, twiddle step 1
+	for (i = 0; i < 512; i += 512) {
+		for (k = 0; k < 256; k++) {
+			butterfly(&z[i + k], &z[i + k + 256], fftTwiddle1024[k]);
+		}
+	}
+
+	splitMagnitude(z, splitTwiddle1024, 512, magnitude);
+}
+
+/** @brief Get the kernel for an FFT size.
+ *
+ * @return The kernel, NULL if no kernel was generated for the size.
+ */
+FftKernel fftKernel_select(int fftSize) {
+	switch (fftSize) {
+		case 128:
+			return fftKernel_rfftMag128;
+		case 256:
+			return fftKernel_rfftMag256;
+		case 512:
+			return fftKernel_rfftMag512;
+		case 1024:
+			return fftKernel_rfftMag1024;
+		default:
+			return NULL;
+	}
+}
@@ -0,0 +1,32 @@
+/** @file fft_kernels.h
+ * @brief Fixed-size real FFT + magnitude kernels for audio analysis.
+ *
+ * GENERATED by Tools/gen_fft_kernels.py, do not edit by hand.
+ *
+ * Each kernel gives the same result as arm_rfft_q15 followed by
+ * arm_cmplx_mag_q15 on fftSize/2 + 1 bins, but is specialized for its size:
+ * constant loop bounds and strides, multiply-free first stages, and twiddle
+ * and bit-reversal tables in flash. The magnitude is taken in 32 bits, so
+ * bins too quiet for arm_cmplx_mag_q15 (which reads them as 0) are kept.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#ifndef MODULES_AUDIO_ANALYSIS_FFT_KERNELS_H_
+#define MODULES_AUDIO_ANALYSIS_FFT_KERNELS_H_
+
+#include <stdint.h>
+#include "arm_math.h"
+
+/** Kernel computing the magnitude spectrum of one frame in place. */
+typedef void (*FftKernel)(q15_t *frame, q15_t *magnitude);
+
+/** Function Prototypes */
+FftKernel fftKernel_select(int fftSize);
+void fftKernel_rfftMag128(q15_t *frame, q15_t *magnitude);
+void fftKernel_rfftMag256(q15_t *frame, q15_t *magnitude);
+void fftKernel_rfftMag512(q15_t *frame, q15_t *magnitude);
+void fftKernel_rfftMag1024(q15_t *frame, q15_t *magnitude);
+
+#endif /* MODULES_AUDIO_ANALYSIS_FFT_KERNELS_H_ */
@@ -0,0 +1,40 @@
+/** @file fixed_point.c
+ * @brief Fixed point helpers shared by the analysis stages.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#include "fixed_point.h"
+
+/** log2(1 + i/32) in Q16, for i = 0 to 32 */
+static const uint32_t log2Table[33] = {
+		0, 2909, 5732, 8473, 11136, 13727, 16248, 18704, 21098, 23433, 25711,
+		27936, 30109, 32234, 34312, 36346, 38336, 40286, 42196, 44068, 45904,
+		47705, 49472, 51207, 52911, 54584, 56229, 57845, 59434, 60997, 62534,
+		64047, 65536
+};
+
+/** @brief Base 2 logarithm of a non-zero 64 bit value, in Q8.
+ * The leading one gives the integer part, the fraction comes from log2Table
+ * with linear interpolation on the 16 bits after it.
+ */
+int32_t log2Q8(uint64_t value) {
+	uint32_t high = (uint32_t) (value >> 32);
+	int msb = high != 0 ? 63 - __CLZ(high) : 31 - __CLZ((uint32_t) value);
+	uint32_t mantissa, index, fraction;
+
+	// 16 bits after the leading one
+	if (msb >= 16) {
+		mantissa = (uint32_t) (value >> (msb - 16)) & 0xFFFF;
+	}
+	else {
+		mantissa = (uint32_t) (value << (16 - msb)) & 0xFFFF;
+	}
+
+	index = mantissa >> 11;
+	fraction = log2Table[index] + (((log2Table[index + 1] - log2Table[index])
+	                                * (mantissa & 0x7FF)) >> 11);
+
+	return msb * 256 + (int32_t) ((fraction + 128) >> 8);
+}
@@ -0,0 +1,21 @@
+/** @file fixed_point.h
+ * @brief Fixed point helpers shared by the analysis stages that work on the
+ * log of the spectrum's power: the mel features, the spectral flux, the
+ * spectral shape and the template matcher.
+ *
+ * Logarithms are Q8 log2 values, 256 is one octave of power (about 3 dB).
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#ifndef MODULES_AUDIO_ANALYSIS_FIXED_POINT_H_
+#define MODULES_AUDIO_ANALYSIS_FIXED_POINT_H_
+
+#include <stdint.h>
+#include "arm_math.h"
+
+/** Function Prototypes */
+int32_t log2Q8(uint64_t value);
+
+#endif /* MODULES_AUDIO_ANALYSIS_FIXED_POINT_H_ */
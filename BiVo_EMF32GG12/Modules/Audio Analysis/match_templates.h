@@ -0,0 +1,26 @@
+/** @file match_templates.h
+ * @brief Spectrogram templates for the template matcher.
+ *
+ * GENERATED by Tools/make_templates.py, do not edit by hand.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#ifndef MODULES_AUDIO_ANALYSIS_MATCH_TEMPLATES_H_
+#define MODULES_AUDIO_ANALYSIS_MATCH_TEMPLATES_H_
+
+#include "template_matcher.h"
+
+/* Settings the templates were made with */
+#define MATCH_TEMPLATE_SAMPLE_RATE 19900
+#define MATCH_TEMPLATE_FFT_SIZE 256
+#define MATCH_TEMPLATE_DECIMATION 1
+#define MATCH_TEMPLATE_BANDS 16
+#define MATCH_TEMPLATE_FREQ_LOWER 1000
+#define MATCH_TEMPLATE_FREQ_UPPER 8000
+#define MATCH_TEMPLATE_COUNT 2
+
+extern const struct MatchTemplate matchTemplateSet[MATCH_TEMPLATE_COUNT];
+
+#endif /* MODULES_AUDIO_ANALYSIS_MATCH_TEMPLATES_H_ */
@@ -0,0 +1,280 @@
+/** @file mel_features.c
+ * @brief Mel filterbank and MFCC features of the analysis spectrum.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#include "mel_features.h"
+#include "mem_plan.h"
+
+/** Sparse filterbank, each band only stores the bins it covers */
+struct MelBand {
+		uint16_t firstBin;	// lowest bin with a non-zero weight
+		uint16_t count;			// number of bins covered
+		uint16_t offset;		// index of the band's first weight
+};
+
+static struct MelBand *_bands = NULL;
+static q15_t *_weights = NULL;			// triangle weights of all bands, in order
+static q15_t *_dctTable = NULL;			// orthonormal DCT-II, cepstra rows of bands
+static q15_t _logMel[MEL_MAX_BANDS];	// log energies of the current frame
+static int _bandCount = 0;
+static int _cepstra = 0;
+static int _weightCount = 0;
+static bool _haveScratch = false;
+static size_t _scratchMark = 0;			// DSP scratch use before the tables
+
+/** @brief Convert a frequency in Hz to mels.
+ */
+static float melFromHz(float freq) {
+	return 2595.0f * log10f(1.0f + freq / 700.0f);
+}
+
+/** @brief Convert mels to a frequency in Hz.
+ */
+static float hzFromMel(float mel) {
+	return 700.0f * (powf(10.0f, mel / 2595.0f) - 1.0f);
+}
+
+/** @brief Find the bins and weights of one triangular filter.
+ * Edges are given in fractional bins. A filter too narrow to contain a bin
+ * gets the bin nearest its center at full weight, so no band is empty.
+ *
+ * @param weights Written with the weights if not NULL, else only counted.
+ * @return Number of bins covered.
+ */
+static int triangle(float left, float center, float right, int lastBin,
+                    uint16_t *firstBin, q15_t *weights) {
+	int first = (int) ceilf(left);
+	int last = (int) floorf(right);
+	int count = 0;
+	float weight;
+
+	if (first < 0) {
+		first = 0;
+	}
+	if (last > lastBin) {
+		last = lastBin;
+	}
+
+	for (int bin = first; bin <= last; bin++) {
+		if (bin <= center) {
+			weight = (bin - left) / (center - left);
+		}
+		else {
+			weight = (right - bin) / (right - center);
+		}
+		// only a bin exactly on an outer edge has no weight
+		if (weight <= 0.0f) {
+			continue;
+		}
+		if (count == 0) {
+			*firstBin = bin;
+		}
+		if (weights != NULL) {
+			weights[count] = (q15_t) __SSAT((int32_t) (weight * 32768.0f + 0.5f), 16);
+		}
+		count++;
+	}
+
+	if (count == 0) {
+		*firstBin = (int) (center + 0.5f) < lastBin ? (int) (center + 0.5f) : lastBin;
+		if (weights != NULL) {
+			weights[0] = INT16_MAX;
+		}
+		count = 1;
+	}
+
+	return count;
+}
+
+/** @brief Initialize the mel feature extractor.
+ * Computes the sparse filterbank for the analysis configuration's bins and the
+ * DCT table, and prepares audio analysis for the configuration.
+ *
+ * @param config Filterbank and cepstrum settings.
+ * @param anlysConfig Analysis configuration the spectra will come from.
+ * @param sampleRate Sample rate of the audio, before any decimation.
+ * @return MEL_OK, or the reason the extractor could not be set up.
+ */
+enum Mel_Ecode melFeatures_init(struct MelConfig config,
+                                struct AnlysConfig anlysConfig,
+                                uint16_t sampleRate) {
+	float edges[MEL_MAX_BANDS + 2];
+	float melLower, melUpper, binsPerHz;
+	uint32_t frameStride;
+	int lastBin = anlysConfig.fftSize / 2;
+	int offset = 0;
+
+	// release tables of a previous configuration
+	melFeatures_deinit();
+
+	if (config.bands < 2 || config.bands > MEL_MAX_BANDS
+	    || config.cepstra < 0 || config.cepstra > config.bands
+	    || config.freqLower < 0 || config.freqUpper <= config.freqLower) {
+		return MEL_BAD_CONFIG;
+	}
+
+	// band edges, evenly spaced in mels, as fractional bins
+	frameStride = audioAnalysis_startSegment(anlysConfig);
+	if (frameStride == 0) {
+		return MEL_NO_MEMORY;
+	}
+	binsPerHz = (float) frameStride / sampleRate;
+	melLower = melFromHz(config.freqLower);
+	melUpper = melFromHz(config.freqUpper);
+	for (int i = 0; i < config.bands + 2; i++) {
+		edges[i] = hzFromMel(melLower + (melUpper - melLower) * i
+		                     / (config.bands + 1)) * binsPerHz;
+	}
+
+	// size the filterbank, then fill it in
+	_weightCount = 0;
+	for (int band = 0; band < config.bands; band++) {
+		uint16_t firstBin;
+		_weightCount += triangle(edges[band], edges[band + 1], edges[band + 2],
+		                         lastBin, &firstBin, NULL);
+	}
+
+	_scratchMark = memPlan_scratchMark();
+	_haveScratch = true;
+	_bands = memPlan_scratch( config.bands * sizeof(struct MelBand) );
+	_weights = memPlan_scratch( _weightCount * sizeof(q15_t) );
+	if (config.cepstra > 0) {
+		_dctTable = memPlan_scratch( config.cepstra * config.bands
+		                             * sizeof(q15_t) );
+	}
+	if (_bands == NULL || _weights == NULL
+	    || (config.cepstra > 0 && _dctTable == NULL)) {
+		melFeatures_deinit();
+		return MEL_NO_MEMORY;
+	}
+
+	for (int band = 0; band < config.bands; band++) {
+		_bands[band].offset = offset;
+		_bands[band].count = triangle(edges[band], edges[band + 1],
+		                              edges[band + 2], lastBin,
+		                              &_bands[band].firstBin, &_weights[offset]);
+		offset += _bands[band].count;
+	}
+
+	// orthonormal DCT-II, row j holds coefficient j's basis over the bands
+	for (int j = 0; j < config.cepstra; j++) {
+		float norm = sqrtf((j == 0 ? 1.0f : 2.0f) / config.bands);
+		for (int band = 0; band < config.bands; band++) {
+			float basis = norm * cosf(PI * j * (band + 0.5f) / config.bands);
+			_dctTable[j * config.bands + band] =
+					(q15_t) __SSAT((int32_t) roundf(basis * 32768.0f), 16);
+		}
+	}
+
+	_bandCount = config.bands;
+	_cepstra = config.cepstra;
+
+	return MEL_OK;
+}
+
+/** @brief De-initialize the mel feature extractor, giving its tables back to
+ * the DSP scratch.
+ */
+void melFeatures_deinit(void) {
+	if (_haveScratch) {
+		memPlan_scratchRewind(_scratchMark);
+		_haveScratch = false;
+	}
+	_bands = NULL;
+	_weights = NULL;
+	_dctTable = NULL;
+	_bandCount = 0;
+	_cepstra = 0;
+	_weightCount = 0;
+}
+
+/** @brief Number of feature values written per frame.
+ */
+int melFeatures_length(void) {
+	return _cepstra > 0 ? _cepstra : _bandCount;
+}
+
+/** @brief Bytes of RAM used by the extractor's tables and working buffer.
+ */
+uint32_t melFeatures_memory(void) {
+	return _bandCount * sizeof(struct MelBand)
+	       + _weightCount * sizeof(q15_t)
+	       + _cepstra * _bandCount * sizeof(q15_t)
+	       + sizeof(_logMel);
+}
+
+/** @brief Compute the features of one frame's spectrum.
+ *
+ * @param spectrum Spectrum from analyzeFrame.
+ * @param features Written with melFeatures_length() values.
+ */
+void melFeatures_frame(const struct AnlysSpectrum *spectrum, q15_t *features) {
+	// power is the squared magnitude, so it carries twice the block exponent,
+	// and the weights add 15 fraction bits
+	int32_t logOffset = (15 + 2 * spectrum->shift) * 256;
+	q63_t coefficient;
+
+	for (int band = 0; band < _bandCount; band++) {
+		const q15_t *magnitude = &spectrum->magnitude[_bands[band].firstBin];
+		const q15_t *weight = &_weights[_bands[band].offset];
+		uint64_t energy = 0;
+
+		for (int i = 0; i < _bands[band].count; i++) {
+			uint32_t power = (uint32_t) (magnitude[i] * magnitude[i]);
+			energy += (uint64_t) power * (uint16_t) weight[i];
+		}
+
+		if (energy == 0) {
+			_logMel[band] = MEL_LOG_FLOOR;
+		}
+		else {
+			_logMel[band] = (q15_t) __SSAT(log2Q8(energy) - logOffset, 16);
+		}
+	}
+
+	if (_cepstra == 0) {
+		memcpy(features, _logMel, _bandCount * sizeof(q15_t));
+		return;
+	}
+
+	// Q8 log energies times the Q15 basis, back to Q8
+	for (int j = 0; j < _cepstra; j++) {
+		arm_dot_prod_q15(_logMel, &_dctTable[j * _bandCount], _bandCount,
+		                 &coefficient);
+		features[j] = (q15_t) __SSAT((int32_t) (coefficient >> 15), 16);
+	}
+}
+
+/** @brief Compute the features of every frame of a segment.
+ * Frames are consecutive and non-overlapping, like analyzeAudio uses them.
+ *
+ * @param features Written with melFeatures_length() values per frame, must
+ * hold maxFrames frames.
+ * @return Number of frames written, 0 if the analysis could not be set up.
+ */
+uint32_t melFeatures_segment(int16_t *audioSamples, uint32_t bufferSize,
+                             struct AnlysConfig anlysConfig, q15_t *features,
+                             uint32_t maxFrames) {
+	struct AnlysSpectrum spectrum;
+	uint32_t frameStride = audioAnalysis_startSegment(anlysConfig);
+	uint32_t frames = 0;
+
+	if (frameStride == 0) {
+		return 0;
+	}
+
+	for (uint32_t copyOffset = 0;
+			copyOffset + frameStride <= bufferSize && frames < maxFrames;
+			copyOffset += frameStride) {
+		if (!analyzeFrame(&audioSamples[copyOffset], &spectrum)) {
+			break;
+		}
+		melFeatures_frame(&spectrum, &features[frames * melFeatures_length()]);
+		frames++;
+	}
+
+	return frames;
+}
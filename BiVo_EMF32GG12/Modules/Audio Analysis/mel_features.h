@@ -0,0 +1,60 @@
+/** @file mel_features.h
+ * @brief Mel filterbank and MFCC features of the analysis spectrum. The
+ * magnitude spectrum of each frame is summed into triangular bands evenly
+ * spaced on the mel scale, the log of each band's power is taken, and a DCT of
+ * the log energies gives the cepstral coefficients. Everything per frame is
+ * fixed point, the filter and DCT tables are computed once by melFeatures_init.
+ *
+ * Features are Q8 log2 values (256 is one octave of power, about 3 dB), on the
+ * scale of the spectrum's magnitude counts without the block exponent, so
+ * frames of different loudness compare directly.
+ *
+ * @note Built with ANLYS_FFT_CMSIS, arm_cmplx_mag_q15 reads quiet bins as 0
+ * and quiet bands fall to MEL_LOG_FLOOR. Use the generated kernels (the
+ * default) or the f32 backend for features.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#ifndef MODULES_AUDIO_ANALYSIS_MEL_FEATURES_H_
+#define MODULES_AUDIO_ANALYSIS_MEL_FEATURES_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+#include "arm_math.h"
+#include "audio_analysis.h"
+#include "fixed_point.h"
+
+#define MEL_MAX_BANDS 40				// most filters the feature extractor supports
+#define MEL_LOG_FLOOR (-48*256)	// log energy given to a band with no power
+
+/* Mel Feature Configuration */
+struct MelConfig {
+		int bands;			// number of triangular mel filters, up to MEL_MAX_BANDS
+		int cepstra;		// MFCCs per frame, 0 for the log mel energies instead
+		int freqLower;	// lower edge of the first filter, in Hz
+		int freqUpper;	// upper edge of the last filter, in Hz
+};
+
+/* Mel Feature Error Codes */
+enum Mel_Ecode {
+	MEL_OK = 0,
+	MEL_BAD_CONFIG = 1,
+	MEL_NO_MEMORY = 2
+};
+
+/* Function Prototypes */
+enum Mel_Ecode melFeatures_init(struct MelConfig config,
+                                struct AnlysConfig anlysConfig,
+                                uint16_t sampleRate);
+void melFeatures_deinit(void);
+int melFeatures_length(void);
+uint32_t melFeatures_memory(void);
+void melFeatures_frame(const struct AnlysSpectrum *spectrum, q15_t *features);
+uint32_t melFeatures_segment(int16_t *audioSamples, uint32_t bufferSize,
+                             struct AnlysConfig anlysConfig, q15_t *features,
+                             uint32_t maxFrames);
+
+#endif /* MODULES_AUDIO_ANALYSIS_MEL_FEATURES_H_ */
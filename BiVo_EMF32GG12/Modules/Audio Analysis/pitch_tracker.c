@@ -0,0 +1,209 @@
+/** @file pitch_tracker.c
+ * @brief YIN pitch tracker for tonal calls.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#include "pitch_tracker.h"
+
+#define PITCH_RELAXED_FACTOR 3		// threshold multiple for a fraction of the lag
+
+/** Working buffers, sized for the largest configuration */
+static q15_t _window[PITCH_MAX_WINDOW + PITCH_MAX_LAG + 2];	// normalized frame
+static q15_t _scratch[PITCH_MAX_WINDOW];				// differences at one lag
+static q63_t _difference[PITCH_MAX_LAG + 2];		// d(tau)
+static q15_t _normalized[PITCH_MAX_LAG + 2];		// d'(tau), Q15
+
+/** Lag range, set by pitchTracker_init */
+static struct PitchConfig _config;
+static uint16_t _sampleRate = 0;
+static int _minLag = 0;				// period of maxFreq, rounded down
+static int _maxLag = 0;				// period of minFreq, rounded up
+
+/** Operation variables */
+static bool _initializedFlag = false;
+
+/** @brief Copy a frame into the window, shifted so its peak fits in 14 bits.
+ * The differences of two samples then fit in q15 without saturating, and
+ * quiet frames keep their precision. d' is a ratio, so the shift does not
+ * change it.
+ */
+static void loadWindow(const int16_t *samples, int length) {
+	int32_t peak = 0;
+	int shift;
+
+	for (int n = 0; n < length; n++) {
+		int32_t magnitude = samples[n] < 0 ? -samples[n] : samples[n];
+		if (magnitude > peak) {
+			peak = magnitude;
+		}
+	}
+
+	// a peak under 2^14 has 18 or more leading zeros
+	shift = peak == 0 ? 0 : (int) __CLZ(peak) - 18;
+	arm_shift_q15((q15_t*) samples, shift, _window, length);
+}
+
+/** @brief Initialize the pitch tracker.
+ * The lags searched run from the period of maxFreq to that of minFreq. The
+ * shortest must be at least 2 samples so the period can be refined between
+ * its neighbours, and the longest at most PITCH_MAX_LAG.
+ *
+ * @param config Window, frequency range and threshold.
+ * @param sampleRate Calibrated sample rate of the audio.
+ * @return PITCH_OK, or PITCH_BAD_CONFIG.
+ */
+enum Pitch_Ecode pitchTracker_init(struct PitchConfig config,
+                                   uint16_t sampleRate) {
+	_initializedFlag = false;
+
+	if (config.windowSize < 1 || config.windowSize > PITCH_MAX_WINDOW
+	    || config.minFreq < 1 || config.minFreq >= config.maxFreq
+	    || config.threshold <= 0) {
+		return PITCH_BAD_CONFIG;
+	}
+
+	_minLag = sampleRate / config.maxFreq;
+	_maxLag = (sampleRate + config.minFreq - 1) / config.minFreq;
+	if (_minLag < 2 || _maxLag > PITCH_MAX_LAG) {
+		return PITCH_BAD_CONFIG;
+	}
+
+	_config = config;
+	_sampleRate = sampleRate;
+	_initializedFlag = true;
+
+	return PITCH_OK;
+}
+
+/** @brief Samples read by pitchTracker_frame from the start of a frame.
+ */
+uint32_t pitchTracker_frameLength(void) {
+	return _config.windowSize + _maxLag + 1;
+}
+
+/** @brief Estimate the f0 of one frame.
+ * d is found for every lag from 1 to one past the longest period, as d' at a
+ * lag depends on all the shorter ones and the parabola needs the neighbour.
+ * The first dip under the threshold is followed down to its minimum, so a
+ * period is not cut short on the falling edge. Without a dip, the lowest d'
+ * in range is reported as not voiced.
+ *
+ * @param samples pitchTracker_frameLength samples.
+ * @param estimate Written with the f0 and confidence.
+ */
+void pitchTracker_frame(const int16_t *samples, struct PitchEstimate *estimate) {
+	q63_t cumulative = 0;
+	int lag = 0;
+	int32_t before, at, after, curvature, offset;
+
+	estimate->f0 = 0;
+	estimate->confidence = 0;
+	estimate->voiced = false;
+	if (!_initializedFlag) {
+		return;
+	}
+
+	loadWindow(samples, pitchTracker_frameLength());
+
+	// cumulative mean normalized difference, d'(tau) = d(tau) tau / sum d(1..tau)
+	for (int tau = 1; tau <= _maxLag + 1; tau++) {
+		arm_sub_q15(_window, &_window[tau], _scratch, _config.windowSize);
+		arm_power_q15(_scratch, _config.windowSize, &_difference[tau]);
+		cumulative += _difference[tau];
+
+		if (cumulative == 0) {
+			_normalized[tau] = INT16_MAX;
+		}
+		else {
+			q63_t ratio = (_difference[tau] * tau << 15) / cumulative;
+			_normalized[tau] = (q15_t) (ratio > INT16_MAX ? INT16_MAX : ratio);
+		}
+	}
+
+	// first dip under the threshold, followed to its minimum
+	for (int tau = _minLag; tau <= _maxLag; tau++) {
+		if (_normalized[tau] < _config.threshold) {
+			while (tau < _maxLag && _normalized[tau + 1] < _normalized[tau]) {
+				tau++;
+			}
+			lag = tau;
+			estimate->voiced = true;
+			break;
+		}
+	}
+	if (lag == 0) {
+		lag = _minLag;
+		for (int tau = _minLag + 1; tau <= _maxLag; tau++) {
+			if (_normalized[tau] < _normalized[lag]) {
+				lag = tau;
+			}
+		}
+	}
+
+	// with periods of only a few samples, the true period can fall between two
+	// lags and miss the threshold while a multiple of it, landing closer to a
+	// whole lag, dips under. A dip near a fraction of the lag, under a relaxed
+	// threshold, is taken as the period instead.
+	for (int divisor = lag / _minLag; divisor >= 2; divisor--) {
+		int candidate = (lag + divisor/2) / divisor;
+		int lowest = candidate;
+
+		for (int tau = candidate - 1; tau <= candidate + 1; tau++) {
+			if (tau >= _minLag && _normalized[tau] < _normalized[lowest]) {
+				lowest = tau;
+			}
+		}
+		if (lowest >= _minLag
+		    && _normalized[lowest] < PITCH_RELAXED_FACTOR * _config.threshold
+		    && _normalized[lowest] <= _normalized[lowest - 1]
+		    && _normalized[lowest] <= _normalized[lowest + 1]) {
+			lag = lowest;
+			break;
+		}
+	}
+
+	// vertex of the parabola through the lag and its neighbours, Q8 lag. The
+	// raw difference keeps the shape of the dip better than d' at short lags.
+	before = (int32_t) (_difference[lag - 1] >> 16);
+	at = (int32_t) (_difference[lag] >> 16);
+	after = (int32_t) (_difference[lag + 1] >> 16);
+	curvature = before - 2 * at + after;
+	offset = curvature > 0
+	         ? (int32_t) (((int64_t) (before - after) << 7) / curvature) : 0;
+	offset = offset > 128 ? 128 : (offset < -128 ? -128 : offset);
+
+	estimate->f0 = ((uint32_t) _sampleRate << 8) / (lag * 256 + offset);
+	estimate->confidence = INT16_MAX - _normalized[lag];
+}
+
+/** @brief Track the f0 over part of a segment.
+ * Frames start every hop samples from start, up to end or to the last frame
+ * that fits in the buffer.
+ *
+ * @param start First sample of the first frame.
+ * @param end Sample frames stop starting at.
+ * @param hop Samples from one frame to the next.
+ * @param contour Written with one estimate per frame.
+ * @param maxPoints Most estimates to write.
+ * @return Number of estimates written.
+ */
+uint32_t pitchTracker_contour(const int16_t *audioSamples, uint32_t bufferSize,
+                              uint32_t start, uint32_t end, uint32_t hop,
+                              struct PitchEstimate *contour, uint32_t maxPoints) {
+	uint32_t count = 0;
+
+	if (!_initializedFlag || hop == 0) {
+		return 0;
+	}
+
+	for (uint32_t offset = start;
+			offset < end && offset + pitchTracker_frameLength() <= bufferSize
+			&& count < maxPoints;
+			offset += hop) {
+		pitchTracker_frame(&audioSamples[offset], &contour[count++]);
+	}
+
+	return count;
+}
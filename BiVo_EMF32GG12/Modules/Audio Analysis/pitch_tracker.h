@@ -0,0 +1,67 @@
+/** @file pitch_tracker.h
+ * @brief YIN pitch tracker for tonal calls. For each frame, the difference
+ * function d(tau) = sum (x[j] - x[j+tau])^2 over a window of windowSize
+ * samples is found for every lag up to the longest period of interest, then
+ * normalized by its running mean (the cumulative mean normalized difference,
+ * d'). The period is the first lag at which d' dips under the threshold,
+ * refined by a parabola through its neighbours, and the confidence is
+ * 1 - d' there.
+ *
+ * At the board's sample rate, bird calls have periods of only 2 to 40
+ * samples, so the difference function is computed directly rather than
+ * through an autocorrelation by FFT, which would need a zero padded FFT and
+ * its inverse of twice the window. Cost per frame is fixed by the
+ * configuration: (sampleRate/minFreq + 2) lags of windowSize subtractions and
+ * multiply-adds, whatever the audio holds.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#ifndef MODULES_AUDIO_ANALYSIS_PITCH_TRACKER_H_
+#define MODULES_AUDIO_ANALYSIS_PITCH_TRACKER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "arm_math.h"
+
+#define PITCH_MAX_WINDOW 256	// largest windowSize supported
+#define PITCH_MAX_LAG 80			// longest period supported, in samples
+
+/* Pitch Tracker Configuration
+ * A frame reads pitchTracker_frameLength samples, about windowSize +
+ * sampleRate/minFreq + 2. threshold is YIN's absolute threshold on d', 0.1 to
+ * 0.2 is usual. */
+struct PitchConfig {
+		int windowSize;			// samples compared at each lag
+		int minFreq;				// lowest f0 searched for, in Hz
+		int maxFreq;				// highest f0 searched for, in Hz
+		q15_t threshold;		// d' under which a dip is taken as the period
+};
+
+/** @struct Pitch Estimate
+ * f0 and confidence of one frame. f0 is reported even when the frame is not
+ * voiced, as the lag with the lowest d'.
+ */
+struct PitchEstimate {
+		uint16_t f0;					// fundamental frequency, in Hz
+		q15_t confidence;			// 1 - d' at the period, 0 to 1.0
+		bool voiced;					// d' dipped under the threshold
+};
+
+/** @enum Error codes the pitch tracker may respond with.
+ */
+enum Pitch_Ecode {
+	PITCH_OK = 0, PITCH_BAD_CONFIG = 1
+};
+
+/** Function Prototypes */
+enum Pitch_Ecode pitchTracker_init(struct PitchConfig config,
+                                   uint16_t sampleRate);
+uint32_t pitchTracker_frameLength(void);
+void pitchTracker_frame(const int16_t *samples, struct PitchEstimate *estimate);
+uint32_t pitchTracker_contour(const int16_t *audioSamples, uint32_t bufferSize,
+                              uint32_t start, uint32_t end, uint32_t hop,
+                              struct PitchEstimate *contour, uint32_t maxPoints);
+
+#endif /* MODULES_AUDIO_ANALYSIS_PITCH_TRACKER_H_ */
@@ -0,0 +1,119 @@
+/** @file spectral_flux.c
+ * @brief Spectral flux onset detection.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#include "spectral_flux.h"
+
+/** Band layout, set by spectralFlux_init */
+static uint16_t _bandEdges[FLUX_MAX_BANDS + 1];	// first bin of each band
+static int _bandCount = 0;
+
+/** State carried from frame to frame */
+static int32_t _previous[FLUX_MAX_BANDS];	// band log powers of the last frame, Q8
+static bool _havePrevious = false;				// false at the start of a segment
+static bool _armed = false;								// flux fell under the mean since the
+																						// last onset
+static int _sinceOnset = 0;								// frames since the last onset
+static int _minGap = 1;										// fewest frames from one onset to the next
+static int32_t _meanFlux = 0;							// running mean of the flux
+static int32_t _meanDeviation = 0;				// running mean of |flux - mean|
+static bool _primed = false;							// running averages hold a value
+
+/** @brief Set up the bands for the bins of the analysis band.
+ * The bins are split into FLUX_MAX_BANDS bands, or one band per bin if there
+ * are fewer. The running averages start over.
+ *
+ * @param lowerBin First bin of the analysis band.
+ * @param upperBin Last bin of the analysis band.
+ * @param minGap Fewest frames from one onset to the next.
+ */
+void spectralFlux_init(int lowerBin, int upperBin, int minGap) {
+	int bins = upperBin - lowerBin + 1;
+
+	_minGap = minGap > 1 ? minGap : 1;
+
+	_bandCount = bins < FLUX_MAX_BANDS ? bins : FLUX_MAX_BANDS;
+	if (_bandCount < 1) {
+		_bandCount = 0;
+		return;
+	}
+	for (int band = 0; band <= _bandCount; band++) {
+		_bandEdges[band] = lowerBin + band * bins / _bandCount;
+	}
+
+	_primed = false;
+	spectralFlux_reset();
+}
+
+/** @brief Start a new segment. The previous frame is forgotten, as segments
+ * are not necessarily back to back, but the running averages are kept.
+ */
+void spectralFlux_reset(void) {
+	_havePrevious = false;
+	_armed = true;
+	_sinceOnset = _minGap;
+}
+
+/** @brief Update the detector with the next frame's spectrum.
+ * The first frame of a segment only sets the previous frame. After an onset,
+ * the flux has to fall back under its running mean and minGap frames have to
+ * pass before the next one, so a call sweeping through the bands is one
+ * onset rather than one per band it enters.
+ *
+ * @param spectrum Spectrum from analyzeFrame.
+ * @param margin Flux over the adaptive threshold needed for an onset, Q8.
+ * @return true if the frame is an onset.
+ */
+bool spectralFlux_frame(const struct AnlysSpectrum *spectrum, int32_t margin) {
+	int32_t flux = 0, deviation, power, threshold;
+	bool onset = false;
+
+	for (int band = 0; band < _bandCount; band++) {
+		uint64_t energy = 1;
+
+		for (int bin = _bandEdges[band]; bin < _bandEdges[band + 1]; bin++) {
+			energy += (uint32_t) (spectrum->magnitude[bin] * spectrum->magnitude[bin]);
+		}
+
+		// log power with the block exponent taken out, so frames compare
+		power = log2Q8(energy) - 2 * spectrum->shift * 256;
+		if (_havePrevious && power > _previous[band]) {
+			flux += power - _previous[band];
+		}
+		_previous[band] = power;
+	}
+
+	if (!_havePrevious) {
+		_havePrevious = true;
+		return false;
+	}
+
+	if (!_primed) {
+		_meanFlux = flux;
+		_meanDeviation = 0;
+		_primed = true;
+	}
+
+	threshold = _meanFlux + FLUX_DEVIATIONS * _meanDeviation + margin;
+	if (_sinceOnset < _minGap) {
+		_sinceOnset++;
+	}
+	if (flux <= _meanFlux) {
+		_armed = true;
+	}
+	else if (_armed && _sinceOnset >= _minGap && flux > threshold) {
+		onset = true;
+		_armed = false;
+		_sinceOnset = 0;
+	}
+
+	// adapt to this frame after deciding, so an onset does not hide itself
+	deviation = flux > _meanFlux ? flux - _meanFlux : _meanFlux - flux;
+	_meanFlux += (flux - _meanFlux) >> FLUX_AVERAGE_SHIFT;
+	_meanDeviation += (deviation - _meanDeviation) >> FLUX_AVERAGE_SHIFT;
+
+	return onset;
+}
@@ -0,0 +1,39 @@
+/** @file spectral_flux.h
+ * @brief Spectral flux onset detection. The analysis band of each frame's
+ * spectrum is split into up to FLUX_MAX_BANDS equal bands, and the flux is the
+ * sum of the increases in each band's log power since the previous frame
+ * (half-wave rectified, decreases count as nothing). In log power, a call
+ * starting over background noise gives the same flux whether it is loud or
+ * far away, so onsets mark sudden spectral change rather than level.
+ *
+ * The threshold adapts to the recent flux: a running mean plus
+ * FLUX_DEVIATIONS times the running mean deviation, plus a fixed margin. The
+ * only state kept between frames is the previous frame's band powers, the
+ * two running averages and how long ago the last onset was.
+ *
+ * Flux and the margin are in Q8 log2 power, 256 being one octave (about 3 dB)
+ * summed over the bands.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#ifndef MODULES_AUDIO_ANALYSIS_SPECTRAL_FLUX_H_
+#define MODULES_AUDIO_ANALYSIS_SPECTRAL_FLUX_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "arm_math.h"
+#include "audio_analysis.h"
+#include "fixed_point.h"
+
+#define FLUX_MAX_BANDS 16			// most bands the analysis band is split into
+#define FLUX_AVERAGE_SHIFT 4	// running averages weigh a new frame by 1/16
+#define FLUX_DEVIATIONS 2			// mean deviations above the mean for an onset
+
+/** Function Prototypes */
+void spectralFlux_init(int lowerBin, int upperBin, int minGap);
+void spectralFlux_reset(void);
+bool spectralFlux_frame(const struct AnlysSpectrum *spectrum, int32_t margin);
+
+#endif /* MODULES_AUDIO_ANALYSIS_SPECTRAL_FLUX_H_ */
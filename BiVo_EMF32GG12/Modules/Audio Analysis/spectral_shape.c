@@ -0,0 +1,90 @@
+/** @file spectral_shape.c
+ * @brief Spectral shape features of a frame's analysis band.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#include "spectral_shape.h"
+
+/** 2^(-i/32) in Q15, for i = 0 to 32 */
+static const uint16_t exp2Table[33] = {
+		32768, 32066, 31379, 30706, 30048, 29405, 28774, 28158, 27554, 26964,
+		26386, 25821, 25268, 24726, 24196, 23678, 23170, 22674, 22188, 21713,
+		21247, 20792, 20347, 19911, 19484, 19066, 18658, 18258, 17867, 17484,
+		17109, 16743, 16384
+};
+
+/** @brief 2 to the power of a value of 0 or less in Q8, as q15.
+ * The integer part is a shift, the fraction comes from exp2Table with linear
+ * interpolation on the 3 bits below its step.
+ */
+static q15_t exp2Q8(int32_t value) {
+	uint32_t magnitude = value < 0 ? (uint32_t) -value : 0;
+	uint32_t shift = magnitude >> 8;
+	uint32_t index = (magnitude >> 3) & 31;
+	uint32_t fraction = magnitude & 7;
+	uint32_t result;
+
+	if (shift > 15) {
+		return 0;
+	}
+
+	result = exp2Table[index]
+	         - (((exp2Table[index] - exp2Table[index + 1]) * fraction) >> 3);
+	result >>= shift;
+
+	return (q15_t) (result > INT16_MAX ? INT16_MAX : result);
+}
+
+/** @brief Compute the shape features of one frame's analysis band.
+ * Each bin's power is its squared magnitude plus one, so an empty bin has a
+ * logarithm and a silent band reads as flat.
+ *
+ * @param spectrum Spectrum from analyzeFrame.
+ * @param lowerBin First bin of the analysis band.
+ * @param upperBin Last bin of the analysis band.
+ * @param sampleRate Sample rate of the audio, before any decimation.
+ * @param frameStride Full-rate samples per frame, from
+ * audioAnalysis_startSegment.
+ * @param shape Written with the features.
+ */
+void spectralShape_frame(const struct AnlysSpectrum *spectrum, int lowerBin,
+                         int upperBin, uint16_t sampleRate, uint32_t frameStride,
+                         struct SpectralShape *shape) {
+	int bins = upperBin - lowerBin + 1;
+	uint64_t total = 0, weightedLog = 0, weightedBin = 0;
+	int64_t logSum = 0;
+	int32_t logTotal, logBins, entropy;
+
+	if (bins < 2) {
+		shape->entropy = 0;
+		shape->flatness = 0;
+		shape->centroid = (uint32_t) lowerBin * sampleRate / frameStride;
+		return;
+	}
+
+	for (int bin = lowerBin; bin <= upperBin; bin++) {
+		uint32_t power = (uint32_t) (spectrum->magnitude[bin]
+		                             * spectrum->magnitude[bin]) + 1;
+		int32_t logPower = log2Q8(power);
+
+		total += power;
+		logSum += logPower;
+		weightedLog += (uint64_t) power * logPower;
+		weightedBin += (uint64_t) power * bin;
+	}
+
+	logTotal = log2Q8(total);
+	logBins = log2Q8(bins);
+
+	// H = log2(total) - sum(p log2 p) / total, over its largest value log2(bins)
+	entropy = logTotal - (int32_t) (weightedLog / total);
+	entropy = (entropy << 15) / logBins;
+	shape->entropy = (q15_t) __SSAT(entropy, 16);
+
+	// log2 of the geometric mean minus log2 of the arithmetic mean
+	shape->flatness = exp2Q8((int32_t) (logSum / bins) - (logTotal - logBins));
+
+	shape->centroid = (uint32_t) (weightedBin * sampleRate / (total * frameStride));
+}
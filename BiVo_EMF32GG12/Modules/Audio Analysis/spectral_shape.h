@@ -0,0 +1,46 @@
+/** @file spectral_shape.h
+ * @brief Spectral shape features of a frame's analysis band, to tell tonal
+ * calls from broadband noise like rain, wind and insect choruses.
+ *
+ * Entropy: of the band's power spectrum taken as a distribution, divided by
+ * its largest possible value (every bin equal). Near 0 for a pure tone, near
+ * 1.0 for white noise.
+ * Flatness: geometric over arithmetic mean of the bin powers. Near 0 for a
+ * tone, near 1.0 for white noise, and more sensitive than entropy to a few
+ * strong peaks over a noise floor.
+ * Centroid: power weighted mean frequency of the band, in Hz.
+ *
+ * Everything is fixed point, the logarithms come from log2Q8's lookup table.
+ * Neither entropy nor flatness depends on the frame's level.
+ *
+ * @note Built with ANLYS_FFT_CMSIS, arm_cmplx_mag_q15 reads quiet bins as 0,
+ * so noise reads as tonal and the gates pass it (bivo_check gates fails). Use
+ * the generated kernels (the default) or the f32 backend with the gates.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#ifndef MODULES_AUDIO_ANALYSIS_SPECTRAL_SHAPE_H_
+#define MODULES_AUDIO_ANALYSIS_SPECTRAL_SHAPE_H_
+
+#include <stdint.h>
+#include "arm_math.h"
+#include "audio_analysis.h"
+#include "fixed_point.h"
+
+/** @struct Spectral Shape
+ * Shape features of one frame's analysis band.
+ */
+struct SpectralShape {
+		q15_t entropy;				// normalized spectral entropy, 0 to 1.0
+		q15_t flatness;				// spectral flatness, 0 to 1.0
+		uint16_t centroid;		// spectral centroid, in Hz
+};
+
+/** Function Prototypes */
+void spectralShape_frame(const struct AnlysSpectrum *spectrum, int lowerBin,
+                         int upperBin, uint16_t sampleRate, uint32_t frameStride,
+                         struct SpectralShape *shape);
+
+#endif /* MODULES_AUDIO_ANALYSIS_SPECTRAL_SHAPE_H_ */
@@ -0,0 +1,283 @@
+/** @file template_matcher.c
+ * @brief Spectrogram template matching for target species.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#include "template_matcher.h"
+#include "mem_plan.h"
+
+/** Working buffers, taken from the DSP scratch by templateMatcher_init */
+static q15_t *_spectrogram = NULL;		// [band][frame], rows of _maxFrames
+static q15_t *_correlation = NULL;		// output of one band's correlation
+static int32_t *_products = NULL;			// template correlation at each offset
+static int64_t *_prefixSum = NULL;		// sum of the frames before each frame
+static int64_t *_prefixSquares = NULL;	// sum of squares of the same
+static uint16_t _bandEdges[MATCH_MAX_BANDS + 1];	// first bin of each band
+static struct MatchConfig _config;
+static uint32_t _maxFrames = 0;
+static bool _haveScratch = false;
+static size_t _scratchMark = 0;			// DSP scratch use before the buffers
+
+/** @brief Integer square root, rounded down.
+ */
+static uint32_t squareRoot(uint64_t value) {
+	uint64_t root = 0;
+	uint64_t bit = (uint64_t) 1 << 62;
+
+	while (bit > value) {
+		bit >>= 2;
+	}
+	while (bit != 0) {
+		if (value >= root + bit) {
+			value -= root + bit;
+			root = (root >> 1) + bit;
+		}
+		else {
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+
+	return (uint32_t) root;
+}
+
+/** @brief Log power of each band of a frame's spectrum, in Q8.
+ * The block exponent is taken out so frames compare directly.
+ */
+static void spectrogramColumn(const struct AnlysSpectrum *spectrum,
+                              uint32_t frame) {
+	for (int band = 0; band < _config.bands; band++) {
+		uint64_t energy = 0;
+		int32_t value = MEL_LOG_FLOOR;
+
+		for (int bin = _bandEdges[band]; bin < _bandEdges[band + 1]; bin++) {
+			energy += (uint32_t) (spectrum->magnitude[bin] * spectrum->magnitude[bin]);
+		}
+		if (energy != 0) {
+			value = log2Q8(energy) - 2 * spectrum->shift * 256;
+		}
+
+		_spectrogram[band * _maxFrames + frame] = (q15_t) __SSAT(value, 16);
+	}
+}
+
+/** @brief Remove the spectrogram's mean and clamp it to MATCH_RANGE, then sum
+ * the frames for the per-offset normalization.
+ * Neither the mean nor the clamp changes a score much: the templates are zero
+ * mean, and the range is 16 octaves either side of the mean. Bounding the
+ * values keeps every correlation inside the fast 32 bit accumulator.
+ */
+static void normalizeSpectrogram(uint32_t frames) {
+	int64_t total = 0;
+	int32_t mean, value;
+
+	for (int band = 0; band < _config.bands; band++) {
+		for (uint32_t frame = 0; frame < frames; frame++) {
+			total += _spectrogram[band * _maxFrames + frame];
+		}
+	}
+	mean = (int32_t) (total / ((int64_t) frames * _config.bands));
+
+	_prefixSum[0] = 0;
+	_prefixSquares[0] = 0;
+	for (uint32_t frame = 0; frame < frames; frame++) {
+		int64_t sum = 0, squares = 0;
+
+		for (int band = 0; band < _config.bands; band++) {
+			q15_t *cell = &_spectrogram[band * _maxFrames + frame];
+
+			value = *cell - mean;
+			if (value > MATCH_RANGE) {
+				value = MATCH_RANGE;
+			}
+			else if (value < -MATCH_RANGE) {
+				value = -MATCH_RANGE;
+			}
+			*cell = (q15_t) value;
+			sum += value;
+			squares += value * value;
+		}
+
+		_prefixSum[frame + 1] = _prefixSum[frame] + sum;
+		_prefixSquares[frame + 1] = _prefixSquares[frame] + squares;
+	}
+}
+
+/** @brief Slide one template across the spectrogram and keep its best score.
+ * Each band of the template is correlated with the same band of the
+ * spectrogram, and the bands are summed at every offset where the template
+ * fits entirely. The score divides that by the norm of the spectrogram under
+ * the template, after removing its mean.
+ */
+static void matchTemplate(const struct MatchTemplate *template, uint32_t frames,
+                          uint32_t frameStride, struct MatchResult *result) {
+	uint32_t length = template->frames;
+	uint32_t offsets = frames - length + 1;
+	int64_t cells = (int64_t) length * _config.bands;
+
+	result->score = INT16_MIN;
+	result->offsetSample = 0;
+	if (length > frames) {
+		return;
+	}
+
+	memset(_products, 0, offsets * sizeof(int32_t));
+	for (int band = 0; band < _config.bands; band++) {
+		arm_correlate_fast_q15(&_spectrogram[band * _maxFrames], frames,
+		                       (q15_t*) &template->cells[band * length], length,
+		                       _correlation);
+
+		// the lag of full overlap at offset 0 is frames - 1
+		for (uint32_t offset = 0; offset < offsets; offset++) {
+			_products[offset] += _correlation[frames - 1 + offset];
+		}
+	}
+
+	for (uint32_t offset = 0; offset < offsets; offset++) {
+		int64_t sum = _prefixSum[offset + length] - _prefixSum[offset];
+		int64_t squares = _prefixSquares[offset + length] - _prefixSquares[offset];
+		int64_t deviation = squares - sum * sum / cells;
+		int32_t score;
+
+		if (deviation <= 0) {
+			continue;
+		}
+
+		score = (int32_t) (((int64_t) _products[offset] << 15)
+		                   / squareRoot(deviation));
+		score = __SSAT(score, 16);
+		if (score > result->score) {
+			result->score = (q15_t) score;
+			result->offsetSample = offset * frameStride;
+		}
+	}
+}
+
+/** @brief Initialize the template matcher.
+ * Works out the bins of each band for the analysis configuration and takes the
+ * spectrogram from the DSP scratch, and prepares audio analysis for the
+ * configuration. The scratch needs 2*bands*maxFrames + 22*maxFrames bytes.
+ * Analysis must not be re-initialized with another configuration while the
+ * matcher is, as its buffers come after the analysis ones.
+ *
+ * @param config Band layout, templates and match score.
+ * @param anlysConfig Analysis configuration the spectra will come from.
+ * @param sampleRate Sample rate of the audio, before any decimation.
+ * @param maxFrames Most frames of a segment to match over.
+ * @return MATCH_OK, or the reason the matcher could not be set up.
+ */
+enum Match_Ecode templateMatcher_init(struct MatchConfig config,
+                                      struct AnlysConfig anlysConfig,
+                                      uint16_t sampleRate, uint32_t maxFrames) {
+	uint32_t frameStride;
+	int lastBin = anlysConfig.fftSize / 2;
+
+	// release buffers of a previous configuration
+	templateMatcher_deinit();
+
+	if (config.bands < 1 || config.bands > MATCH_MAX_BANDS
+	    || config.freqLower < 0 || config.freqUpper <= config.freqLower
+	    || config.templateCount < 1 || maxFrames < 1) {
+		return MATCH_BAD_CONFIG;
+	}
+	for (int i = 0; i < config.templateCount; i++) {
+		if (config.templates[i].frames < 1
+		    || config.templates[i].frames > MATCH_MAX_FRAMES) {
+			return MATCH_BAD_CONFIG;
+		}
+	}
+
+	// equal width bands, each at least one bin wide
+	frameStride = audioAnalysis_startSegment(anlysConfig);
+	if (frameStride == 0) {
+		return MATCH_NO_MEMORY;
+	}
+	for (int band = 0; band <= config.bands; band++) {
+		uint32_t freq = config.freqLower
+		    + (uint32_t) (config.freqUpper - config.freqLower) * band / config.bands;
+		int bin = (uint32_t) freq * frameStride / sampleRate;
+
+		if (band > 0 && bin <= _bandEdges[band - 1]) {
+			bin = _bandEdges[band - 1] + 1;
+		}
+		_bandEdges[band] = bin > lastBin + 1 ? lastBin + 1 : bin;
+	}
+
+	_config = config;
+	_maxFrames = maxFrames;
+	_scratchMark = memPlan_scratchMark();
+	_haveScratch = true;
+	_spectrogram = memPlan_scratch( config.bands * maxFrames * sizeof(q15_t) );
+	_correlation = memPlan_scratch( (2 * maxFrames - 1) * sizeof(q15_t) );
+	_products = memPlan_scratch( maxFrames * sizeof(int32_t) );
+	_prefixSum = memPlan_scratch( (maxFrames + 1) * sizeof(int64_t) );
+	_prefixSquares = memPlan_scratch( (maxFrames + 1) * sizeof(int64_t) );
+	if (_spectrogram == NULL || _correlation == NULL || _products == NULL
+	    || _prefixSum == NULL || _prefixSquares == NULL) {
+		templateMatcher_deinit();
+		return MATCH_NO_MEMORY;
+	}
+
+	return MATCH_OK;
+}
+
+/** @brief De-initialize the template matcher, giving its buffers back to the
+ * DSP scratch.
+ */
+void templateMatcher_deinit(void) {
+	if (_haveScratch) {
+		memPlan_scratchRewind(_scratchMark);
+		_haveScratch = false;
+	}
+	_spectrogram = NULL;
+	_correlation = NULL;
+	_products = NULL;
+	_prefixSum = NULL;
+	_prefixSquares = NULL;
+	_maxFrames = 0;
+}
+
+/** @brief Match every template against a segment of audio.
+ * Frames past maxFrames are not looked at.
+ *
+ * @param results Written with each template's best score and its offset.
+ * @return true if any template scored at least minScore.
+ */
+bool matchTemplates(int16_t *audioSamples, uint32_t bufferSize,
+                    struct AnlysConfig anlysConfig,
+                    struct MatchResult *results) {
+	struct AnlysSpectrum spectrum;
+	uint32_t frameStride = audioAnalysis_startSegment(anlysConfig);
+	uint32_t frames = 0;
+	bool matched = false;
+
+	if (_maxFrames == 0 || frameStride == 0) {
+		return false;
+	}
+
+	// build the segment's spectrogram
+	for (uint32_t copyOffset = 0;
+			copyOffset + frameStride <= bufferSize && frames < _maxFrames;
+			copyOffset += frameStride) {
+		if (!analyzeFrame(&audioSamples[copyOffset], &spectrum)) {
+			return false;
+		}
+		spectrogramColumn(&spectrum, frames);
+		frames++;
+	}
+	if (frames == 0) {
+		return false;
+	}
+	normalizeSpectrogram(frames);
+
+	for (int i = 0; i < _config.templateCount; i++) {
+		matchTemplate(&_config.templates[i], frames, frameStride, &results[i]);
+		if (results[i].score >= _config.minScore) {
+			matched = true;
+		}
+	}
+
+	return matched;
+}
@@ -0,0 +1,78 @@
+/** @file template_matcher.h
+ * @brief Spectrogram template matching for target species with stereotyped
+ * calls. A segment is reduced to a coarse log spectrogram (equal width bands,
+ * one column per analysis frame), and each template, a short spectrogram of
+ * an exemplar call kept in flash, is slid across it in time. The score at each
+ * offset is the normalized cross-correlation of the template with the part of
+ * the spectrogram under it, from -1.0 to 1.0 in q15, so it does not depend on
+ * the loudness of the call.
+ *
+ * Templates are made by Tools/make_templates.py with the same band layout and
+ * analysis settings the matcher is configured with. They are zero mean and
+ * scaled to a norm of 1.0, which makes the correlation the numerator of the
+ * score directly.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#ifndef MODULES_AUDIO_ANALYSIS_TEMPLATE_MATCHER_H_
+#define MODULES_AUDIO_ANALYSIS_TEMPLATE_MATCHER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arm_math.h"
+#include "audio_analysis.h"
+#include "mel_features.h"
+#include "fixed_point.h"
+
+#define MATCH_MAX_BANDS 32			// most spectrogram bands supported
+#define MATCH_MAX_FRAMES 64			// longest template, in frames
+#define MATCH_RANGE 4095				// spectrogram values are clamped to +/- this
+
+/** @struct Template
+ * Spectrogram of an exemplar call, [band][frame] so each band is contiguous.
+ */
+struct MatchTemplate {
+		const char *name;
+		uint16_t frames;
+		const q15_t *cells;
+};
+
+/* Matcher Configuration
+ * The band layout must be the one the templates were made with. */
+struct MatchConfig {
+		int bands;				// number of equal width bands
+		int freqLower;		// lower edge of the first band, in Hz
+		int freqUpper;		// upper edge of the last band, in Hz
+		q15_t minScore;		// score at which a template counts as matched
+		const struct MatchTemplate *templates;
+		int templateCount;
+};
+
+/** @struct Match Result
+ * Best match of one template over a segment.
+ */
+struct MatchResult {
+		q15_t score;							// normalized cross-correlation, q15
+		uint32_t offsetSample;		// first sample of the best matching frame
+};
+
+/** @enum Error codes the template matcher may respond with.
+ */
+enum Match_Ecode {
+	MATCH_OK = 0, MATCH_BAD_CONFIG = 1, MATCH_NO_MEMORY = 2
+};
+
+/** Function Prototypes */
+enum Match_Ecode templateMatcher_init(struct MatchConfig config,
+                                      struct AnlysConfig anlysConfig,
+                                      uint16_t sampleRate, uint32_t maxFrames);
+void templateMatcher_deinit(void);
+bool matchTemplates(int16_t *audioSamples, uint32_t bufferSize,
+                    struct AnlysConfig anlysConfig,
+                    struct MatchResult *results);
+
+#endif /* MODULES_AUDIO_ANALYSIS_TEMPLATE_MATCHER_H_ */
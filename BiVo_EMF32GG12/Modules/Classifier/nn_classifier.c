@@ -0,0 +1,349 @@
+/** @file nn_classifier.c
+ * @brief Quantized neural network inference on spectral features.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#include "nn_classifier.h"
+#include "mem_plan.h"
+
+#if NN_CLASSIFIER_ENABLE
+
+#define NN_HEADER_SIZE 16
+#define NN_LAYER_HEADER_SIZE 8
+
+/** Loaded model */
+static struct NNLayer _layers[NN_MAX_LAYERS];
+static int _layerCount = 0;
+static int _inputFrames = 0;
+static int _inputFeatures = 0;
+static int _classes = 0;
+
+/** Working buffers, taken from the DSP scratch by nnClassifier_init */
+static q15_t *_activations[2] = {NULL, NULL};	// layer input and output, swapped
+static q15_t *_scratch = NULL;		// widened int8 weights, matrix multiply state
+static q15_t *_window = NULL;			// features of the last T frames of a segment
+static bool _haveScratch = false;
+static size_t _scratchMark = 0;		// DSP scratch use before the buffers
+
+/** @brief Read a little endian 16 bit field of the model blob.
+ */
+static uint16_t readU16(const uint8_t *field) {
+	return (uint16_t) (field[0] | (field[1] << 8));
+}
+
+/** @brief Read a little endian 32 bit field of the model blob.
+ */
+static uint32_t readU32(const uint8_t *field) {
+	return (uint32_t) readU16(field) | ((uint32_t) readU16(field + 2) << 16);
+}
+
+/** @brief Round a size in bytes up to the blob's 4 byte alignment.
+ */
+static uint32_t padded(uint32_t bytes) {
+	return (bytes + 3) & ~3u;
+}
+
+/** @brief Add the biases, apply the activation and rescale a layer's output.
+ *
+ * @param steps Time steps of the output, each with one value per bias.
+ */
+static void finishLayer(const struct NNLayer *layer, q15_t *output, int steps) {
+	int length = steps * layer->outputs;
+
+	for (int t = 0; t < steps; t++) {
+		arm_add_q15(&output[t * layer->outputs], (q15_t*) layer->biases,
+		            &output[t * layer->outputs], layer->outputs);
+	}
+
+	if (layer->flags & NN_FLAG_RELU) {
+		for (int i = 0; i < length; i++) {
+			if (output[i] < 0) {
+				output[i] = 0;
+			}
+		}
+	}
+
+	if (layer->shift != 0) {
+		arm_shift_q15(output, layer->shift, output, length);
+	}
+}
+
+/** @brief Run a fully connected layer.
+ * q15 weights are multiplied straight from flash as one matrix product. int8
+ * weights are widened a row at a time into the scratch buffer. The converter
+ * keeps each row's sum of absolute weights under 1.0, so both give the same
+ * result and neither accumulator can overflow.
+ */
+static void denseLayer(const struct NNLayer *layer, q15_t *input,
+                       q15_t *output) {
+	arm_matrix_instance_q15 weights, column, result;
+	q63_t sum;
+
+	if (layer->flags & NN_FLAG_INT8) {
+		for (int row = 0; row < layer->outputs; row++) {
+			arm_q7_to_q15((q7_t*) layer->weights + row * layer->inputs, _scratch,
+			              layer->inputs);
+			arm_dot_prod_q15(_scratch, input, layer->inputs, &sum);
+			output[row] = (q15_t) __SSAT((q31_t) (sum >> 15), 16);
+		}
+	}
+	else {
+		arm_mat_init_q15(&weights, layer->outputs, layer->inputs,
+		                 (q15_t*) layer->weights);
+		arm_mat_init_q15(&column, layer->inputs, 1, input);
+		arm_mat_init_q15(&result, layer->outputs, 1, output);
+		arm_mat_mult_fast_q15(&weights, &column, &result, _scratch);
+	}
+
+	finishLayer(layer, output, 1);
+}
+
+/** @brief Run a 1-D convolution layer.
+ * With activations stored [time][channel], each output is the dot product of
+ * K consecutive steps of the input with one filter.
+ */
+static void conv1dLayer(const struct NNLayer *layer, q15_t *input,
+                        q15_t *output) {
+	int window = layer->kernel * layer->inputs;
+	int steps = layer->steps - layer->kernel + 1;
+	const q15_t *filter;
+	q63_t sum;
+
+	for (int f = 0; f < layer->outputs; f++) {
+		if (layer->flags & NN_FLAG_INT8) {
+			arm_q7_to_q15((q7_t*) layer->weights + f * window, _scratch, window);
+			filter = _scratch;
+		}
+		else {
+			filter = (const q15_t*) layer->weights + f * window;
+		}
+
+		for (int t = 0; t < steps; t++) {
+			arm_dot_prod_q15(&input[t * layer->inputs], (q15_t*) filter, window,
+			                 &sum);
+			output[t * layer->outputs + f] = (q15_t) __SSAT((q31_t) (sum >> 15), 16);
+		}
+	}
+
+	finishLayer(layer, output, steps);
+}
+
+/** @brief Load a model and take the buffers to run it from the DSP scratch.
+ * The blob is checked against the layout in nn_classifier.h, and the layers
+ * keep pointing into it, so it must stay in place (normally in flash).
+ *
+ * @param model Model blob from nn_convert.py, 4 byte aligned.
+ * @return NN_OK, or the reason the model could not be loaded.
+ */
+enum NN_Ecode nnClassifier_init(const uint8_t *model) {
+	const uint8_t *cursor = model + NN_HEADER_SIZE;
+	uint32_t steps, length, largest, scratch = 0;
+
+	// release buffers of a previous model
+	nnClassifier_deinit();
+
+	if (readU32(model) != NN_MODEL_MAGIC
+	    || readU16(model + 4) != NN_MODEL_VERSION) {
+		return NN_BAD_MODEL;
+	}
+	_layerCount = readU16(model + 6);
+	_inputFrames = readU16(model + 8);
+	_inputFeatures = readU16(model + 10);
+	_classes = readU16(model + 14);
+	if (_layerCount == 0 || _layerCount > NN_MAX_LAYERS) {
+		_layerCount = 0;
+		return NN_BAD_MODEL;
+	}
+
+	// walk the layers, checking each fits the output of the one before
+	steps = _inputFrames;
+	length = steps * _inputFeatures;
+	largest = length;
+	for (int i = 0; i < _layerCount; i++) {
+		struct NNLayer *layer = &_layers[i];
+		uint32_t weightCount;
+
+		layer->type = cursor[0];
+		layer->flags = cursor[1];
+		layer->shift = (int8_t) cursor[2];
+		layer->kernel = cursor[3];
+		layer->inputs = readU16(cursor + 4);
+		layer->outputs = readU16(cursor + 6);
+		layer->steps = steps;
+		cursor += NN_LAYER_HEADER_SIZE;
+
+		if (layer->type == NN_LAYER_DENSE && layer->inputs == length) {
+			weightCount = layer->outputs * layer->inputs;
+			if (layer->inputs > scratch) {
+				scratch = layer->inputs;
+			}
+			steps = 1;
+			length = layer->outputs;
+		}
+		else if (layer->type == NN_LAYER_CONV1D && layer->kernel > 0
+		         && layer->kernel <= steps && layer->inputs * steps == length) {
+			weightCount = layer->outputs * layer->kernel * layer->inputs;
+			if ((layer->flags & NN_FLAG_INT8)
+			    && layer->kernel * layer->inputs > scratch) {
+				scratch = layer->kernel * layer->inputs;
+			}
+			steps = steps - layer->kernel + 1;
+			length = steps * layer->outputs;
+		}
+		else {
+			_layerCount = 0;
+			return NN_BAD_MODEL;
+		}
+
+		layer->weights = cursor;
+		cursor += padded(weightCount * (layer->flags & NN_FLAG_INT8 ? 1 : 2));
+		layer->biases = (const q15_t*) cursor;
+		cursor += padded(layer->outputs * sizeof(q15_t));
+
+		if (length > largest) {
+			largest = length;
+		}
+	}
+	if (length != _classes) {
+		_layerCount = 0;
+		return NN_BAD_MODEL;
+	}
+
+	_scratchMark = memPlan_scratchMark();
+	_haveScratch = true;
+	_activations[0] = memPlan_scratch( largest * sizeof(q15_t) );
+	_activations[1] = memPlan_scratch( largest * sizeof(q15_t) );
+	_scratch = memPlan_scratch( (scratch > 0 ? scratch : 1) * sizeof(q15_t) );
+	_window = memPlan_scratch( _inputFrames * _inputFeatures * sizeof(q15_t) );
+	if (_activations[0] == NULL || _activations[1] == NULL || _scratch == NULL
+	    || _window == NULL) {
+		nnClassifier_deinit();
+		return NN_NO_MEMORY;
+	}
+	memset(_window, 0, _inputFrames * _inputFeatures * sizeof(q15_t));
+
+	return NN_OK;
+}
+
+/** @brief Unload the model, giving the working buffers back to the DSP
+ * scratch.
+ */
+void nnClassifier_deinit(void) {
+	if (_haveScratch) {
+		memPlan_scratchRewind(_scratchMark);
+		_haveScratch = false;
+	}
+	_activations[0] = NULL;
+	_activations[1] = NULL;
+	_scratch = NULL;
+	_window = NULL;
+	_layerCount = 0;
+}
+
+/** @brief Number of classes the loaded model scores.
+ */
+int nnClassifier_classes(void) {
+	return _classes;
+}
+
+/** @brief Number of input values the loaded model takes, T frames of C
+ * features.
+ */
+int nnClassifier_inputLength(void) {
+	return _inputFrames * _inputFeatures;
+}
+
+/** @brief Run the model on one input.
+ *
+ * @param input nnClassifier_inputLength() values, [frame][feature].
+ * @return The score of each class, valid until the next inference.
+ */
+const q15_t* nnClassifier_run(const q15_t *input) {
+	uint32_t profileStart = profiler_begin();
+	q15_t *layerInput = _activations[0];
+	q15_t *layerOutput = _activations[1];
+	q15_t *swap;
+
+	memcpy(layerInput, input, nnClassifier_inputLength() * sizeof(q15_t));
+
+	for (int i = 0; i < _layerCount; i++) {
+		if (_layers[i].type == NN_LAYER_DENSE) {
+			denseLayer(&_layers[i], layerInput, layerOutput);
+		}
+		else {
+			conv1dLayer(&_layers[i], layerInput, layerOutput);
+		}
+
+		swap = layerInput;
+		layerInput = layerOutput;
+		layerOutput = swap;
+	}
+
+	profiler_end(PROFILE_INFERENCE, profileStart);
+	return layerInput;
+}
+
+/** @brief Classify a segment of audio.
+ * The model runs on every window of T consecutive analysis frames, sliding by
+ * one frame, with features from the mel feature extractor. Each class's
+ * score is its highest over the segment.
+ *
+ * @param scores Written with nnClassifier_classes() scores.
+ * @return The class with the highest score, or -1 if the segment is shorter
+ * than T frames, the mel features do not match the model's input, or the
+ * analysis could not be set up.
+ */
+int nnClassifier_classifySegment(int16_t *audioSamples, uint32_t bufferSize,
+                                 struct AnlysConfig anlysConfig,
+                                 q15_t *scores) {
+	struct AnlysSpectrum spectrum;
+	const q15_t *result;
+	uint32_t frameStride, frames = 0, best;
+	q15_t bestScore;
+	int lastFrame = (_inputFrames - 1) * _inputFeatures;
+
+	if (_layerCount == 0 || melFeatures_length() != _inputFeatures) {
+		return -1;
+	}
+
+	for (int c = 0; c < _classes; c++) {
+		scores[c] = INT16_MIN;
+	}
+
+	frameStride = audioAnalysis_startSegment(anlysConfig);
+	if (frameStride == 0) {
+		return -1;
+	}
+	for (uint32_t copyOffset = 0;
+			copyOffset + frameStride <= bufferSize;
+			copyOffset += frameStride) {
+		if (!analyzeFrame(&audioSamples[copyOffset], &spectrum)) {
+			return -1;
+		}
+
+		// slide the window by one frame and add the new one at the end
+		memmove(_window, &_window[_inputFeatures], lastFrame * sizeof(q15_t));
+		melFeatures_frame(&spectrum, &_window[lastFrame]);
+		if (++frames < (uint32_t) _inputFrames) {
+			continue;
+		}
+
+		result = nnClassifier_run(_window);
+		for (int c = 0; c < _classes; c++) {
+			if (result[c] > scores[c]) {
+				scores[c] = result[c];
+			}
+		}
+	}
+
+	if (frames < (uint32_t) _inputFrames) {
+		return -1;
+	}
+
+	arm_max_q15(scores, _classes, &bestScore, &best);
+	return (int) best;
+}
+
+#endif /* NN_CLASSIFIER_ENABLE */
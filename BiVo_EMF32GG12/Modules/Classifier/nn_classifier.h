@@ -0,0 +1,109 @@
+/** @file nn_classifier.h
+ * @brief Inference engine for small quantized neural networks on spectral
+ * features. Models are fully connected and 1-D convolution layers with q15
+ * activations and q15 or int8 weights, converted on the host by
+ * Tools/nn_convert.py into a binary blob that stays in flash. Only the
+ * activations and a small scratch buffer are taken from the DSP scratch.
+ *
+ * The arithmetic is integer throughout and the converter bounds every layer so
+ * no accumulator can overflow, so the results are bit-exact with the
+ * converter's reference implementation (nn_convert.py --reference).
+ *
+ * Model blob layout, all fields little endian:
+ *
+ * 	Header, 16 bytes
+ * 		uint32	magic, NN_MODEL_MAGIC ("BVNN")
+ * 		uint16	version, NN_MODEL_VERSION
+ * 		uint16	number of layers
+ * 		uint16	input frames T
+ * 		uint16	input features C per frame
+ * 		int8		input exponent, real value = q15 value * 2^(exponent - 15)
+ * 		uint8		reserved, 0
+ * 		uint16	number of classes, the size of the last layer's output
+ *
+ * 	Each layer, an 8 byte header followed by its weights then its biases, each
+ * 	padded with zeros to a multiple of 4 bytes
+ * 		uint8		type, NN_LAYER_DENSE or NN_LAYER_CONV1D
+ * 		uint8		flags, NN_FLAG_RELU | NN_FLAG_INT8
+ * 		int8		output shift, left shift applied after the bias (negative for
+ * 						a right shift)
+ * 		uint8		kernel length K (conv1d), 0 (dense)
+ * 		uint16	inputs, the input length (dense) or channels (conv1d)
+ * 		uint16	outputs, the output length (dense) or filters (conv1d)
+ * 		q15/q7	weights, [outputs][inputs] (dense) or [filters][K][channels]
+ * 						(conv1d)
+ * 		q15			biases, [outputs]
+ *
+ * Activations are stored as [time][channel]. The input is T frames of C
+ * features, a conv1d layer with F filters turns T steps into T - K + 1 steps
+ * of F channels (stride 1, no padding), and a dense layer takes everything
+ * before it as one flat vector.
+ *
+ * The engine and the model blob are only built with NN_CLASSIFIER_ENABLE 1.
+ * The checked in nn_model.c is an untrained example, so by default neither
+ * takes flash in the firmware, the host benchmarks build them to time
+ * inference. Each nnClassifier_run is timed as the PROFILE_INFERENCE region.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#ifndef MODULES_CLASSIFIER_NN_CLASSIFIER_H_
+#define MODULES_CLASSIFIER_NN_CLASSIFIER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arm_math.h"
+#include "audio_analysis.h"
+#include "mel_features.h"
+#include "profiler.h"
+
+#ifndef NN_CLASSIFIER_ENABLE
+#define NN_CLASSIFIER_ENABLE 0
+#endif
+
+/** Model blob constants */
+#define NN_MODEL_MAGIC 0x4E4E5642		// "BVNN" in memory order
+#define NN_MODEL_VERSION 1
+#define NN_MAX_LAYERS 8
+
+#define NN_LAYER_DENSE 1
+#define NN_LAYER_CONV1D 2
+
+#define NN_FLAG_RELU 0x01				// clamp negative outputs to 0
+#define NN_FLAG_INT8 0x02				// weights stored as q7
+
+/** @enum Error codes the classifier may respond with.
+ */
+enum NN_Ecode {
+	NN_OK = 0, NN_BAD_MODEL = 1, NN_NO_MEMORY = 2, NN_BAD_FEATURES = 3
+};
+
+/** @struct Layer
+ * One layer of a loaded model, pointing into the blob in flash.
+ */
+struct NNLayer {
+		uint8_t type;
+		uint8_t flags;
+		int8_t shift;
+		uint8_t kernel;
+		uint16_t inputs;
+		uint16_t outputs;
+		uint16_t steps;					// time steps of the input
+		const void *weights;
+		const q15_t *biases;
+};
+
+/** Function Prototypes */
+enum NN_Ecode nnClassifier_init(const uint8_t *model);
+void nnClassifier_deinit(void);
+int nnClassifier_classes(void);
+int nnClassifier_inputLength(void);
+const q15_t* nnClassifier_run(const q15_t *input);
+int nnClassifier_classifySegment(int16_t *audioSamples, uint32_t bufferSize,
+                                 struct AnlysConfig anlysConfig,
+                                 q15_t *scores);
+
+#endif /* MODULES_CLASSIFIER_NN_CLASSIFIER_H_ */
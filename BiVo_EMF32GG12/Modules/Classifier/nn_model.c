@@ -0,0 +1,92 @@
+/** @file nn_model.c
+ * @brief Model blob for the neural network classifier, kept in flash.
+ *
+ * GENERATED by Tools/nn_convert.py from nn_example_model.json, do not edit by hand.
+ *
+ * layer 0: conv1d q15, weight exponent 3, output exponent 5
+ * layer 1: dense int8, weight exponent 2, output exponent 4
+ * layer 2: dense q15, weight exponent 2, output exponent 3
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#include "nn_model.h"
+#include "nn_classifier.h"
+
+#if NN_CLASSIFIER_ENABLE
+const uint8_t nnModel[NN_MODEL_SIZE] __attribute__((aligned(4))) = {
+		0x42, 0x56, 0x4E, 0x4E, 0x01, 0x00, 0x03, 0x00, 0x04, 0x00, 0x0D, 0x00,
+		0x07, 0x00, 0x02, 0x00, 0x02, 0x01, 0x05, 0x03, 0x0D, 0x00, 0x08, 0x00,
+		0x2D, 0x01, 0x9F, 0x00, 0xA6, 0xFE, 0xE5, 0x03, 0xF0, 0xFC, 0x12, 0x00,
+		0xDA, 0x01, 0x59, 0x01, 0x4A, 0x01, 0x0D, 0xFE, 0xBB, 0x03, 0xA6, 0xFE,
+		0xF3, 0xFF, 0x0E, 0x00, 0x08, 0x00, 0x01, 0xFF, 0x1B, 0x03, 0x2F, 0x00,
+		0x03, 0x02, 0xF3, 0xFC, 0x3C, 0x01, 0xA1, 0xFF, 0xD9, 0x00, 0x7A, 0x00,
+		0xED, 0x00, 0xDF, 0xFF, 0x35, 0x00, 0x53, 0x00, 0x83, 0x00, 0x2A, 0x00,
+		0x4F, 0xFF, 0xEA, 0x00, 0x62, 0xFE, 0x1B, 0x04, 0xBF, 0x01, 0x0F, 0x03,
+		0xD1, 0xFF, 0x84, 0xFD, 0x13, 0xFD, 0x7E, 0xFE, 0xD1, 0xFE, 0x47, 0xFF,
+		0x50, 0xFF, 0x43, 0x01, 0x66, 0xFB, 0x51, 0x03, 0x59, 0xFF, 0x53, 0x00,
+		0x86, 0xFC, 0x83, 0x00, 0x2F, 0xFD, 0x01, 0x01, 0x94, 0x00, 0x5F, 0x00,
+		0xAF, 0xFF, 0x7D, 0xFF, 0x65, 0xFF, 0xCB, 0x01, 0x2E, 0x00, 0x7D, 0x00,
+		0xB9, 0x04, 0x33, 0x00, 0x39, 0xFE, 0x9E, 0xFB, 0x3C, 0xFB, 0x40, 0x00,
+		0xBB, 0x01, 0xFA, 0xFD, 0xBD, 0xFD, 0xA4, 0xFF, 0x49, 0x00, 0xD8, 0x01,
+		0xC9, 0xFF, 0xC1, 0xFE, 0x59, 0x01, 0x25, 0xFE, 0x2C, 0xFD, 0xD4, 0xFD,
+		0x5E, 0xFF, 0x2B, 0xFF, 0x00, 0x00, 0x17, 0x00, 0xA7, 0x04, 0xCF, 0x00,
+		0xC8, 0xFB, 0x36, 0xFD, 0x52, 0x00, 0x5C, 0xFE, 0x40, 0x04, 0x1C, 0xFF,
+		0x3B, 0xFF, 0x38, 0x00, 0x84, 0xFF, 0x0D, 0x01, 0x79, 0xFF, 0x99, 0x00,
+		0xC6, 0xFE, 0xC9, 0xFA, 0xD1, 0x00, 0x3E, 0x03, 0x19, 0xFE, 0xE3, 0xFE,
+		0x90, 0x01, 0xF9, 0xFE, 0x38, 0x00, 0x8A, 0xFF, 0x31, 0x01, 0xBD, 0xFF,
+		0xF7, 0x03, 0x18, 0x00, 0x7C, 0xFF, 0x2B, 0xFD, 0x30, 0x00, 0x24, 0xFE,
+		0x44, 0x01, 0x1B, 0x01, 0x32, 0x05, 0x72, 0xFE, 0x42, 0x00, 0x0F, 0x02,
+		0x0A, 0xFC, 0x45, 0x01, 0x9C, 0x03, 0x20, 0x00, 0xF3, 0xFF, 0x6C, 0x02,
+		0x8E, 0x00, 0x95, 0x00, 0xAF, 0x01, 0x7A, 0xFE, 0xC8, 0x03, 0x53, 0xFF,
+		0x03, 0x00, 0x3E, 0xFF, 0xEF, 0xFA, 0xD1, 0xFC, 0x4B, 0xFF, 0xFD, 0xFF,
+		0x47, 0x02, 0x3C, 0x05, 0x6E, 0x01, 0xCA, 0xFF, 0xBB, 0xFE, 0xC4, 0x02,
+		0xC5, 0xFE, 0xF1, 0xFF, 0xA9, 0x02, 0xBD, 0xFF, 0xBB, 0xFF, 0x4E, 0x00,
+		0xCD, 0xFC, 0xCB, 0xFF, 0x5C, 0x00, 0xBD, 0x00, 0x4D, 0xFF, 0xBD, 0xFB,
+		0x72, 0xFE, 0x85, 0x01, 0x7A, 0xFE, 0x3E, 0xFE, 0x11, 0x01, 0x1D, 0x01,
+		0x59, 0x00, 0x39, 0x01, 0xA0, 0x01, 0x02, 0x01, 0xB7, 0x00, 0xA8, 0x03,
+		0xD8, 0xFD, 0x70, 0x04, 0x92, 0x00, 0x97, 0xFE, 0x6B, 0x01, 0x10, 0x02,
+		0xA8, 0xFD, 0x63, 0x00, 0xB1, 0x01, 0xA7, 0x01, 0x1F, 0x00, 0xEB, 0xFD,
+		0xDC, 0xFF, 0x56, 0x04, 0x35, 0xFE, 0x06, 0x06, 0xF3, 0xFF, 0xE1, 0xFF,
+		0xF8, 0xFE, 0x5B, 0x00, 0x74, 0x00, 0x0C, 0xFE, 0x11, 0x04, 0x6C, 0x02,
+		0xCD, 0x00, 0x80, 0xFD, 0x50, 0xFF, 0xB0, 0xFF, 0x9E, 0x01, 0xD2, 0xFF,
+		0xCC, 0xFD, 0xAA, 0xFF, 0xA3, 0xFF, 0x10, 0x00, 0xC0, 0x01, 0x9C, 0xFE,
+		0x03, 0xFD, 0x5E, 0x02, 0xF4, 0x01, 0xA5, 0xFD, 0x7D, 0x01, 0x06, 0xFF,
+		0x67, 0x01, 0x16, 0x01, 0x4A, 0xFD, 0xFD, 0xFD, 0xBC, 0xFF, 0x4F, 0xFD,
+		0xB5, 0xFD, 0x51, 0xFE, 0xB3, 0xFF, 0xD9, 0xFF, 0x86, 0xFE, 0x8E, 0xFF,
+		0x60, 0x02, 0x29, 0x01, 0xD9, 0x00, 0xAF, 0xFE, 0xB4, 0xFE, 0xA4, 0xFD,
+		0x60, 0xFE, 0x77, 0xFC, 0xBD, 0xFF, 0x43, 0xFF, 0xAF, 0xFE, 0xCF, 0xFE,
+		0x82, 0xFD, 0x70, 0x01, 0x3F, 0x01, 0x64, 0x02, 0xB5, 0x00, 0xB6, 0xFF,
+		0xCB, 0x01, 0x94, 0xFD, 0x4E, 0xFD, 0xDA, 0x01, 0x00, 0x01, 0x8B, 0x00,
+		0xAD, 0x02, 0xF6, 0xFF, 0x80, 0x00, 0xE1, 0x00, 0xB8, 0xFD, 0xCB, 0x00,
+		0x3B, 0x01, 0xEC, 0xFF, 0xA3, 0xFE, 0x71, 0xFE, 0xB7, 0xFB, 0x64, 0xFE,
+		0xAF, 0x02, 0x78, 0x02, 0xD3, 0xFF, 0x7F, 0xFE, 0x52, 0x02, 0x2E, 0x02,
+		0x12, 0x01, 0x97, 0xFE, 0x95, 0x01, 0xDD, 0x01, 0x22, 0xFF, 0x69, 0xFE,
+		0x3E, 0xFF, 0x79, 0x00, 0xDC, 0x00, 0x0E, 0x01, 0x0C, 0x00, 0x06, 0xFF,
+		0xB0, 0x00, 0x08, 0x02, 0x5A, 0x00, 0x61, 0x01, 0xE2, 0xFF, 0x9A, 0xFE,
+		0x41, 0xFF, 0xB2, 0xFF, 0x0C, 0xFD, 0xAC, 0xFF, 0xD2, 0xFE, 0x67, 0x00,
+		0x83, 0x01, 0x4A, 0x00, 0x42, 0xFF, 0x7B, 0x00, 0xF4, 0xFD, 0x05, 0x01,
+		0x9C, 0x02, 0x1D, 0x01, 0xE0, 0x02, 0x2E, 0xFF, 0x8D, 0xFC, 0x22, 0x01,
+		0x6B, 0x04, 0x68, 0xFE, 0x1F, 0x03, 0x05, 0xFF, 0x0C, 0x03, 0xDD, 0xFE,
+		0x88, 0xFF, 0xEB, 0x00, 0x05, 0xFD, 0x3E, 0x00, 0xC9, 0xFF, 0xCD, 0x01,
+		0xE0, 0xFF, 0xF2, 0xFF, 0xF0, 0xFF, 0xF0, 0xFF, 0xFC, 0xFF, 0x0A, 0x00,
+		0xE2, 0xFF, 0xE1, 0xFF, 0x01, 0x03, 0x03, 0x00, 0x10, 0x00, 0x08, 0x00,
+		0x02, 0x01, 0xFF, 0x0C, 0x03, 0x01, 0xF2, 0x0A, 0x00, 0x02, 0x06, 0x02,
+		0x0A, 0x00, 0x04, 0x02, 0x05, 0x02, 0x03, 0x02, 0x02, 0x04, 0xFC, 0xFB,
+		0x00, 0x01, 0x08, 0xF7, 0x0A, 0xFD, 0xFB, 0x02, 0x02, 0x06, 0xF3, 0x07,
+		0x03, 0x09, 0xFF, 0xF7, 0xFF, 0xFF, 0x05, 0x06, 0xF3, 0xF6, 0x01, 0xFC,
+		0x07, 0x09, 0x0E, 0x01, 0x07, 0x04, 0x02, 0xFE, 0x07, 0x05, 0x00, 0xFF,
+		0xF5, 0x02, 0x01, 0xFA, 0x09, 0x00, 0xF9, 0xFE, 0xF9, 0xFB, 0xF8, 0x01,
+		0xF6, 0xFC, 0x00, 0xFF, 0x01, 0xFB, 0xFC, 0x02, 0xFE, 0x06, 0xFD, 0x01,
+		0xFE, 0x07, 0xFA, 0x05, 0x07, 0x03, 0x09, 0xFA, 0xF5, 0xFC, 0xFD, 0x03,
+		0xFC, 0xFD, 0xFE, 0x0B, 0xFC, 0x00, 0x02, 0x0A, 0xF8, 0xF5, 0x00, 0xFB,
+		0xFC, 0xF3, 0x0A, 0xF6, 0x03, 0x04, 0x05, 0x0A, 0xFD, 0xF8, 0x02, 0x06,
+		0xFF, 0xFE, 0x08, 0xFA, 0x0C, 0xF6, 0xFB, 0xFF, 0x8A, 0xFF, 0xFC, 0xFF,
+		0xB6, 0x00, 0x97, 0xFF, 0x3A, 0x00, 0x3B, 0xFF, 0xE1, 0xFF, 0x70, 0x01,
+		0x01, 0x00, 0x03, 0x00, 0x08, 0x00, 0x02, 0x00, 0x3A, 0xF5, 0x28, 0x0A,
+		0xE8, 0xF7, 0xB9, 0xF9, 0x51, 0xFC, 0xE6, 0x0E, 0xDC, 0xFF, 0xDB, 0xFD,
+		0x1B, 0x0F, 0x40, 0xF5, 0xB8, 0xEF, 0xDC, 0xFF, 0xF3, 0x05, 0xD3, 0xF3,
+		0x77, 0xFD, 0xF7, 0x04, 0x83, 0xFF, 0x05, 0x00
+};
+#endif /* NN_CLASSIFIER_ENABLE */
@@ -0,0 +1,23 @@
+/** @file nn_model.h
+ * @brief Model blob for the neural network classifier.
+ *
+ * GENERATED by Tools/nn_convert.py from nn_example_model.json, do not edit by hand.
+ *
+ * Input: 4 frames of 13 features, exponent 7
+ * Classes: background, bird
+ * Scores: q15, exponent 3
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#ifndef MODULES_CLASSIFIER_NN_MODEL_H_
+#define MODULES_CLASSIFIER_NN_MODEL_H_
+
+#include <stdint.h>
+
+#define NN_MODEL_SIZE 860
+
+extern const uint8_t nnModel[NN_MODEL_SIZE];
+
+#endif /* MODULES_CLASSIFIER_NN_MODEL_H_ */
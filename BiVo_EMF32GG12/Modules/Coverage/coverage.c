@@ -0,0 +1,148 @@
+/** @file coverage.c
+ * @brief Listening coverage and duty cycle accounting, see coverage.h.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#include "coverage.h"
+
+/** Ticks put down to each activity, in all and while not listening */
+static uint64_t _ticks[COVERAGE_ACTIVITIES];
+static uint64_t _deafTicks[COVERAGE_ACTIVITIES];
+
+/** Current state */
+static enum Coverage_Activity _activity = COVERAGE_RUNNING;
+static bool _listening = false;
+static uint32_t _last = 0;					// count the accounts are up to
+static uint32_t _tickRate = 1;
+
+/** Gaps in listening */
+static uint32_t _gapStart = 0;			// count the current gap started at
+static uint32_t _gaps = 0;
+static uint32_t _longestGap = 0;		// ms
+static uint32_t _histogram[COVERAGE_BINS];
+
+/** @brief Put the ticks since the last update down to the current state.
+ */
+static void account(void) {
+	uint32_t now = WTIMER0->CNT;
+	uint32_t ticks = now - _last;
+
+	_ticks[_activity] += ticks;
+	if (!_listening) {
+		_deafTicks[_activity] += ticks;
+	}
+	_last = now;
+}
+
+/** @brief Convert ticks to milliseconds.
+ */
+static uint32_t ticksToMs(uint64_t ticks) {
+	return (uint32_t) (ticks * 1000 / _tickRate);
+}
+
+/** @brief Start the timer and the accounts. The system counts as deaf and
+ * running until told otherwise.
+ */
+void coverage_init(void) {
+	CMU->HFPERCLKEN1 |= CMU_HFPERCLKEN1_WTIMER0;
+	WTIMER0->CTRL = TIMER_CTRL_MODE_UP | TIMER_CTRL_PRESC_DIV1024;
+	WTIMER0->CMD = TIMER_CMD_START;
+	_tickRate = CMU_ClockFreqGet(cmuClock_WTIMER0) >> 10;
+
+	_last = WTIMER0->CNT;
+	_gapStart = _last;
+}
+
+/** @brief Mark the activity the core is starting. Called from the main loop
+ * only.
+ *
+ * @return The activity it was in, to go back to when this one ends.
+ */
+enum Coverage_Activity coverage_set(enum Coverage_Activity activity) {
+	enum Coverage_Activity previous;
+
+	__disable_irq();
+	account();
+	previous = _activity;
+	_activity = activity;
+	__enable_irq();
+
+	return previous;
+}
+
+/** @brief Mark the microphone starting or stopping capture. Called by the
+ * microphone driver, from the PDM interrupt or with the PDM stopped, so never
+ * preempted by itself.
+ */
+void coverage_listening(bool listening) {
+	uint32_t gap;
+
+	if (listening == _listening) {
+		return;
+	}
+	account();
+
+	if (listening) {
+		gap = ticksToMs(_last - _gapStart);
+		_histogram[gap >> COVERAGE_BINS ? COVERAGE_BINS - 1 : 31 - __CLZ(gap | 1)]++;
+		_gaps++;
+		if (gap > _longestGap) {
+			_longestGap = gap;
+		}
+	}
+	else {
+		_gapStart = _last;
+	}
+	_listening = listening;
+}
+
+/** @brief EMU_EnterEM1 if the main loop has nothing to do, with the time
+ * asleep put down to sleeping. Interrupts are masked from the check until the
+ * core sleeps, so an interrupt that gives the main loop work in between is
+ * not lost: the core wakes on it pending and takes it once they are unmasked.
+ *
+ * @param idle Whether the main loop has nothing to do until an interrupt,
+ * called with interrupts masked.
+ */
+void coverage_sleep(bool (*idle)(void)) {
+	enum Coverage_Activity previous = coverage_set(COVERAGE_SLEEPING);
+
+	__disable_irq();
+	if (idle()) {
+		EMU_EnterEM1();
+	}
+	__enable_irq();
+	coverage_set(previous);
+}
+
+/** @brief Send the accounts as a coverage record.
+ *
+ * @return Number of bytes put on the link.
+ */
+uint32_t coverage_send(void) {
+	struct CoverageRecord record;
+	uint64_t elapsed = 0, deaf = 0;
+
+	__disable_irq();
+	account();
+	for (int activity=0; activity<COVERAGE_ACTIVITIES; activity++) {
+		elapsed += _ticks[activity];
+		deaf += _deafTicks[activity];
+		record.activity[activity] = ticksToMs(_ticks[activity]);
+		record.deaf[activity] = ticksToMs(_deafTicks[activity]);
+	}
+	record.energyMode[1] = ticksToMs(_ticks[COVERAGE_SLEEPING]);
+	record.gaps = _gaps;
+	record.longestGap = _longestGap;
+	memcpy(record.histogram, _histogram, sizeof(record.histogram));
+	__enable_irq();
+
+	record.elapsed = ticksToMs(elapsed);
+	record.listening = ticksToMs(elapsed - deaf);
+	record.coverage = elapsed > 0 ? (elapsed - deaf) * 10000 / elapsed : 0;
+	record.energyMode[0] = record.elapsed - record.energyMode[1];
+
+	return transmitRecord(RECORD_COVERAGE, &record, sizeof(struct CoverageRecord));
+}
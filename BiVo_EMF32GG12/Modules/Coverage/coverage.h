@@ -0,0 +1,50 @@
+/** @file coverage.h
+ * @brief Listening coverage and duty cycle accounting.
+ *
+ * Every tick since coverage_init is put down to the activity the core was in,
+ * and to whether the microphone was capturing. The operation modes and
+ * drivers mark their activities with coverage_set, and the microphone driver
+ * reports each recording starting and stopping with coverage_listening.
+ * Sleeping is EM1, every other activity EM0. The time from a recording
+ * stopping to the next starting is a gap, audio the unit did not hear, and
+ * gap lengths are kept in a log2 histogram. coverage_send puts the totals on
+ * the link as a coverage record, the desktop application asks for it with the
+ * coverage command.
+ *
+ * Time comes from WTIMER0 counting HFPERCLK over 1024, as the core's cycle
+ * counter stops in EM1. A tick is about 54 us, and the counter wraps after
+ * about 64 hours, so the accounts have to change at least that often.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#ifndef MODULES_COVERAGE_COVERAGE_H_
+#define MODULES_COVERAGE_COVERAGE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "em_device.h"
+#include "em_cmu.h"
+#include "em_emu.h"
+#include "gen_com.h"
+
+/** @enum Activities time is put down to, COVERAGE_ACTIVITIES of them.
+ */
+enum Coverage_Activity {
+	COVERAGE_RUNNING = 0,				// awake, nothing else marked
+	COVERAGE_SLEEPING = 1,			// EM1, until an interrupt
+	COVERAGE_ANALYZING = 2,			// analysis of a segment
+	COVERAGE_TRANSMITTING = 3,	// sending over the link
+	COVERAGE_WAITING = 4				// waiting on the desktop application
+};
+
+/** Function Prototypes */
+void coverage_init(void);
+enum Coverage_Activity coverage_set(enum Coverage_Activity activity);
+void coverage_listening(bool listening);
+void coverage_sleep(bool (*idle)(void));
+uint32_t coverage_send(void);
+
+#endif /* MODULES_COVERAGE_COVERAGE_H_ */
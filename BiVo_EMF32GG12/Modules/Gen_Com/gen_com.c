@@ -17,6 +17,11 @@ char handshake_request[5] = "hands";
 char handshake_response[5] = "cnfrm";
 char handshake_ack[5] = "ackng";
 char record_command[5] = "recrd";
+char fetch_command[5] = "fetch";
+char summary_command[5] = "sumry";
+char profile_command[5] = "profl";
+char inject_command[5] = "injct";
+char coverage_command[5] = "covrg";
 
 /** Initialize the general communication module.
  * At this point, only makes sure the serial communication module is
@@ -63,6 +68,95 @@ void waitOnRecordMessage(void) {
 	}
 }
 
+/** @brief Check for a command from the desktop application without blocking.
+ * Received bytes are kept in a sliding window of the last five bytes, so a
+ * command is recognized even if stray bytes came before it.
+ *
+ * @return The command completed by the bytes received so far, COMMAND_NONE if
+ * there is none.
+ */
+enum GenCom_Command pollCommand(void) {
+	static char window[5];
+	static int received = 0;
+	int8_t byte;
+
+	while (poll_Byte(&byte) == SERIAL_USB_OK) {
+		// slide the window and append the new byte
+		for (int index=0; index<4; index++) {
+			window[index] = window[index+1];
+		}
+		window[4] = byte;
+		if (received < 5) {
+			received++;
+		}
+		if (received < 5) {
+			continue;
+		}
+
+		if (stringCompare(record_command, window, 5) == 0) {
+			received = 0;
+			return COMMAND_RECORD;
+		}
+		if (stringCompare(fetch_command, window, 5) == 0) {
+			received = 0;
+			return COMMAND_FETCH;
+		}
+		if (stringCompare(summary_command, window, 5) == 0) {
+			received = 0;
+			return COMMAND_SUMMARY;
+		}
+		if (stringCompare(profile_command, window, 5) == 0) {
+			received = 0;
+			return COMMAND_PROFILE;
+		}
+		if (stringCompare(inject_command, window, 5) == 0) {
+			received = 0;
+			return COMMAND_INJECT;
+		}
+		if (stringCompare(coverage_command, window, 5) == 0) {
+			received = 0;
+			return COMMAND_COVERAGE;
+		}
+	}
+
+	return COMMAND_NONE;
+}
+
+/** @brief Frame and send a telemetry record.
+ *
+ * @param type Record type, see enum Record_Type.
+ * @param payload Record payload.
+ * @param length Number of bytes in the payload.
+ * @return Number of bytes put on the link.
+ */
+uint32_t transmitRecord(uint8_t type, const void *payload, uint8_t length) {
+	uint8_t header[3] = {RECORD_SYNC, type, length};
+	uint8_t checksum = type + length;
+
+	for (int index=0; index<length; index++) {
+		checksum += ((const uint8_t*) payload)[index];
+	}
+	checksum = -checksum;
+
+	transmit_Byte((int8_t*) header, 3);
+	transmit_Byte((int8_t*) payload, length);
+	transmit_Byte((int8_t*) &checksum, 1);
+
+	return length + RECORD_OVERHEAD;
+}
+
+/** @brief Send an error record.
+ *
+ * @param module Module that failed.
+ * @param code The module's error code.
+ * @return Number of bytes put on the link.
+ */
+uint32_t transmitError(enum Error_Module module, uint8_t code) {
+	struct ErrorRecord record = {.module = module, .code = code};
+
+	return transmitRecord(RECORD_ERROR, &record, sizeof(record));
+}
+
 /** Compares two strings to each other up to a specified length. Identicial to
  * strcmp but terminates on length instead of null character.
  *
@@ -72,11 +166,11 @@ void waitOnRecordMessage(void) {
  * @return 0 if strings are equal, not 0 otherwise.
  */
 int stringCompare(char *str1, char *str2, int len) {
-	int sum = 0;
-
 	for (int index=0; index<len; index++) {
-		sum = str1[index] - str2[index];
+		if (str1[index] != str2[index]) {
+			return str1[index] - str2[index];
+		}
 	}
 
-	return sum;
+	return 0;
 }
@@ -11,10 +11,208 @@
 #define MODULES_GEN_COM_INC_GEN_COM_H_
 
 #include <stdio.h>
+#include <stdint.h>
 #include "serial_usb_drv.h"
 
+/** Telemetry record framing.
+ * Every record goes out as [sync][type][length][payload...][checksum], where
+ * the checksum makes the 8-bit sum of type, length, payload and checksum zero.
+ * Payloads are little endian.
+ */
+#define RECORD_SYNC 0xB5
+#define RECORD_OVERHEAD 4
+
+/** @enum Type byte of a telemetry record.
+ */
+enum Record_Type {
+	RECORD_EVENT = 'E', RECORD_SUMMARY = 'S', RECORD_CONTOUR = 'C',
+	RECORD_INDICES = 'I', RECORD_LEVEL = 'L', RECORD_PROFILE = 'P',
+	RECORD_INJECT = 'J', RECORD_COVERAGE = 'V', RECORD_AUDIO = 'A',
+	RECORD_STREAM = 'R', RECORD_ERROR = 'X'
+};
+
+/** @struct Payload of an event record, one per segment with a detection.
+ */
+struct __attribute__((packed)) EventRecord {
+	uint32_t timestamp;			// ms of capture time since the mode started
+	uint16_t bandLower;			// Hz
+	uint16_t bandUpper;			// Hz
+	uint16_t peakFreq;			// Hz
+	uint16_t duration;			// ms
+	int16_t peakMagnitude;
+	int16_t noiseFloor;
+};
+
+#define CONTOUR_MAX_POINTS 80		// most frames in one contour record
+
+/** @struct One frame of a pitch contour.
+ */
+struct __attribute__((packed)) ContourPoint {
+	uint16_t f0;						// Hz, 0 if the frame is not voiced
+	uint8_t confidence;			// 0 to 255
+};
+
+/** @struct Payload of a contour record, the f0 of each frame of a detection.
+ * Follows the event record of the same segment. Only count points are sent.
+ */
+struct __attribute__((packed)) ContourRecord {
+	uint32_t timestamp;			// ms of capture time of the first frame
+	uint16_t hop;						// us from one frame to the next
+	uint8_t count;					// frames in the contour
+	struct ContourPoint points[CONTOUR_MAX_POINTS];
+};
+
+/** @struct Payload of an indices record, the ecoacoustic indices of one
+ * interval.
+ */
+struct __attribute__((packed)) IndicesRecord {
+	uint32_t timestamp;			// ms of capture time at the end of the interval
+	uint16_t duration;			// s of audio the indices cover
+	uint32_t aci;						// hundredths
+	uint16_t bi;						// tenths of dB kHz
+	int16_t ndsi;						// -1 to 1 in Q15
+	uint16_t adi;						// thousandths of a nat
+};
+
+/** @struct Payload of a level record, the A-weighted sound level over one
+ * interval.
+ */
+struct __attribute__((packed)) LevelRecord {
+	uint32_t timestamp;			// ms of capture time at the end of the interval
+	uint16_t duration;			// ms the interval covers
+	int16_t leq;						// 0.01 dB(A)
+	int16_t lmax;						// 0.01 dB(A), fast time weighting
+	int16_t lmin;						// 0.01 dB(A), fast time weighting
+};
+
+#define PROFILE_BINS 32				// log2 histogram bins of a profile record
+
+/** @struct Payload of a profile record, the statistics of one profiled region,
+ * see profiler.h. Bin b of the histogram counts the runs of 2^b to 2^(b+1)-1
+ * ticks.
+ */
+struct __attribute__((packed)) ProfileRecord {
+	uint8_t region;					// enum Profiler_Region
+	uint32_t tickRate;			// ticks per second
+	uint32_t count;					// runs since the last reset
+	uint32_t min;						// ticks
+	uint32_t max;						// ticks
+	uint64_t sum;						// ticks
+	uint32_t histogram[PROFILE_BINS];
+};
+
+#define COVERAGE_ACTIVITIES 5		// activities of a coverage record
+#define COVERAGE_BINS 16				// log2 histogram bins of a coverage record
+
+/** @struct Payload of a coverage record, where the time since the system
+ * started went, see coverage.h. Bin b of the histogram counts the gaps in
+ * listening of 2^b to 2^(b+1)-1 ms, the last bin every longer gap too.
+ */
+struct __attribute__((packed)) CoverageRecord {
+	uint32_t elapsed;				// ms since the system started
+	uint32_t listening;			// ms the microphone was capturing
+	uint16_t coverage;			// listening share of elapsed, hundredths of a percent
+	uint32_t activity[COVERAGE_ACTIVITIES];		// ms, enum Coverage_Activity
+	uint32_t deaf[COVERAGE_ACTIVITIES];				// ms of each while not listening
+	uint32_t energyMode[2];		// ms in EM0 and EM1
+	uint32_t gaps;					// gaps in listening that have ended
+	uint32_t longestGap;		// ms, of those
+	uint32_t histogram[COVERAGE_BINS];
+};
+
+/** @enum Verdict of an inject record.
+ */
+enum Inject_Verdict {
+	INJECT_PENDING = 0,			// the block did not finish a segment
+	INJECT_QUIET = 1,				// the segment it finished did not pass analysis
+	INJECT_DETECTED = 2			// the segment it finished passed analysis
+};
+
+/** @struct Payload of an inject record, one per block of injected audio, see
+ * inject_mode.h.
+ */
+struct __attribute__((packed)) InjectRecord {
+	uint32_t block;					// blocks injected before this one
+	uint16_t samples;				// samples in the block
+	uint8_t verdict;				// enum Inject_Verdict
+	uint32_t tickRate;			// ticks per second, see profiler.h
+	uint32_t injectTicks;		// recording the block, block callback included
+	uint32_t analysisTicks;	// analyzing the segment finished, 0 if none was
+};
+
+/** @enum Format of the samples of an audio record.
+ */
+enum Audio_Format {
+	AUDIO_FORMAT_PCM16 = 0,			// 16 bit samples
+	AUDIO_FORMAT_PACKED12 = 1		// 12 bit samples, 8 in 3 words, see sample_pack.h
+};
+
+#define AUDIO_MAX_DATA 240			// most bytes of samples in one audio record
+
+/** @struct Payload of an audio record, one block of a streamed recording, see
+ * stream.h. Only the bytes of the block's samples are sent. A sequence number
+ * skipped over is a block lost to an overrun.
+ */
+struct __attribute__((packed, aligned(4))) AudioRecord {
+	uint32_t sequence;			// blocks captured before this one, lost ones too
+	uint16_t samples;				// samples in the block
+	uint8_t format;					// enum Audio_Format
+	uint8_t backlog;				// blocks waiting to be sent behind this one
+	uint8_t data[AUDIO_MAX_DATA];
+};
+
+/** @struct Payload of a stream record, sent at the end of a streamed recording.
+ */
+struct __attribute__((packed)) StreamRecord {
+	uint32_t samples;				// samples captured
+	uint32_t blocks;				// blocks captured, lost ones too
+	uint32_t dropped;				// blocks lost because the queue was full
+	uint32_t overruns;			// runs of lost blocks
+	uint16_t peakBacklog;		// most blocks waiting to be sent at once
+	uint16_t capacity;			// blocks the queue holds
+	uint32_t clips;					// packed groups with a clipped sample
+	uint32_t bytesSent;			// bytes put on the link, this record included
+};
+
+/** @enum Module an error record is about.
+ */
+enum Error_Module {
+	ERROR_ANALYSIS = 0, ERROR_GOERTZEL = 1, ERROR_INDICES = 2, ERROR_PITCH = 3,
+	ERROR_LEVEL = 4, ERROR_MATCH = 5, ERROR_SERIAL = 6, ERROR_MIC = 7
+};
+
+/** @struct Payload of an error record, sent when a mode cannot start because
+ * a module failed to initialize, or cannot start recording. The mode stops
+ * after sending it.
+ */
+struct __attribute__((packed)) ErrorRecord {
+	uint8_t module;					// enum Error_Module
+	uint8_t code;						// the module's error code
+};
+
+/** @struct Payload of a summary record, sent periodically and on request.
+ */
+struct __attribute__((packed)) SummaryRecord {
+	uint32_t timestamp;			// ms of capture time since the mode started
+	uint32_t segments;			// segments analyzed
+	uint32_t events;				// segments with a detection
+	uint32_t bytesSent;			// bytes put on the link, including this record
+};
+
+/** @enum Commands the desktop application may send.
+ */
+enum GenCom_Command {
+	COMMAND_NONE = 0, COMMAND_RECORD = 1, COMMAND_FETCH = 2, COMMAND_SUMMARY = 3,
+	COMMAND_PROFILE = 4, COMMAND_INJECT = 5, COMMAND_COVERAGE = 6
+};
+
 /** Function Prototypes */
+void genCom_init(void);
 void handshakeApp(void);
 void waitOnRecordMessage(void);
+enum GenCom_Command pollCommand(void);
+uint32_t transmitRecord(uint8_t type, const void *payload, uint8_t length);
+uint32_t transmitError(enum Error_Module module, uint8_t code);
+int stringCompare(char *str1, char *str2, int len);
 
 #endif /* MODULES_GEN_COM_INC_GEN_COM_H_ */
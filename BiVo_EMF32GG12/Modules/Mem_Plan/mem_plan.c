@@ -0,0 +1,62 @@
+/** @file mem_plan.c
+ * @brief Static memory plan, see mem_plan.h.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#include "mem_plan.h"
+
+#define SCRATCH_ALIGN 8		// every scratch buffer starts on a double word
+
+/** Arena of the DSP scratch region */
+static uint8_t _scratch[MEMPLAN_DSP_SCRATCH_BUDGET] MEMPLAN_DSP_SCRATCH
+		__attribute__((aligned(SCRATCH_ALIGN)));
+static size_t _scratchUsed = 0;
+static size_t _scratchPeak = 0;
+
+/** @brief Hand out a buffer from the DSP scratch arena.
+ * Buffers are taken one after the other and given back together with
+ * memPlan_scratchRewind, so a module takes a mark before its buffers and
+ * rewinds to it when it de-initializes. Modules have to be de-initialized in
+ * the reverse order they were initialized in. The contents of a new buffer
+ * are undefined.
+ *
+ * @param bytes Size of the buffer.
+ * @return The buffer, NULL if the arena is used up.
+ */
+void *memPlan_scratch(size_t bytes) {
+	size_t start = _scratchUsed;
+	size_t end = start + ((bytes + SCRATCH_ALIGN - 1) & ~(size_t) (SCRATCH_ALIGN - 1));
+
+	if (end > sizeof(_scratch)) {
+		return NULL;
+	}
+
+	_scratchUsed = end;
+	if (_scratchUsed > _scratchPeak) {
+		_scratchPeak = _scratchUsed;
+	}
+
+	return &_scratch[start];
+}
+
+/** @brief Mark the DSP scratch arena's current use, to rewind to later.
+ */
+size_t memPlan_scratchMark(void) {
+	return _scratchUsed;
+}
+
+/** @brief Give back every scratch buffer handed out since the mark was taken.
+ */
+void memPlan_scratchRewind(size_t mark) {
+	if (mark < _scratchUsed) {
+		_scratchUsed = mark;
+	}
+}
+
+/** @brief Most of the DSP scratch arena used at once, in bytes.
+ */
+size_t memPlan_scratchPeak(void) {
+	return _scratchPeak;
+}
@@ -0,0 +1,56 @@
+/** @file mem_plan.h
+ * @brief Static memory plan, the RAM regions buffers are placed in.
+ *
+ * Nothing the operation modes need for the life of the mode comes from the
+ * heap. Buffers are sized from the mode's settings at build time and placed
+ * in named linker sections, see bivo_linkerfile.ld:
+ * 	.capture			segment buffers the microphone records into
+ * 	.dsp_scratch	working buffers of the analysis, handed out by
+ * 								memPlan_scratch from one fixed arena
+ * 	.transport		staging buffers of records and blocks on the link
+ * Each region has a budget in the linker script and the link fails when a
+ * region, or the heap left over, is past its budget. Tools/mem_budget.py
+ * prints the use of each region from the map file.
+ *
+ * The regions are not cleared at boot, buffers in them start out undefined.
+ * The host simulation has no such sections, the attributes are left out and
+ * the buffers are ordinary statics.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#ifndef MODULES_MEM_PLAN_MEM_PLAN_H_
+#define MODULES_MEM_PLAN_MEM_PLAN_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/** Placement of a static buffer in a region of the plan */
+#ifdef BIVO_HOST_SIM
+#define MEMPLAN_CAPTURE
+#define MEMPLAN_DSP_SCRATCH
+#define MEMPLAN_TRANSPORT
+#else
+#define MEMPLAN_CAPTURE __attribute__((section(".capture")))
+#define MEMPLAN_DSP_SCRATCH __attribute__((section(".dsp_scratch")))
+#define MEMPLAN_TRANSPORT __attribute__((section(".transport")))
+#endif
+
+/** Budgets of the regions, in bytes, kept equal to the linker script's */
+#define MEMPLAN_CAPTURE_BUDGET 0x27000
+#define MEMPLAN_DSP_SCRATCH_BUDGET 0x2000
+#define MEMPLAN_TRANSPORT_BUDGET 0x800
+
+/** Fails the build when a buffer alone is past its region's budget. The
+ * linker checks the region as a whole. */
+#define MEMPLAN_FITS(buffer, budget) \
+	_Static_assert(sizeof(buffer) <= (budget), #buffer " is over its budget")
+
+/** Function Prototypes */
+void *memPlan_scratch(size_t bytes);
+size_t memPlan_scratchMark(void);
+void memPlan_scratchRewind(size_t mark);
+size_t memPlan_scratchPeak(void);
+
+#endif /* MODULES_MEM_PLAN_MEM_PLAN_H_ */
@@ -10,23 +10,117 @@
  */
 
 #include "mic_drv.h"
+#include "profiler.h"
+#include "coverage.h"
 
 /** Right track from microphones */
 static int16_t *_right_track = NULL;		// samples from the right microphone
-static uint32_t _right_track_len = 0; 	// right microphone buffer length
 static uint32_t _right_track_index = 0;	// index counter for iterating
+static uint32_t _right_track_pos = 0;		// where the next sample goes
+static uint32_t _right_track_stop = 0;	// index the recording stops at
+static uint32_t _ring_len = 0;					// ring length, 0 if not a ring
+static uint32_t *_packed_track = NULL;		// packed storage, see startRecordingPacked
+static int16_t _pack_stage[SAMPLE_PACK_GROUP];	// samples of the group being filled
+static uint32_t _pack_clips = 0;					// groups with a clipped sample
 /** Eventually, allow for left track, put here! **/
 
+/** Block callback, sees every sample recorded */
+static MicBlockCallback _block_callback = NULL;
+static uint32_t _block_size = 0;
+static uint32_t _block_start = 0;				// first sample not yet passed on
+
 /** Operation variables */
 static bool _is_recording = false;
 static bool _initializedFlag = false;
+static enum Mic_Source _source = MIC_SOURCE_PDM;
+
+/** @brief Pack the group being filled into packed storage, the samples past
+ * the end of a partial group as silence.
+ */
+static void packStage(void) {
+	uint32_t group = ( _right_track_index - 1 ) / SAMPLE_PACK_GROUP;
+
+	for (uint32_t index = _right_track_index - group * SAMPLE_PACK_GROUP;
+	     index < SAMPLE_PACK_GROUP; index++)
+	{
+		_pack_stage[ index ] = 0;
+	}
+	if (samplePack_group( _pack_stage, &_packed_track[ group * SAMPLE_PACK_WORDS ] ))
+	{
+		_pack_clips++;
+	}
+}
+
+/** @brief Put one sample into the buffer, whether it came from the PDM or was
+ * injected. Passes on full blocks, and when the buffer is filled, stops
+ * recording and resets the recording flag.
+ */
+static void takeSample(int16_t sample) {
+	// samples left in the FIFO after the stop would land past the end of the
+	// buffer, or in the next block of a ring
+	if (!_is_recording)
+	{
+		return;
+	}
+
+	if (_packed_track != NULL)
+	{
+		_pack_stage[ _right_track_index % SAMPLE_PACK_GROUP ] = sample;
+		_right_track_index = _right_track_index + 1;
+		if (_right_track_index % SAMPLE_PACK_GROUP == 0)
+		{
+			packStage( );
+		}
+	}
+	else
+	{
+		_right_track[ _right_track_pos ] = sample;
+		_right_track_index = _right_track_index + 1;
+		_right_track_pos = _right_track_pos + 1;
+	}
+
+	// pass on each full block
+	if (_block_callback != NULL && _packed_track == NULL
+	    && _right_track_index - _block_start == _block_size)
+	{
+		_block_callback( &_right_track[ _right_track_pos - _block_size ], _block_size );
+		_block_start = _right_track_index;
+
+		// a ring starts over once its last block is passed on
+		if (_right_track_pos == _ring_len)
+		{
+			_right_track_pos = 0;
+		}
+	}
+
+	// if the buffer is full, set flag and disable recording
+	if (_right_track_index == _right_track_stop)
+	{
+		stopRecording( );
+
+		// finish the partial group at the end of packed storage
+		if (_packed_track != NULL && _right_track_index % SAMPLE_PACK_GROUP != 0)
+		{
+			packStage( );
+		}
+
+		// pass on the partial block at the end of the buffer
+		if (_block_callback != NULL && _packed_track == NULL
+		    && _right_track_index > _block_start)
+		{
+			uint32_t count = _right_track_index - _block_start;
+
+			_block_callback( &_right_track[ _right_track_pos - count ], count );
+			_block_start = _right_track_index;
+		}
+	}
+}
 
 /** @brief PDM Interrupt Handler.
  * When the FIFO is full, takes the samples out and puts them into the buffer.
- * When the buffer is filled, stops recording and resets the recording
- * flag.
  */
 void PDM_IRQHandler(void) {
+	uint32_t profileStart = profiler_begin();
 	uint32_t interruptFlags = PDM->IF;
 
 	// if data is available in the FIFO
@@ -37,16 +131,11 @@ void PDM_IRQHandler(void) {
 		// get the 4 samples in the FIFO
 		while (!( PDM->STATUS & PDM_STATUS_EMPTY ))
 		{
-			_right_track[ _right_track_index ] = PDM->RXDATA & 0x0000FFFF;
-			_right_track_index = _right_track_index + 1;
-
-			// if the buffer is full, set flag and disable recording
-			if (_right_track_index == _right_track_len - 1)
-			{
-				stopRecording( );
-			}
+			takeSample( PDM->RXDATA & 0x0000FFFF );
 		}
 	}
+
+	profiler_end(PROFILE_PDM_ISR, profileStart);
 }
 
 /** @brief Initializes the board's PDM peripheral.
@@ -95,11 +184,11 @@ void initPdmMic(struct MicConfig config) {
 	NVIC_EnableIRQ( PDM_IRQn );
 }
 
-/** @brief Single-shot record an audio segment.
- * Sets pointers for sampling into, sets the recording flag, and starts
- * recording into the buffer.
+/** @brief Set pointers for sampling into, set the recording flag, and start
+ * recording, into the buffer, a ring or packed storage.
  */
-enum Mic_Ecode startRecording(int16_t *buffer, uint32_t size) {
+static enum Mic_Ecode beginRecording(int16_t *buffer, uint32_t *packed,
+                                     uint32_t ringSize, uint32_t stop) {
 	// check if initialized
 	if (!_initializedFlag) {
 		return MIC_NOT_INITIALIZED;
@@ -107,17 +196,73 @@ enum Mic_Ecode startRecording(int16_t *buffer, uint32_t size) {
 
 	// set pointers and counters
 	_right_track = buffer;
-	_right_track_len = size;
+	_packed_track = packed;
+	_ring_len = ringSize;
+	_right_track_stop = stop;
 	_right_track_index = 0;
+	_right_track_pos = 0;
+	_block_start = 0;
 
-	// Start filter
-	while (PDM->SYNCBUSY != 0);
+	// Start filter, injected samples need no filter
 	_is_recording = true;
-	PDM->CMD = PDM_CMD_START;
+	coverage_listening(true);
+	if (_source == MIC_SOURCE_PDM) {
+		while (PDM->SYNCBUSY != 0);
+		PDM->CMD = PDM_CMD_START;
+	}
 
 	return MIC_OK;
 }
 
+/** @brief Single-shot record an audio segment.
+ * Sets pointers for sampling into, sets the recording flag, and starts
+ * recording into the buffer.
+ */
+enum Mic_Ecode startRecording(int16_t *buffer, uint32_t size) {
+	return beginRecording( buffer, NULL, 0, size );
+}
+
+/** @brief Single-shot record an audio segment into packed 12 bit storage, see
+ * sample_pack.h. Samples are read back with samplePack_read. The block
+ * callback is not called for packed recordings.
+ *
+ * @param packed Storage of SAMPLE_PACK_SIZE(size) words.
+ * @param size Number of samples to record.
+ */
+enum Mic_Ecode startRecordingPacked(uint32_t *packed, uint32_t size) {
+	return beginRecording( NULL, packed, 0, size );
+}
+
+/** @brief Record a run of samples of any length through a ring of blocks.
+ * Each block is passed to the block callback as soon as it is filled, then
+ * recorded over one ring later, so the callback has to take the samples out
+ * before returning. The ring has to hold a whole number of the callback's
+ * blocks. Recording stops once size samples are taken, after a shorter last
+ * block if size is not a whole number of blocks.
+ *
+ * @param ring Ring of ringSize samples.
+ * @param ringSize Number of samples in the ring.
+ * @param size Number of samples to record.
+ * @return MIC_BUSY if there is no block callback, or the ring is not a whole
+ * number of its blocks.
+ */
+enum Mic_Ecode startRecordingRing(int16_t *ring, uint32_t ringSize,
+                                  uint32_t size) {
+	if (_block_callback == NULL || ringSize % _block_size != 0) {
+		return MIC_BUSY;
+	}
+
+	return beginRecording( ring, NULL, ringSize, size );
+}
+
+/** @brief Number of packed groups that had a sample clipped to 12 bits, since
+ * the driver was initialized. A count that keeps growing means the
+ * microphone gain is too high for packed storage.
+ */
+uint32_t micDriver_packClips(void) {
+	return _pack_clips;
+}
+
 /** @brief Terminates the recording.
  * Stops recording and resets the recording flag.
  */
@@ -128,9 +273,12 @@ enum Mic_Ecode stopRecording(void) {
 	}
 
 	// Stop filter
-	while (PDM->SYNCBUSY != 0);
-	PDM->CMD = PDM_CMD_STOP;
+	if (_source == MIC_SOURCE_PDM) {
+		while (PDM->SYNCBUSY != 0);
+		PDM->CMD = PDM_CMD_STOP;
+	}
 	_is_recording = false;
+	coverage_listening(false);
 
 	return MIC_OK;
 }
@@ -143,6 +291,70 @@ bool isRecording(void) {
 	return _is_recording;
 }
 
+/** @brief Set the function called with each block of recorded samples.
+ * Every sample of every recording is passed on exactly once, in order, in
+ * blocks of blockSize and a shorter last block at the end of each buffer.
+ *
+ * @param callback Function to call, NULL for none.
+ * @param blockSize Samples per block.
+ */
+void micDriver_setBlockCallback(MicBlockCallback callback, uint32_t blockSize) {
+	NVIC_DisableIRQ( PDM_IRQn );
+	_block_callback = blockSize > 0 ? callback : NULL;
+	_block_size = blockSize;
+	NVIC_EnableIRQ( PDM_IRQn );
+}
+
+/** @brief Select where recordings get their samples. Injected samples take
+ * the same path as the PDM's, into the buffer and through the block callback,
+ * so whatever records them cannot tell the difference.
+ *
+ * @param source MIC_SOURCE_PDM, or MIC_SOURCE_INJECT to leave the PDM stopped
+ * and record only what micDriver_inject is given.
+ * @return MIC_BUSY if a recording is in progress.
+ */
+enum Mic_Ecode micDriver_setSource(enum Mic_Source source) {
+	if (_is_recording) {
+		return MIC_BUSY;
+	}
+
+	_source = source;
+	return MIC_OK;
+}
+
+/** @brief Record samples from somewhere other than the PDM, see
+ * micDriver_setSource. Takes samples until the recording's buffer is filled.
+ *
+ * @param samples Samples to record.
+ * @param count Number of samples.
+ * @param taken Set to the number of samples recorded, the rest belong to the
+ * next recording.
+ * @return MIC_NOT_RECORDING if no recording is in progress, MIC_BUSY if the
+ * source is the PDM.
+ */
+enum Mic_Ecode micDriver_inject(const int16_t *samples, uint32_t count,
+                                uint32_t *taken) {
+	*taken = 0;
+
+	// check if initialized
+	if (!_initializedFlag) {
+		return MIC_NOT_INITIALIZED;
+	}
+	if (_source != MIC_SOURCE_INJECT) {
+		return MIC_BUSY;
+	}
+	if (!_is_recording) {
+		return MIC_NOT_RECORDING;
+	}
+
+	while (*taken < count && _is_recording) {
+		takeSample( samples[*taken] );
+		*taken = *taken + 1;
+	}
+
+	return MIC_OK;
+}
+
 /** @brief Initialize the microphone driver.
  *
  */
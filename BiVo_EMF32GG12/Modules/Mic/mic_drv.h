@@ -17,6 +17,7 @@
 #include "em_ldma.h"
 #include "em_pdm.h"
 #include "serial_usb_drv.h"
+#include "sample_pack.h"
 
 /** Pins and Ports for on-board microphone */
 #define MIC_CLK_PORT gpioPortB
@@ -44,18 +45,37 @@ struct MicConfig {
 			int mic_gain;
 	};
 
+/** @brief Called from the PDM interrupt with each block of new samples.
+ * Runs in interrupt context, so it has to finish well within a block's time.
+ */
+typedef void (*MicBlockCallback)(const int16_t *block, uint32_t count);
+
 /** @enum Error codes the driver may respond with.
  *
  * See function descriptions for more details of why and what error can respond.
  */
 enum Mic_Ecode {
-	MIC_OK = 0, MIC_NOT_INITIALIZED = 1, MIC_BUSY = 2
+	MIC_OK = 0, MIC_NOT_INITIALIZED = 1, MIC_BUSY = 2, MIC_NOT_RECORDING = 3
+};
+
+/** @enum Where recordings get their samples, see micDriver_setSource.
+ */
+enum Mic_Source {
+	MIC_SOURCE_PDM = 0, MIC_SOURCE_INJECT = 1
 };
 
 /** Function Prototypes */
 void micDriver_init(struct MicConfig config);
 enum Mic_Ecode startRecording(int16_t *buffer, uint32_t size);
+enum Mic_Ecode startRecordingPacked(uint32_t *packed, uint32_t size);
+enum Mic_Ecode startRecordingRing(int16_t *ring, uint32_t ringSize,
+                                  uint32_t size);
 enum Mic_Ecode stopRecording(void);
 bool isRecording(void);
+uint32_t micDriver_packClips(void);
+void micDriver_setBlockCallback(MicBlockCallback callback, uint32_t blockSize);
+enum Mic_Ecode micDriver_setSource(enum Mic_Source source);
+enum Mic_Ecode micDriver_inject(const int16_t *samples, uint32_t count,
+                                uint32_t *taken);
 
 #endif /* MODULES_MIC_MIC_DRV_H_ */
@@ -0,0 +1,101 @@
+/** @file sample_pack.c
+ * @brief Packed 12 bit storage of recorded samples, see sample_pack.h.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#include "sample_pack.h"
+
+/** Signed 12 bit field of a word, a single SBFX */
+#define FIELD12(word, lsb) (((int32_t) ((word) << (20 - (lsb)))) >> 20)
+
+/** @brief Read two samples as one word, lane 0 the first.
+ */
+static inline uint32_t readPair(const int16_t *samples) {
+	uint32_t pair;
+
+	memcpy(&pair, samples, sizeof(pair));
+	return pair;
+}
+
+/** @brief Write two samples from the low 16 bits of each argument.
+ */
+static inline void writePair(int16_t *samples, int32_t first, int32_t second) {
+	uint32_t pair = __PKHBT(first, second, 16);
+
+	memcpy(samples, &pair, sizeof(pair));
+}
+
+/** @brief Unpack one group of samples.
+ */
+static void unpackGroup(const uint32_t *packed, int16_t *samples) {
+	uint32_t w0 = packed[0], w1 = packed[1], w2 = packed[2];
+	uint32_t s6 = (w0 & 0xF) | ((w0 >> 12) & 0xF0) | ((w1 & 0xF) << 8);
+	uint32_t s7 = ((w1 >> 16) & 0xF) | ((w2 & 0xF) << 4) | ((w2 >> 8) & 0xF00);
+
+	writePair(&samples[0], FIELD12(w0, 4), FIELD12(w0, 20));
+	writePair(&samples[2], FIELD12(w1, 4), FIELD12(w1, 20));
+	writePair(&samples[4], FIELD12(w2, 4), FIELD12(w2, 20));
+	writePair(&samples[6], FIELD12(s6, 0), FIELD12(s7, 0));
+}
+
+/** @brief Pack one group of samples.
+ * Two samples are saturated at a time, then the lanes of the first three
+ * pairs are shifted up to make room for the bits of the last pair.
+ *
+ * @param samples SAMPLE_PACK_GROUP samples.
+ * @param packed Written with SAMPLE_PACK_WORDS words.
+ * @return true if a sample was clipped to fit.
+ */
+bool samplePack_group(const int16_t *samples, uint32_t *packed) {
+	uint32_t pair0 = readPair(&samples[0]), pair1 = readPair(&samples[2]);
+	uint32_t pair2 = readPair(&samples[4]), pair3 = readPair(&samples[6]);
+	uint32_t sat0 = __SSAT16(pair0, 12), sat1 = __SSAT16(pair1, 12);
+	uint32_t sat2 = __SSAT16(pair2, 12), sat3 = __SSAT16(pair3, 12);
+
+	packed[0] = ((sat0 << 4) & 0xFFF0FFF0) | (sat3 & 0xF) | ((sat3 << 12) & 0xF0000);
+	packed[1] = ((sat1 << 4) & 0xFFF0FFF0) | ((sat3 >> 8) & 0xF) | (sat3 & 0xF0000);
+	packed[2] = ((sat2 << 4) & 0xFFF0FFF0) | ((sat3 >> 20) & 0xF)
+	            | ((sat3 >> 8) & 0xF0000);
+
+	return ((sat0 ^ pair0) | (sat1 ^ pair1) | (sat2 ^ pair2) | (sat3 ^ pair3)) != 0;
+}
+
+/** @brief Unpack a run of samples from packed storage.
+ * Whole groups are unpacked straight into the samples, the partial groups at
+ * either end go through a group on the stack.
+ *
+ * @param packed Packed storage, from its first group.
+ * @param first Index of the first sample to read.
+ * @param count Number of samples to read.
+ * @param samples Written with count samples.
+ */
+void samplePack_read(const uint32_t *packed, uint32_t first, uint32_t count,
+                     int16_t *samples) {
+	int16_t group[SAMPLE_PACK_GROUP];
+	uint32_t skip = first % SAMPLE_PACK_GROUP;
+	uint32_t take;
+
+	packed += first / SAMPLE_PACK_GROUP * SAMPLE_PACK_WORDS;
+
+	if (skip != 0 && count > 0) {
+		take = SAMPLE_PACK_GROUP - skip < count ? SAMPLE_PACK_GROUP - skip : count;
+		unpackGroup(packed, group);
+		memcpy(samples, &group[skip], take * sizeof(int16_t));
+		packed += SAMPLE_PACK_WORDS;
+		samples += take;
+		count -= take;
+	}
+
+	for (; count >= SAMPLE_PACK_GROUP; count -= SAMPLE_PACK_GROUP) {
+		unpackGroup(packed, samples);
+		packed += SAMPLE_PACK_WORDS;
+		samples += SAMPLE_PACK_GROUP;
+	}
+
+	if (count > 0) {
+		unpackGroup(packed, group);
+		memcpy(samples, group, count * sizeof(int16_t));
+	}
+}
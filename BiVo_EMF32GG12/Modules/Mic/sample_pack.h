@@ -0,0 +1,41 @@
+/** @file sample_pack.h
+ * @brief Packed 12 bit storage of recorded samples.
+ *
+ * A group of SAMPLE_PACK_GROUP samples is saturated to 12 bits and stored in
+ * SAMPLE_PACK_WORDS words, 3/4 of the space of 16 bit samples, so the same
+ * RAM holds a third more audio. The PDM's samples keep their scale, only
+ * those past +-2047 are clipped, so the microphone gain decides what fits.
+ *
+ * Layout of a group, s0 to s7, each word two halfword lanes:
+ * 	word 0	s0 << 4 | s6 bits 0-3			s1 << 4 | s6 bits 4-7
+ * 	word 1	s2 << 4 | s6 bits 8-11		s3 << 4 | s7 bits 0-3
+ * 	word 2	s4 << 4 | s7 bits 4-7			s5 << 4 | s7 bits 8-11
+ * Six samples are read back with one signed bit field extract each, and
+ * packing saturates two samples at a time with SSAT16.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#ifndef MODULES_MIC_SAMPLE_PACK_H_
+#define MODULES_MIC_SAMPLE_PACK_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "em_device.h"
+
+#define SAMPLE_PACK_GROUP 8			// samples in a group
+#define SAMPLE_PACK_WORDS 3			// words a group is stored in
+#define SAMPLE_PACK_MAX 2047		// largest sample stored as it is
+
+/** Words needed to store a number of samples */
+#define SAMPLE_PACK_SIZE(samples) \
+	(((samples) + SAMPLE_PACK_GROUP - 1) / SAMPLE_PACK_GROUP * SAMPLE_PACK_WORDS)
+
+/** Function Prototypes */
+bool samplePack_group(const int16_t *samples, uint32_t *packed);
+void samplePack_read(const uint32_t *packed, uint32_t first, uint32_t count,
+                     int16_t *samples);
+
+#endif /* MODULES_MIC_SAMPLE_PACK_H_ */
@@ -0,0 +1,93 @@
+/** @file profiler.c
+ * @brief Cycle profiling of marked code regions, see profiler.h.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#include "profiler.h"
+
+/** Statistics of each region */
+static struct ProfilerRegion _regions[PROFILE_REGION_COUNT];
+
+/** @brief Enable the core's cycle counter and clear the table.
+ */
+void profiler_init(void) {
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	profiler_reset();
+}
+
+/** @brief Ticks per second, the core clock on the board.
+ */
+uint32_t profiler_tickRate(void) {
+#ifdef BIVO_HOST_SIM
+	return 1000000000;
+#else
+	return SystemCoreClockGet();
+#endif
+}
+
+#if PROFILER_ENABLE
+/** @brief End a run of a region.
+ *
+ * @param start Tick count profiler_begin returned at the start of the run.
+ */
+void profiler_end(enum Profiler_Region region, uint32_t start) {
+	uint32_t ticks = profiler_begin() - start;
+	struct ProfilerRegion *stats = &_regions[region];
+
+	if (stats->count == 0 || ticks < stats->min) {
+		stats->min = ticks;
+	}
+	if (ticks > stats->max) {
+		stats->max = ticks;
+	}
+	stats->count++;
+	stats->sum += ticks;
+	stats->histogram[31 - __CLZ(ticks | 1)]++;
+}
+#endif
+
+/** @brief Copy the statistics of a region.
+ * Interrupts are held off for the copy, so a region timed in a handler is
+ * read whole.
+ */
+void profiler_region(enum Profiler_Region region, struct ProfilerRegion *stats) {
+	__disable_irq();
+	*stats = _regions[region];
+	__enable_irq();
+}
+
+/** @brief Clear the statistics of every region.
+ */
+void profiler_reset(void) {
+	__disable_irq();
+	memset(_regions, 0, sizeof(_regions));
+	__enable_irq();
+}
+
+/** @brief Send one profile record per region.
+ *
+ * @return Number of bytes put on the link.
+ */
+uint32_t profiler_send(void) {
+	struct ProfileRecord record;
+	struct ProfilerRegion stats;
+	uint32_t bytesSent = 0;
+
+	record.tickRate = profiler_tickRate();
+	for (int region=0; region<PROFILE_REGION_COUNT; region++) {
+		profiler_region(region, &stats);
+		record.region = region;
+		record.count = stats.count;
+		record.min = stats.min;
+		record.max = stats.max;
+		record.sum = stats.sum;
+		memcpy(record.histogram, stats.histogram, sizeof(record.histogram));
+		bytesSent += transmitRecord(RECORD_PROFILE, &record,
+		                            sizeof(struct ProfileRecord));
+	}
+
+	return bytesSent;
+}
@@ -0,0 +1,92 @@
+/** @file profiler.h
+ * @brief Cycle profiling of marked code regions.
+ *
+ * A region is timed from profiler_begin to profiler_end with the core's DWT
+ * cycle counter. Each region keeps its run count, shortest, longest and total
+ * time in a static table, along with a log2 histogram where bin b counts the
+ * runs that took 2^b to 2^(b+1)-1 ticks. profiler_send puts the table on the
+ * link as profile records, the desktop application asks for it with the
+ * profile command.
+ *
+ * Regions may nest. A region timed in an interrupt handler must not also be
+ * timed in the main loop. Runs longer than 2^32 ticks (about 226 s at the
+ * core clock) wrap.
+ *
+ * On the host simulation (BIVO_HOST_SIM) ticks are ns of the host's monotonic
+ * clock, as the simulated cycle counter only counts simulated time. Set
+ * against the cycles the board measures, they give the host's speed relative
+ * to the board, the simulation's cpu scale.
+ *
+ * Build with PROFILER_ENABLE 0 to compile the markers out.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#ifndef MODULES_PROFILER_PROFILER_H_
+#define MODULES_PROFILER_PROFILER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "em_device.h"
+#include "gen_com.h"
+#ifdef BIVO_HOST_SIM
+#include <time.h>
+#endif
+
+#ifndef PROFILER_ENABLE
+#define PROFILER_ENABLE 1
+#endif
+
+/** @enum Regions profiled, one entry of the table each.
+ */
+enum Profiler_Region {
+	PROFILE_ANALYZE = 0,			// analyzeAudio or analyzeAudioEvent, one segment
+	PROFILE_FFT = 1,					// spectrum of one analysis frame, FFT and magnitudes
+	PROFILE_TRANSMIT = 2,			// transmit_HalfWord, one call
+	PROFILE_PDM_ISR = 3,			// PDM_IRQHandler, block callback included
+	PROFILE_MATCH = 4,				// template confirmation of one flagged segment
+	PROFILE_INFERENCE = 5,		// nnClassifier_run, one inference
+	PROFILE_REGION_COUNT
+};
+
+/** @struct Statistics of one region, in ticks.
+ */
+struct ProfilerRegion {
+		uint32_t count;
+		uint32_t min;
+		uint32_t max;
+		uint64_t sum;
+		uint32_t histogram[PROFILE_BINS];
+};
+
+/** @brief Current tick count, the start of a region.
+ */
+static inline uint32_t profiler_begin(void) {
+#if PROFILER_ENABLE && defined(BIVO_HOST_SIM)
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint32_t) (now.tv_sec * 1000000000ULL + now.tv_nsec);
+#elif PROFILER_ENABLE
+	return DWT->CYCCNT;
+#else
+	return 0;
+#endif
+}
+
+/** Function Prototypes */
+void profiler_init(void);
+uint32_t profiler_tickRate(void);
+void profiler_region(enum Profiler_Region region, struct ProfilerRegion *stats);
+void profiler_reset(void);
+uint32_t profiler_send(void);
+#if PROFILER_ENABLE
+void profiler_end(enum Profiler_Region region, uint32_t start);
+#else
+static inline void profiler_end(enum Profiler_Region region, uint32_t start) {
+}
+#endif
+
+#endif /* MODULES_PROFILER_PROFILER_H_ */
@@ -0,0 +1,161 @@
+/** @file stream.c
+ * @brief Streaming of recordings longer than RAM, see stream.h.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#include "stream.h"
+
+_Static_assert(STREAM_BLOCK_SAMPLES * sizeof(int16_t) <= AUDIO_MAX_DATA,
+               "a block has to fit in an audio record");
+_Static_assert(STREAM_BLOCK_SAMPLES % SAMPLE_PACK_GROUP == 0,
+               "a block has to be whole packed groups");
+
+/** Ring the microphone records into, and the queue of encoded blocks */
+static int16_t _ring[STREAM_RING_BLOCKS * STREAM_BLOCK_SAMPLES] MEMPLAN_CAPTURE;
+static struct AudioRecord _queue[STREAM_QUEUE_BLOCKS] MEMPLAN_CAPTURE;
+_Static_assert(sizeof(_ring) + sizeof(_queue) <= MEMPLAN_CAPTURE_BUDGET,
+               "the ring and the queue have to fit in the capture region");
+
+/** Queue, put into by the PDM interrupt and taken out of by stream_pump */
+static volatile uint32_t _queued = 0;		// blocks put into the queue
+static volatile uint32_t _sent = 0;			// blocks taken out and sent
+static enum Audio_Format _format = AUDIO_FORMAT_PCM16;
+static bool _dropping = false;					// the last block was lost
+
+/** Accounts of the recording, sent as the stream record */
+static struct StreamRecord _report;
+
+/** @brief Bytes of samples in an audio record.
+ */
+static uint32_t dataBytes(uint32_t samples, enum Audio_Format format) {
+	if (format == AUDIO_FORMAT_PACKED12) {
+		return SAMPLE_PACK_SIZE(samples) * sizeof(uint32_t);
+	}
+	return samples * sizeof(int16_t);
+}
+
+/** @brief Encode a block of samples into an audio record's data. The partial
+ * group of a short last block is packed with silence after it.
+ */
+static void encodeBlock(const int16_t *block, uint32_t count, uint8_t *data) {
+	uint32_t *packed = (uint32_t*) data;
+	int16_t group[SAMPLE_PACK_GROUP] = {0};
+	uint32_t index;
+
+	if (_format != AUDIO_FORMAT_PACKED12) {
+		memcpy(data, block, count * sizeof(int16_t));
+		return;
+	}
+
+	for (index = 0; index + SAMPLE_PACK_GROUP <= count; index += SAMPLE_PACK_GROUP) {
+		if (samplePack_group(&block[index], packed)) {
+			_report.clips++;
+		}
+		packed += SAMPLE_PACK_WORDS;
+	}
+	if (index < count) {
+		memcpy(group, &block[index], (count - index) * sizeof(int16_t));
+		if (samplePack_group(group, packed)) {
+			_report.clips++;
+		}
+	}
+}
+
+/** @brief Block callback of the microphone, in the PDM interrupt. Queues the
+ * block as an audio record, or loses it if the queue is full.
+ */
+static void takeBlock(const int16_t *block, uint32_t count) {
+	uint32_t backlog = _queued - _sent;
+	struct AudioRecord *record;
+
+	if (backlog == STREAM_QUEUE_BLOCKS) {
+		// the link is a whole queue behind
+		if (!_dropping) {
+			_report.overruns++;
+		}
+		_dropping = true;
+		_report.dropped++;
+	}
+	else {
+		record = &_queue[_queued % STREAM_QUEUE_BLOCKS];
+		record->sequence = _report.blocks;
+		record->samples = count;
+		record->format = _format;
+		encodeBlock(block, count, record->data);
+		_queued = _queued + 1;
+		_dropping = false;
+
+		if (backlog + 1 > _report.peakBacklog) {
+			_report.peakBacklog = backlog + 1;
+		}
+	}
+
+	_report.blocks++;
+	_report.samples += count;
+}
+
+/** @brief Start streaming a recording. Sets the microphone's block callback,
+ * which stays set after the recording.
+ *
+ * @param samples Number of samples to record.
+ * @param format Format the samples are sent in.
+ * @return What startRecordingRing returned, MIC_BUSY if a recording is in
+ * progress.
+ */
+enum Mic_Ecode stream_start(uint32_t samples, enum Audio_Format format) {
+	if (isRecording()) {
+		return MIC_BUSY;
+	}
+
+	_format = format;
+	_queued = 0;
+	_sent = 0;
+	_dropping = false;
+	memset(&_report, 0, sizeof(_report));
+	_report.capacity = STREAM_QUEUE_BLOCKS;
+
+	micDriver_setBlockCallback(takeBlock, STREAM_BLOCK_SAMPLES);
+	return startRecordingRing(_ring, sizeof(_ring) / sizeof(_ring[0]), samples);
+}
+
+/** @brief Send the blocks waiting in the queue, from the main loop. Blocks
+ * filled meanwhile are sent too, so this returns only once the queue is empty.
+ *
+ * @return true while the recording goes on or blocks are waiting, false once
+ * the whole recording has been sent.
+ */
+bool stream_pump(void) {
+	struct AudioRecord *record;
+	uint32_t backlog;
+
+	while (_sent != _queued) {
+		record = &_queue[_sent % STREAM_QUEUE_BLOCKS];
+		backlog = _queued - _sent - 1;
+		record->backlog = backlog > UINT8_MAX ? UINT8_MAX : backlog;
+		_report.bytesSent += transmitRecord(RECORD_AUDIO, record,
+		                                    offsetof(struct AudioRecord, data)
+		                                    + dataBytes(record->samples, record->format));
+		_sent = _sent + 1;
+	}
+
+	// the interrupt that stops the recording queues its last block as well
+	return isRecording() || _sent != _queued;
+}
+
+/** @brief Whether stream_pump has nothing to do until the next block is
+ * filled, for sleeping on with interrupts masked.
+ */
+bool stream_idle(void) {
+	return isRecording() && _sent == _queued;
+}
+
+/** @brief Send the accounts of the last recording as a stream record.
+ *
+ * @return Number of bytes put on the link.
+ */
+uint32_t stream_sendReport(void) {
+	_report.bytesSent += sizeof(struct StreamRecord) + RECORD_OVERHEAD;
+	return transmitRecord(RECORD_STREAM, &_report, sizeof(struct StreamRecord));
+}
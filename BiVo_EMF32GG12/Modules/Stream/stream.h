@@ -0,0 +1,44 @@
+/** @file stream.h
+ * @brief Streaming of recordings longer than RAM straight to the link.
+ *
+ * The microphone records into a ring of STREAM_RING_BLOCKS blocks
+ * (startRecordingRing). As each block is filled, the PDM interrupt encodes it
+ * into a queue of audio records, see gen_com.h, as 16 bit samples or packed
+ * to 12 bits. The main loop sends the queued records with stream_pump. Only
+ * the ring and the queue are held in RAM, so a recording can be as long as
+ * the link keeps up with it.
+ *
+ * Backpressure: the queue takes up the link falling behind for a while, up to
+ * STREAM_QUEUE_BLOCKS blocks. A block filled while the queue is full is lost
+ * whole and never sent, and the blocks after it keep their place in the
+ * sequence, so the desktop application sees the gap. stream_sendReport sends
+ * the accounts of the recording as a stream record: blocks lost, runs of them,
+ * and the deepest the queue got.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#ifndef MODULES_STREAM_STREAM_H_
+#define MODULES_STREAM_STREAM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "gen_com.h"
+#include "mic_drv.h"
+#include "sample_pack.h"
+#include "mem_plan.h"
+
+#define STREAM_BLOCK_SAMPLES 120	// samples per block, one audio record
+#define STREAM_RING_BLOCKS 2			// blocks the microphone records into
+#define STREAM_QUEUE_BLOCKS 64		// blocks waiting for the link, a power of 2
+
+/** Function Prototypes */
+enum Mic_Ecode stream_start(uint32_t samples, enum Audio_Format format);
+bool stream_pump(void);
+bool stream_idle(void);
+uint32_t stream_sendReport(void);
+
+#endif /* MODULES_STREAM_STREAM_H_ */
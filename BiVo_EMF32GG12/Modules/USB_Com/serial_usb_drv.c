@@ -25,6 +25,8 @@
  */
 
 #include "serial_usb_drv.h"
+#include "profiler.h"
+#include "coverage.h"
 
 /** @brief Static flag representing if the serial communication has been
  * initialized.
@@ -62,13 +64,16 @@ static void setupGpio(void) {
  * Enables the CMU clock for the USART peripheral, initiates the USART peripheral,
  * clears the RX and TX interrupt request queues, and finally enables the
  * USART-VCOM connection.
+ *
+ * @param baudrate Baud rate of the link, 8N1 and no flow control.
  */
-static void setupUsart(void) {
+static void setupUsart(uint32_t baudrate) {
 	// enable clock for USART peripheral
 	CMU_ClockEnable( cmuClock_USART0, true );
 
-	// Default asynchronous initializer (115.2 Kbps, 8N1, no flow control)
+	// Default asynchronous initializer (8N1, no flow control) at the baud rate
 	USART_InitAsync_TypeDef init = USART_INITASYNC_DEFAULT;
+	init.baudrate = baudrate;
 
 	// Configure and enable USART
 	USART_InitAsync( USART0, &init );
@@ -91,12 +96,28 @@ void serialUsbDriver_init(void) {
 	setupGpio( );
 
 	// setup USART for communication with debug
-	setupUsart( );
+	setupUsart( SERIAL_USB_BAUDRATE );
 
 	// set initialized flag
 	_initializedFlag = true;
 }
 
+/** @brief Change the baud rate of the link, while nothing is being sent. The
+ * desktop application has to open the port at the same rate. The VCOM of the
+ * board controller runs up to 921600 baud.
+ *
+ * @param baudrate New baud rate.
+ */
+enum USB_Ecode serialUsbDriver_setBaudrate(uint32_t baudrate) {
+	// check if initialized
+	if (!_initializedFlag) {
+		return SERIAL_USB_NOT_INITIALIZED;
+	}
+
+	setupUsart( baudrate );
+	return SERIAL_USB_OK;
+}
+
 /** Transmit half a word at a time over the serial connection.
  * This is useful to send audio samples, as samples are half words.
  *
@@ -104,10 +125,15 @@ void serialUsbDriver_init(void) {
  * @param size The number of half words to transmit.
  */
 enum USB_Ecode transmit_HalfWord(int16_t* buffer, uint32_t size) {
+	enum Coverage_Activity previous;
+	uint32_t profileStart;
+
 	// check if initialized
 	if (!_initializedFlag) {
 		return SERIAL_USB_NOT_INITIALIZED;
 	}
+	profileStart = profiler_begin();
+	previous = coverage_set(COVERAGE_TRANSMITTING);
 
 	// send each sample
 	for (int i=0; i<size; i++)
@@ -118,6 +144,8 @@ enum USB_Ecode transmit_HalfWord(int16_t* buffer, uint32_t size) {
 		// fill tx buffer to send
 		USART0->TXDOUBLE = buffer[i];
 	}
+	coverage_set(previous);
+	profiler_end(PROFILE_TRANSMIT, profileStart);
 	return SERIAL_USB_OK;
 }
 
@@ -129,10 +157,13 @@ enum USB_Ecode transmit_HalfWord(int16_t* buffer, uint32_t size) {
  * @param size The number of bytes to transmit.
  */
 enum USB_Ecode transmit_Byte(int8_t* buffer, uint32_t size) {
+	enum Coverage_Activity previous;
+
 	// check if initialized
 	if (!_initializedFlag) {
 		return SERIAL_USB_NOT_INITIALIZED;
 	}
+	previous = coverage_set(COVERAGE_TRANSMITTING);
 
 	// send each sample
 	for (int i=0; i<size; i++)
@@ -143,6 +174,7 @@ enum USB_Ecode transmit_Byte(int8_t* buffer, uint32_t size) {
 		// fill tx buffer to send
 		USART0->TXDATA = buffer[i];
 	}
+	coverage_set(previous);
 	return SERIAL_USB_OK;
 }
 
@@ -154,10 +186,13 @@ enum USB_Ecode transmit_Byte(int8_t* buffer, uint32_t size) {
  * @param size The number of bytes to receive.
  */
 enum USB_Ecode receive_Byte(int8_t* buffer, uint32_t size) {
+	enum Coverage_Activity previous;
+
 	// check if initialized
 	if (!_initializedFlag) {
 		return SERIAL_USB_NOT_INITIALIZED;
 	}
+	previous = coverage_set(COVERAGE_WAITING);
 
 	// send each sample
 	for (int i=0; i<size; i++)
@@ -168,5 +203,28 @@ enum USB_Ecode receive_Byte(int8_t* buffer, uint32_t size) {
 		// put into buffer
 		buffer[i] = USART0->RXDATA;
 	}
+	coverage_set(previous);
+	return SERIAL_USB_OK;
+}
+
+/** Receive a single byte if one is waiting, without blocking.
+ * This is useful to listen for commands while the board keeps working.
+ *
+ * @param byte Where to store the received byte.
+ * @return SERIAL_USB_EMPTY if no byte was waiting.
+ */
+enum USB_Ecode poll_Byte(int8_t* byte) {
+	// check if initialized
+	if (!_initializedFlag) {
+		return SERIAL_USB_NOT_INITIALIZED;
+	}
+
+	// check if rx buffer has data
+	if (((USART0->STATUS>>7) & 0x1) == 0) {
+		return SERIAL_USB_EMPTY;
+	}
+
+	// put into buffer
+	*byte = USART0->RXDATA;
 	return SERIAL_USB_OK;
 }
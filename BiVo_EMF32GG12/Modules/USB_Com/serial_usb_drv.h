@@ -52,17 +52,23 @@
 #include "em_ldma.h"
 #include <stdio.h>
 
+#define SERIAL_USB_BAUDRATE 115200		// baud rate the link starts at
+
 /** @enum Error codes the driver may respond with.
  *
  * See function descriptions for more details of why and what error can respond.
  */
 enum USB_Ecode {
-	SERIAL_USB_OK = 0, SERIAL_USB_NOT_INITIALIZED = 1, SERIAL_USB_BUSY = 2
+	SERIAL_USB_OK = 0, SERIAL_USB_NOT_INITIALIZED = 1, SERIAL_USB_BUSY = 2,
+	SERIAL_USB_EMPTY = 3
 };
 
 /* Function Prototypes */
+void serialUsbDriver_init(void);
+enum USB_Ecode serialUsbDriver_setBaudrate(uint32_t baudrate);
 enum USB_Ecode transmit_HalfWord(int16_t* buffer, uint32_t size);
 enum USB_Ecode transmit_Byte(int8_t* buffer, uint32_t size);
 enum USB_Ecode receive_Byte(int8_t* buffer, uint32_t size);
+enum USB_Ecode poll_Byte(int8_t* byte);
 
 #endif /* MODULES_USB_COM_INC_USB_COM_H_ */
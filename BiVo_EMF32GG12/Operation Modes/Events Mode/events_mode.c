@@ -0,0 +1,316 @@
+/** @file events_mode.c
+ * @brief Events mode streams detection records instead of audio.
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#include "events_mode.h"
+
+/** Settings for the microphone */
+static struct MicConfig mic_config = {
+		.clk_prescalar = EVENTS_CLK_PRESCALAR,
+		.down_sample_rate = EVENTS_DOWN_SAMPLE_RATE,
+		.mic_gain = 7
+	};
+
+/** Segments the microphone records into, and the kept detection */
+static int16_t segments[EVENTS_SEGMENTS][EVENTS_SEGMENT_SAMPLES] MEMPLAN_CAPTURE;
+MEMPLAN_FITS(segments, MEMPLAN_CAPTURE_BUDGET);
+
+/** Settings for the audio analysis */
+static struct AnlysConfig anlys_config = {
+		.fftSize = 256,
+		.freqLower = 0,
+		.freqUpper = 9950,
+		.powerThreshold = 20,
+		.sampleScaler = 50,
+		.decimation = 1,
+		.indices = true
+	};
+
+/** Settings for the acoustic indices */
+static struct IndicesConfig indices_config = {
+		.aciStepSeconds = 5,
+		.biLower = 2000,
+		.biUpper = 8000,
+		.anthroLower = 1000,
+		.anthroUpper = 2000,
+		.bioLower = 2000,
+		.bioUpper = 8000,
+		.adiBandWidth = 1000,
+		.adiThreshold = -50
+	};
+
+/** Settings for the pitch tracker */
+static struct PitchConfig pitch_config = {
+		.windowSize = 256,
+		.minFreq = 1000,
+		.maxFreq = 8000,
+		.threshold = 4915		// 0.15
+	};
+
+/** Settings for the sound level meter */
+static struct LevelConfig level_config = {
+		.calibration = 0		// levels in dBFS(A) until the microphone is calibrated
+	};
+
+/** Counters reported by the summary record */
+static struct SummaryRecord summary = { 0 };
+
+/** @brief Initialize the modules needed for the operation of the events mode.
+ * Needed modules:
+ * 	serial communication
+ * 	microphone
+ * 	audio analysis
+ * 	acoustic indices
+ * 	pitch tracker
+ * 	sound level meter
+ *
+ * @return true if every module is ready. If not, an error record has been
+ * sent and the mode should stop.
+ */
+static bool initMode(int sampleRate) {
+	enum Error_Module module;
+	int error;
+
+	// initialize modules
+	serialUsbDriver_init( );
+	micDriver_init( mic_config );
+
+	if ((error = audioAnalysis_init( anlys_config, sampleRate )) != ANLYS_OK) {
+		module = ERROR_ANALYSIS;
+	}
+	else if ((error = acousticIndices_init( indices_config, sampleRate,
+	                                        audioAnalysis_startSegment(anlys_config),
+	                                        anlys_config.fftSize/2 + 1 )) != INDICES_OK) {
+		module = ERROR_INDICES;
+	}
+	else if ((error = pitchTracker_init( pitch_config, sampleRate )) != PITCH_OK) {
+		module = ERROR_PITCH;
+	}
+	else if ((error = levelMeter_init( level_config, sampleRate )) != LEVEL_OK) {
+		module = ERROR_LEVEL;
+	}
+	else {
+		micDriver_setBlockCallback(levelMeter_block, LEVEL_MAX_BLOCK);
+		return true;
+	}
+
+	handshakeApp();
+	transmitError(module, error);
+	return false;
+}
+
+/** @brief Convert a sample count of capture time to milliseconds.
+ */
+static uint32_t samplesToMs(uint64_t samples, int sampleRate) {
+	return (uint32_t) (samples * 1000 / sampleRate);
+}
+
+/** @brief Track the f0 over a detection and send it as a contour record.
+ * Frames are one analysis frame apart, from the first to the last flagged
+ * frame of the event.
+ *
+ * @param capturedSamples Capture time up to the start of the segment, for
+ * the timestamp.
+ * @return Bytes put on the link.
+ */
+static uint32_t sendContour(int16_t *segment, int bufferSize,
+                            struct AnlysEvent *event, uint64_t capturedSamples,
+                            int sampleRate) {
+	static struct PitchEstimate estimates[CONTOUR_MAX_POINTS] MEMPLAN_TRANSPORT;
+	static struct ContourRecord contour MEMPLAN_TRANSPORT;
+	uint32_t hop = anlys_config.fftSize;
+
+	if (anlys_config.decimation > 1) {
+		hop *= anlys_config.decimation;
+	}
+
+	contour.timestamp = samplesToMs(capturedSamples + event->onsetSample,
+	                                sampleRate);
+	contour.hop = (uint64_t) hop * 1000000 / sampleRate;
+	coverage_set(COVERAGE_ANALYZING);
+	contour.count = pitchTracker_contour(segment, bufferSize, event->onsetSample,
+	                                     event->onsetSample + event->durationSamples,
+	                                     hop, estimates, CONTOUR_MAX_POINTS);
+	coverage_set(COVERAGE_RUNNING);
+	for (int point = 0; point < contour.count; point++) {
+		contour.points[point].f0 = estimates[point].voiced ? estimates[point].f0 : 0;
+		contour.points[point].confidence = estimates[point].confidence >> 7;
+	}
+
+	return transmitRecord(RECORD_CONTOUR, &contour,
+	                      sizeof(struct ContourRecord)
+	                      - sizeof(struct ContourPoint) * (CONTOUR_MAX_POINTS
+	                                                       - contour.count));
+}
+
+/** @brief Send the indices of the interval just completed as an indices
+ * record.
+ *
+ * @param capturedSamples Capture time since the mode started, for the
+ * timestamp.
+ * @return Bytes put on the link.
+ */
+static uint32_t sendIndices(uint64_t capturedSamples, int sampleRate) {
+	struct AcousticIndices indices;
+	struct IndicesRecord record;
+
+	acousticIndices_take(&indices);
+	record.timestamp = samplesToMs(capturedSamples, sampleRate);
+	record.duration = EVENTS_INDICES_PERIOD * EVENTS_SEG_LEN;
+	record.aci = (uint32_t) (indices.aci * 100.0f + 0.5f);
+	record.bi = (uint16_t) __USAT((int32_t) (indices.bi * 10.0f + 0.5f), 16);
+	record.ndsi = (int16_t) __SSAT((int32_t) (indices.ndsi * 32768.0f), 16);
+	record.adi = (uint16_t) (indices.adi * 1000.0f + 0.5f);
+
+	return transmitRecord(RECORD_INDICES, &record, sizeof(struct IndicesRecord));
+}
+
+/** @brief Send any level readings finished since the last call as level
+ * records.
+ *
+ * @return Bytes put on the link.
+ */
+static uint32_t sendLevels(int sampleRate) {
+	struct LevelReading reading;
+	struct LevelRecord record;
+	uint32_t bytes = 0;
+
+	for (int period = LEVEL_SHORT; period <= LEVEL_LONG; period++) {
+		if (levelMeter_take(period, &reading)) {
+			record.timestamp = samplesToMs(reading.endSample, sampleRate);
+			record.duration = samplesToMs(reading.samples, sampleRate);
+			record.leq = reading.leq;
+			record.lmax = reading.lmax;
+			record.lmin = reading.lmin;
+			bytes += transmitRecord(RECORD_LEVEL, &record, sizeof(struct LevelRecord));
+		}
+	}
+
+	return bytes;
+}
+
+/** @brief Send the summary counters as a summary record.
+ *
+ * @param capturedSamples Capture time since the mode started, for the
+ * timestamp.
+ */
+static void sendSummary(uint64_t capturedSamples, int sampleRate) {
+	summary.timestamp = samplesToMs(capturedSamples, sampleRate);
+	summary.bytesSent += sizeof(struct SummaryRecord) + RECORD_OVERHEAD;
+	transmitRecord(RECORD_SUMMARY, &summary, sizeof(struct SummaryRecord));
+}
+
+/** @brief Run the events operational mode.
+ * Handshakes once with the desktop application, then records back to back
+ * into two segment buffers. While one records the other is analyzed, and if
+ * analysis passes an event record is sent and the segment is copied aside for
+ * fetching. Commands are checked whenever the core wakes:
+ * 	"fetch" sends the kept segment as audio, like standard mode does
+ * 	"sumry" sends a summary record right away
+ * 	"profl" and "covrg" send the profile and coverage records
+ *
+ * @note Sending a fetched segment takes longer than recording one, so the
+ * board stops listening once the recording in progress finishes until the
+ * transfer is done. Timestamps count capture time and skip over such gaps.
+ */
+void run_events_mode(void) {
+	// initialize variables
+	int sampleRate = EVENTS_SAMPLE_RATE;
+	int bufferSize = EVENTS_SEGMENT_SAMPLES;
+	int16_t *buffers[2] = {segments[0], segments[1]};
+	int16_t *kept = segments[2];
+	bool keptValid = false;
+	int recordingIdx = 0;
+	uint64_t capturedSamples = 0;
+	struct AnlysEvent event;
+	bool detected;
+	struct EventRecord record;
+	char end_segment_msg[5] = {'-','e','n','d','-'};
+
+	// initialize the mode, stop if a module cannot run
+	if (!initMode(sampleRate)) {
+		return;
+	}
+	handshakeApp();
+
+	startRecording(buffers[recordingIdx], bufferSize);
+
+	while (true) {
+		coverage_sleep(isRecording);
+
+		// the PDM interrupt wakes the core often, so check for commands each time
+		switch (pollCommand()) {
+			case COMMAND_FETCH:
+				if (keptValid) {
+					transmit_HalfWord(kept, bufferSize);
+					summary.bytesSent += bufferSize * sizeof(int16_t);
+				}
+				transmit_Byte((int8_t*) end_segment_msg, 5);
+				summary.bytesSent += 5;
+				break;
+			case COMMAND_SUMMARY:
+				sendSummary(capturedSamples, sampleRate);
+				break;
+			case COMMAND_PROFILE:
+				summary.bytesSent += profiler_send();
+				break;
+			case COMMAND_COVERAGE:
+				summary.bytesSent += coverage_send();
+				break;
+			default:
+				break;
+		}
+
+		summary.bytesSent += sendLevels(sampleRate);
+
+		if (isRecording()) {
+			continue;
+		}
+
+		// swap buffers and keep listening while the finished one is analyzed
+		int16_t *finished = buffers[recordingIdx];
+		recordingIdx ^= 1;
+		startRecording(buffers[recordingIdx], bufferSize);
+
+		coverage_set(COVERAGE_ANALYZING);
+		detected = analyzeAudioEvent(finished, bufferSize, sampleRate, anlys_config,
+		                             &event);
+		coverage_set(COVERAGE_RUNNING);
+
+		if (detected) {
+			record.timestamp = samplesToMs(capturedSamples + event.onsetSample,
+			                               sampleRate);
+			record.bandLower = event.bandLower;
+			record.bandUpper = event.bandUpper;
+			record.peakFreq = event.peakFreq;
+			record.duration = samplesToMs(event.durationSamples, sampleRate);
+			record.peakMagnitude = event.peakMagnitude;
+			record.noiseFloor = event.noiseFloor;
+			summary.bytesSent += transmitRecord(RECORD_EVENT, &record,
+			                                    sizeof(struct EventRecord));
+			summary.bytesSent += sendContour(finished, bufferSize, &event,
+			                                 capturedSamples, sampleRate);
+			summary.events++;
+
+			memcpy(kept, finished, bufferSize * sizeof(int16_t));
+			keptValid = true;
+		}
+		summary.segments++;
+		capturedSamples += bufferSize;
+
+		if (summary.segments % EVENTS_INDICES_PERIOD == 0) {
+			summary.bytesSent += sendIndices(capturedSamples, sampleRate);
+		}
+
+		if (summary.segments % EVENTS_SUMMARY_PERIOD == 0) {
+			sendSummary(capturedSamples, sampleRate);
+		}
+	}
+
+	// exiting mode, de-initialize the mode
+	micDriver_setBlockCallback(NULL, 0);
+	acousticIndices_deinit();
+	audioAnalysis_deinit();
+}
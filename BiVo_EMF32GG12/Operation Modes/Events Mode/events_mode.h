@@ -0,0 +1,58 @@
+/** @file events_mode.h
+ * @brief Events mode never sends audio on its own. It listens continuously,
+ * and for every segment with a detection sends a compact binary event record
+ * over the link. Summary counters go out periodically. The audio of the latest
+ * detection is kept so the desktop application can fetch it on demand.
+ *
+ * This is meant for units on long, weak links where even a single segment of
+ * audio is too much. An event record is 20 bytes on the link, where a segment
+ * of audio is tens of kilobytes. Each event record is followed by a contour
+ * record with the f0 and confidence of every frame of the detection, 3 bytes
+ * per frame, for the desktop application to classify tonal calls from.
+ * Every EVENTS_INDICES_PERIOD segments, an indices record carries the
+ * ecoacoustic indices of the soundscape, for surveys that need no audio.
+ * The A-weighted sound level is metered on every captured sample and sent as
+ * a level record every second and every minute, which also gives the noise
+ * context around each detection.
+ * If a module cannot be initialized, such as the analysis not fitting the DSP
+ * scratch, an error record is sent after the handshake and the mode stops.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#ifndef OPERATION_MODES_EVENTS_MODE_EVENTS_MODE_H_
+#define OPERATION_MODES_EVENTS_MODE_EVENTS_MODE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "serial_usb_drv.h"
+#include "gen_com.h"
+#include "mic_drv.h"
+#include "audio_analysis.h"
+#include "pitch_tracker.h"
+#include "acoustic_indices.h"
+#include "level_meter.h"
+#include "profiler.h"
+#include "coverage.h"
+#include "mem_plan.h"
+
+#define EVENTS_SEG_LEN 1					// number of seconds for audio segment length
+#define EVENTS_SUMMARY_PERIOD 60	// segments between summary records
+#define EVENTS_INDICES_PERIOD 60	// segments between indices records
+
+/** Microphone settings, fixed at build time to size the segment buffers */
+#define EVENTS_CLK_PRESCALAR 29
+#define EVENTS_DOWN_SAMPLE_RATE 32
+#define EVENTS_SAMPLE_RATE \
+	(BASE_CLK_RATE/((EVENTS_CLK_PRESCALAR+1)*EVENTS_DOWN_SAMPLE_RATE))
+#define EVENTS_SEGMENT_SAMPLES (EVENTS_SEG_LEN*EVENTS_SAMPLE_RATE)
+#define EVENTS_SEGMENTS 3					// two recorded into in turn, one kept
+
+/** Function Prototypes */
+void run_events_mode(void);
+
+#endif /* OPERATION_MODES_EVENTS_MODE_EVENTS_MODE_H_ */
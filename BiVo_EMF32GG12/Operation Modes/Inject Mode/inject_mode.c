@@ -0,0 +1,95 @@
+/** @file inject_mode.c
+ * @brief Inject mode analyzes audio sent over the link as if the microphone
+ * had recorded it.
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#include "inject_mode.h"
+
+/** @brief Record one received part of a block, analyzing each segment it
+ * finishes and starting the next.
+ *
+ * @param record Inject record of the block, its verdict and ticks are added
+ * to.
+ */
+static void injectChunk(int16_t *chunk, uint32_t count,
+                        struct InjectRecord *record) {
+	uint32_t offset = 0, taken, start;
+
+	while (offset < count) {
+		start = profiler_begin();
+		micDriver_inject(&chunk[offset], count - offset, &taken);
+		record->injectTicks += profiler_begin() - start;
+		offset += taken;
+
+		// when done recording, analyze and record the next segment
+		if (!isRecording()) {
+			start = profiler_begin();
+			if (segmentPasses()) {
+				record->verdict = INJECT_DETECTED;
+			}
+			else if (record->verdict == INJECT_PENDING) {
+				record->verdict = INJECT_QUIET;
+			}
+			record->analysisTicks += profiler_begin() - start;
+
+			recordSegment();
+		}
+	}
+}
+
+/** @brief Run the inject operational mode.
+ * Handshakes with the desktop application once, then records the blocks it
+ * sends and answers each with an inject record, see inject_mode.h.
+ */
+void run_inject_mode(void) {
+	// initialize variables
+	static int16_t chunk[INJECT_MAX_CHUNK] MEMPLAN_TRANSPORT;
+	struct InjectRecord record = { 0 };
+	uint16_t remaining;
+
+	// initialize the mode, the PDM stays stopped
+	if (!initMode()) {
+		return;
+	}
+	micDriver_setSource(MIC_SOURCE_INJECT);
+	handshakeApp();
+
+	recordSegment();
+
+	while (true) {
+		switch (pollCommand()) {
+			case COMMAND_INJECT:
+				receive_Byte((int8_t*) &remaining, sizeof(remaining));
+				record.samples = remaining;
+				record.verdict = INJECT_PENDING;
+				record.tickRate = profiler_tickRate();
+				record.injectTicks = 0;
+				record.analysisTicks = 0;
+
+				while (remaining > 0) {
+					uint16_t count = remaining < INJECT_MAX_CHUNK ? remaining : INJECT_MAX_CHUNK;
+
+					receive_Byte((int8_t*) chunk, count * sizeof(int16_t));
+					injectChunk(chunk, count, &record);
+					remaining -= count;
+				}
+
+				transmitRecord(RECORD_INJECT, &record, sizeof(struct InjectRecord));
+				record.block++;
+				break;
+			case COMMAND_PROFILE:
+				profiler_send();
+				break;
+			case COMMAND_COVERAGE:
+				coverage_send();
+				break;
+			default:
+				break;
+		}
+	}
+
+	// exiting mode, de-initialize the mode
+	deinitMode();
+}
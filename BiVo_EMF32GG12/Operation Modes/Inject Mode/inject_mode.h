@@ -0,0 +1,41 @@
+/** @file inject_mode.h
+ * @brief Inject mode records audio sent over the link instead of the
+ * microphone's, to replay field recordings on the bench. Blocks of samples go
+ * into the microphone driver's recording path (micDriver_inject), so segments
+ * are cut and analyzed exactly as standard mode does with audio from the PDM,
+ * with the same settings and detector.
+ *
+ * The desktop application handshakes once, then sends each block as the
+ * inject command followed by a 16 bit sample count and the samples, 16 bit
+ * little endian at the standard mode's sample rate. Every block is answered
+ * with an inject record: the verdict of the segment the block finished, if
+ * any, and the ticks spent recording the block and analyzing the segment.
+ * The board only listens for the link between blocks, so the next block waits
+ * for the record of the last.
+ * The profile command is answered meanwhile, so the full histograms can be
+ * read after a replay. Tools/inject_audio.py streams WAV files this way.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#ifndef OPERATION_MODES_INJECT_MODE_INJECT_MODE_H_
+#define OPERATION_MODES_INJECT_MODE_INJECT_MODE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "serial_usb_drv.h"
+#include "gen_com.h"
+#include "mic_drv.h"
+#include "standard_mode.h"
+#include "profiler.h"
+#include "coverage.h"
+
+#define INJECT_MAX_CHUNK 512		// samples received at a time, longer blocks in parts
+
+/** Function Prototypes */
+void run_inject_mode(void);
+
+#endif /* OPERATION_MODES_INJECT_MODE_INJECT_MODE_H_ */
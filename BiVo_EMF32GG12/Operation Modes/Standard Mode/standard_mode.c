@@ -9,41 +9,212 @@
 
 /** Settings for the microphone */
 struct MicConfig mic_config = {
-		.clk_prescalar = 29,
-		.down_sample_rate = 32,
+		.clk_prescalar = STANDARD_CLK_PRESCALAR,
+		.down_sample_rate = STANDARD_DOWN_SAMPLE_RATE,
 		.mic_gain = 7
 	};
 
+/** Segment the microphone records into, the inject mode records into it too */
+#if STANDARD_SAMPLE_FORMAT == STANDARD_FORMAT_PACKED12
+static uint32_t segment_buffer[SAMPLE_PACK_SIZE(STANDARD_SEGMENT_SAMPLES)] MEMPLAN_CAPTURE;
+#else
+static int16_t segment_buffer[STANDARD_SEGMENT_SAMPLES] MEMPLAN_CAPTURE;
+#endif
+MEMPLAN_FITS(segment_buffer, MEMPLAN_CAPTURE_BUDGET);
+
 /** Settings for the audio analysis */
 struct AnlysConfig anlys_config = {
 		.fftSize = 256,
 		.freqLower = 0,
 		.freqUpper = 9950,
 		.powerThreshold = 20,
-		.sampleScaler = 50
+		.sampleScaler = 50,
+		.decimation = 1,
+		.trigger = ANLYS_TRIGGER_LEVEL,
+		.onsetMargin = 1024,
+		.gates = {.maxEntropy = 0, .maxFlatness = 0}	// maxFlatness 3277 (0.10)
+																								// rejects rain and wind
+	};
+
+/** Target tones and settings for the Goertzel detector */
+const uint16_t goertzel_targets[] = {2500, 3150, 4000};
+struct GoertzelConfig goertzel_config = {
+		.blockSize = 256,
+		.powerThreshold = 20,
+		.sampleScaler = 50,
+		.targets = goertzel_targets,
+		.targetCount = sizeof(goertzel_targets) / sizeof(goertzel_targets[0])
+	};
+
+#if STANDARD_CONFIRM == STANDARD_CONFIRM_TEMPLATES
+/** Settings of the template confirmation, the templates' own band layout */
+struct MatchConfig match_config = {
+		.bands = MATCH_TEMPLATE_BANDS,
+		.freqLower = MATCH_TEMPLATE_FREQ_LOWER,
+		.freqUpper = MATCH_TEMPLATE_FREQ_UPPER,
+		.minScore = 18022,			// 0.55, a call near the noise level scores 0.69
+		.templates = matchTemplateSet,
+		.templateCount = MATCH_TEMPLATE_COUNT
 	};
+static struct MatchResult match_results[MATCH_TEMPLATE_COUNT];
+#endif
 
 /** @brief Initialize the modules needed for the operation of the standard mode.
  * Needed modules:
  * 	serial communication
  * 	microphone
  * 	audio analysis
+ * 	template matcher, if segments are confirmed with templates
+ *
+ * @return true if the detector is ready. If not, an error record has been sent
+ * and the mode should stop.
  */
-void initMode(void) {
+bool initMode(void) {
 	// initialize modules
 	serialUsbDriver_init( );
 	micDriver_init( mic_config );
+#if STANDARD_DETECTOR == STANDARD_DETECTOR_GOERTZEL
+	enum Goertzel_Ecode error = goertzel_init( goertzel_config,
+	               BASE_CLK_RATE/((mic_config.clk_prescalar+1)*mic_config.down_sample_rate) );
+	enum Error_Module module = ERROR_GOERTZEL;
+#else
+	int error = audioAnalysis_init( anlys_config, STANDARD_SAMPLE_RATE );
+	enum Error_Module module = ERROR_ANALYSIS;
+#endif
+#if STANDARD_CONFIRM == STANDARD_CONFIRM_TEMPLATES
+	if (error == ANLYS_OK) {
+		module = ERROR_MATCH;
+		if (anlys_config.fftSize != MATCH_TEMPLATE_FFT_SIZE
+		    || anlys_config.decimation != MATCH_TEMPLATE_DECIMATION) {
+			error = MATCH_BAD_CONFIG;
+		}
+		else {
+			error = templateMatcher_init( match_config, anlys_config,
+			                              STANDARD_SAMPLE_RATE, STANDARD_CONFIRM_FRAMES );
+		}
+	}
+#endif
+
+	if (error != 0) {
+		handshakeApp();
+		transmitError(module, error);
+		return false;
+	}
+	return true;
 }
 
 /** @brief De-initialize the modules used for the operation of the standard
  * mode.
  */
 void deinitMode(void) {
+#if STANDARD_CONFIRM == STANDARD_CONFIRM_TEMPLATES
+	templateMatcher_deinit();
+#endif
+#if STANDARD_DETECTOR == STANDARD_DETECTOR_FFT
 	audioAnalysis_deinit();
+#endif
 	// nothing more right now, as we will never leave this mode in this version of
 	// BiVo
 }
 
+/** @brief Start recording a segment into the segment buffer.
+ */
+void recordSegment(void) {
+#if STANDARD_SAMPLE_FORMAT == STANDARD_FORMAT_PACKED12
+	startRecordingPacked(segment_buffer, STANDARD_SEGMENT_SAMPLES);
+#else
+	startRecording(segment_buffer, STANDARD_SEGMENT_SAMPLES);
+#endif
+}
+
+#if STANDARD_CONFIRM == STANDARD_CONFIRM_TEMPLATES
+/** @brief Match the templates over the recorded segment, a window of
+ * STANDARD_CONFIRM_FRAMES frames at a time. Windows overlap by the longest
+ * template less one frame, so every offset of every template is tried.
+ *
+ * @return true at the first window a template matches in.
+ */
+static bool segmentMatches(void) {
+	uint32_t profileStart = profiler_begin();
+	uint32_t frameStride = audioAnalysis_startSegment(anlys_config);
+	uint32_t window = STANDARD_CONFIRM_FRAMES * frameStride;
+	uint32_t longest = 0;
+	uint32_t hop;
+	bool matched = false;
+
+	if (frameStride == 0) {
+		profiler_end(PROFILE_MATCH, profileStart);
+		return false;
+	}
+	for (int i = 0; i < MATCH_TEMPLATE_COUNT; i++) {
+		if (matchTemplateSet[i].frames > longest) {
+			longest = matchTemplateSet[i].frames;
+		}
+	}
+	hop = (STANDARD_CONFIRM_FRAMES - longest + 1) * frameStride;
+
+	for (uint32_t first = 0; first < STANDARD_SEGMENT_SAMPLES && !matched;
+	     first += hop) {
+		uint32_t count = STANDARD_SEGMENT_SAMPLES - first < window
+		                 ? STANDARD_SEGMENT_SAMPLES - first : window;
+
+		matched = matchTemplates(&segment_buffer[first], count, anlys_config,
+		                         match_results);
+		if (first + window >= STANDARD_SEGMENT_SAMPLES) {
+			break;
+		}
+	}
+
+	profiler_end(PROFILE_MATCH, profileStart);
+	return matched;
+}
+#endif
+
+/** @brief Pass the recorded segment through the configured detector, and the
+ * confirmation if one is built in.
+ */
+bool segmentPasses(void) {
+	enum Coverage_Activity previous = coverage_set(COVERAGE_ANALYZING);
+	bool passes;
+
+#if STANDARD_DETECTOR == STANDARD_DETECTOR_GOERTZEL
+	passes = analyzeAudioGoertzel(segment_buffer, STANDARD_SEGMENT_SAMPLES,
+	                              STANDARD_SAMPLE_RATE, goertzel_config);
+#elif STANDARD_SAMPLE_FORMAT == STANDARD_FORMAT_PACKED12
+	passes = analyzeAudioPacked(segment_buffer, STANDARD_SEGMENT_SAMPLES,
+	                            STANDARD_SAMPLE_RATE, anlys_config);
+#else
+	passes = analyzeAudio(segment_buffer, STANDARD_SEGMENT_SAMPLES,
+	                      STANDARD_SAMPLE_RATE, anlys_config);
+#endif
+#if STANDARD_CONFIRM == STANDARD_CONFIRM_TEMPLATES
+	passes = passes && segmentMatches();
+#endif
+	coverage_set(previous);
+
+	return passes;
+}
+
+/** @brief Send the recorded segment as 16 bit samples, whatever it is stored
+ * as. Packed storage is unpacked STANDARD_TRANSMIT_CHUNK samples at a time.
+ */
+void transmitSegment(void) {
+#if STANDARD_SAMPLE_FORMAT == STANDARD_FORMAT_PACKED12
+	static int16_t chunk[STANDARD_TRANSMIT_CHUNK] MEMPLAN_TRANSPORT;
+
+	for (uint32_t first = 0; first < STANDARD_SEGMENT_SAMPLES;
+	     first += STANDARD_TRANSMIT_CHUNK) {
+		uint32_t count = STANDARD_SEGMENT_SAMPLES - first < STANDARD_TRANSMIT_CHUNK
+		                 ? STANDARD_SEGMENT_SAMPLES - first : STANDARD_TRANSMIT_CHUNK;
+
+		samplePack_read(segment_buffer, first, count, chunk);
+		transmit_HalfWord(chunk, count);
+	}
+#else
+	transmit_HalfWord(segment_buffer, STANDARD_SEGMENT_SAMPLES);
+#endif
+}
+
 /** @brief Run the standard operational mode.
  * First begins with handshake from desktop application. Then falls into the
  * operation of waiting for the command from the app to record a segment,
@@ -58,47 +229,58 @@ void deinitMode(void) {
  */
 void run_standard_mode(void) {
 	// initialize variables
-	int sampleRate = BASE_CLK_RATE/((mic_config.clk_prescalar+1)*mic_config.down_sample_rate);
-	int bufferSize = AUDIO_SEG_LEN*sampleRate;
-	int16_t *buffer = (int16_t*) calloc(bufferSize, sizeof(int16_t));
 	char end_segment_msg[5] = {'-','e','n','d','-'};
 
-	// initialize the mode
-	initMode();
+	// initialize the mode, stop if the detector cannot run
+	if (!initMode()) {
+		return;
+	}
 
 	// loop now, on receiving command and sending audio
 	while (true) {
 		// wait for command from app to record and send a segment. Doesn't check for
 		// if a correct command is sent, just a command
 		handshakeApp(); // handshake here because of difficulties making app not handshake every segment call
-		waitOnRecordMessage();
+
+		// wait for the record command, answering profile and coverage requests
+		// meanwhile
+		coverage_set(COVERAGE_WAITING);
+		for (enum GenCom_Command command = pollCommand();
+		     command != COMMAND_RECORD; command = pollCommand()) {
+			if (command == COMMAND_PROFILE) {
+				profiler_send();
+			}
+			else if (command == COMMAND_COVERAGE) {
+				coverage_send();
+			}
+		}
+		coverage_set(COVERAGE_RUNNING);
 
 		// record segment and send back
-		startRecording(buffer, bufferSize);
+		recordSegment();
 
 		while (true) {
-			EMU_EnterEM1();
+			coverage_sleep(isRecording);
 
 			// when done recording
 			if (!isRecording()) {
 				// pass into audio analysis
 				// if passed analysis, send
-				if (analyzeAudio(buffer, bufferSize, sampleRate, anlys_config)) {
+				if (segmentPasses()) {
 					// send
-					transmit_HalfWord(buffer, bufferSize);
-					transmit_Byte(end_segment_msg, 5);
+					transmitSegment();
+					transmit_Byte((int8_t*) end_segment_msg, 5);
 					break;
 				}
 
 				// analysis didn't pass, record a new segment
 				else {
-					startRecording(buffer, bufferSize);
+					recordSegment();
 				}
 			}
 		}
 	}
 
 	// exiting mode, de-initialize the mode
-	free(buffer);
 	deinitMode();
 }
@@ -14,9 +14,86 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "serial_usb_drv.h"
+#include "gen_com.h"
 #include "mic_drv.h"
 #include "audio_analysis.h"
+#include "goertzel.h"
+#include "template_matcher.h"
+#include "match_templates.h"
+#include "profiler.h"
+#include "coverage.h"
+#include "mem_plan.h"
 
-#define AUDIO_SEG_LEN 4.0		// number of seconds for audio segment length
+/* Storage of the segment buffer, chosen at build time by defining
+ * STANDARD_SAMPLE_FORMAT. Packed storage takes 12 bits a sample instead of 16,
+ * so its 5 s segment holds a quarter more audio than the 4 s one in slightly
+ * less RAM (whole seconds, about 5.3 s would fill MEMPLAN_CAPTURE_BUDGET).
+ * Samples past +-2047 are clipped, see sample_pack.h */
+#define STANDARD_FORMAT_16 0					// samples as the PDM gives them
+#define STANDARD_FORMAT_PACKED12 1		// 12 bit samples, 8 in 3 words
+#ifndef STANDARD_SAMPLE_FORMAT
+#define STANDARD_SAMPLE_FORMAT STANDARD_FORMAT_16
+#endif
+
+#ifndef AUDIO_SEG_LEN
+#if STANDARD_SAMPLE_FORMAT == STANDARD_FORMAT_PACKED12
+#define AUDIO_SEG_LEN 5		// number of seconds for audio segment length
+#else
+#define AUDIO_SEG_LEN 4		// number of seconds for audio segment length
+#endif
+#endif
+#define STANDARD_TRANSMIT_CHUNK 256	// samples unpacked at a time to be sent
+
+/** Microphone settings, fixed at build time to size the segment buffer */
+#define STANDARD_CLK_PRESCALAR 29
+#define STANDARD_DOWN_SAMPLE_RATE 32
+#define STANDARD_SAMPLE_RATE \
+	(BASE_CLK_RATE/((STANDARD_CLK_PRESCALAR+1)*STANDARD_DOWN_SAMPLE_RATE))
+#define STANDARD_SEGMENT_SAMPLES (AUDIO_SEG_LEN*STANDARD_SAMPLE_RATE)
+
+/* Detector segments are flagged with, chosen at build time by defining
+ * STANDARD_DETECTOR */
+#define STANDARD_DETECTOR_FFT 0				// analyzeAudio, any frequency in the band
+#define STANDARD_DETECTOR_GOERTZEL 1	// analyzeAudioGoertzel, listed tones only
+#ifndef STANDARD_DETECTOR
+#define STANDARD_DETECTOR STANDARD_DETECTOR_FFT
+#endif
+#if STANDARD_DETECTOR == STANDARD_DETECTOR_GOERTZEL \
+    && STANDARD_SAMPLE_FORMAT == STANDARD_FORMAT_PACKED12
+#error "the Goertzel detector needs the segment as 16 bit samples"
+#endif
+
+/* Confirmation of segments the detector flags, chosen at build time by
+ * defining STANDARD_CONFIRM. With templates, a flagged segment is only sent if
+ * one of matchTemplateSet also matches it, see template_matcher.h. The segment
+ * is matched in windows of STANDARD_CONFIRM_FRAMES frames, each overlapping the
+ * one before by the longest template, to bound the matcher's scratch. */
+#define STANDARD_CONFIRM_NONE 0				// every flagged segment is sent
+#define STANDARD_CONFIRM_TEMPLATES 1	// flagged segments must match a template
+#ifndef STANDARD_CONFIRM
+#define STANDARD_CONFIRM STANDARD_CONFIRM_NONE
+#endif
+#define STANDARD_CONFIRM_FRAMES 64		// frames matched at a time
+#if STANDARD_CONFIRM == STANDARD_CONFIRM_TEMPLATES
+#if STANDARD_DETECTOR != STANDARD_DETECTOR_FFT \
+    || STANDARD_SAMPLE_FORMAT == STANDARD_FORMAT_PACKED12
+#error "template confirmation needs the FFT detector and 16 bit samples"
+#endif
+#if STANDARD_SAMPLE_RATE != MATCH_TEMPLATE_SAMPLE_RATE
+#error "the templates were made at another sample rate"
+#endif
+#endif
+
+/** Settings, shared with the inject mode */
+extern struct MicConfig mic_config;
+extern struct AnlysConfig anlys_config;
+
+/** Function Prototypes */
+bool initMode(void);
+void deinitMode(void);
+void recordSegment(void);
+bool segmentPasses(void);
+void transmitSegment(void);
+void run_standard_mode(void);
 
 #endif /* OPERATION_MODES_STANDARD_MODE_STANDARD_MODE_H_ */
@@ -0,0 +1,87 @@
+/** @file stream_mode.c
+ * @brief Stream mode sends segments longer than RAM as they are recorded.
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#include "stream_mode.h"
+
+/** Settings for the microphone */
+static struct MicConfig mic_config = {
+		.clk_prescalar = STREAM_CLK_PRESCALAR,
+		.down_sample_rate = STREAM_DOWN_SAMPLE_RATE,
+		.mic_gain = 7
+	};
+
+/** @brief Initialize the modules needed for the operation of the stream mode.
+ * Needed modules:
+ * 	serial communication, at the stream mode's baud rate
+ * 	microphone
+ *
+ * @return true if the mode is ready. If not, an error record has been sent
+ * and the mode should stop.
+ */
+static bool initMode(void) {
+	enum USB_Ecode error;
+
+	// initialize modules
+	serialUsbDriver_init( );
+	error = serialUsbDriver_setBaudrate( STREAM_BAUDRATE );
+	micDriver_init( mic_config );
+
+	if (error != SERIAL_USB_OK) {
+		handshakeApp();
+		transmitError(ERROR_SERIAL, error);
+		return false;
+	}
+	return true;
+}
+
+/** @brief Run the stream operational mode.
+ * Handshakes with the desktop application, waits for the record command, and
+ * streams a segment, then repeats indefinitely, see stream_mode.h. The core
+ * sleeps whenever every block filled so far has been sent. Returns after
+ * sending an error record if the mode could not start or a recording could
+ * not.
+ */
+void run_stream_mode(void) {
+	// initialize variables
+	char end_segment_msg[5] = {'-','e','n','d','-'};
+	enum Mic_Ecode error;
+
+	// initialize the mode
+	if (!initMode()) {
+		return;
+	}
+
+	while (true) {
+		handshakeApp();
+
+		// wait for the record command, answering profile and coverage requests
+		// meanwhile
+		coverage_set(COVERAGE_WAITING);
+		for (enum GenCom_Command command = pollCommand();
+		     command != COMMAND_RECORD; command = pollCommand()) {
+			if (command == COMMAND_PROFILE) {
+				profiler_send();
+			}
+			else if (command == COMMAND_COVERAGE) {
+				coverage_send();
+			}
+		}
+		coverage_set(COVERAGE_RUNNING);
+
+		// record the segment, sending each block as it is filled
+		error = stream_start(STREAM_SEGMENT_SAMPLES, STREAM_SAMPLE_FORMAT);
+		if (error != MIC_OK) {
+			transmitError(ERROR_MIC, error);
+			return;
+		}
+		while (stream_pump()) {
+			coverage_sleep(stream_idle);
+		}
+
+		stream_sendReport();
+		transmit_Byte((int8_t*) end_segment_msg, 5);
+	}
+}
@@ -0,0 +1,57 @@
+/** @file stream_mode.h
+ * @brief Stream mode records on command like standard mode, but streams the
+ * segment over the link as it is captured instead of holding it in RAM, so
+ * segments can be far longer than standard mode's, such as a dawn chorus.
+ * Nothing is analyzed, every segment is sent.
+ *
+ * The desktop application handshakes and sends the record command as it does
+ * for standard mode. The segment then comes as audio records of
+ * STREAM_BLOCK_SAMPLES samples each, see stream.h, followed by a stream record
+ * with the accounts of the segment and the end message. A block the link
+ * could not keep up with is left out, its sequence number is skipped. Profile
+ * and coverage commands are answered while waiting for the record command.
+ *
+ * The link runs at STREAM_BAUDRATE, from the handshake on. 16 bit samples
+ * take about 420 kbaud with the records' framing, packed ones about 320.
+ * Tools/stream_audio.py receives a segment into a WAV file.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#ifndef OPERATION_MODES_STREAM_MODE_STREAM_MODE_H_
+#define OPERATION_MODES_STREAM_MODE_STREAM_MODE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "serial_usb_drv.h"
+#include "gen_com.h"
+#include "mic_drv.h"
+#include "stream.h"
+#include "profiler.h"
+#include "coverage.h"
+
+#ifndef STREAM_SEG_LEN
+#define STREAM_SEG_LEN 60				// number of seconds for audio segment length
+#endif
+#define STREAM_BAUDRATE 921600	// baud rate of the link in this mode
+
+/* Format the samples are sent in, chosen at build time by defining
+ * STREAM_SAMPLE_FORMAT as an enum Audio_Format */
+#ifndef STREAM_SAMPLE_FORMAT
+#define STREAM_SAMPLE_FORMAT AUDIO_FORMAT_PCM16
+#endif
+
+/** Microphone settings, the same as standard mode's */
+#define STREAM_CLK_PRESCALAR 29
+#define STREAM_DOWN_SAMPLE_RATE 32
+#define STREAM_SAMPLE_RATE \
+	(BASE_CLK_RATE/((STREAM_CLK_PRESCALAR+1)*STREAM_DOWN_SAMPLE_RATE))
+#define STREAM_SEGMENT_SAMPLES (STREAM_SEG_LEN*STREAM_SAMPLE_RATE)
+
+/** Function Prototypes */
+void run_stream_mode(void);
+
+#endif /* OPERATION_MODES_STREAM_MODE_STREAM_MODE_H_ */
@@ -0,0 +1,70 @@
+#!/usr/bin/env python3
+"""Compare two runs of bivo_bench and flag regressions.
+
+Each benchmark and size found in both files is listed with the ratio of its
+times, current over baseline. A benchmark regressed when its fastest run is
+slower than the baseline's fastest run by more than the threshold; the
+fastest run is the least disturbed by the rest of the host, so it is the
+steadiest to compare. The median ratio is listed alongside.
+
+Usage:
+    bench_compare.py [--threshold PERCENT] baseline.csv current.csv
+
+Options:
+    --threshold PERCENT   slowdown counted as a regression, default 5
+
+Exits with status 1 if anything regressed. Compare runs from the same host
+only.
+"""
+
+import csv
+import sys
+
+
+def read_bench(path):
+    with open(path, newline="") as f:
+        return {(row["benchmark"], int(row["size"])): row
+                for row in csv.DictReader(f)}
+
+
+def main():
+    threshold = 5.0
+    paths = []
+    args = sys.argv[1:]
+    while args:
+        arg = args.pop(0)
+        if arg == "--threshold" and args:
+            threshold = float(args.pop(0))
+        elif not arg.startswith("-"):
+            paths.append(arg)
+        else:
+            sys.exit(__doc__)
+    if len(paths) != 2:
+        sys.exit(__doc__)
+
+    baseline, current = read_bench(paths[0]), read_bench(paths[1])
+    regressions = 0
+    print("%-22s %6s %12s %12s %8s %8s" % ("benchmark", "size", "base_min_ns",
+                                           "cur_min_ns", "min", "median"))
+    for key in sorted(set(baseline) & set(current)):
+        base, cur = baseline[key], current[key]
+        ratio = float(cur["min_ns"]) / float(base["min_ns"])
+        median = float(cur["median_ns"]) / float(base["median_ns"])
+        flag = ""
+        if ratio > 1.0 + threshold / 100.0:
+            flag = "  REGRESSED"
+            regressions += 1
+        print("%-22s %6d %12s %12s %7.3fx %7.3fx%s" % (key[0], key[1], base["min_ns"],
+                                                       cur["min_ns"], ratio, median,
+                                                       flag))
+    for key in sorted(set(baseline) ^ set(current)):
+        print("%-22s %6d only in %s" % (key[0], key[1],
+                                         paths[0] if key in baseline else paths[1]))
+
+    if regressions:
+        print("%d regressed by more than %g%%" % (regressions, threshold))
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,315 @@
+#!/usr/bin/env python3
+"""Generate the fixed-size real FFT + magnitude kernels for audio analysis.
+
+Writes fft_kernels.h and fft_kernels.c into Modules/Audio Analysis. Each
+kernel computes the magnitude spectrum of one frame of fftSize q15 samples,
+on the same scale as arm_rfft_q15 followed by arm_cmplx_mag_q15
+(|X[k]| / (2 * fftSize)), for bins 0 to fftSize/2.
+
+A real FFT of N points is done as a complex FFT of M = N/2 points on the
+even/odd samples packed as complex pairs, followed by the usual split step.
+The complex FFT is radix-2 decimation in time. For a fixed size every loop
+bound, stride and twiddle step is a literal, the first two stages need no
+multiplies at all, and the twiddle and bit-reversal swap tables are const so
+they stay in flash.
+
+Scaling, so no stage can overflow q15: the first stage divides by 4 and every
+other stage by 2, which keeps each complex value's magnitude under 23170. The
+split step is done in 32 bits.
+
+Usage: python3 gen_fft_kernels.py [size ...]     (default 128 256 512 1024)
+Run from anywhere, the output path is relative to this script. The output is
+checked in, rerun this only to change the set of sizes.
+"""
+
+import math
+import os
+import sys
+
+DEFAULT_SIZES = [128, 256, 512, 1024]
+OUT_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..",
+                       "Modules", "Audio Analysis")
+
+
+def q15(value):
+    return max(-32768, min(32767, int(round(value * 32768))))
+
+
+def packed(re, im):
+    """Pack a q15 complex value the way the kernels load it, re low."""
+    return "0x%08X" % (((q15(im) & 0xFFFF) << 16) | (q15(re) & 0xFFFF))
+
+
+def table(ctype, name, values, per_line):
+    lines = ["static const %s %s[%d] = {" % (ctype, name, len(values))]
+    for start in range(0, len(values), per_line):
+        chunk = ", ".join(values[start:start + per_line])
+        last = start + per_line >= len(values)
+        lines.append("\t\t" + chunk + ("" if last else ","))
+    lines.append("};")
+    return "\n".join(lines)
+
+
+def bit_reverse_pairs(m):
+    bits = m.bit_length() - 1
+    pairs = []
+    for i in range(m):
+        j = int(format(i, "0%db" % bits)[::-1], 2)
+        if i < j:
+            pairs += [str(i), str(j)]
+    return pairs
+
+
+def sqrt_table():
+    """sqrt(i * 2^24) for the top byte i of a power normalized to [2^30, 2^32)."""
+    values = [str(int(round(math.sqrt(i * (1 << 24))))) for i in range(64, 257)]
+    return ("/** sqrt(i * 2^24) for i = 64 to 256, used by binMagnitude */\n"
+            + table("uint32_t", "sqrtTable", values, 8))
+
+
+def kernel(n):
+    m = n // 2
+    stages = m.bit_length() - 1
+    out = []
+
+    # forward twiddles cos - j sin are stored as (cos, sin)
+    fft_tw = [packed(math.cos(2 * math.pi * k / m), math.sin(2 * math.pi * k / m))
+              for k in range(m // 2)]
+    split_tw = [packed(math.cos(2 * math.pi * k / n), math.sin(2 * math.pi * k / n))
+                for k in range(1, m)]
+    swaps = bit_reverse_pairs(m)
+
+    out.append("/* %d point real FFT: %d point complex FFT, %d stages */" % (n, m, stages))
+    out.append(table("uint32_t", "fftTwiddle%d" % n, fft_tw, 6))
+    out.append("")
+    out.append(table("uint32_t", "splitTwiddle%d" % n, split_tw, 6))
+    out.append("")
+    out.append(table("uint16_t", "bitRevSwaps%d" % n, swaps, 12))
+    out.append("")
+    out.append("/** @brief Magnitude spectrum of a %d sample frame.\n"
+               " * The frame is used as workspace and is overwritten.\n"
+               " */" % n)
+    out.append("void fftKernel_rfftMag%d(q15_t *frame, q15_t *magnitude) {" % n)
+    out.append("\tuint32_t *z = (uint32_t*) frame;")
+    out.append("\tint i, k;")
+    out.append("")
+    out.append("\tbitReverse(z, bitRevSwaps%d, %d);" % (n, len(swaps) // 2))
+    out.append("")
+    out.append("\t// stage 1: 2 point butterflies, W = 1")
+    out.append("\tfor (i = 0; i < %d; i += 2) {" % m)
+    out.append("\t\tbutterflyQuarter(&z[i], &z[i + 1]);")
+    out.append("\t}")
+    if stages >= 2:
+        out.append("")
+        out.append("\t// stage 2: 4 point butterflies, W = 1 and -j")
+        out.append("\tfor (i = 0; i < %d; i += 4) {" % m)
+        out.append("\t\tbutterflyHalf(&z[i], &z[i + 2]);")
+        out.append("\t\tbutterflyMinusJ(&z[i + 1], &z[i + 3]);")
+        out.append("\t}")
+    for s in range(3, stages + 1):
+        span = 1 << s
+        half = span // 2
+        step = m // span
+        out.append("")
+        out.append("\t// stage %d: %d point butterflies, twiddle step %d" % (s, span, step))
+        out.append("\tfor (i = 0; i < %d; i += %d) {" % (m, span))
+        out.append("\t\tfor (k = 0; k < %d; k++) {" % half)
+        tw = "fftTwiddle%d[k]" % n if step == 1 else "fftTwiddle%d[k * %d]" % (n, step)
+        out.append("\t\t\tbutterfly(&z[i + k], &z[i + k + %d], %s);" % (half, tw))
+        out.append("\t\t}")
+        out.append("\t}")
+    out.append("")
+    out.append("\tsplitMagnitude(z, splitTwiddle%d, %d, magnitude);" % (n, m))
+    out.append("}")
+    return "\n".join(out)
+
+
+HEADER = """/** @file fft_kernels.h
+ * @brief Fixed-size real FFT + magnitude kernels for audio analysis.
+ *
+ * GENERATED by Tools/gen_fft_kernels.py, do not edit by hand.
+ *
+ * Each kernel gives the same result as arm_rfft_q15 followed by
+ * arm_cmplx_mag_q15 on fftSize/2 + 1 bins, but is specialized for its size:
+ * constant loop bounds and strides, multiply-free first stages, and twiddle
+ * and bit-reversal tables in flash. The magnitude is taken in 32 bits, so
+ * bins too quiet for arm_cmplx_mag_q15 (which reads them as 0) are kept.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#ifndef MODULES_AUDIO_ANALYSIS_FFT_KERNELS_H_
+#define MODULES_AUDIO_ANALYSIS_FFT_KERNELS_H_
+
+#include <stdint.h>
+#include "arm_math.h"
+
+/** Kernel computing the magnitude spectrum of one frame in place. */
+typedef void (*FftKernel)(q15_t *frame, q15_t *magnitude);
+
+/** Function Prototypes */
+FftKernel fftKernel_select(int fftSize);
+%s
+
+#endif /* MODULES_AUDIO_ANALYSIS_FFT_KERNELS_H_ */
+"""
+
+SOURCE_HEAD = """/** @file fft_kernels.c
+ * @brief Fixed-size real FFT + magnitude kernels for audio analysis.
+ *
+ * GENERATED by Tools/gen_fft_kernels.py, do not edit by hand.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#include "fft_kernels.h"
+
+%s
+
+/** @brief Swap complex values into bit-reversed order.
+ */
+static inline void bitReverse(uint32_t *z, const uint16_t *swaps, int count) {
+	for (int i = 0; i < 2*count; i += 2) {
+		uint32_t tmp = z[swaps[i]];
+		z[swaps[i]] = z[swaps[i + 1]];
+		z[swaps[i + 1]] = tmp;
+	}
+}
+
+/** @brief Butterfly with W = 1, scaled by 1/4 (first stage only).
+ */
+static inline void butterflyQuarter(uint32_t *a, uint32_t *b) {
+	uint32_t aHalf = __SHADD16(*a, 0);
+	uint32_t bHalf = __SHADD16(*b, 0);
+
+	*a = __SHADD16(aHalf, bHalf);
+	*b = __SHSUB16(aHalf, bHalf);
+}
+
+/** @brief Butterfly with W = 1, scaled by 1/2.
+ */
+static inline void butterflyHalf(uint32_t *a, uint32_t *b) {
+	uint32_t sum = __SHADD16(*a, *b);
+
+	*b = __SHSUB16(*a, *b);
+	*a = sum;
+}
+
+/** @brief Butterfly with W = -j, scaled by 1/2.
+ */
+static inline void butterflyMinusJ(uint32_t *a, uint32_t *b) {
+	uint32_t sum = __SHSAX(*a, *b);
+
+	*b = __SHASX(*a, *b);
+	*a = sum;
+}
+
+/** @brief Butterfly with W = cos - j sin, given as (cos, sin), scaled by 1/2.
+ */
+static inline void butterfly(uint32_t *a, uint32_t *b, uint32_t w) {
+	q31_t tr = ((q31_t) __SMUAD(*b, w)) >> 15;
+	q31_t ti = ((q31_t) __SMUSDX(w, *b)) >> 15;
+	uint32_t t = __PKHBT(tr, ti, 16);
+
+	*b = __SHSUB16(*a, t);
+	*a = __SHADD16(*a, t);
+}
+
+/** @brief Magnitude of one bin of the real FFT, as arm_cmplx_mag_q15 scales it.
+ * The square root is normalized with __CLZ so the power falls in [2^30, 2^32)
+ * and then looked up from sqrtTable with linear interpolation, which is
+ * accurate to a fraction of an output step.
+ */
+static inline q15_t binMagnitude(q31_t re, q31_t im) {
+	uint32_t power = (uint32_t) (re * re) + (uint32_t) (im * im);
+	uint32_t shift, index, root;
+
+	if (power == 0) {
+		return 0;
+	}
+
+	shift = __CLZ(power) & ~1u;
+	power <<= shift;
+	index = (power >> 24) - 64;
+	root = sqrtTable[index] + (((sqrtTable[index + 1] - sqrtTable[index])
+	                            * ((power >> 8) & 0xFFFF)) >> 16);
+
+	// sqrt(power) = root >> shift/2, the magnitude is half of that
+	return (q15_t) (root >> (shift/2 + 1));
+}
+
+/** @brief Split the complex FFT of the packed frame into the real FFT and
+ * take the magnitude of bins 0 to m.
+ *
+ * @param z Complex FFT of m points, scaled by 1/(2m).
+ * @param twiddle W = cos - j sin of 2 pi k / 2m for k = 1 to m-1.
+ */
+static void splitMagnitude(uint32_t *z, const uint32_t *twiddle, int m,
+                           q15_t *magnitude) {
+	q31_t zr0 = (int16_t) z[0];
+	q31_t zi0 = (int16_t) (z[0] >> 16);
+
+	magnitude[0] = binMagnitude(zr0 + zi0, 0);
+	magnitude[m] = binMagnitude(zr0 - zi0, 0);
+
+	for (int k = 1; k < m; k++) {
+		q31_t zr = (int16_t) z[k], zi = (int16_t) (z[k] >> 16);
+		q31_t cr = (int16_t) z[m - k], ci = (int16_t) (z[m - k] >> 16);
+		q31_t c = (int16_t) twiddle[k - 1], s = (int16_t) (twiddle[k - 1] >> 16);
+		// A = Z[k] + conj(Z[m-k]), B = Z[k] - conj(Z[m-k])
+		q31_t ar = zr + cr, ai = zi - ci;
+		q31_t br = zr - cr, bi = zi + ci;
+		// X[k] = (A + W * -jB) / 2
+		q31_t re = (ar + ((c * bi - s * br) >> 15)) >> 1;
+		q31_t im = (ai - ((c * br + s * bi) >> 15)) >> 1;
+
+		magnitude[k] = binMagnitude(re, im);
+	}
+}
+"""
+
+SELECT = """/** @brief Get the kernel for an FFT size.
+ *
+ * @return The kernel, NULL if no kernel was generated for the size.
+ */
+FftKernel fftKernel_select(int fftSize) {
+	switch (fftSize) {
+%s
+		default:
+			return NULL;
+	}
+}
+"""
+
+
+def main():
+    args = sys.argv[1:]
+    if "-h" in args or "--help" in args:
+        print(__doc__)
+        return
+    if not all(a.isdigit() for a in args):
+        sys.exit(__doc__)
+
+    sizes = [int(a) for a in args] or DEFAULT_SIZES
+    for n in sizes:
+        if n < 8 or n & (n - 1):
+            sys.exit("size %d is not a power of two of at least 8" % n)
+
+    prototypes = "\n".join("void fftKernel_rfftMag%d(q15_t *frame, q15_t *magnitude);" % n
+                           for n in sizes)
+    cases = "\n".join("\t\tcase %d:\n\t\t\treturn fftKernel_rfftMag%d;" % (n, n)
+                      for n in sizes)
+
+    with open(os.path.join(OUT_DIR, "fft_kernels.h"), "w") as f:
+        f.write(HEADER % prototypes)
+    with open(os.path.join(OUT_DIR, "fft_kernels.c"), "w") as f:
+        f.write(SOURCE_HEAD % sqrt_table())
+        for n in sizes:
+            f.write("\n" + kernel(n) + "\n")
+        f.write("\n" + SELECT % cases)
+
+
+if __name__ == "__main__":
+    main()
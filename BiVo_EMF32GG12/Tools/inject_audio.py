@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+"""Replay WAV files through a board running the inject mode.
+
+Each file is cut into blocks and sent over the link with the inject command,
+see inject_mode.h. The board records the blocks as if its microphone had
+heard them, analyzes every segment they finish, and answers each block with
+an inject record. One CSV row is printed per block: where it starts in its
+file, the verdict of the segment it finished, and the time the board spent
+recording the block and analyzing the segment.
+
+Usage:
+    inject_audio.py [options] PORT audio.wav [audio.wav ...]
+
+Options:
+    --block N       samples per block, default 1024
+    --baud RATE     baud rate of PORT, default 115200
+    --profile       print the board's profile records at the end
+
+PORT is the board's virtual COM port, or the pseudo-terminal bivo_sim -p
+prints for a host simulation built with MODE=inject. Files are 16 bit mono at
+the board's sample rate; the segments run on from one file into the next.
+"""
+
+import os
+import struct
+import sys
+import termios
+import wave
+
+RECORD_SYNC = 0xB5
+RECORD_INJECT = ord("J")
+RECORD_PROFILE = ord("P")
+INJECT_FORMAT = "<IHBIII"       # struct InjectRecord
+PROFILE_FORMAT = "<BIIIIQ32I"   # struct ProfileRecord
+VERDICTS = ["pending", "quiet", "detected"]
+REGIONS = ["analyze", "fft", "transmit", "pdm_isr", "match",
+           "inference"]
+BAUDS = {9600: termios.B9600, 57600: termios.B57600, 115200: termios.B115200,
+         230400: termios.B230400, 460800: termios.B460800,
+         921600: termios.B921600}
+
+
+class Link:
+    def __init__(self, path, baud):
+        self.fd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+        mode = termios.tcgetattr(self.fd)
+        mode[0] = mode[1] = mode[3] = 0             # raw in, out and local
+        mode[2] = termios.CS8 | termios.CREAD | termios.CLOCAL
+        mode[4] = mode[5] = BAUDS[baud]
+        mode[6][termios.VMIN] = 1
+        mode[6][termios.VTIME] = 0
+        termios.tcsetattr(self.fd, termios.TCSANOW, mode)
+        self.pending = b""
+
+    def send(self, data):
+        while data:
+            data = data[os.write(self.fd, data):]
+
+    def read(self, count):
+        while len(self.pending) < count:
+            chunk = os.read(self.fd, 4096)
+            if not chunk:
+                sys.exit("link closed")
+            self.pending += chunk
+        data, self.pending = self.pending[:count], self.pending[count:]
+        return data
+
+    def await_message(self, message):
+        window = b""
+        while window != message:
+            window = (window + self.read(1))[-len(message):]
+
+    def record(self):
+        """Next telemetry record with a good checksum, as (type, payload)."""
+        while True:
+            if self.read(1)[0] != RECORD_SYNC:
+                continue
+            kind, length = self.read(2)
+            payload = self.read(length)
+            if (kind + length + sum(payload) + self.read(1)[0]) & 0xFF == 0:
+                return kind, payload
+
+
+def read_wav(path):
+    with wave.open(path, "rb") as w:
+        if w.getnchannels() != 1 or w.getsampwidth() != 2:
+            sys.exit("%s: not 16 bit mono" % path)
+        return w.getframerate(), w.readframes(w.getnframes())
+
+
+def main():
+    block = 1024
+    baud = 115200
+    profile = False
+    paths = []
+    args = sys.argv[1:]
+    while args:
+        arg = args.pop(0)
+        if arg == "--block" and args:
+            block = int(args.pop(0))
+        elif arg == "--baud" and args:
+            baud = int(args.pop(0))
+        elif arg == "--profile":
+            profile = True
+        elif not arg.startswith("-"):
+            paths.append(arg)
+        else:
+            sys.exit(__doc__)
+    if len(paths) < 2 or not 0 < block < 65536 or baud not in BAUDS:
+        sys.exit(__doc__)
+
+    link = Link(paths[0], baud)
+    link.send(b"hands")
+    link.await_message(b"cnfrm")
+    link.send(b"ackng")
+
+    print("file,block,start_s,samples,verdict,inject_us,analysis_us")
+    for path in paths[1:]:
+        rate, frames = read_wav(path)
+        for start in range(0, len(frames), 2 * block):
+            data = frames[start:start + 2 * block]
+            link.send(b"injct" + struct.pack("<H", len(data) // 2) + data)
+            while True:
+                kind, payload = link.record()
+                if kind == RECORD_INJECT:
+                    break
+            number, samples, verdict, rate_ticks, inject, analysis = \
+                struct.unpack(INJECT_FORMAT, payload)
+            print("%s,%d,%.3f,%d,%s,%.1f,%.1f" % (
+                os.path.basename(path), number, start / 2 / rate, samples,
+                VERDICTS[verdict] if verdict < len(VERDICTS) else verdict,
+                inject * 1e6 / rate_ticks, analysis * 1e6 / rate_ticks))
+
+    if profile:
+        link.send(b"profl")
+        print()
+        print("region,count,min_us,mean_us,max_us")
+        for _ in REGIONS:
+            kind, payload = link.record()
+            while kind != RECORD_PROFILE:
+                kind, payload = link.record()
+            region, rate_ticks, count, low, high, total = \
+                struct.unpack(PROFILE_FORMAT, payload)[:6]
+            print("%s,%d,%.1f,%.1f,%.1f" % (
+                REGIONS[region], count, low * 1e6 / rate_ticks,
+                total * 1e6 / rate_ticks / count if count else 0.0,
+                high * 1e6 / rate_ticks))
+
+
+if __name__ == "__main__":
+    main()
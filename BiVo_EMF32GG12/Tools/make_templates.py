@@ -0,0 +1,243 @@
+#!/usr/bin/env python3
+"""Make spectrogram templates for the template matcher from exemplar calls.
+
+Each exemplar is a 16 bit mono WAV file holding one call, trimmed close to
+it. It is cut into consecutive frames the way audio analysis does (no window,
+frameStride samples apart), and each frame is reduced to the log2 power of
+equal width bands, exactly as template_matcher.c bands the magnitude
+spectrum. The result is made zero mean, clamped like the device's
+spectrogram, and scaled to a norm of 1.0 in q15, stored [band][frame].
+
+The band layout and analysis settings are written to the header as
+MATCH_TEMPLATE_* macros, so the matcher can be configured with the settings
+the templates were made for.
+
+Usage:
+    make_templates.py [options] name=call.wav [name=call.wav ...]
+
+Options:
+    --rate HZ         sample rate of the device, default the first WAV's
+    --fft N           analysis fftSize, default 256
+    --decimation D    analysis decimation, 1 to 4, default 1
+    --bands B         number of bands, default 16
+    --lower HZ        lower edge of the first band, default 1000
+    --upper HZ        upper edge of the last band, default 8000
+
+WAV files at another rate are resampled to --rate first. Writes
+match_templates.c/.h into Modules/Audio Analysis.
+"""
+
+import math
+import os
+import struct
+import sys
+import wave
+
+OUT_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..",
+                       "Modules", "Audio Analysis")
+
+MAX_BANDS = 32          # MATCH_MAX_BANDS
+MAX_FRAMES = 64         # MATCH_MAX_FRAMES
+RANGE = 4095            # MATCH_RANGE
+LOG_FLOOR = -48 * 256   # MEL_LOG_FLOOR
+
+
+def read_wav(path):
+    with wave.open(path, "rb") as f:
+        if f.getsampwidth() != 2:
+            sys.exit("%s: only 16 bit WAV files are supported" % path)
+        channels, rate = f.getnchannels(), f.getframerate()
+        data = f.readframes(f.getnframes())
+    samples = struct.unpack("<%dh" % (len(data) // 2), data)
+    return list(samples[::channels]), rate
+
+
+def lowpass(samples, cutoff, taps=63):
+    """Windowed sinc low-pass, cutoff as a fraction of the sample rate."""
+    half = taps // 2
+    kernel = []
+    for i in range(taps):
+        n = i - half
+        sinc = 2 * cutoff if n == 0 else math.sin(2 * math.pi * cutoff * n) / (math.pi * n)
+        kernel.append(sinc * (0.54 - 0.46 * math.cos(2 * math.pi * i / (taps - 1))))
+    gain = sum(kernel)
+    padded = [0.0] * half + samples + [0.0] * half
+    return [sum(k * padded[i + j] for j, k in enumerate(kernel)) / gain
+            for i in range(len(samples))]
+
+
+def resample(samples, rate, target):
+    """Linear interpolation, low-passed first when going down in rate."""
+    if rate == target:
+        return [float(s) for s in samples]
+    if target < rate:
+        samples = lowpass([float(s) for s in samples], 0.45 * target / rate)
+    length = int(len(samples) * target / rate)
+    out = []
+    for i in range(length):
+        x = i * rate / target
+        j = int(x)
+        frac = x - j
+        nxt = samples[j + 1] if j + 1 < len(samples) else samples[j]
+        out.append(samples[j] * (1 - frac) + nxt * frac)
+    return out
+
+
+def band_edges(rate, stride, fft_size, bands, lower, upper):
+    """First bin of each band and one past the last, as templateMatcher_init."""
+    last_bin = fft_size // 2
+    edges = []
+    for band in range(bands + 1):
+        freq = lower + (upper - lower) * band // bands
+        b = freq * stride // rate
+        if band > 0 and b <= edges[-1]:
+            b = edges[-1] + 1
+        edges.append(min(b, last_bin + 1))
+    return edges
+
+
+def spectrogram(samples, fft_size, decimation, edges, bands):
+    """Band log2 powers in Q8, [band][frame]."""
+    if decimation > 1:
+        samples = lowpass(samples, 0.4 / decimation)[::decimation]
+    frames = min(len(samples) // fft_size, MAX_FRAMES)
+    bins = range(edges[0], edges[-1])
+    table = [[(math.cos(2 * math.pi * k * n / fft_size),
+               -math.sin(2 * math.pi * k * n / fft_size))
+              for n in range(fft_size)] for k in bins]
+    cells = [[0] * frames for _ in range(bands)]
+    for t in range(frames):
+        frame = samples[t * fft_size:(t + 1) * fft_size]
+        power = {}
+        for k, row in zip(bins, table):
+            re = sum(x * c for x, (c, _) in zip(frame, row))
+            im = sum(x * s for x, (_, s) in zip(frame, row))
+            power[k] = re * re + im * im
+        for band in range(bands):
+            energy = sum(power[k] for k in range(edges[band], edges[band + 1]))
+            cells[band][t] = (int(round(256 * math.log2(energy)))
+                              if energy > 0 else LOG_FLOOR)
+    return cells, frames
+
+
+def normalize(cells):
+    """Zero mean, clamped, then scaled to a q15 norm of 1.0."""
+    flat = [v for row in cells for v in row]
+    mean = sum(flat) / len(flat)
+    cells = [[max(-RANGE, min(RANGE, v - mean)) for v in row] for row in cells]
+    flat = [v for row in cells for v in row]
+    mean = sum(flat) / len(flat)
+    cells = [[v - mean for v in row] for row in cells]
+    norm = math.sqrt(sum(v * v for row in cells for v in row))
+    if norm == 0:
+        sys.exit("exemplar has no spectral shape in the band range")
+    return [[int(round(v * 32767 / norm)) for v in row] for row in cells]
+
+
+HEADER = """/** @file match_templates.h
+ * @brief Spectrogram templates for the template matcher.
+ *
+ * GENERATED by Tools/make_templates.py, do not edit by hand.
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#ifndef MODULES_AUDIO_ANALYSIS_MATCH_TEMPLATES_H_
+#define MODULES_AUDIO_ANALYSIS_MATCH_TEMPLATES_H_
+
+#include "template_matcher.h"
+
+/* Settings the templates were made with */
+#define MATCH_TEMPLATE_SAMPLE_RATE %(rate)d
+#define MATCH_TEMPLATE_FFT_SIZE %(fft)d
+#define MATCH_TEMPLATE_DECIMATION %(decimation)d
+#define MATCH_TEMPLATE_BANDS %(bands)d
+#define MATCH_TEMPLATE_FREQ_LOWER %(lower)d
+#define MATCH_TEMPLATE_FREQ_UPPER %(upper)d
+#define MATCH_TEMPLATE_COUNT %(count)d
+
+extern const struct MatchTemplate matchTemplateSet[MATCH_TEMPLATE_COUNT];
+
+#endif /* MODULES_AUDIO_ANALYSIS_MATCH_TEMPLATES_H_ */
+"""
+
+SOURCE = """/** @file match_templates.c
+ * @brief Spectrogram templates for the template matcher, kept in flash.
+ *
+ * GENERATED by Tools/make_templates.py, do not edit by hand.
+ *
+%(summary)s
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#include "match_templates.h"
+
+%(tables)s
+
+const struct MatchTemplate matchTemplateSet[MATCH_TEMPLATE_COUNT] = {
+%(entries)s
+};
+"""
+
+
+def c_table(name, cells):
+    flat = [v for row in cells for v in row]
+    lines = ",\n".join("\t\t" + ", ".join(str(v) for v in flat[i:i + 12])
+                       for i in range(0, len(flat), 12))
+    return "static const q15_t %sCells[%d] = {\n%s\n};" % (name, len(flat), lines)
+
+
+def main():
+    options = dict(rate=0, fft=256, decimation=1, bands=16, lower=1000, upper=8000)
+    exemplars = []
+    args = sys.argv[1:]
+    while args:
+        arg = args.pop(0)
+        if arg.startswith("--") and arg[2:] in options and args:
+            options[arg[2:]] = int(args.pop(0))
+        elif "=" in arg and not arg.startswith("-"):
+            exemplars.append(arg.split("=", 1))
+        else:
+            sys.exit(__doc__)
+    if not exemplars:
+        sys.exit(__doc__)
+    if not 1 <= options["bands"] <= MAX_BANDS:
+        sys.exit("--bands must be 1 to %d" % MAX_BANDS)
+    if not 1 <= options["decimation"] <= 4:
+        sys.exit("--decimation must be 1 to 4")
+
+    sounds = [(name, read_wav(path)) for name, path in exemplars]
+    rate = options["rate"] or sounds[0][1][1]
+    stride = options["fft"] * options["decimation"]
+    edges = band_edges(rate, stride, options["fft"], options["bands"],
+                       options["lower"], options["upper"])
+
+    tables, entries, summary = [], [], []
+    for name, (samples, wav_rate) in sounds:
+        ident = "".join(c if c.isalnum() else "_" for c in name)
+        cells, frames = spectrogram(resample(samples, wav_rate, rate),
+                                    options["fft"], options["decimation"],
+                                    edges, options["bands"])
+        if frames == 0:
+            sys.exit("%s: shorter than one frame" % name)
+        tables.append(c_table(ident, normalize(cells)))
+        entries.append('\t\t{"%s", %d, %sCells}' % (name, frames, ident))
+        summary.append(" * %s: %d frames, %d bytes" % (name, frames,
+                                                       2 * frames * options["bands"]))
+
+    fields = dict(options, rate=rate, count=len(exemplars),
+                  summary="\n".join(summary), tables="\n\n".join(tables),
+                  entries=",\n".join(entries))
+    with open(os.path.join(OUT_DIR, "match_templates.h"), "w") as f:
+        f.write(HEADER % fields)
+    with open(os.path.join(OUT_DIR, "match_templates.c"), "w") as f:
+        f.write(SOURCE % fields)
+    for line in summary:
+        print(line[3:])
+
+
+if __name__ == "__main__":
+    main()
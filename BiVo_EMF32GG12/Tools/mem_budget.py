@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+"""Report the RAM use of a firmware build against its memory plan.
+
+The map file of the link lists every output section and the budgets set in
+bivo_linkerfile.ld. Each region of the memory plan is printed with its
+size, its budget and what is left, followed by the rest of RAM: the stack,
+the static data and the heap left over. See Modules/Mem_Plan/mem_plan.h.
+
+Usage:
+    mem_budget.py BiVo_EMF32GG12.map
+
+Exits with status 1 if a region is over its budget or the heap is under its
+minimum. The link itself fails in that case too, this names the region.
+"""
+
+import re
+import sys
+
+RAM_SECTIONS = [".stack", ".noinit", ".data", ".bss", ".capture",
+                ".dsp_scratch", ".transport", ".heap"]
+BUDGETS = {".capture": "__capture_budget",
+           ".dsp_scratch": "__dsp_scratch_budget",
+           ".transport": "__transport_budget",
+           ".heap": "__heap_minimum"}
+
+SECTION = re.compile(r"^(\.[\w.]+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)")
+SYMBOL = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+(__\w+)\s*=")
+
+
+def read_map(path):
+    sections, symbols = {}, {}
+    pending = None
+    with open(path) as f:
+        for line in f:
+            # a long section name puts its address and size on the next line
+            if pending is not None:
+                match = re.match(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)", line)
+                if match:
+                    sections[pending] = int(match.group(2), 16)
+                pending = None
+                continue
+            match = SECTION.match(line)
+            if match:
+                sections.setdefault(match.group(1), int(match.group(3), 16))
+                continue
+            if re.match(r"^\.[\w.]+\s*$", line):
+                pending = line.strip()
+                continue
+            match = SYMBOL.match(line)
+            if match:
+                symbols[match.group(2)] = int(match.group(1), 16)
+    return sections, symbols
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit(__doc__)
+
+    sections, symbols = read_map(sys.argv[1])
+    overcommitted = 0
+    total = 0
+    print("%-14s %9s %9s %9s" % ("section", "bytes", "budget", "left"))
+    for name in RAM_SECTIONS:
+        size = sections.get(name, 0)
+        total += size
+        budget = symbols.get(BUDGETS.get(name))
+        if budget is None:
+            print("%-14s %9d" % (name, size))
+            continue
+        # the heap has a minimum, every other region a maximum
+        left = size - budget if name == ".heap" else budget - size
+        flag = ""
+        if left < 0:
+            flag = "  OVER"
+            overcommitted += 1
+        print("%-14s %9d %9d %9d%s" % (name, size, budget, left, flag))
+    print("%-14s %9d" % ("RAM", total))
+
+    if overcommitted:
+        print("%d region(s) past their budget" % overcommitted)
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,347 @@
+#!/usr/bin/env python3
+"""Convert a float neural network to the classifier's quantized model blob.
+
+The model is read from JSON:
+
+    {
+      "input": {"frames": T, "features": C, "exponent": 7},
+      "classes": ["noise", "bird"],
+      "layers": [
+        {"type": "conv1d", "kernel": K, "weights": [[[...C] x K] x F],
+         "bias": [...F], "relu": true, "int8": false},
+        {"type": "dense", "weights": [[...inputs] x outputs],
+         "bias": [...outputs], "relu": false, "int8": true}
+      ],
+      "calibration": [[...T*C input values], ...]
+    }
+
+Inputs are real valued, [frame][feature]. The default input exponent of 7
+matches the Q8 log2 features of mel_features. Dense weights after a conv1d
+layer take its output flattened as [time][filter].
+
+Each layer's weights get a power-of-two scale, raised until every output's
+sum of absolute q15 weights is under 1.0, so no accumulator on the device can
+overflow and the fast matrix multiply is exact. With calibration inputs, each
+layer's output is shifted so its largest calibration activation uses the
+full q15 range.
+
+Usage:
+    nn_convert.py model.json                write nn_model.c/.h
+    nn_convert.py model.json --bin out.bin  also write the raw blob
+    nn_convert.py --reference MODEL INPUTS  run the integer reference
+
+MODEL for --reference is a .bin blob or a generated nn_model.c. INPUTS is a
+CSV of q15 input rows, the output is one CSV row of q15 scores per input. The
+reference follows the firmware's arithmetic exactly, so its scores are what
+nnClassifier_run returns for the same inputs.
+
+Host Sim/nn_scores.csv is the reference for Host Sim/nn_inputs.csv and the
+model in Modules/Classifier, which bivo_check nn compares the firmware with.
+Regenerate it after converting a new model:
+
+    nn_convert.py --reference ../Modules/Classifier/nn_model.c \\
+        nn_inputs.csv > nn_scores.csv                (from Host Sim)
+"""
+
+import json
+import math
+import os
+import re
+import struct
+import sys
+
+OUT_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..",
+                       "Modules", "Classifier")
+
+MAGIC = 0x4E4E5642
+VERSION = 1
+LAYER_DENSE = 1
+LAYER_CONV1D = 2
+FLAG_RELU = 0x01
+FLAG_INT8 = 0x02
+
+
+def sat16(value):
+    return max(-32768, min(32767, value))
+
+
+def wrap(value, bits):
+    value &= (1 << bits) - 1
+    return value - (1 << bits) if value >> (bits - 1) else value
+
+
+def pad4(data):
+    return data + b"\0" * (-len(data) % 4)
+
+
+# ---------------------------------------------------------------- float model
+
+def float_layer(layer, x, steps):
+    """Run one float layer on x ([time][channel] flattened)."""
+    if layer["type"] == "dense":
+        y = [sum(w * v for w, v in zip(row, x)) + b
+             for row, b in zip(layer["weights"], layer["bias"])]
+        steps = 1
+    else:
+        k = layer["kernel"]
+        channels = len(x) // steps
+        out_steps = steps - k + 1
+        y = []
+        for t in range(out_steps):
+            window = x[t * channels:(t + k) * channels]
+            for f, b in zip(layer["weights"], layer["bias"]):
+                flat = [w for tap in f for w in tap]
+                y.append(sum(w * v for w, v in zip(flat, window)) + b)
+        steps = out_steps
+    if layer.get("relu"):
+        y = [max(0.0, v) for v in y]
+    return y, steps
+
+
+def float_run(model, x):
+    steps = model["input"]["frames"]
+    activations = []
+    for layer in model["layers"]:
+        x, steps = float_layer(layer, x, steps)
+        activations.append(x)
+    return activations
+
+
+# --------------------------------------------------------------- quantization
+
+def weight_rows(layer):
+    if layer["type"] == "dense":
+        return layer["weights"]
+    return [[w for tap in f for w in tap] for f in layer["weights"]]
+
+
+def quantize_weights(rows, int8):
+    """Pick the weight exponent and quantize, keeping row L1 norms under 1."""
+    peak = max((abs(w) for row in rows for w in row), default=0.0)
+    exponent = math.ceil(math.log2(peak)) if peak > 0 else 0
+    while True:
+        bits = 7 if int8 else 15
+        top = (1 << bits) - 1
+        q = [[max(-top - 1, min(top, int(round(w * 2.0 ** (bits - exponent)))))
+              for w in row] for row in rows]
+        widened = [[v << (15 - bits) for v in row] for row in q]
+        if (peak * 2.0 ** (bits - exponent) <= top + 0.5
+                and max(sum(abs(v) for v in row) for row in widened) < 32768):
+            return exponent, q
+        exponent += 1
+
+
+def convert(model):
+    """Quantize the model, returning the blob and a summary per layer."""
+    calibration = model.get("calibration", [])
+    traces = [float_run(model, x) for x in calibration]
+    frames = model["input"]["frames"]
+    features = model["input"]["features"]
+    x_exp = model["input"].get("exponent", 7)
+
+    blob = struct.pack("<IHHHHbBH", MAGIC, VERSION, len(model["layers"]),
+                       frames, features, x_exp, 0,
+                       len(model["layers"][-1]["bias"]))
+    summary = []
+    for i, layer in enumerate(model["layers"]):
+        int8 = bool(layer.get("int8"))
+        rows = weight_rows(layer)
+        w_exp, q = quantize_weights(rows, int8)
+        y_exp = x_exp + w_exp
+
+        bias = [int(round(b * 2.0 ** (15 - y_exp))) for b in layer["bias"]]
+        if any(b != sat16(b) for b in bias):
+            print("warning: layer %d biases saturate" % i, file=sys.stderr)
+        bias = [sat16(b) for b in bias]
+
+        shift = 0
+        peak = max((abs(v) for trace in traces for v in trace[i]), default=0.0)
+        if peak > 0:
+            out_exp = math.ceil(math.log2(peak * 32768.0 / 32767.0))
+            shift = max(-15, min(15, y_exp - out_exp))
+        out_exp = y_exp - shift
+
+        flags = (FLAG_RELU if layer.get("relu") else 0) | (FLAG_INT8 if int8 else 0)
+        if layer["type"] == "dense":
+            header = struct.pack("<BBbBHH", LAYER_DENSE, flags, shift, 0,
+                                 len(rows[0]), len(rows))
+        else:
+            header = struct.pack("<BBbBHH", LAYER_CONV1D, flags, shift,
+                                 layer["kernel"], len(layer["weights"][0][0]),
+                                 len(rows))
+        flat = [v for row in q for v in row]
+        weights = struct.pack("<%d%s" % (len(flat), "b" if int8 else "h"), *flat)
+        blob += header + pad4(weights) + pad4(struct.pack("<%dh" % len(bias), *bias))
+
+        summary.append("layer %d: %s %s, weight exponent %d, output exponent %d"
+                       % (i, layer["type"], "int8" if int8 else "q15", w_exp, out_exp))
+        x_exp = out_exp
+    return blob, summary, x_exp
+
+
+# ---------------------------------------------------------- integer reference
+
+def parse_blob(blob):
+    magic, version, count, frames, features, x_exp, _, classes = \
+        struct.unpack_from("<IHHHHbBH", blob, 0)
+    if magic != MAGIC or version != VERSION:
+        sys.exit("not a version %d model blob" % VERSION)
+    layers, offset = [], 16
+    for _ in range(count):
+        kind, flags, shift, kernel, inputs, outputs = \
+            struct.unpack_from("<BBbBHH", blob, offset)
+        offset += 8
+        int8 = bool(flags & FLAG_INT8)
+        n = outputs * inputs * (kernel if kind == LAYER_CONV1D else 1)
+        weights = list(struct.unpack_from("<%d%s" % (n, "b" if int8 else "h"), blob, offset))
+        offset += (n * (1 if int8 else 2) + 3) & ~3
+        bias = list(struct.unpack_from("<%dh" % outputs, blob, offset))
+        offset += (outputs * 2 + 3) & ~3
+        if int8:
+            weights = [w << 8 for w in weights]
+        layers.append(dict(kind=kind, relu=bool(flags & FLAG_RELU), int8=int8,
+                           shift=shift, kernel=kernel, inputs=inputs,
+                           outputs=outputs, weights=weights, bias=bias))
+    return frames, features, layers
+
+
+def reference_run(frames, layers, x):
+    steps = frames
+    for layer in layers:
+        n_in, n_out, w = layer["inputs"], layer["outputs"], layer["weights"]
+        if layer["kind"] == LAYER_DENSE:
+            y = []
+            for o in range(n_out):
+                acc = sum(a * b for a, b in zip(w[o * n_in:(o + 1) * n_in], x))
+                if layer["int8"]:
+                    y.append(sat16(acc >> 15))                  # arm_dot_prod_q15
+                else:
+                    y.append(wrap(wrap(acc, 32) >> 15, 16))     # arm_mat_mult_fast_q15
+            out_steps = 1
+        else:
+            window = layer["kernel"] * n_in
+            out_steps = steps - layer["kernel"] + 1
+            y = [0] * (out_steps * n_out)
+            for f in range(n_out):
+                taps = w[f * window:(f + 1) * window]
+                for t in range(out_steps):
+                    acc = sum(a * b for a, b in zip(x[t * n_in:t * n_in + window], taps))
+                    y[t * n_out + f] = sat16(acc >> 15)
+        y = [sat16(v + layer["bias"][i % n_out]) for i, v in enumerate(y)]
+        if layer["relu"]:
+            y = [max(0, v) for v in y]
+        if layer["shift"] > 0:
+            y = [sat16(v << layer["shift"]) for v in y]
+        elif layer["shift"] < 0:
+            y = [v >> -layer["shift"] for v in y]
+        x, steps = y, out_steps
+    return x
+
+
+def load_blob(path):
+    if path.endswith(".c"):
+        text = open(path).read()
+        body = text[text.index("nnModel["):]
+        return bytes(int(h, 16) for h in re.findall(r"0x([0-9A-Fa-f]{2})\b", body))
+    return open(path, "rb").read()
+
+
+def reference(model_path, inputs_path):
+    frames, features, layers = parse_blob(load_blob(model_path))
+    for line in open(inputs_path):
+        if line.strip():
+            x = [int(v) for v in line.split(",")]
+            if len(x) != frames * features:
+                sys.exit("input rows need %d values" % (frames * features))
+            print(",".join(str(v) for v in reference_run(frames, layers, x)))
+
+
+# ---------------------------------------------------------------- C output
+
+HEADER = """/** @file nn_model.h
+ * @brief Model blob for the neural network classifier.
+ *
+ * GENERATED by Tools/nn_convert.py from %(source)s, do not edit by hand.
+ *
+ * Input: %(frames)d frames of %(features)d features, exponent %(in_exp)d
+ * Classes: %(classes)s
+ * Scores: q15, exponent %(out_exp)d
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#ifndef MODULES_CLASSIFIER_NN_MODEL_H_
+#define MODULES_CLASSIFIER_NN_MODEL_H_
+
+#include <stdint.h>
+
+#define NN_MODEL_SIZE %(size)d
+
+extern const uint8_t nnModel[NN_MODEL_SIZE];
+
+#endif /* MODULES_CLASSIFIER_NN_MODEL_H_ */
+"""
+
+SOURCE = """/** @file nn_model.c
+ * @brief Model blob for the neural network classifier, kept in flash.
+ *
+ * GENERATED by Tools/nn_convert.py from %(source)s, do not edit by hand.
+ *
+%(summary)s
+ *
+ * @authors agent
+ * @date 10-19-26
+ */
+
+#include "nn_model.h"
+#include "nn_classifier.h"
+
+#if NN_CLASSIFIER_ENABLE
+const uint8_t nnModel[NN_MODEL_SIZE] __attribute__((aligned(4))) = {
+%(bytes)s
+};
+#endif /* NN_CLASSIFIER_ENABLE */
+"""
+
+
+def write_sources(model, source, blob, summary, out_exp):
+    fields = dict(source=source, frames=model["input"]["frames"],
+                  features=model["input"]["features"],
+                  in_exp=model["input"].get("exponent", 7),
+                  classes=", ".join(model.get("classes", [])) or "unnamed",
+                  out_exp=out_exp, size=len(blob),
+                  summary="\n".join(" * " + line for line in summary))
+    fields["bytes"] = ",\n".join(
+        "\t\t" + ", ".join("0x%02X" % b for b in blob[i:i + 12])
+        for i in range(0, len(blob), 12))
+    with open(os.path.join(OUT_DIR, "nn_model.h"), "w") as f:
+        f.write(HEADER % fields)
+    with open(os.path.join(OUT_DIR, "nn_model.c"), "w") as f:
+        f.write(SOURCE % fields)
+
+
+def main():
+    args = sys.argv[1:]
+    if args in (["-h"], ["--help"]):
+        print(__doc__)
+        return
+    if len(args) == 3 and args[0] == "--reference":
+        reference(args[1], args[2])
+        return
+    if (len(args) not in (1, 3) or args[0].startswith("-")
+            or (len(args) == 3 and args[1] != "--bin")):
+        sys.exit(__doc__)
+
+    model = json.load(open(args[0]))
+    blob, summary, out_exp = convert(model)
+    write_sources(model, os.path.basename(args[0]), blob, summary, out_exp)
+    if len(args) == 3:
+        open(args[2], "wb").write(blob)
+    for line in summary:
+        print(line)
+    print("%d bytes of flash" % len(blob))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+"""Record a segment from a board running the stream mode into a WAV file.
+
+The board is asked for one segment, see stream_mode.h, and sends it as audio
+records while it records. Blocks the link could not keep up with are missing
+from the sequence, they are written as silence so the file keeps its timing.
+The stream record at the end is printed: samples captured, blocks lost and in
+how many runs, and the deepest the board's queue got.
+
+Usage:
+    stream_audio.py [options] PORT out.wav
+
+Options:
+    --baud RATE     baud rate of PORT, default 921600
+    --rate HZ       sample rate written to the file, default 19900
+    --file PATH     read the board's bytes from a file instead, such as the
+                    output of bivo_sim -o, nothing is sent
+
+PORT is the board's virtual COM port, or the pseudo-terminal bivo_sim -p
+prints for a host simulation built with MODE=stream.
+"""
+
+import os
+import struct
+import sys
+import wave
+
+from inject_audio import BAUDS, Link, RECORD_SYNC
+
+RECORD_AUDIO = ord("A")
+RECORD_STREAM = ord("R")
+RECORD_ERROR = ord("X")
+AUDIO_HEADER = "<IHBB"          # struct AudioRecord, before its data
+STREAM_FORMAT = "<IIIIHHII"     # struct StreamRecord
+FORMAT_PCM16 = 0
+FORMAT_PACKED12 = 1
+
+
+class FileLink(Link):
+    def __init__(self, path):
+        self.fd = os.open(path, os.O_RDONLY)
+        self.pending = b""
+
+    def send(self, data):
+        pass
+
+
+def field12(value):
+    value &= 0xFFF
+    return value - 0x1000 if value & 0x800 else value
+
+
+def unpack12(data, count):
+    """Samples of packed 12 bit data, see sample_pack.h."""
+    words = struct.unpack("<%dI" % (len(data) // 4), data)
+    samples = []
+    for group in range(0, len(words), 3):
+        w0, w1, w2 = words[group:group + 3]
+        s6 = (w0 & 0xF) | ((w0 >> 12) & 0xF0) | ((w1 & 0xF) << 8)
+        s7 = ((w1 >> 16) & 0xF) | ((w2 & 0xF) << 4) | ((w2 >> 8) & 0xF00)
+        samples += [field12(w0 >> 4), field12(w0 >> 20), field12(w1 >> 4),
+                    field12(w1 >> 20), field12(w2 >> 4), field12(w2 >> 20),
+                    field12(s6), field12(s7)]
+    return samples[:count]
+
+
+def main():
+    baud = 921600
+    rate = 19900
+    source = None
+    paths = []
+    args = sys.argv[1:]
+    while args:
+        arg = args.pop(0)
+        if arg == "--baud" and args:
+            baud = int(args.pop(0))
+        elif arg == "--rate" and args:
+            rate = int(args.pop(0))
+        elif arg == "--file" and args:
+            source = args.pop(0)
+        elif not arg.startswith("-"):
+            paths.append(arg)
+        else:
+            sys.exit(__doc__)
+    if len(paths) != (1 if source else 2) or baud not in BAUDS:
+        sys.exit(__doc__)
+
+    link = FileLink(source) if source else Link(paths[0], baud)
+    link.send(b"hands")
+    link.await_message(b"cnfrm")
+    link.send(b"ackng")
+    link.send(b"recrd")
+
+    frames = bytearray()
+    block = 0
+    while True:
+        kind, payload = link.record()
+        if kind == RECORD_STREAM:
+            break
+        if kind == RECORD_ERROR:
+            sys.exit("the board stopped: error %d of module %d"
+                     % (payload[1], payload[0]))
+        if kind != RECORD_AUDIO:
+            continue
+        sequence, count, form, _ = struct.unpack_from(AUDIO_HEADER, payload)
+        data = payload[struct.calcsize(AUDIO_HEADER):]
+        # lost blocks are as long as the one that follows them
+        frames += bytes(2 * count * (sequence - block))
+        if form == FORMAT_PACKED12:
+            frames += struct.pack("<%dh" % count, *unpack12(data, count))
+        else:
+            frames += data[:2 * count]
+        block = sequence + 1
+
+    samples, blocks, dropped, overruns, peak, capacity, clips, sent = \
+        struct.unpack(STREAM_FORMAT, payload)
+    # blocks lost at the end, up to the samples captured
+    frames += bytes(2 * samples - len(frames))
+    with wave.open(paths[-1], "wb") as w:
+        w.setnchannels(1)
+        w.setsampwidth(2)
+        w.setframerate(rate)
+        w.writeframes(bytes(frames))
+
+    print("samples,blocks,dropped,overruns,peak_backlog,capacity,clips,bytes_sent")
+    print("%d,%d,%d,%d,%d,%d,%d,%d" % (samples, blocks, dropped, overruns,
+                                       peak, capacity, clips, sent))
+
+
+if __name__ == "__main__":
+    main()
@@ -27,18 +27,38 @@
 #include <stdlib.h>
 #include "em_chip.h"
 #include "gen_com.h"
+#include "profiler.h"
+#include "coverage.h"
+#include "standard_mode.h"
+#include "events_mode.h"
+#include "inject_mode.h"
+#include "stream_mode.h"
+
+/** Operation modes the sensor can run in */
+#define OP_MODE_STANDARD 0		// record on command, send audio that passes analysis
+#define OP_MODE_EVENTS 1			// listen continuously, send detection records only
+#define OP_MODE_INJECT 2			// analyze audio sent over the link, for bench replays
+#define OP_MODE_STREAM 3			// record on command, send audio as it is captured
+
+/** Operation mode entered after initialization */
+#ifndef BIVO_OP_MODE
+#define BIVO_OP_MODE OP_MODE_STANDARD
+#endif
 
 
 /** @brief Initialize the system for operation.
  */
 void initSys(void) {
 	CHIP_Init();
+	profiler_init();
+	coverage_init();
 	genCom_init();
 }
 
 
 /** @brief Main function.
- * Initialize the system, then ender standard mode of operation.
+ * Initialize the system, then enter the operation mode selected by
+ * BIVO_OP_MODE.
  */
 int main(void) {
 	// initialize the system
@@ -47,6 +67,14 @@ int main(void) {
 	// handshake with application before proceeding
 	// handshakeApp(); // moved to standard mode as quick fix to front end issue
 
-	// start the standard mode
+	// start the selected mode
+#if BIVO_OP_MODE == OP_MODE_EVENTS
+	run_events_mode();
+#elif BIVO_OP_MODE == OP_MODE_INJECT
+	run_inject_mode();
+#elif BIVO_OP_MODE == OP_MODE_STREAM
+	run_stream_mode();
+#else
 	run_standard_mode();
+#endif
 }